@@ -0,0 +1,198 @@
+/*
+ * asyncbench - compare asyncmsg and MsgSend throughput for small messages
+ *
+ * The same number of messages of the same size is moved from one thread
+ * to another twice: once with MsgSend() to a server that replies at once,
+ * and once with asyncmsg_put() to an asynchronous channel, where the
+ * receiver wakes on the channel's pulse and drains what is queued with
+ * asyncmsg_get_n(), handing each buffer back with asyncmsg_free(). The
+ * rate of each is printed.
+ */
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/neutrino.h>
+#include <sys/asyncmsg.h>
+
+#define PULSE_CODE_ASYNC	(_PULSE_CODE_MINAVAIL + 1)
+
+static int			chid;			/* MsgSend() server's, or the async one */
+static int			pchid;			/* the async channel's pulses come here */
+static int			count = 100000;
+static int			msgsize = 16;
+static int			batch = 32;
+
+static double now(void) {
+	struct timespec		ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void *sync_server(void *arg) {
+	char				*buf;
+	int					rcvid;
+
+	if((buf = malloc(msgsize)) == NULL) {
+		return NULL;
+	}
+	for( ;; ) {
+		if((rcvid = MsgReceive(chid, buf, msgsize, NULL)) == -1 || rcvid == 0) {
+			// a pulse, the client is done
+			break;
+		}
+		MsgReply(rcvid, EOK, NULL, 0);
+	}
+	free(buf);
+	return NULL;
+}
+
+static void *async_server(void *arg) {
+	struct _asyncmsg_get_header	*list, *agh;
+	struct _pulse		pulse;
+	int					got = 0, n;
+
+	while(got < count) {
+		if(MsgReceivePulse(pchid, &pulse, sizeof pulse, NULL) == -1) {
+			perror("asyncbench: MsgReceivePulse");
+			break;
+		}
+		while((n = asyncmsg_get_n(chid, 0, &list)) > 0) {
+			while((agh = list) != NULL) {
+				list = agh->next;
+				asyncmsg_free(agh);
+			}
+			got += n;
+		}
+	}
+	return NULL;
+}
+
+static int run_sync(void) {
+	pthread_t			tid;
+	char				*msg;
+	double				start, elapsed;
+	int					coid, i;
+
+	if((msg = calloc(1, msgsize)) == NULL) {
+		fprintf(stderr, "asyncbench: no memory\n");
+		return -1;
+	}
+	if((chid = ChannelCreate(_NTO_CHF_PRIVATE)) == -1
+			|| (coid = ConnectAttach(0, 0, chid, _NTO_SIDE_CHANNEL, 0)) == -1) {
+		perror("asyncbench: channel");
+		return -1;
+	}
+	if((errno = pthread_create(&tid, NULL, sync_server, NULL)) != EOK) {
+		perror("asyncbench: pthread_create");
+		return -1;
+	}
+
+	start = now();
+	for(i = 0; i < count; i++) {
+		if(MsgSend(coid, msg, msgsize, NULL, 0) == -1) {
+			perror("asyncbench: MsgSend");
+			return -1;
+		}
+	}
+	elapsed = now() - start;
+
+	MsgSendPulse(coid, -1, 0, 0);
+	pthread_join(tid, NULL);
+	ConnectDetach(coid);
+	ChannelDestroy(chid);
+	free(msg);
+
+	printf("MsgSend      %4d bytes: %12.0f msgs/s\n", msgsize, count / elapsed);
+	return 0;
+}
+
+static int run_async(void) {
+	struct _asyncmsg_connection_attr	attr;
+	struct sigevent		ev;
+	pthread_t			tid;
+	char				*msg;
+	double				start, elapsed;
+	int					pcoid, coid, i;
+
+	if((msg = calloc(1, msgsize)) == NULL) {
+		fprintf(stderr, "asyncbench: no memory\n");
+		return -1;
+	}
+	if((pchid = ChannelCreate(_NTO_CHF_PRIVATE)) == -1
+			|| (pcoid = ConnectAttach(0, 0, pchid, _NTO_SIDE_CHANNEL, 0)) == -1) {
+		perror("asyncbench: channel");
+		return -1;
+	}
+	SIGEV_PULSE_INIT(&ev, pcoid, SIGEV_PULSE_PRIO_INHERIT, PULSE_CODE_ASYNC, 0);
+	if((chid = asyncmsg_channel_create(0, 0600, msgsize, batch * 2, &ev, NULL)) == -1) {
+		perror("asyncbench: asyncmsg_channel_create");
+		return -1;
+	}
+	memset(&attr, 0, sizeof attr);
+	attr.buffer_size = msgsize;
+	attr.max_num_buffer = batch * 2;
+	attr.trigger_num_msg = batch;
+	if((coid = asyncmsg_connect_attach(0, 0, chid, 0, ASYNCMSG_COF_SINGLE_PRODUCER, &attr)) == -1) {
+		perror("asyncbench: asyncmsg_connect_attach");
+		return -1;
+	}
+	if((errno = pthread_create(&tid, NULL, async_server, NULL)) != EOK) {
+		perror("asyncbench: pthread_create");
+		return -1;
+	}
+
+	start = now();
+	for(i = 0; i < count; i++) {
+		if(asyncmsg_put(coid, msg, msgsize, 0, NULL) == -1) {
+			perror("asyncbench: asyncmsg_put");
+			return -1;
+		}
+	}
+	asyncmsg_flush(coid, 0);
+	pthread_join(tid, NULL);
+	elapsed = now() - start;
+
+	asyncmsg_connect_detach(coid);
+	asyncmsg_channel_destroy(chid);
+	ConnectDetach(pcoid);
+	ChannelDestroy(pchid);
+	free(msg);
+
+	printf("asyncmsg     %4d bytes: %12.0f msgs/s (trigger every %d)\n", msgsize, count / elapsed, batch);
+	return 0;
+}
+
+int main(int argc, char *argv[]) {
+	int					c;
+
+	while((c = getopt(argc, argv, "b:n:s:")) != -1) {
+		switch(c) {
+		case 'b':
+			batch = atoi(optarg);
+			break;
+		case 'n':
+			count = atoi(optarg);
+			break;
+		case 's':
+			msgsize = atoi(optarg);
+			break;
+		default:
+			return EXIT_FAILURE;
+		}
+	}
+	if(count <= 0 || msgsize <= 0 || batch <= 0) {
+		fprintf(stderr, "use: asyncbench [-n count] [-s size] [-b batch]\n");
+		return EXIT_FAILURE;
+	}
+
+	if(run_sync() == -1 || run_async() == -1) {
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,16 @@
+ifndef QCONFIG
+QCONFIG=qconfig.mk
+endif
+include $(QCONFIG)
+
+INSTALLDIR=usr/bin
+
+define PINFO
+PINFO DESCRIPTION=Compare asyncmsg and MsgSend throughput for small messages
+endef
+
+USEFILE=$(PROJECT_ROOT)/$(NAME).use
+
+LIBS=asyncmsg
+
+include $(MKFILES_ROOT)/qtargets.mk
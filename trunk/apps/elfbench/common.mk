@@ -0,0 +1,16 @@
+ifndef QCONFIG
+QCONFIG=qconfig.mk
+endif
+include $(QCONFIG)
+
+INSTALLDIR=usr/bin
+
+define PINFO
+PINFO DESCRIPTION=Time reading ELF files through libelf
+endef
+
+USEFILE=$(PROJECT_ROOT)/$(NAME).use
+
+LIBS=elf
+
+include $(MKFILES_ROOT)/qtargets.mk
@@ -0,0 +1,114 @@
+/*
+ * elfbench - time reading ELF files through libelf
+ *
+ * Each file is opened with elf_begin() and every section's data is
+ * fetched with elf_getdata(), the way elfdiff and friends walk a file.
+ * This is done with ELF_C_READ and with ELF_C_READ_MMAP so the two
+ * access modes can be compared on real (large, debug) binaries.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <time.h>
+#include <libelf.h>
+
+static double now(void) {
+	struct timespec		ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/*
+ * Walk every section of one file, adding every data byte into *SUM
+ * (which also shows that both modes see the same data). Returns the
+ * number of data bytes seen, or -1 on error.
+ */
+static long walk(const char *path, Elf_Cmd cmd, unsigned *sum) {
+	int					fd;
+	Elf					*elf;
+	Elf_Scn				*scn;
+	Elf_Data			*data;
+	long				bytes = 0;
+	size_t				i;
+
+	if((fd = open(path, O_RDONLY)) == -1) {
+		perror(path);
+		return -1;
+	}
+	if(!(elf = elf_begin(fd, cmd, NULL)) || !elf32_getehdr(elf)) {
+		fprintf(stderr, "%s: not an ELF file\n", path);
+		if(elf) {
+			elf_end(elf);
+		}
+		close(fd);
+		return -1;
+	}
+	for(scn = elf_nextscn(elf, NULL); scn; scn = elf_nextscn(elf, scn)) {
+		for(data = elf_getdata(scn, NULL); data; data = elf_getdata(scn, data)) {
+			bytes += data->d_size;
+			if(data->d_buf) {
+				for(i = 0; i < data->d_size; i++) {
+					*sum += ((unsigned char *)data->d_buf)[i];
+				}
+			}
+		}
+	}
+	elf_end(elf);
+	close(fd);
+	return bytes;
+}
+
+static int run(const char *name, Elf_Cmd cmd, int iterations, int nfiles, char **files) {
+	double				start, elapsed;
+	long				bytes = 0, n;
+	unsigned			sum = 0;
+	int					i, f;
+
+	start = now();
+	for(i = 0; i < iterations; i++) {
+		for(f = 0; f < nfiles; f++) {
+			if((n = walk(files[f], cmd, &sum)) == -1) {
+				return -1;
+			}
+			bytes += n;
+		}
+	}
+	elapsed = now() - start;
+	printf("%-10s %8.3f ms per pass, %ld bytes of section data per pass (sum %08x)\n",
+		name, elapsed * 1000 / iterations, bytes / iterations, sum);
+	return 0;
+}
+
+int main(int argc, char *argv[]) {
+	int					iterations = 100;
+	int					c;
+
+	while((c = getopt(argc, argv, "n:")) != -1) {
+		switch(c) {
+		case 'n':
+			iterations = atoi(optarg);
+			break;
+		default:
+			return EXIT_FAILURE;
+		}
+	}
+	if(optind >= argc || iterations <= 0) {
+		fprintf(stderr, "use: elfbench [-n iterations] file...\n");
+		return EXIT_FAILURE;
+	}
+	if(elf_version(EV_CURRENT) == EV_NONE) {
+		fprintf(stderr, "elfbench: libelf is out of date\n");
+		return EXIT_FAILURE;
+	}
+
+	// Warm the cache so neither mode pays for the disk
+	if(run("warmup", ELF_C_READ, 1, argc - optind, argv + optind) == -1
+			|| run("read", ELF_C_READ, iterations, argc - optind, argv + optind) == -1
+			|| run("read_mmap", ELF_C_READ_MMAP, iterations, argc - optind, argv + optind) == -1) {
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,124 @@
+/*
+ * msgpingpong - time MsgSend/MsgReceive/MsgReply round trips
+ *
+ * A server thread receives on a private channel and replies at once; the
+ * main thread sends to it in a loop. Short messages take the kernel's
+ * fast path, where the receiver is readied on the sending cpu if it may
+ * run there, so the run can be repeated with the two threads locked to
+ * the same cpu, to different cpus, or left to float.
+ */
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/neutrino.h>
+
+static int			chid;
+static int			msgsize = 4;
+static unsigned		server_mask;
+
+static double now(void) {
+	struct timespec		ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void set_runmask(unsigned mask) {
+	if(mask != 0 && ThreadCtl(_NTO_TCTL_RUNMASK, (void *)mask) == -1) {
+		perror("ThreadCtl(_NTO_TCTL_RUNMASK)");
+		exit(EXIT_FAILURE);
+	}
+}
+
+static void *server(void *arg) {
+	char				*buf;
+	int					rcvid;
+
+	set_runmask(server_mask);
+	if((buf = malloc(msgsize)) == NULL) {
+		return NULL;
+	}
+	for( ;; ) {
+		if((rcvid = MsgReceive(chid, buf, msgsize, NULL)) == -1) {
+			break;
+		}
+		if(rcvid == 0) {
+			// pulse, the client is done
+			break;
+		}
+		MsgReply(rcvid, EOK, buf, msgsize);
+	}
+	free(buf);
+	return NULL;
+}
+
+int main(int argc, char *argv[]) {
+	int					iterations = 100000;
+	unsigned			client_mask = 0;
+	pthread_t			tid;
+	char				*smsg, *rmsg;
+	double				start, elapsed;
+	int					c, i, coid;
+
+	while((c = getopt(argc, argv, "c:n:s:S:")) != -1) {
+		switch(c) {
+		case 'c':
+			client_mask = 1u << atoi(optarg);
+			break;
+		case 'n':
+			iterations = atoi(optarg);
+			break;
+		case 's':
+			msgsize = atoi(optarg);
+			break;
+		case 'S':
+			server_mask = 1u << atoi(optarg);
+			break;
+		default:
+			return EXIT_FAILURE;
+		}
+	}
+	if(iterations <= 0 || msgsize <= 0) {
+		fprintf(stderr, "use: msgpingpong [-n iterations] [-s size] [-c cpu] [-S cpu]\n");
+		return EXIT_FAILURE;
+	}
+	set_runmask(client_mask);
+
+	if((smsg = calloc(1, msgsize)) == NULL || (rmsg = malloc(msgsize)) == NULL) {
+		fprintf(stderr, "msgpingpong: no memory\n");
+		return EXIT_FAILURE;
+	}
+	if((chid = ChannelCreate(_NTO_CHF_PRIVATE)) == -1
+			|| (coid = ConnectAttach(0, 0, chid, _NTO_SIDE_CHANNEL, 0)) == -1) {
+		perror("msgpingpong: channel");
+		return EXIT_FAILURE;
+	}
+	if((errno = pthread_create(&tid, NULL, server, NULL)) != EOK) {
+		perror("msgpingpong: pthread_create");
+		return EXIT_FAILURE;
+	}
+
+	// one round trip first so the server is receive blocked
+	MsgSend(coid, smsg, msgsize, rmsg, msgsize);
+
+	start = now();
+	for(i = 0; i < iterations; i++) {
+		if(MsgSend(coid, smsg, msgsize, rmsg, msgsize) == -1) {
+			perror("msgpingpong: MsgSend");
+			return EXIT_FAILURE;
+		}
+	}
+	elapsed = now() - start;
+
+	MsgSendPulse(coid, -1, 0, 0);
+	pthread_join(tid, NULL);
+
+	printf("%d byte messages: %.3f us per round trip (%d round trips)\n",
+		msgsize, elapsed * 1e6 / iterations, iterations);
+	return EXIT_SUCCESS;
+}
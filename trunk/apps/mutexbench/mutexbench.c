@@ -0,0 +1,119 @@
+/*
+ * mutexbench - time contended pthread mutexes, blocking and adaptive
+ *
+ * A number of threads lock one shared mutex, do a short critical section
+ * (a few loads and stores on shared data) and unlock it, for a fixed
+ * time. This is run once with an ordinary mutex, which blocks in the
+ * kernel as soon as it is contended, and once with an adaptive one,
+ * which spins while the owner is running on another cpu.
+ */
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+struct worker {
+	pthread_t			tid;
+	unsigned long		count;
+	char				pad[64];	/* keep the counters on their own cache lines */
+};
+
+static pthread_mutex_t	mutex;
+static volatile int		running;
+static int				hold = 50;		/* critical section length, in loop passes */
+static volatile unsigned long shared[8];
+
+static void *worker(void *arg) {
+	struct worker		*wp = arg;
+	unsigned long		n = 0;
+	int					i;
+
+	while(!running) {
+		// wait for the start
+	}
+	while(running > 0) {
+		pthread_mutex_lock(&mutex);
+		for(i = 0; i < hold; i++) {
+			shared[i & 7]++;
+		}
+		pthread_mutex_unlock(&mutex);
+		n++;
+	}
+	wp->count = n;
+	return NULL;
+}
+
+static int run(const char *kind, int adaptive, int nthreads, int seconds) {
+	pthread_mutexattr_t	attr;
+	struct worker		*workers;
+	unsigned long		total = 0;
+	int					i;
+
+	pthread_mutexattr_init(&attr);
+	if(adaptive && pthread_mutexattr_setadaptive(&attr, PTHREAD_ADAPTIVE_ENABLE) != EOK) {
+		fprintf(stderr, "mutexbench: no adaptive mutexes\n");
+		return -1;
+	}
+	pthread_mutex_init(&mutex, &attr);
+	pthread_mutexattr_destroy(&attr);
+
+	if((workers = calloc(nthreads, sizeof *workers)) == NULL) {
+		fprintf(stderr, "mutexbench: no memory\n");
+		return -1;
+	}
+	running = 0;
+	for(i = 0; i < nthreads; i++) {
+		if((errno = pthread_create(&workers[i].tid, NULL, worker, &workers[i])) != EOK) {
+			perror("mutexbench: pthread_create");
+			return -1;
+		}
+	}
+
+	running = 1;
+	sleep(seconds);
+	running = -1;
+
+	for(i = 0; i < nthreads; i++) {
+		pthread_join(workers[i].tid, NULL);
+		total += workers[i].count;
+	}
+	printf("%-9s %3d threads: %12.0f locks/s\n", kind, nthreads, (double)total / seconds);
+	free(workers);
+	pthread_mutex_destroy(&mutex);
+	return 0;
+}
+
+int main(int argc, char *argv[]) {
+	int					nthreads = 4, seconds = 2;
+	int					c;
+
+	while((c = getopt(argc, argv, "h:n:t:")) != -1) {
+		switch(c) {
+		case 'h':
+			hold = atoi(optarg);
+			break;
+		case 'n':
+			nthreads = atoi(optarg);
+			break;
+		case 't':
+			seconds = atoi(optarg);
+			break;
+		default:
+			return EXIT_FAILURE;
+		}
+	}
+	if(nthreads <= 0 || seconds <= 0 || hold < 0) {
+		fprintf(stderr, "use: mutexbench [-n threads] [-t seconds] [-h hold]\n");
+		return EXIT_FAILURE;
+	}
+
+	if(run("blocking", 0, nthreads, seconds) == -1
+			|| run("adaptive", 1, nthreads, seconds) == -1) {
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,14 @@
+ifndef QCONFIG
+QCONFIG=qconfig.mk
+endif
+include $(QCONFIG)
+
+INSTALLDIR=usr/bin
+
+define PINFO
+PINFO DESCRIPTION=Time named semaphore operations
+endef
+
+USEFILE=$(PROJECT_ROOT)/$(NAME).use
+
+include $(MKFILES_ROOT)/qtargets.mk
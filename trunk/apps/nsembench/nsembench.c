@@ -0,0 +1,131 @@
+/*
+ * nsembench - time named semaphore operations
+ *
+ * Runs the same loops on a pair of named semaphores (sem_open) and on a
+ * pair of unnamed ones (sem_init), so the cost of going through procnto
+ * can be compared with the kernel sync object:
+ *
+ *	post/wait	sem_post() then sem_wait() in one thread (never blocks)
+ *	trywait		sem_trywait() on a semaphore with no tokens
+ *	pingpong	two threads handing a token back and forth (always blocks)
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+static int			iterations = 100000;
+static sem_t		*ping, *pong;
+
+static double now(void) {
+	struct timespec		ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void report(const char *kind, const char *test, double start) {
+	printf("%-8s %-10s %8.3f us per operation\n", kind, test,
+		(now() - start) * 1e6 / iterations);
+}
+
+static void *pingpong_thread(void *arg) {
+	int					i;
+
+	for(i = 0; i < iterations; i++) {
+		sem_wait(ping);
+		sem_post(pong);
+	}
+	return NULL;
+}
+
+static int run(const char *kind) {
+	pthread_t			tid;
+	double				start;
+	int					i;
+
+	start = now();
+	for(i = 0; i < iterations; i++) {
+		if(sem_post(ping) == -1 || sem_wait(ping) == -1) {
+			perror("post/wait");
+			return -1;
+		}
+	}
+	report(kind, "post/wait", start);
+
+	start = now();
+	for(i = 0; i < iterations; i++) {
+		if(sem_trywait(ping) != -1 || errno != EAGAIN) {
+			perror("trywait");
+			return -1;
+		}
+	}
+	report(kind, "trywait", start);
+
+	if((errno = pthread_create(&tid, NULL, pingpong_thread, NULL)) != EOK) {
+		perror("pthread_create");
+		return -1;
+	}
+	start = now();
+	for(i = 0; i < iterations; i++) {
+		sem_post(ping);
+		sem_wait(pong);
+	}
+	report(kind, "pingpong", start);
+	pthread_join(tid, NULL);
+	return 0;
+}
+
+int main(int argc, char *argv[]) {
+	static sem_t		unnamed[2];
+	char				name[2][32];
+	int					c, status;
+
+	while((c = getopt(argc, argv, "n:")) != -1) {
+		switch(c) {
+		case 'n':
+			iterations = atoi(optarg);
+			break;
+		default:
+			return EXIT_FAILURE;
+		}
+	}
+	if(iterations <= 0) {
+		fprintf(stderr, "use: nsembench [-n iterations]\n");
+		return EXIT_FAILURE;
+	}
+
+	sprintf(name[0], "/nsembench.%d.ping", getpid());
+	sprintf(name[1], "/nsembench.%d.pong", getpid());
+	if((ping = sem_open(name[0], O_CREAT | O_EXCL, 0600, 0)) == SEM_FAILED
+			|| (pong = sem_open(name[1], O_CREAT | O_EXCL, 0600, 0)) == SEM_FAILED) {
+		perror("sem_open");
+		sem_unlink(name[0]);
+		return EXIT_FAILURE;
+	}
+	status = run("named");
+	sem_close(ping);
+	sem_close(pong);
+	sem_unlink(name[0]);
+	sem_unlink(name[1]);
+	if(status == -1) {
+		return EXIT_FAILURE;
+	}
+
+	sem_init(&unnamed[0], 0, 0);
+	sem_init(&unnamed[1], 0, 0);
+	ping = &unnamed[0];
+	pong = &unnamed[1];
+	if(run("unnamed") == -1) {
+		return EXIT_FAILURE;
+	}
+	sem_destroy(&unnamed[0]);
+	sem_destroy(&unnamed[1]);
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,133 @@
+/*
+ * rwlockbench - time pthread rwlock read locking as readers are added
+ *
+ * For 1, 2, ... up to the maximum number of threads, each thread takes
+ * and drops a read lock on one shared rwlock in a loop for a fixed time.
+ * Read locks don't exclude each other, so the total rate should grow
+ * with the number of readers on a multi-cpu machine. An optional writer
+ * takes the write lock every so often to show the cost of contention.
+ */
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+struct reader {
+	pthread_t			tid;
+	unsigned long		count;
+	char				pad[64];	/* keep the counters on their own cache lines */
+};
+
+static pthread_rwlock_t	rwlock = PTHREAD_RWLOCK_INITIALIZER;
+static volatile int		running;
+static int				write_interval;		/* microseconds between writes, 0 for none */
+static unsigned long	writes;
+
+static void *reader(void *arg) {
+	struct reader		*rp = arg;
+	unsigned long		n = 0;
+
+	while(!running) {
+		// wait for the start
+	}
+	while(running > 0) {
+		pthread_rwlock_rdlock(&rwlock);
+		pthread_rwlock_unlock(&rwlock);
+		n++;
+	}
+	rp->count = n;
+	return NULL;
+}
+
+static void *writer(void *arg) {
+	while(!running) {
+		// wait for the start
+	}
+	while(running > 0) {
+		usleep(write_interval);
+		pthread_rwlock_wrlock(&rwlock);
+		writes++;
+		pthread_rwlock_unlock(&rwlock);
+	}
+	return NULL;
+}
+
+static int run(int nreaders, int seconds) {
+	struct reader		*readers;
+	pthread_t			wtid;
+	unsigned long		total = 0;
+	int					i;
+
+	if((readers = calloc(nreaders, sizeof *readers)) == NULL) {
+		fprintf(stderr, "rwlockbench: no memory\n");
+		return -1;
+	}
+	running = 0;
+	writes = 0;
+	for(i = 0; i < nreaders; i++) {
+		if((errno = pthread_create(&readers[i].tid, NULL, reader, &readers[i])) != EOK) {
+			perror("rwlockbench: pthread_create");
+			return -1;
+		}
+	}
+	if(write_interval && (errno = pthread_create(&wtid, NULL, writer, NULL)) != EOK) {
+		perror("rwlockbench: pthread_create");
+		return -1;
+	}
+
+	running = 1;
+	sleep(seconds);
+	running = -1;
+
+	for(i = 0; i < nreaders; i++) {
+		pthread_join(readers[i].tid, NULL);
+		total += readers[i].count;
+	}
+	if(write_interval) {
+		pthread_join(wtid, NULL);
+	}
+	printf("%3d readers: %12.0f read locks/s, %10.0f per reader", nreaders,
+		(double)total / seconds, (double)total / seconds / nreaders);
+	if(write_interval) {
+		printf(", %lu writes", writes);
+	}
+	printf("\n");
+	free(readers);
+	return 0;
+}
+
+int main(int argc, char *argv[]) {
+	int					maxreaders = 4, seconds = 2;
+	int					c, n;
+
+	while((c = getopt(argc, argv, "r:t:w:")) != -1) {
+		switch(c) {
+		case 'r':
+			maxreaders = atoi(optarg);
+			break;
+		case 't':
+			seconds = atoi(optarg);
+			break;
+		case 'w':
+			write_interval = atoi(optarg);
+			break;
+		default:
+			return EXIT_FAILURE;
+		}
+	}
+	if(maxreaders <= 0 || seconds <= 0 || write_interval < 0) {
+		fprintf(stderr, "use: rwlockbench [-r readers] [-t seconds] [-w usec]\n");
+		return EXIT_FAILURE;
+	}
+
+	for(n = 1; n <= maxreaders; n++) {
+		if(run(n, seconds) == -1) {
+			return EXIT_FAILURE;
+		}
+	}
+	return EXIT_SUCCESS;
+}
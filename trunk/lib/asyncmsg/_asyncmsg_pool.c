@@ -0,0 +1,155 @@
+/*
+ * $QNXLicenseC:
+ * Copyright 2007, QNX Software Systems. All Rights Reserved.
+ * 
+ * You must obtain a written license from and pay applicable license fees to QNX 
+ * Software Systems before you may reproduce, modify or distribute this software, 
+ * or any work that includes all or part of this software.   Free development 
+ * licenses are available for evaluation and non-commercial purposes.  For more 
+ * information visit http://licensing.qnx.com or email licensing@qnx.com.
+ *  
+ * This file may contain contributions from others.  Please review this entire 
+ * file for other proprietary rights or license notices, as well as the QNX 
+ * Development Suite License Guide at http://licensing.qnx.com/license-guide/ 
+ * for other information.
+ * $
+ */
+
+
+
+
+#include <stdlib.h>
+#include "asyncmsg_priv.h"
+
+/* Receive buffers are set up once, when they are allocated or come back
+ * through asyncmsg_free(). The payload is never cleared; the kernel only
+ * needs the header and iov, and clears the _msg_info itself.
+ */
+static void _asyncmsg_pool_init(struct _asyncmsg_channel_context *acc, struct _asyncmsg_get_header *agh)
+{
+	agh->err = 0;
+	agh->iov = (iov_t *)(agh + 1);
+	agh->iov->iov_base = agh->iov + 1;
+	agh->iov->iov_len  = acc->buffer_size;
+	agh->parts = 1;
+	agh->next = acc->free;
+	acc->free = agh;
+	acc->num_free++;
+}
+
+static void _asyncmsg_pool_destroy(struct _asyncmsg_channel_context *acc)
+{
+	pthread_mutex_destroy(&acc->mutex);
+	free(acc->slab);
+	free(acc);
+}
+
+/* Carve max_num_buffer receive buffers out of one allocation, before the
+ * channel is published. Each one is tagged with the channel, which is how
+ * asyncmsg_free() finds its way back here. Without a slab (a recvbuf
+ * callback, or no memory) buffers are allocated one at a time by
+ * _asyncmsg_pool_fill().
+ */
+void _asyncmsg_pool_create(struct _asyncmsg_channel_context *acc)
+{
+	union _asyncmsg_tag *tag;
+	size_t entsize;
+	char *p;
+
+	if (acc->recvbuf_cb || acc->max_num_buffer == 0) {
+		return;
+	}
+	entsize = sizeof(*tag) + sizeof(struct _asyncmsg_get_header) + sizeof(iov_t) + acc->buffer_size;
+	entsize = (entsize + 7) & ~7;
+	if ((acc->slab = malloc(entsize * acc->max_num_buffer)) == NULL) {
+		return;
+	}
+	acc->slab_end = acc->slab + entsize * acc->max_num_buffer;
+	for (p = acc->slab_end; p > acc->slab; ) {
+		p -= entsize;
+		tag = (union _asyncmsg_tag *)p;
+		tag->owner = acc;
+		_asyncmsg_pool_init(acc, (struct _asyncmsg_get_header *)(tag + 1));
+	}
+}
+
+/* top up the free list, called with acc->mutex held */
+void _asyncmsg_pool_fill(struct _asyncmsg_channel_context *acc)
+{
+	struct _asyncmsg_get_header *agh;
+	union _asyncmsg_tag *tag;
+	size_t entsize;
+
+	entsize = sizeof(struct _asyncmsg_get_header) + sizeof(iov_t) + acc->buffer_size;
+	while (acc->num_free < acc->max_num_buffer) {
+		void *bufs[1];
+
+		if (!acc->recvbuf_cb) {
+			if ((agh = asyncmsg_malloc(entsize)) == NULL) {
+				break;
+			}
+		} else {
+			if (acc->recvbuf_cb(sizeof(*tag) + entsize, 1, (void **)bufs, ASYNCMSG_RECVBUF_ALLOC) <= 0) {
+				break;
+			}
+			tag = bufs[0];
+			tag->owner = NULL;
+			agh = (struct _asyncmsg_get_header *)(tag + 1);
+		}
+		_asyncmsg_pool_init(acc, agh);
+	}
+}
+
+/* asyncmsg_free() of BUF, a slab buffer of ACC: hand it back */
+void _asyncmsg_pool_put(struct _asyncmsg_channel_context *acc, void *buf)
+{
+	int last;
+
+	_mutex_lock(&acc->mutex);
+	if (!acc->destroyed) {
+		_asyncmsg_pool_init(acc, buf);
+	}
+	last = (--acc->outstanding == 0 && acc->destroyed);
+	_mutex_unlock(&acc->mutex);
+
+	if (last) {
+		_asyncmsg_pool_destroy(acc);
+	}
+}
+
+/* the channel is gone, free the context once all its slab buffers are back */
+void _asyncmsg_pool_release(struct _asyncmsg_channel_context *acc)
+{
+	struct _asyncmsg_get_header *ahp;
+	void *buffs[16];
+	int n, last;
+
+	_mutex_lock(&acc->mutex);
+	acc->destroyed = 1;
+	n = 0;
+	while ((ahp = acc->free)) {
+		acc->free = ahp->next;
+		if (_ASYNCMSG_IN_SLAB(acc, ahp)) {
+			continue;
+		}
+		if (!acc->recvbuf_cb) {
+			asyncmsg_free(ahp);
+			continue;
+		}
+		buffs[n++] = _ASYNCMSG_TAG(ahp);
+		if (n == sizeof(buffs) / sizeof(buffs[0]) || acc->free == NULL) {
+			acc->recvbuf_cb(sizeof(union _asyncmsg_tag) + acc->buffer_size + sizeof(iov_t) + sizeof(struct _asyncmsg_get_header),
+							n, buffs, ASYNCMSG_RECVBUF_FREE);
+			n = 0;
+		}
+	}
+	acc->num_free = 0;
+	last = (acc->outstanding == 0);
+	_mutex_unlock(&acc->mutex);
+
+	if (last) {
+		_asyncmsg_pool_destroy(acc);
+	}
+}
+
+__SRCVERSION("_asyncmsg_pool.c $Rev: 153052 $");
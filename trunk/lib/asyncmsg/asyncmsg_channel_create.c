@@ -44,22 +44,21 @@ int asyncmsg_channel_create(unsigned flags,  mode_t mode, size_t buffer_size, un
 	acc->max_num_buffer = max_num_buffer;
 	acc->buffer_size = buffer_size;
 
-	if ((acc->iovs = malloc(sizeof(iov_t) * max_num_buffer)) == NULL) {
-		free(acc);
-		return -1;
-	}
-	
 	if ((chid = ChannelCreateExt(flags | _NTO_CHF_ASYNC, mode, buffer_size, max_num_buffer, ev, NULL)) == -1) {
 		pthread_mutex_destroy(&acc->mutex);
-		free(acc->iovs);
 		free(acc);
 		return -1;
 	}
 
+	/* have the receive buffers ready before the first asyncmsg_get() */
+	_asyncmsg_pool_create(acc);
+	_mutex_lock(&acc->mutex);
+	_asyncmsg_pool_fill(acc);
+	_mutex_unlock(&acc->mutex);
+
 	if (_asyncmsg_handle(chid, _ASYNCMSG_HANDLE_ADD | _ASYNCMSG_HANDLE_CHANNEL, acc) == NULL) {
-		asyncmsg_channel_destroy(chid);
-		free(acc->iovs);
-		free(acc);
+		ChannelDestroy(chid);
+		_asyncmsg_pool_release(acc);
 		return -1;
 	}
 	
@@ -34,41 +34,9 @@ int asyncmsg_channel_destroy(int chid)
 		return -1;
 	}
 
-	/* how do we destroy mutex safely ? */
-	pthread_mutex_destroy(&acc->mutex);
-	
-	if (acc->free) {
-		if (!acc->recvbuf_cb) {
-			struct _asyncmsg_get_header *ahp;
-			
-			while (ahp = acc->free) {
-				acc->free = ahp->next;
-				asyncmsg_free(ahp);
-			}
-		} else {
-			int i, n;
-			void **buffs, *single_buf;
-			
-			if ((buffs = alloca(acc->num_free * sizeof(void *))) == NULL) {
-				buffs = &single_buf;
-				n = 1;
-			} else {
-				n = acc->num_free;
-			}
-			
-			do {
-				for (i = 0; i < n; i++) {
-					buffs[i] = acc->free;
-					acc->free = acc->free->next;
-				}
-				acc->recvbuf_cb(acc->buffer_size + sizeof(iov_t) + sizeof(struct _asyncmsg_get_header),
-								n, buffs, ASYNCMSG_RECVBUF_FREE);
-				acc->num_free -= n;
-			} while (acc->num_free);
-		}
-	}
-	free(acc->iovs);
-	free(acc);
+	/* buffers still held by the application keep the context
+	 * alive, the last asyncmsg_free() of them releases it */
+	_asyncmsg_pool_release(acc);
 	return 0;
 }
 
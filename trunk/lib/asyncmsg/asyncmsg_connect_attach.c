@@ -18,6 +18,7 @@
 
 
 
+#include <atomic.h>
 #include <errno.h>
 #include <pthread.h>
 #include <stdlib.h>
@@ -44,14 +45,13 @@ static void * _async_event_thread(void *arg)
 		  continue;
 		acd = &acc->acd;
 		
-		_mutex_lock(&acd->mu);
 		if (pulse.code == 'T') {
-			/* triger timer expired */
+			/* triger timer expired; rearm first, so a put that races
+			 * with us restarts the timer rather than being stranded */
+			atomic_set(&acc->flags, _ASYNCMSG_CONNECT_TIMEROFF);
 			if (acc->acd.num_curmsg) {
 				MsgSendAsync(coid);
 			}
-			acc->flags |= _ASYNCMSG_CONNECT_TIMEROFF;
-			_mutex_unlock(&acd->mu);
 			continue;
 		}
 		
@@ -60,6 +60,7 @@ static void * _async_event_thread(void *arg)
 			/* collect some done message from "free" ptr */
 			struct _asyncmsg_put_header *aph;
 			
+			_mutex_lock(&acd->mu);
 			while (acd->sendq_free != acd->sendq_head) {
 				aph = &acd->sendq[acd->sendq_free];
 				if (aph->cb) {
@@ -85,7 +86,7 @@ int asyncmsg_connect_attach(uint32_t nd, pid_t pid, int chid, unsigned index, un
 {
 	struct _asyncmsg_connect_context *acc;
 	struct _asyncmsg_connection_descriptor *acd;
-	int id, size;
+	int id, size, sp;
 	static pthread_mutex_t _async_init_mutex = PTHREAD_MUTEX_INITIALIZER;
 
 	_mutex_lock(&_async_init_mutex);
@@ -137,6 +138,8 @@ int asyncmsg_connect_attach(uint32_t nd, pid_t pid, int chid, unsigned index, un
 	memset(acc, 0, sizeof(*acc));
 	acd = &acc->acd;
 
+	sp = (flags & ASYNCMSG_COF_SINGLE_PRODUCER) != 0;
+	flags &= ~ASYNCMSG_COF_SINGLE_PRODUCER;
 	flags |= _NTO_COF_NOSHARE;
 	acd->attr = *attr;
 	acd->flags = flags;
@@ -155,7 +158,7 @@ int asyncmsg_connect_attach(uint32_t nd, pid_t pid, int chid, unsigned index, un
 		asyncmsg_connect_detach(id);
 		return -1;
 	}
-	acc->flags = _ASYNCMSG_CONNECT_TIMEROFF;
+	acc->flags = _ASYNCMSG_CONNECT_TIMEROFF | (sp ? _ASYNCMSG_CONNECT_SPRODUCER : 0);
 	
 	acd->ev.sigev_code = 'P';
 	if ((errno = pthread_mutex_init(&acd->mu, 0)) != EOK)
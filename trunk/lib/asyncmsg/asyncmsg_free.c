@@ -19,11 +19,21 @@
 
 
 #include <stdlib.h>
-#include <sys/asyncmsg.h>
+#include "asyncmsg_priv.h"
 
 void asyncmsg_free(void *buf)
 {
-	free(buf);
+	union _asyncmsg_tag *tag;
+
+	if (buf == NULL)
+	  return;
+	tag = _ASYNCMSG_TAG(buf);
+	/* a receive buffer from a channel's slab, recycle it */
+	if (tag->owner != NULL) {
+		_asyncmsg_pool_put(tag->owner, buf);
+		return;
+	}
+	free(tag);
 	return;
 }
 
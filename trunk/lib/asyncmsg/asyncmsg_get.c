@@ -18,98 +18,88 @@
 
 
 
+#include <errno.h>
 #include <unistd.h>
 #include "asyncmsg_priv.h"
 
-struct _asyncmsg_get_header* asyncmsg_get(int chid)
+/* Receive up to "max" messages (0 means the channel's max_num_buffer,
+ * capped at _ASYNCMSG_GET_MAX) in one kernel call. The headers are
+ * chained through "next" from *list, and each one goes back to the
+ * channel's pool with asyncmsg_free().
+ */
+int asyncmsg_get_n(int chid, unsigned max, struct _asyncmsg_get_header **list)
 {
 	struct _asyncmsg_get_header *agh;
 	struct _asyncmsg_channel_context *acc;
-	iov_t  *iov;
+	iov_t  iov[_ASYNCMSG_GET_MAX];
 	size_t entsize;
-	int n, used;
+	int i, n, used, got;
 	
+	*list = NULL;
 	if ((acc = _asyncmsg_handle(chid, _ASYNCMSG_HANDLE_LOOKUP | _ASYNCMSG_HANDLE_CHANNEL, 0)) == NULL)
-	  return NULL;
+	  return -1;
 
+	if (max == 0 || max > acc->max_num_buffer)
+	  max = acc->max_num_buffer;
+	if (max > _ASYNCMSG_GET_MAX)
+	  max = _ASYNCMSG_GET_MAX;
 	entsize = sizeof(struct _asyncmsg_get_header) + sizeof(iov_t) + acc->buffer_size;
 	
 	_mutex_lock(&acc->mutex);
-	while (acc->num_free < acc->max_num_buffer) {
-		void *bufs[1];
-
-		if (!acc->recvbuf_cb) {
-			if ((agh = asyncmsg_malloc(entsize)) == NULL) {
-				break;
-			}
-			memset(agh, 0, entsize);
-			agh->iov = (iov_t *)(agh + 1);
-			agh->iov->iov_base = agh->iov + 1;
-			agh->iov->iov_len  = acc->buffer_size;
-			agh->parts = 1;
-			agh->next = acc->free;
-			acc->free = agh;
-			acc->num_free++;
-		} else {
-			if (acc->recvbuf_cb(entsize, 1, (void **)bufs, ASYNCMSG_RECVBUF_ALLOC) <= 0) {
-				break;
-			}
-			agh = bufs[0];
-			memset(agh, 0, entsize);
-			agh->iov = (iov_t *)(agh + 1);
-			agh->iov->iov_base = agh->iov + 1;
-			agh->iov->iov_len  = acc->buffer_size;
-			agh->parts = 1;
-			agh->next = acc->free;
-			acc->free = agh;
-			acc->num_free++;
-		}
-	}
+	_asyncmsg_pool_fill(acc);
 
-	iov = acc->iovs;
-	for (n = 0, agh = acc->free; n < acc->max_num_buffer && agh; n++, agh = agh->next)
+	for (n = 0, agh = acc->free; n < max && agh; n++, agh = agh->next)
 	{
 		SETIOV(&iov[n], agh, entsize);
+		if (_ASYNCMSG_IN_SLAB(acc, agh))
+		  acc->outstanding++;
 	}
 
 	if (n == 0) {
 		_mutex_unlock(&acc->mutex);
-		return NULL;
+		errno = ENOMEM;
+		return -1;
 	}
 
-	if (agh) {
-		acc->free = agh;
-		agh = iov[n - 1].iov_base;
-		agh->next = NULL;
-	} else {
-		acc->free = NULL;
-	}
+	acc->free = agh;
+	agh = iov[n - 1].iov_base;
+	agh->next = NULL;
 	acc->num_free -= n;
 	_mutex_unlock(&acc->mutex);
 
-	if ((used = MsgReceiveAsync(chid, iov, n)) <= 0) {
+	used = MsgReceiveAsync(chid, iov, n);
+	got = (used > 0) ? used : 0;
+	
+	if (got < n) {
+		int left = n - got;
+
 		_mutex_lock(&acc->mutex);
 		agh = iov[n - 1].iov_base;
 		agh->next = acc->free;
-		acc->free = iov[0].iov_base;
-		acc->num_free += n;
+		acc->free = iov[got].iov_base;
+		if (got > 0) {
+			agh = iov[got - 1].iov_base;
+			agh->next = NULL;
+		}
+		acc->num_free += left;
+		for (i = got; i < n; i++) {
+			if (_ASYNCMSG_IN_SLAB(acc, iov[i].iov_base))
+			  acc->outstanding--;
+		}
 		_mutex_unlock(&acc->mutex);
-		return NULL;
 	}
-	
-	if (used < n) {
-		_mutex_lock(&acc->mutex);
-		agh = iov[n - 1].iov_base;
-		agh->next = acc->free;
-		acc->free = iov[used].iov_base;
+	if (got > 0) {
+		*list = iov[0].iov_base;
+	}
+	return used;
+}
 
-		agh = iov[used - 1].iov_base;
-		agh->next = NULL;
+struct _asyncmsg_get_header* asyncmsg_get(int chid)
+{
+	struct _asyncmsg_get_header *agh;
 
-		acc->num_free += n - used;
-		_mutex_unlock(&acc->mutex);
-	}
-	agh = iov[0].iov_base;
+	if (asyncmsg_get_n(chid, 0, &agh) <= 0)
+	  return NULL;
 	return agh;
 }
 
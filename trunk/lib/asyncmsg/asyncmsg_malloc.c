@@ -19,11 +19,16 @@
 
 
 #include <stdlib.h>
-#include <sys/asyncmsg.h>
+#include "asyncmsg_priv.h"
 
 void *asyncmsg_malloc(size_t size)
 {
-	return malloc(size);
+	union _asyncmsg_tag *tag;
+
+	if ((tag = malloc(sizeof(*tag) + size)) == NULL)
+	  return NULL;
+	tag->owner = NULL;
+	return tag + 1;
 }
 
 __SRCVERSION("asyncmsg_malloc.c $Rev: 153052 $");
@@ -36,14 +36,35 @@ struct _asyncmsg_channel_context {
 	int max_num_buffer;
 	struct _asyncmsg_get_header *free;
 	int num_free;
-	iov_t *iovs;
+	char *slab;			/* receive buffers owned by the channel */
+	char *slab_end;
+	int outstanding;	/* slab buffers handed out by asyncmsg_get_n() */
+	int destroyed;
 };
 
+/* Every buffer asyncmsg_malloc() or a receive pool hands out has one of
+ * these in front of it, recording the channel whose slab it is in (NULL
+ * for anything else). asyncmsg_free() goes by that alone, so it doesn't
+ * need to look the buffer up anywhere.
+ */
+union _asyncmsg_tag {
+	struct _asyncmsg_channel_context *owner;
+	double align;
+};
+#define _ASYNCMSG_TAG(buf)	((union _asyncmsg_tag *)(buf) - 1)
+
 struct _asyncmsg_connect_context {
 	unsigned flags;
 	struct _asyncmsg_connection_descriptor acd;
 };
 #define _ASYNCMSG_CONNECT_TIMEROFF 1
+#define _ASYNCMSG_CONNECT_SPRODUCER 2
+
+#define _ASYNCMSG_IN_SLAB(acc, buf) \
+	((char *)(buf) >= (acc)->slab && (char *)(buf) < (acc)->slab_end)
+
+/* most messages asyncmsg_get_n() receives in one kernel call */
+#define _ASYNCMSG_GET_MAX        32
 
 /* by default, every get will try to receive 5 message */
 #define _ASYNCMSG_DEFAULT_GET    5
@@ -56,4 +77,10 @@ struct _asyncmsg_connect_context {
 
 extern void * _asyncmsg_handle(int id, int cmd, void *handle);
 
+/* for the receive buffer pool, _asyncmsg_pool.c */
+extern void _asyncmsg_pool_create(struct _asyncmsg_channel_context *acc);
+extern void _asyncmsg_pool_fill(struct _asyncmsg_channel_context *acc);
+extern void _asyncmsg_pool_put(struct _asyncmsg_channel_context *acc, void *buf);
+extern void _asyncmsg_pool_release(struct _asyncmsg_channel_context *acc);
+
 #endif
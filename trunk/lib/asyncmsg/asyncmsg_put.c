@@ -19,25 +19,67 @@
 
 
 #include <errno.h>
+#include <atomic.h>
+#include <sys/neutrino.h>
 #include "asyncmsg_priv.h"
 
 static int _asyncmsg_put_trigger(int coid, struct _asyncmsg_connect_context *acc)
 {
 	/* figure out if we need to trigger kernel */
-	acc->acd.num_curmsg++;
-	if (acc->acd.attr.trigger_num_msg && acc->acd.num_curmsg >= acc->acd.attr.trigger_num_msg)
+	unsigned cur = atomic_add_value(&acc->acd.num_curmsg, 1) + 1;
+
+	if (acc->acd.attr.trigger_num_msg && cur >= acc->acd.attr.trigger_num_msg)
 	{
 		return MsgSendAsync(coid);
 	}
 
 	/* if this is the first message, trigger & tick the ttimer */
-	if (acc->flags & _ASYNCMSG_CONNECT_TIMEROFF) {
+	if (atomic_clr_value(&acc->flags, _ASYNCMSG_CONNECT_TIMEROFF) & _ASYNCMSG_CONNECT_TIMEROFF) {
 		TimerSettime(acc->acd.ttimer, 0, &acc->acd.attr.trigger_time, NULL);
-		acc->flags &= ~_ASYNCMSG_CONNECT_TIMEROFF;
 	}
 	return 0;
 }
 
+/* Only one thread puts on this connection, so nobody else moves
+ * sendq_tail. The event thread only moves sendq_free, and the kernel
+ * only reads up to sendq_tail, so the header can be filled in without
+ * the mutex, as long as it is visible before the new tail is.
+ */
+static int _asyncmsg_putv_sp(int coid, struct _asyncmsg_connect_context *acc, const iov_t* iov, int parts, unsigned handle, int (*call_back)(int err, void* buf, unsigned handle))
+{
+	struct _asyncmsg_connection_descriptor *acd = &acc->acd;
+	struct _asyncmsg_put_header *aph;
+	unsigned new_tail;
+
+	new_tail = acd->sendq_tail + 1;
+	if (new_tail >= acd->sendq_size)
+	  new_tail = 0;
+
+	if (new_tail == *(volatile unsigned *)&acd->sendq_free) {
+		/* put list is full */
+		if (acd->flags & _NTO_COF_NONBLOCK) {
+			errno = EAGAIN;
+			return -1;
+		}
+		_mutex_lock(&acd->mu);
+		while (new_tail == acd->sendq_free) {
+			pthread_cond_wait(&acd->block_con, &acd->mu);
+		}
+		_mutex_unlock(&acd->mu);
+	}
+
+	aph = &acd->sendq[acd->sendq_tail];
+	aph->err = 0;
+	aph->iov = (iov_t *)iov;
+	aph->parts = parts;
+	aph->handle = handle;
+	aph->cb = call_back;
+	__cpu_membarrier();
+	*(volatile unsigned *)&acd->sendq_tail = new_tail;
+
+	return _asyncmsg_put_trigger(coid, acc);
+}
+
 int asyncmsg_putv(int coid, const iov_t* iov, int parts, unsigned handle, int (*call_back)(int err, void* buf, unsigned handle))
 {
 	struct _asyncmsg_connect_context *acc;
@@ -48,6 +90,8 @@ int asyncmsg_putv(int coid, const iov_t* iov, int parts, unsigned handle, int (*
 	
 	if ((acc = _asyncmsg_handle(coid, _ASYNCMSG_HANDLE_LOOKUP, 0)) == NULL)
 	  return -1;
+	if (acc->flags & _ASYNCMSG_CONNECT_SPRODUCER)
+	  return _asyncmsg_putv_sp(coid, acc, iov, parts, handle, call_back);
 	acd = &acc->acd;
 	
 	_mutex_lock(&acd->mu);
@@ -0,0 +1,317 @@
+/*
+ * $QNXLicenseC:
+ * Copyright 2007, QNX Software Systems. All Rights Reserved.
+ * 
+ * You must obtain a written license from and pay applicable license fees to QNX 
+ * Software Systems before you may reproduce, modify or distribute this software, 
+ * or any work that includes all or part of this software.   Free development 
+ * licenses are available for evaluation and non-commercial purposes.  For more 
+ * information visit http://licensing.qnx.com or email licensing@qnx.com.
+ *  
+ * This file may contain contributions from others.  Please review this entire 
+ * file for other proprietary rights or license notices, as well as the QNX 
+ * Development Suite License Guide at http://licensing.qnx.com/license-guide/ 
+ * for other information.
+ * $
+ */
+/*
+ * The lazy DFA.  This file is #included by regexec.c, after the two
+ * copies of engine.h, and uses the large-representation step().
+ *
+ * A DFA state is a set of NFA states (large representation) plus the
+ * kind of character that led to it, since that decides whether there's
+ * a BOL or word boundary before the next one.  dfafast() does exactly
+ * what fast() does, including leaving the same coldp behind for slow(),
+ * but each (state, character class) pair goes through step() only once
+ * until the arena is flushed.
+ */
+
+#define	DFA_HASH	256		/* hash chains, power of 2 */
+#define	DFA_GAIN	8		/* give up if the arena fills up in fewer
+					   characters than this per transition */
+
+#define	DFA_NO		1		/* acc[]: no match after this class */
+#define	DFA_YES		2		/* acc[]: a match ends here */
+
+struct dstate {
+	struct dstate *next;		/* hash chain */
+	unsigned hash;
+	uch kind;			/* DFA_K* of the character before */
+	uch fresh;			/* same NFA states as a fresh start */
+	uch *acc;			/* -> uch[nclass], 0 if not known yet */
+	struct dstate **to;		/* -> [nclass], NULL if not known yet */
+	char *set;			/* -> char[nstates] */
+};
+
+#define	DFA_ALIGN(n)	(((n) + sizeof(void *) - 1) & ~(sizeof(void *) - 1))
+
+/*
+ - dfasetup - get the arena and the fresh start states
+ */
+static int			/* 0 success, -1 can't use the DFA */
+dfasetup(g, d)
+register struct re_guts *g;
+register struct re_dfa *d;
+{
+	register size_t n = g->nstates;
+	register size_t extra;
+
+	d->ssize = DFA_ALIGN(sizeof(struct dstate) +
+			d->nclass * sizeof(struct dstate *)) +
+			DFA_ALIGN(d->nclass + n);
+	extra = DFA_HASH * sizeof(struct dstate *) + 3*n;
+	d->asize = d->ssize * DFA_MINSTATES;
+	if (d->asize > DFA_ARENA || (d->arena = malloc(extra)) == NULL) {
+		d->failed = 1;
+		return(-1);
+	}
+	if ((d->space = malloc(d->asize)) == NULL) {
+		free(d->arena);
+		d->arena = NULL;
+		d->failed = 1;
+		return(-1);
+	}
+	d->hash = (struct dstate **)d->arena;
+	d->fresh = d->arena + DFA_HASH * sizeof(struct dstate *);
+	d->work = d->fresh + n;
+
+	memset(d->fresh, 0, n);
+	d->fresh[g->firststate+1] = 1;
+	(void) lstep(g, g->firststate+1, g->laststate, d->fresh, NOTHING,
+								d->fresh);
+	return(0);
+}
+
+/*
+ - dfagrow - double the room for states, up to DFA_ARENA
+ *
+ * Only done just before a flush, so nothing in the old states is kept.
+ */
+static int			/* 0 success, -1 already as big as it gets */
+dfagrow(d)
+register struct re_dfa *d;
+{
+	register size_t n = d->asize * 2;
+	register char *p;
+
+	if (d->asize >= DFA_ARENA)
+		return(-1);
+	if (n > DFA_ARENA)
+		n = DFA_ARENA;
+	if ((p = malloc(n)) == NULL)
+		return(-1);
+	free(d->space);
+	d->space = p;
+	d->asize = n;
+	return(0);
+}
+
+/*
+ - dfaflush - throw away all the states
+ */
+static void
+dfaflush(g, d)
+register struct re_guts *g;
+register struct re_dfa *d;
+{
+	memset(d->hash, 0, DFA_HASH * sizeof(struct dstate *));
+	memset(d->start, 0, sizeof(d->start));
+	d->free = d->space;
+}
+
+/*
+ - dfastate - find or make the state for a set of NFA states
+ */
+static struct dstate *		/* NULL if the arena is full */
+dfastate(g, d, set, kind)
+register struct re_guts *g;
+register struct re_dfa *d;
+char *set;
+int kind;
+{
+	register struct dstate *s;
+	register size_t n = g->nstates;
+	register unsigned h = kind;
+	register size_t i;
+
+	for (i = 0; i < n; i++)
+		h = h * 33 + set[i];
+	for (s = d->hash[h & (DFA_HASH-1)]; s != NULL; s = s->next)
+		if (s->hash == h && s->kind == kind &&
+				memcmp(s->set, set, n) == 0)
+			return(s);
+
+	if (d->free + d->ssize > d->space + d->asize)
+		return(NULL);
+	s = (struct dstate *)d->free;
+	d->free += d->ssize;
+	memset(s, 0, d->ssize);
+	s->to = (struct dstate **)(s + 1);
+	s->acc = (uch *)((char *)s + DFA_ALIGN(sizeof(struct dstate) +
+				d->nclass * sizeof(struct dstate *)));
+	s->set = (char *)s->acc + d->nclass;
+	memcpy(s->set, set, n);
+	s->kind = kind;
+	s->fresh = (memcmp(set, d->fresh, n) == 0);
+	s->hash = h;
+	s->next = d->hash[h & (DFA_HASH-1)];
+	d->hash[h & (DFA_HASH-1)] = s;
+	return(s);
+}
+
+/*
+ - dfanext - work out what character class k does in state s
+ *
+ * This is the body of the loop in fast(), done on a copy of s's states.
+ * Sets s->acc[k] and, except at the end of the string, s->to[k].  If the
+ * arena has to be flushed (and grown, if it can be), s is gone and the
+ * next state (via *sp) is all that's left.
+ */
+static int			/* 0 success, 1 flushed, -1 give up on the DFA */
+dfanext(g, d, sp, k, acc, noflush)
+register struct re_guts *g;
+register struct re_dfa *d;
+struct dstate **sp;
+int k;
+int *acc;
+int noflush;
+{
+	register struct dstate *s = *sp;
+	register struct dstate *t;
+	register char *st = d->work;
+	register char *tmp = d->work + g->nstates;
+	const sopno gf = g->firststate+1;
+	const sopno gl = g->laststate;
+	register int flagch = '\0';
+	register int i = 0;
+	int end = (k >= d->nclass - 2);
+	int lword = (s->kind == DFA_KWORD);
+	int cword = (!end && d->kind[k] == DFA_KWORD);
+	int ceol;
+
+	memcpy(st, s->set, g->nstates);
+
+	/* is there an EOL and/or BOL between the last character and this? */
+	if (s->kind == DFA_KBOL) {
+		flagch = BOL;
+		i = g->nbol;
+	}
+	ceol = end ? (k == d->nclass - 2) : (d->kind[k] == DFA_KBOL);
+	if (ceol) {
+		flagch = (flagch == BOL) ? BOLEOL : EOL;
+		i += g->neol;
+	}
+	for (; i > 0; i--)
+		(void) lstep(g, gf, gl, st, flagch, st);
+
+	/* how about a word boundary? */
+	if ( (flagch == BOL || s->kind == DFA_KOTHER) && cword )
+		flagch = BOW;
+	if ( lword && (flagch == EOL || (!end && !cword)) )
+		flagch = EOW;
+	if (flagch == BOW || flagch == EOW)
+		(void) lstep(g, gf, gl, st, flagch, st);
+
+	*acc = s->acc[k] = st[gl] ? DFA_YES : DFA_NO;
+	if (end)
+		return(0);
+
+	/* and the character itself */
+	memcpy(tmp, st, g->nstates);
+	memcpy(st, d->fresh, g->nstates);
+	(void) lstep(g, gf, gl, tmp, d->rep[k], st);
+	if ((t = dfastate(g, d, st, d->kind[k])) == NULL) {
+		if (dfagrow(d) != 0 && noflush)
+			return(-1);
+		dfaflush(g, d);
+		*sp = dfastate(g, d, st, d->kind[k]);
+		return(1);
+	}
+	s->to[k] = t;
+	*sp = t;
+	return(0);
+}
+
+/*
+ - dfafast - fast() using the DFA
+ */
+static int			/* 1 match, 0 none, -1 use fast() instead */
+dfafast(g, start, stop, beginp, endp, eflags, endpp, coldpp)
+register struct re_guts *g;
+char *start;
+char *stop;
+char *beginp;
+char *endp;
+int eflags;
+char **endpp;
+char **coldpp;
+{
+	register struct re_dfa *d = g->dfa;
+	struct dstate *s;
+	register char *p = start;
+	register int k;
+	register char *coldp = NULL;
+	char *flushp = start;
+	int kind;
+	int acc;
+	int built = 0;		/* transitions worked out since flushp */
+	int ret = -1;
+	int r;
+
+	if (d->failed || pthread_mutex_trylock(&d->lock) != EOK)
+		return(-1);
+	if (d->arena == NULL) {
+		if (dfasetup(g, d) != 0)
+			goto out;
+		dfaflush(g, d);
+	}
+
+	if (start == beginp)
+		kind = (eflags&REG_NOTBOL) ? DFA_KNONE : DFA_KBOL;
+	else
+		kind = d->kind[d->cls[(uch)*(start-1)]];
+	if ((s = d->start[kind]) == NULL) {
+		if ((s = dfastate(g, d, d->fresh, kind)) == NULL) {
+			dfaflush(g, d);
+			s = dfastate(g, d, d->fresh, kind);
+		}
+		d->start[kind] = s;
+	}
+
+	for (;;) {
+		if (s->fresh)
+			coldp = p;
+		if (p == endp)
+			k = d->nclass - ((eflags&REG_NOTEOL) ? 1 : 2);
+		else
+			k = d->cls[(uch)*p];
+		if ((acc = s->acc[k]) == 0 || (p != stop && s->to[k] == NULL)) {
+			/* not been this way before */
+			r = dfanext(g, d, &s, k, &acc,
+					(p - flushp) < DFA_GAIN * built);
+			if (r < 0)
+				goto out;	/* thrashing, fast() will do */
+			if (r > 0) {
+				flushp = p;
+				built = 0;
+			}
+			built++;
+			if (acc == DFA_YES || p == stop)
+				break;
+		} else {
+			if (acc == DFA_YES || p == stop)
+				break;
+			s = s->to[k];
+		}
+		p++;
+	}
+
+	*coldpp = coldp;
+	*endpp = (acc == DFA_YES) ? p+1 : NULL;
+	ret = (acc == DFA_YES);
+out:
+	pthread_mutex_unlock(&d->lock);
+	return(ret);
+}
+
+/* __SRCVERSION("dfa.h $Rev: 153052 $"); */
@@ -92,7 +92,7 @@ size_t nmatch;
 regmatch_t pmatch[];
 int eflags;
 {
-	register char *endp;
+	char *endp;
 	register int i;
 	struct match mv;
 	register struct match *m = &mv;
@@ -142,7 +142,9 @@ int eflags;
 
 	/* this loop does only one repetition except for backrefs */
 	for (;;) {
-		endp = fast(m, start, stop, gf, gl);
+		if (g->dfa == NULL || dfafast(g, start, stop, m->beginp,
+				m->endp, m->eflags, &endp, &m->coldp) < 0)
+			endp = fast(m, start, stop, gf, gl);
 		if (endp == NULL) {		/* a miss */
 			STATETEARDOWN(m);
 			return(REG_NOMATCH);
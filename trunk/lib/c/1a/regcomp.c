@@ -28,6 +28,7 @@ to the following restrictions:
 #include <limits.h>
 #include <stdlib.h>
 #include <regex.h>
+#include <pthread.h>
 
 #include "utils.h"
 #include "regex2.h"
@@ -178,6 +179,7 @@ int cflags;
 	g->categories = &g->catspace[-(CHAR_MIN)];
 	(void) memset((char *)g->catspace, 0, NC*sizeof(cat_t));
 	g->backrefs = 0;
+	g->dfa = NULL;
 
 	/* do it */
 	EMIT(OEND, 0);
@@ -196,6 +198,7 @@ int cflags;
 	stripsnug(p, g);
 	findmust(p, g);
 	g->nplus = pluscount(p, g);
+	mkdfa(p, g);
 	g->magic = MAGIC2;
 	preg->re_nsub = g->nsub;
 	preg->re_g = g;
@@ -1635,4 +1638,51 @@ register struct re_guts *g;
 	return(maxnest);
 }
 
+/*
+ - mkdfa - set up for the lazy DFA, if the expression can use it
+ == static void mkdfa(register struct parse *p, register struct re_guts *g);
+ *
+ * Characters go into classes the DFA can't tell apart:  same category,
+ * and the same as far as word and line boundaries are concerned.  The
+ * states themselves are only built, as needed, by regexec().
+ */
+static void
+mkdfa(p, g)
+register struct parse *p;
+register struct re_guts *g;
+{
+	register struct re_dfa *d;
+	register int c;
+	register int key;
+	register int i;
+	short map[NC*4];
+
+	if (p->error != 0 || g->backrefs || g->ncategories > NC)
+		return;
+	d = (struct re_dfa *)calloc(1, sizeof(struct re_dfa));
+	if (d == NULL)
+		return;		/* not fatal, regexec() does without */
+
+	for (i = 0; i < NC*4; i++)
+		map[i] = -1;
+	for (c = CHAR_MIN; c <= CHAR_MAX; c++) {
+		key = g->categories[c] * 4;
+		if (ISWORD(c))
+			key += DFA_KWORD;
+		else if (c == '\n' && (g->cflags&REG_NEWLINE))
+			key += DFA_KBOL;
+		if (map[key] < 0) {
+			map[key] = d->nclass;
+			d->rep[d->nclass] = c;
+			d->kind[d->nclass] = key & 3;
+			d->nclass++;
+		}
+		d->cls[(uch)c] = map[key];
+	}
+	d->kind[d->nclass++] = DFA_KNONE;	/* end of string */
+	d->kind[d->nclass++] = DFA_KNONE;	/* end of string, REG_NOTEOL */
+	pthread_mutex_init(&d->lock, NULL);
+	g->dfa = d;
+}
+
 __SRCVERSION("regcomp.c $Rev: 153052 $");
@@ -148,10 +148,46 @@ struct re_guts {
 	size_t nsub;		/* copy of re_nsub */
 	int backrefs;		/* does it use back references? */
 	sopno nplus;		/* how deep does it nest +s? */
+	struct re_dfa *dfa;	/* lazy DFA for fast(), NULL if not usable */
 	/* catspace must be last */
 	cat_t catspace[1];	/* actually [NC] */
 };
 
+/*
+ * Lazily built DFA used in place of fast() for expressions without
+ * back references.  Only the transitions actually taken are built, in an
+ * arena which is thrown away and restarted when it fills up.  The arena
+ * starts out with room for a few states and doubles, up to DFA_ARENA,
+ * each time it fills, so small expressions stay small.
+ * The states themselves are private to regexec.c (dfa.h).  regexec() may
+ * be called on the same regex_t from several threads at once; a thread
+ * that can't get the lock just uses the old engine.
+ */
+#define	DFA_ARENA	(128*1024)	/* most bytes of states per expression */
+#define	DFA_MINSTATES	16		/* states in the first arena */
+#define	DFA_KOTHER	0		/* previous character: anything else */
+#define	DFA_KWORD	1		/* a word character */
+#define	DFA_KBOL	2		/* start of line */
+#define	DFA_KNONE	3		/* start of string, REG_NOTBOL */
+
+struct re_dfa {
+	pthread_mutex_t lock;
+	char *arena;		/* hash, fresh and work; malloced on first use */
+	char *space;		/* -> char[asize], the arena the states go in */
+	char *free;		/* first unused byte of space */
+	size_t asize;		/* bytes of space, DFA_ARENA at most */
+	char *fresh;		/* -> char[nstates], states for a fresh start */
+	char *work;		/* -> char[2*nstates], scratch */
+	struct dstate **hash;	/* -> [DFA_HASH] */
+	struct dstate *start[4];	/* initial state by kind, NULL if not built */
+	size_t ssize;		/* bytes per state */
+	int nclass;		/* input classes, plus two for end of string */
+	int failed;		/* arena couldn't be set up, don't try again */
+	uch cls[NC];		/* character to class */
+	uch kind[NC+2];		/* class to kind (DFA_K*) */
+	int rep[NC];		/* a character of each class */
+};
+
 /* misc utilities */
 #define	OUT	(CHAR_MAX+1)	/* a non-character value */
 #define	ISWORD(c)	(isalnum(c) || (c) == '_')
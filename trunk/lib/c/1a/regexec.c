@@ -26,6 +26,8 @@ to the following restrictions:
  * This file includes engine.c *twice*, after muchos fiddling with the
  * macros that code uses.  This lets the same code operate on two different
  * representations for state sets.
+ * The lazy DFA in dfa.h, included last, sits in front of both and uses
+ * the large one's step().
  */
 #include <sys/types.h>
 #include <stdio.h>
@@ -34,10 +36,14 @@ to the following restrictions:
 #include <limits.h>
 #include <ctype.h>
 #include <regex.h>
+#include <errno.h>
+#include <pthread.h>
 
 #include "utils.h"
 #include "regex2.h"
 
+static int dfafast(struct re_guts *g, char *start, char *stop, char *beginp, char *endp, int eflags, char **endpp, char **coldpp);
+
 //static int nope = 0;		/* for use in asserts; shuts lint up */
 
 /* macros for manipulating states, small version */
@@ -116,6 +122,8 @@ to the following restrictions:
 
 #include "engine.h"
 
+#include "dfa.h"
+
 /*
  - regexec - interface for matching
  = extern int regexec(const regex_t *, const char *, size_t, \
@@ -23,7 +23,9 @@ to the following restrictions:
 #include <sys/types.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <limits.h>
 #include <regex.h>
+#include <pthread.h>
 
 #include "utils.h"
 #include "regex2.h"
@@ -55,6 +57,14 @@ regex_t *preg;
 		free((char *)g->setbits);
 	if (g->must != NULL)
 		free(g->must);
+	if (g->dfa != NULL) {
+		pthread_mutex_destroy(&g->dfa->lock);
+		if (g->dfa->arena != NULL) {
+			free(g->dfa->space);
+			free(g->dfa->arena);
+		}
+		free((char *)g->dfa);
+	}
 	free((char *)g);
 }
 
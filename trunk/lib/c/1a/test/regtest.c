@@ -0,0 +1,264 @@
+/*
+ * regtest - check the lazy DFA (dfa.h) against the engine it stands in for
+ *
+ * Each expression is compiled twice, and one copy has its DFA marked as
+ * failed, so regexec() on it goes through fast() exactly as it did before
+ * the DFA.  Both copies must give the same answer and the same matches.
+ *
+ *	regtest [-n count] [-s seed]
+ *		random expressions and strings, compared as above
+ *	regtest -b corpus [-n passes]
+ *		time the expressions in pats[] over each line of the
+ *		corpus (e.g. corpus.txt here), with and without the DFA
+ *
+ * This isn't built with the library.  It needs the private headers, so
+ * build it from this directory with something like
+ *
+ *	qcc -I.. -o regtest regtest.c
+ */
+#include <sys/types.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <unistd.h>
+#include <time.h>
+#include <regex.h>
+#include <pthread.h>
+
+#include "utils.h"
+#include "regex2.h"
+
+static const char *atoms[] = {
+	"a", "b", "c", "x", "_", "\n", " ", ".", "[ab]", "[^a\n]",
+	"[[:alpha:]]", "[[:space:]]", "[0-9]", "A", "^", "$", "\\<", "\\>",
+};
+#define	NATOMS	(int)(sizeof(atoms) / sizeof(atoms[0]))
+
+static const char alpha[] = "abcxA_ \n19.";
+
+/* expressions for -b, the sort of thing grep and awk scripts ask for */
+static const char *pats[] = {
+	"error",
+	"[0-9]+\\.[0-9]+\\.[0-9]+\\.[0-9]+",
+	"^[A-Z][a-z]+ +[0-9]+ [0-9:]+",
+	"(warning|error|fatal):",
+	"[a-z_]+\\([^)]*\\)",
+	"\\<(int|char|long|void)\\>[ \t]+\\*?[a-z_]+",
+	"[[:alpha:]]+[[:digit:]]+[[:alpha:]]*$",
+	"x.*y.*z",
+	"no such thing anywhere",
+};
+#define	NPATS	(int)(sizeof(pats) / sizeof(pats[0]))
+
+static double
+now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return(ts.tv_sec + ts.tv_nsec / 1e9);
+}
+
+/*
+ - nodfa - make regexec() do without the DFA for this expression
+ */
+static void
+nodfa(regex_t *re)
+{
+	struct re_guts *g = (struct re_guts *)re->re_g;
+
+	if (g->dfa != NULL)
+		g->dfa->failed = 1;
+}
+
+/*
+ - gen - append a random expression to o
+ */
+static void
+gen(char *o, int depth, int ere)
+{
+	int n = 1 + rand() % 4;
+	int r;
+
+	while (n-- > 0) {
+		if (depth < 3 && rand() % 10 == 0) {
+			strcat(o, ere ? "(" : "\\(");
+			gen(o, depth + 1, ere);
+			if (ere && rand() % 2) {
+				strcat(o, "|");
+				gen(o, depth + 1, ere);
+			}
+			strcat(o, ere ? ")" : "\\)");
+		} else
+			strcat(o, atoms[rand() % NATOMS]);
+		r = rand() % 6;
+		if (r == 0)
+			strcat(o, "*");
+		else if (ere && r == 1)
+			strcat(o, "+");
+		else if (ere && r == 2)
+			strcat(o, "?");
+		else if (ere && r == 3)
+			strcat(o, "{1,3}");
+	}
+}
+
+/*
+ - differ - compare the two engines on random input
+ */
+static int			/* number of mismatches */
+differ(int count)
+{
+	static char str[4096];
+	char pat[512];
+	regex_t a, b;
+	regmatch_t ma[10], mb[10];
+	int bad = 0;
+	int i, k, len, cflags, eflags, ra, rb;
+	size_t nmatch;
+
+	for (i = 0; i < count; i++) {
+		int ere = rand() % 2;
+
+		cflags = ere ? REG_EXTENDED : 0;
+		if (rand() % 3 == 0)
+			cflags |= REG_NEWLINE;
+		if (rand() % 4 == 0)
+			cflags |= REG_ICASE;
+		if (rand() % 5 == 0)
+			cflags |= REG_NOSUB;
+		pat[0] = '\0';
+		gen(pat, 0, ere);
+
+		ra = regcomp(&a, pat, cflags);
+		rb = regcomp(&b, pat, cflags);
+		if (ra != rb) {
+			printf("regcomp /%s/ 0%o: %d vs %d\n", pat, cflags, ra, rb);
+			bad++;
+		}
+		if (ra != 0 || rb != 0) {
+			if (ra == 0)
+				regfree(&a);
+			if (rb == 0)
+				regfree(&b);
+			continue;
+		}
+		nodfa(&b);
+
+		/* a few strings each, so the DFA gets to reuse its states */
+		for (k = 0; k < 8; k++) {
+			/* and now and then a long one, to fill the arena */
+			len = (rand() % 16 == 0) ? rand() % (sizeof(str) - 1)
+								: rand() % 60;
+			str[len] = '\0';
+			while (len-- > 0)
+				str[len] = alpha[rand() % (sizeof(alpha) - 1)];
+			nmatch = k & 1;
+			eflags = rand() % 4 & (REG_NOTBOL|REG_NOTEOL);
+
+			memset(ma, 0x55, sizeof(ma));
+			memset(mb, 0x55, sizeof(mb));
+			ra = regexec(&a, str, nmatch, ma, eflags);
+			rb = regexec(&b, str, nmatch, mb, eflags);
+			if (ra != rb || (ra == 0 && memcmp(ma, mb, sizeof(ma)) != 0)) {
+				if (++bad <= 20)
+					printf("regexec /%s/ 0%o 0%o [%s]: "
+						"%d (%d,%d) vs %d (%d,%d)\n",
+						pat, cflags, eflags, str,
+						ra, (int)ma[0].rm_so, (int)ma[0].rm_eo,
+						rb, (int)mb[0].rm_so, (int)mb[0].rm_eo);
+			}
+		}
+		regfree(&a);
+		regfree(&b);
+	}
+	printf("%d expressions, %d mismatches\n", count, bad);
+	return(bad);
+}
+
+/*
+ - bench - time pats[] over the lines of a file, with and without the DFA
+ */
+static int
+bench(const char *file, int passes)
+{
+	FILE *fp;
+	char **lines = NULL;
+	char buf[1024];
+	int nlines = 0;
+	int p, pass, l, mode, hits[2];
+	double t[2], start;
+	regex_t re;
+
+	if ((fp = fopen(file, "r")) == NULL) {
+		perror(file);
+		return(1);
+	}
+	while (fgets(buf, sizeof(buf), fp) != NULL) {
+		buf[strcspn(buf, "\n")] = '\0';
+		if ((lines = realloc(lines, (nlines + 1) * sizeof(*lines))) == NULL ||
+				(lines[nlines++] = strdup(buf)) == NULL) {
+			fprintf(stderr, "regtest: out of memory\n");
+			return(1);
+		}
+	}
+	fclose(fp);
+
+	printf("%d lines, %d passes\n", nlines, passes);
+	for (p = 0; p < NPATS; p++) {
+		for (mode = 0; mode < 2; mode++) {
+			if (regcomp(&re, pats[p], REG_EXTENDED|REG_NOSUB) != 0) {
+				fprintf(stderr, "regtest: can't compile /%s/\n", pats[p]);
+				return(1);
+			}
+			if (mode == 1)
+				nodfa(&re);
+			hits[mode] = 0;
+			start = now();
+			for (pass = 0; pass < passes; pass++)
+				for (l = 0; l < nlines; l++)
+					if (regexec(&re, lines[l], 0, NULL, 0) == 0)
+						hits[mode]++;
+			t[mode] = now() - start;
+			regfree(&re);
+		}
+		printf("%8.3f ms dfa %8.3f ms fast() %6.2fx  %s/%s/\n",
+			t[0] * 1000 / passes, t[1] * 1000 / passes,
+			t[0] > 0 ? t[1] / t[0] : 0.0,
+			hits[0] == hits[1] ? "" : "MISMATCH ", pats[p]);
+	}
+	while (nlines > 0)
+		free(lines[--nlines]);
+	free(lines);
+	return(0);
+}
+
+int
+main(int argc, char *argv[])
+{
+	char *corpus = NULL;
+	int count = -1;
+	int c;
+
+	srand(1);
+	while ((c = getopt(argc, argv, "b:n:s:")) != -1) {
+		switch (c) {
+		case 'b':
+			corpus = optarg;
+			break;
+		case 'n':
+			count = atoi(optarg);
+			break;
+		case 's':
+			srand(atoi(optarg));
+			break;
+		default:
+			fprintf(stderr, "use: regtest [-n count] [-s seed] [-b corpus]\n");
+			return(EXIT_FAILURE);
+		}
+	}
+	if (corpus != NULL)
+		return(bench(corpus, count > 0 ? count : 20) ? EXIT_FAILURE : EXIT_SUCCESS);
+	return(differ(count > 0 ? count : 20000) ? EXIT_FAILURE : EXIT_SUCCESS);
+}
@@ -19,19 +19,26 @@
 
 #include <errno.h>
 #include <fcntl.h>
+#include <limits.h>
 #include <pthread.h>
 #include <share.h>
 #include <semaphore.h>
 #include <stdlib.h>
+#include <devctl.h>
+#include <sys/dcmd_misc.h>
 #include <sys/iomsg.h>
+#include <sys/mman.h>
+#include <sys/neutrino.h>
+#include <sys/netmgr.h>
 #include <sys/stat.h>
 
 struct nsem {
-	sem_t			object;
-	int				refcnt;
-	dev_t			dev;
-	ino_t			ino;
-	struct nsem		*link;
+	sem_t				object;
+	int					refcnt;
+	dev_t				dev;
+	ino_t				ino;
+	struct nsem			*link;
+	struct _sem_shared	*shared;
 };
 
 static struct {
@@ -56,17 +63,37 @@ int				fd;
 	return(-1);
 }
 
+/*
+ *  Map the shared count of a semaphore served by the local procnto.  If
+ *  that isn't possible all operations are messages to the server.
+ */
+static struct _sem_shared *semshared(int fd)
+{
+struct _server_info	info;
+void				*addr;
+
+	if (ConnectServerInfo(0, fd, &info) != fd || info.nd != ND_LOCAL_NODE || info.pid != SYSMGR_PID)
+		return(NULL);
+	if ((addr = mmap(NULL, sizeof(struct _sem_shared), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)) == MAP_FAILED)
+		return(NULL);
+	return((struct _sem_shared *)addr);
+}
+
 sem_t *_nsem_open(const char *name, int oflag, mode_t mode, unsigned value)
 {
 struct nsem		*sem, *n;
 
 	if ((sem = malloc(sizeof(struct nsem))) != NULL) {
 		if ((sem->object.__count = semfd(name, oflag, mode, value, &sem->dev, &sem->ino)) != -1) {
+			// Map (and talk to the server) before taking the list lock
+			sem->shared = semshared(sem->object.__count);
 			_mutex_lock(&_semctrl.mutex);
 			for (n = _semctrl.nsems; n != NULL; n = n->link) {
 				if (n->dev == sem->dev && n->ino == sem->ino) {
 					++n->refcnt;
 					_mutex_unlock(&_semctrl.mutex);
+					if (sem->shared != NULL)
+						munmap(sem->shared, sizeof(struct _sem_shared));
 					close(sem->object.__count);
 					free(sem);
 					return(&n->object);
@@ -95,6 +122,8 @@ struct nsem		**n, *sem;
 	for (n = &_semctrl.nsems; (sem = *n) != NULL; n = &sem->link) {
 		if (ptr == &sem->object) {
 			if (!--sem->refcnt) {
+				if (sem->shared != NULL)
+					munmap(sem->shared, sizeof(struct _sem_shared));
 				close(sem->object.__count);
 				sem->object.__count = -1;
 				*n = sem->link;
@@ -109,4 +138,61 @@ struct nsem		**n, *sem;
 	return(-1);
 }
 
+/*
+ *  Take a token without talking to the server.  Returns 1 if one was
+ *  taken, 0 if there are none, -1 if the count isn't shared or there
+ *  are clients blocked at the server (the caller has to send the request
+ *  to the server, so that it queues behind them).
+ */
+int _nsem_take(sem_t *ptr)
+{
+struct _sem_shared	*shared;
+unsigned			v;
+
+	if ((shared = ((struct nsem *)ptr)->shared) == NULL || shared->waiters != 0)
+		return(-1);
+	while ((v = shared->value) != 0) {
+		if (_smp_cmpxchg(&shared->value, v, v - 1) == v)
+			return(1);
+	}
+	return(0);
+}
+
+/*
+ *  Give a token without talking to the server, unless there are clients
+ *  blocked there.  Returns 0 or -1 (errno) when done, 1 if the count
+ *  isn't shared.
+ */
+int _nsem_give(sem_t *ptr)
+{
+struct _sem_shared	*shared;
+unsigned			v;
+
+	if ((shared = ((struct nsem *)ptr)->shared) == NULL)
+		return(1);
+	do {
+		if ((v = shared->value) >= SEM_VALUE_MAX) {
+			errno = EAGAIN;
+			return(-1);
+		}
+	} while (_smp_cmpxchg(&shared->value, v, v + 1) != v);
+	if (shared->waiters != 0 && _devctl(ptr->__count, DCMD_MISC_SEMPOST, NULL, 0, 0) == -1)
+		return(-1);
+	return(0);
+}
+
+/*
+ *  Read the count without talking to the server.  Returns 0, or -1 if
+ *  the count isn't shared.
+ */
+int _nsem_value(sem_t *ptr, int *value)
+{
+struct _sem_shared	*shared;
+
+	if ((shared = ((struct nsem *)ptr)->shared) == NULL)
+		return(-1);
+	*value = shared->value;
+	return(0);
+}
+
 __SRCVERSION("__named_sem.c $Rev: 153052 $");
@@ -24,11 +24,14 @@
 #include <atomic.h>
 #include <errno.h>
 #include <fcntl.h>
+#include <limits.h>
 #include <malloc.h>
 #include <sched.h>
+#include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
 #include <sys/iomsg.h>
+#include <sys/neutrino.h>
 #include <aio_priv.h>
 
 struct _aio_control_block *_aio_cb = NULL;
@@ -39,8 +42,46 @@ struct _aio_context {
 	int                 policy;
 	struct sched_param  param;
 	pthread_t           tid;
+	struct _aio_context *hnext;		/* on ct_fdhash while curr_list is set */
+	int                 fd;
+	int                 pinned;
 };
 
+/* The following fd hash functions are called with cb_mutex held */
+static struct _aio_context *_aio_fd_owner(struct _aio_control_block *cbp, int fd)
+{
+	struct _aio_context *cp;
+
+	for (cp = cbp->ct_fdhash[_AIO_FD_HASHFN(fd)]; cp; cp = cp->hnext) {
+		if (cp->fd == fd)
+		  break;
+	}
+	return cp;
+}
+
+static void _aio_fd_own(struct _aio_control_block *cbp, struct _aio_context *ctp, int fd)
+{
+	struct _aio_context **cpp = &cbp->ct_fdhash[_AIO_FD_HASHFN(fd)];
+
+	ctp->fd = fd;
+	ctp->hnext = *cpp;
+	*cpp = ctp;
+}
+
+static void _aio_fd_release(struct _aio_control_block *cbp, struct _aio_context *ctp)
+{
+	struct _aio_context **cpp, *cp;
+
+	for (cpp = &cbp->ct_fdhash[_AIO_FD_HASHFN(ctp->fd)]; (cp = *cpp); cpp = &cp->hnext) {
+		if (cp == ctp) {
+			*cpp = cp->hnext;
+			break;
+		}
+	}
+	ctp->hnext = NULL;
+	ctp->fd = -1;
+}
+
 static int _aio_wakeup(struct aiocb *aiocbp) {
 	struct sigevent *ev = &aiocbp->aio_sigevent;
 	int flag, ret = EOK;
@@ -111,13 +152,21 @@ static struct _aio_context *_aio_block(struct _aio_context *ctp)
 	struct _aio_context *cp;
 	struct _aio_prio_list *plist;
 	struct aiocb *curr, *ap, **app;
-	int ret;
+	int ret, n;
 
 	if (!cbp->tp) {
 		errno = EINVAL;
 		return NULL;
 	}
 
+	if (!ctp->pinned) {
+		/* see AIO_CPUMASK in _aio_init() */
+		if (cbp->cb_runmask) {
+			(void)ThreadCtl(_NTO_TCTL_RUNMASK, (void *)cbp->cb_runmask);
+		}
+		ctp->pinned = 1;
+	}
+
 	_mutex_lock(&cbp->cb_mutex);
 	do {
 		while ((plist = cbp->cb_plist) == NULL) {
@@ -156,16 +205,25 @@ static struct _aio_context *_aio_block(struct _aio_context *ctp)
 		atomic_set(&curr->_aio_flag, _AIO_FLAG_IN_PROGRESS);
 		
 		/* check if another thread already handling this fd */
-		for (cp = _aio_cb->ct_list; cp; cp = cp->next) {
-			if (!cp->curr_list)
-			  continue;
-			if (cp->curr_list->aio_fildes == curr->aio_fildes)
-			  break;
-		}
-
-		if (!cp) {
-			/* if nobody handling this fd, we will do it */
+		if ((cp = _aio_fd_owner(cbp, curr->aio_fildes)) == NULL) {
+			/* if nobody handling this fd, we will do it, and take the
+			 * requests for it queued right behind this one as well so
+			 * that _aio_handler() can put them in one message.
+			 */
 			ctp->curr_list = curr;
+			_aio_fd_own(cbp, ctp, curr->aio_fildes);
+			app = &curr->_aio_next;
+			for (n = 1; n < _AIO_BATCH_MAX; n++) {
+				if ((ap = plist->head) == NULL || ap->aio_fildes != curr->aio_fildes)
+				  break;
+				if ((plist->head = ap->_aio_next) == NULL)
+				  plist->tail = &plist->head;
+				ap->_aio_next = NULL;
+				ap->_aio_plist = NULL;
+				atomic_set(&ap->_aio_flag, _AIO_FLAG_IN_PROGRESS);
+				*app = ap;
+				app = &ap->_aio_next;
+			}
 		} else {
 			/* another thread is handling this fd, insert at right priority */
 			for (app = &cp->curr_list, ap = *app; ap; app = &ap->_aio_next, ap = *app) {
@@ -194,89 +252,145 @@ static void _aio_unblock(struct _aio_context *ctp)
 
 static int _aio_handler(struct _aio_context *ctp)
 {
-	struct aiocb *curr;
+	struct aiocb *curr, *last, *ap, **app;
 	io_lseek_t	 lmsg;
 	union {
 		io_read_t   rmsg;
 		io_write_t  wmsg;
 	} msg;
-	iov_t iov[3];
-	int niov;
+	iov_t iov[2 + _AIO_BATCH_MAX];
+	int nreq, err;
+	unsigned result, left;
+	size_t nbytes;
 
 	if (!ctp)
 	  return -1;
 	
 	while ((curr = ctp->curr_list) != NULL) 
 	{
+		last = curr;
 		/* see if we need to change sched_param */
 		if (ctp->policy != curr->_aio_policy || memcmp(&ctp->param, &curr->_aio_param, sizeof(ctp->param)))
 		{
-			curr->_aio_error = pthread_setschedparam(ctp->tid, curr->_aio_policy, (struct sched_param *)&curr->_aio_param);
-			if (curr->_aio_error != EOK) {
-				curr->_aio_result = (unsigned)-1;
-				_aio_wakeup(curr);
-				continue;
+			if ((err = pthread_setschedparam(ctp->tid, curr->_aio_policy, (struct sched_param *)&curr->_aio_param)) != EOK) {
+				errno = err;
+				result = (unsigned)-1;
+				goto done;
 			}
 			ctp->policy = curr->_aio_policy;
 			memcpy(&ctp->param, &curr->_aio_param, sizeof ctp->param);
 		}
-		niov = 0;
+		result = 0;
 		switch (curr->_aio_iotype) {
 		  case _AIO_OPCODE_READ:
 		  case _AIO_OPCODE_WRITE:
+			/* Requests of the same kind and priority for the bytes of the
+			 * file right after this one go in the same message. Nothing
+			 * is ever inserted in the middle of a run of requests of the
+			 * same priority, so the run is still intact when it is taken
+			 * off the list below. The run stops short of INT_MAX bytes,
+			 * as that is all a single read or write can report back.
+			 */
+			SETIOV(iov + 2, curr->aio_buf, curr->aio_nbytes);
+			nbytes = curr->aio_nbytes;
+			nreq = 1;
+			_mutex_lock(&_aio_cb->cb_mutex);
+			for (ap = curr->_aio_next; ap && nreq < _AIO_BATCH_MAX; ap = ap->_aio_next) {
+				if (ap->_aio_iotype != curr->_aio_iotype ||
+					ap->_aio_policy != curr->_aio_policy ||
+					memcmp(&ap->_aio_param, &curr->_aio_param, sizeof(ap->_aio_param)) ||
+					ap->aio_offset != last->aio_offset + (off_t)last->aio_nbytes ||
+					nbytes > INT_MAX || ap->aio_nbytes > INT_MAX - nbytes)
+				  break;
+				SETIOV(iov + 2 + nreq, ap->aio_buf, ap->aio_nbytes);
+				nbytes += ap->aio_nbytes;
+				nreq++;
+				last = ap;
+			}
+			_mutex_unlock(&_aio_cb->cb_mutex);
+
 			/* creat a lseek + read/write combined message */
 			lmsg.i.type = _IO_LSEEK;
 			lmsg.i.combine_len = sizeof(lmsg) | _IO_COMBINE_FLAG;
 			lmsg.i.offset = curr->aio_offset;
 			lmsg.i.whence = SEEK_SET;
 			lmsg.i.zero = 0;
-			SETIOV(iov + niov, &lmsg, sizeof(lmsg));
-			niov++;
+			SETIOV(iov + 0, &lmsg, sizeof(lmsg));
 			
 			if (curr->_aio_iotype == _AIO_OPCODE_READ) {
 				msg.rmsg.i.type = _IO_READ;
 				msg.rmsg.i.combine_len = sizeof(msg.rmsg);
-				msg.rmsg.i.nbytes = curr->aio_nbytes;
+				msg.rmsg.i.nbytes = nbytes;
 				msg.rmsg.i.xtype = _IO_XTYPE_NONE;
 				msg.rmsg.i.zero = 0;
-				SETIOV(iov + niov, &msg, sizeof(msg.rmsg));
-				niov++;
-				curr->_aio_result = MsgSendvs(curr->aio_fildes, iov, niov,
-											  (void *)curr->aio_buf, curr->aio_nbytes);
+				SETIOV(iov + 1, &msg, sizeof(msg.rmsg));
+				result = MsgSendv(curr->aio_fildes, iov, 2, iov + 2, nreq);
 			} else {
 				msg.wmsg.i.type = _IO_WRITE;
 				msg.wmsg.i.combine_len = sizeof(msg.wmsg);
 				msg.wmsg.i.xtype = _IO_XTYPE_NONE;
-				msg.wmsg.i.nbytes = curr->aio_nbytes;
+				msg.wmsg.i.nbytes = nbytes;
 				msg.wmsg.i.zero = 0;
-				SETIOV(iov + niov, &msg, sizeof(msg.wmsg));
-				SETIOV(iov + niov + 1, curr->aio_buf, curr->aio_nbytes);
-				niov += 2;
-				curr->_aio_result = MsgSendv(curr->aio_fildes, iov, niov, 0, 0);
+				SETIOV(iov + 1, &msg, sizeof(msg.wmsg));
+				result = MsgSendv(curr->aio_fildes, iov, 2 + nreq, 0, 0);
+			}
+
+			/* On an error only the first request gets it; the rest are
+			 * tried again on their own. On a short transfer the ones that
+			 * got nothing are tried again.
+			 */
+			if (result == -1U) {
+				last = curr;
+			} else {
+				left = result;
+				for (ap = curr; ap != last; ap = ap->_aio_next) {
+					if (left <= ap->aio_nbytes) {
+						last = ap;
+						break;
+					}
+					left -= ap->aio_nbytes;
+				}
 			}
 			break;
 		  case _AIO_OPCODE_SYNC:
-			curr->_aio_result = fsync(curr->aio_fildes);
+			result = fsync(curr->aio_fildes);
 			break;
 		  case _AIO_OPCODE_DSYNC:
-			curr->_aio_result = fdatasync(curr->aio_fildes);
+			result = fdatasync(curr->aio_fildes);
 			break;
 		  default:
 			break;
 		}
-		
+
+done:
+		err = (result == -1U) ? errno : EOK;
+
+		/* take curr to last off our list */
 		_mutex_lock(&_aio_cb->cb_mutex);
-		ctp->curr_list = curr->_aio_next;
-		curr->_aio_next = NULL;
+		for (app = &ctp->curr_list; *app != curr; app = &(*app)->_aio_next) {
+			/* nothing to do */
+		}
+		*app = last->_aio_next;
+		last->_aio_next = NULL;
+		if (ctp->curr_list == NULL) {
+			_aio_fd_release(_aio_cb, ctp);
+		}
 		_mutex_unlock(&_aio_cb->cb_mutex);
 		
-		if (curr->_aio_result == -1U) {
-			curr->_aio_error = errno;
-		} else {
-			curr->_aio_error = EOK;
+		left = result;
+		while ((ap = curr) != NULL) {
+			curr = ap->_aio_next;
+			ap->_aio_next = NULL;
+			if (err != EOK) {
+				ap->_aio_result = (unsigned)-1;
+				ap->_aio_error = err;
+			} else {
+				ap->_aio_result = curr ? ap->aio_nbytes : left;
+				left -= ap->_aio_result;
+				ap->_aio_error = EOK;
+			}
+			_aio_wakeup(ap);
 		}
-
-		_aio_wakeup(curr);
 	}
 	return 0;
 }
@@ -309,6 +423,9 @@ static struct _aio_context *_aio_context_alloc(struct _aio_control_block *handle
 	ctp->tid = tid;
 	ctp->policy = policy;
 	ctp->param = param;
+	ctp->hnext = NULL;
+	ctp->fd = -1;
+	ctp->pinned = 0;
 
 	return ctp;
 }
@@ -329,6 +446,9 @@ static void _aio_context_free(struct _aio_context *ctp)
 	}
 	*ctpp = cp->next;
 	curr_list = cp->curr_list;
+	if (curr_list) {
+		_aio_fd_release(cbp, cp);
+	}
 	cp->next = cbp->ct_free;
 	cbp->ct_free = cp;
 	_mutex_unlock(&cbp->cb_mutex);
@@ -363,6 +483,7 @@ int _aio_init(thread_pool_attr_t *pool_attr)
 	struct _aio_context *ctp;
 	struct _aio_prio_list *plist;
 	sigset_t set, oset;
+	char *env;
 	int i;
 	  
 	_mutex_lock(&_aio_init_mutex);
@@ -381,6 +502,12 @@ int _aio_init(thread_pool_attr_t *pool_attr)
 	
 	if (pool_attr == NULL) {
 		pool_attr = &default_pool_attr;
+		/* AIO_WORKERS sets the most worker threads there will be */
+		if ((env = getenv("AIO_WORKERS")) != NULL && (i = strtol(env, NULL, 0)) > 0 && i <= USHRT_MAX) {
+			pool_attr->maximum = i;
+			pool_attr->hi_water = min(pool_attr->hi_water, i);
+			pool_attr->lo_water = min(pool_attr->lo_water, i);
+		}
 	} else {
 		pool_attr->block_func = _aio_block;
 		pool_attr->context_alloc = _aio_context_alloc;
@@ -390,6 +517,13 @@ int _aio_init(thread_pool_attr_t *pool_attr)
 	}
 	pool_attr->handle = (void *)cb;
 
+	/* AIO_CPUMASK keeps the workers, and so the I/O and the completion
+	 * notifications, on the given cpus.
+	 */
+	if ((env = getenv("AIO_CPUMASK")) != NULL) {
+		cb->cb_runmask = strtoul(env, NULL, 0);
+	}
+
 	/* prepare some priority list entries */
 	for (i = 0; i < _AIO_PRIO_LIST_LOW; i++) {
 		plist = (struct _aio_prio_list *)malloc(sizeof(*plist));
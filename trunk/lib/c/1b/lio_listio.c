@@ -32,7 +32,8 @@
 int lio_listio64(int mode, struct aiocb64 * __const list[], int nent,
 	struct sigevent *sig)
 {
-	unsigned i, err;
+	unsigned i, err, nrun;
+	int lastfd;
 	struct aiocb *aiocbp;
 	struct _aio_waiter waiter;
 	int policy;
@@ -60,6 +61,8 @@ int lio_listio64(int mode, struct aiocb64 * __const list[], int nent,
 	}
 
 	err = 0;
+	nrun = 0;
+	lastfd = -1;
 	_mutex_lock(&_aio_cb->cb_mutex);
 	for (i = 0; i < nent; i++) {
 		if ((aiocbp = (struct aiocb *)list[i]) == NULL)
@@ -116,14 +119,24 @@ int lio_listio64(int mode, struct aiocb64 * __const list[], int nent,
 				waiter.w_count--;
 			}
 			err = EAGAIN;
+		} else if (aiocbp->aio_fildes != lastfd) {
+			nrun++;
+			lastfd = aiocbp->aio_fildes;
 		}
 	}
 
 	
 	/* wakeup the working threads since we've put some on queue,
-	 * wait for all waiter reference come back.
+	 * wait for all waiter reference come back. A worker takes a run of
+	 * requests for the same fd in one go, so one per run is enough.
 	 */
-	pthread_cond_broadcast(&_aio_cb->cb_cond);
+	if (nrun >= _AIO_BATCH_MAX) {
+		pthread_cond_broadcast(&_aio_cb->cb_cond);
+	} else {
+		while (nrun--) {
+			pthread_cond_signal(&_aio_cb->cb_cond);
+		}
+	}
 	while (waiter.w_count > 0) {
 		pthread_cleanup_push(_aio_clean_up, &_aio_cb->cb_mutex);
 		err = pthread_cond_wait(&waiter.w_cond, &_aio_cb->cb_mutex);
@@ -25,6 +25,8 @@
 #include <pthread.h>
 #include <sys/dcmd_misc.h>
 
+extern int _nsem_value(sem_t *, int *);
+
 int sem_getvalue(sem_t *sem, int *value) {
 	
 	// Is it a destroyed semaphore.
@@ -37,6 +39,9 @@ int sem_getvalue(sem_t *sem, int *value) {
 	if(sem->__owner == _NTO_SYNC_NAMED_SEM) {
 		struct mq_attr attr;
 
+		if(_nsem_value(sem, value) == 0) {
+			return 0;
+		}
 		if(_devctl(sem->__count, DCMD_MISC_MQGETATTR, &attr, sizeof attr, 0) == -1) {
 			if(errno == EBADF) {
 				errno = EINVAL;
@@ -24,6 +24,8 @@
 #include <semaphore.h>
 #include <pthread.h>
 
+extern int _nsem_give(sem_t *);
+
 int
 sem_post(sem_t *sem) {
 
@@ -31,7 +33,10 @@ sem_post(sem_t *sem) {
 	if(sem->__owner == _NTO_SYNC_NAMED_SEM) {
 		int status;
 
-		if((status = write(sem->__count, NULL, 0)) == -1) {
+		if((status = _nsem_give(sem)) > 0) {
+			status = write(sem->__count, NULL, 0);
+		}
+		if(status == -1) {
 			if(errno == EBADF) {
 				errno = EINVAL;
 			}
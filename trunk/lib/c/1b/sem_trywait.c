@@ -25,6 +25,8 @@
 #include <pthread.h>
 #include <sys/iomsg.h>
 
+extern int _nsem_take(sem_t *);
+
 int
 sem_trywait(sem_t *sem) {
 
@@ -32,6 +34,13 @@ sem_trywait(sem_t *sem) {
 	if(sem->__owner == _NTO_SYNC_NAMED_SEM) {
 		int status;
 
+		switch(_nsem_take(sem)) {
+		case 1:
+			return 0;
+		case 0:
+			errno = EAGAIN;
+			return -1;
+		}
 		if((status = _readx(sem->__count, NULL, 0, _IO_XFLAG_NONBLOCK, NULL, 0)) == -1) {
 			if(errno == EBADF) {
 				errno = EINVAL;
@@ -24,6 +24,8 @@
 #include <pthread.h>
 #include <sys/neutrino.h>
 
+extern int _nsem_take(sem_t *);
+
 int
 sem_wait(sem_t *sem) {
 
@@ -31,6 +33,9 @@ sem_wait(sem_t *sem) {
 	if(sem->__owner == _NTO_SYNC_NAMED_SEM) {
 		int status;
 
+		if(_nsem_take(sem) == 1) {
+			return 0;
+		}
 		if((status = read(sem->__count, NULL, 0)) == -1) {
 			if(errno == EBADF) {
 				errno = EINVAL;
@@ -0,0 +1,127 @@
+/*
+ * $QNXLicenseC:
+ * Copyright 2007, QNX Software Systems. All Rights Reserved.
+ * 
+ * You must obtain a written license from and pay applicable license fees to QNX 
+ * Software Systems before you may reproduce, modify or distribute this software, 
+ * or any work that includes all or part of this software.   Free development 
+ * licenses are available for evaluation and non-commercial purposes.  For more 
+ * information visit http://licensing.qnx.com or email licensing@qnx.com.
+ *  
+ * This file may contain contributions from others.  Please review this entire 
+ * file for other proprietary rights or license notices, as well as the QNX 
+ * Development Suite License Guide at http://licensing.qnx.com/license-guide/ 
+ * for other information.
+ * $
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/neutrino.h>
+#include <sys/storage.h>
+#include <sys/syspage.h>
+#include "cpucfg.h"
+#include "mutex.h"
+
+/*
+ * Spin bounds, in passes over the mutex. The limit for a lock is twice
+ * the running average of what successful spins took (plus a little),
+ * so it follows the critical section lengths the thread actually meets.
+ * A spin that gives up pulls the average down, which makes a mutex that
+ * is held for long stop spinning quickly. pthread_mutex_t has no room
+ * for it, so the average is kept per thread, in the thread's TLS.
+ */
+#define SPIN_MIN		16
+#define SPIN_MAX		2000
+#define SPIN_SHIFT		3
+
+int						_mutex_adaptive_default;
+
+/*
+ * Map procnto's table of running owners the first time it's wanted.
+ * Opening it may itself wait on a mutex, so anyone who comes in while
+ * that's going on just blocks instead of spinning.
+ */
+static volatile uint32_t *
+running_owners(void) {
+	static volatile uint32_t	*running;
+	static volatile unsigned	state;
+	void						*addr;
+	int							fd;
+
+	if(state != 2) {
+		if(_syspage_ptr->num_cpu < 2 || __mutex_smp_cmpxchg(&state, 0, 1) != 0) {
+			return NULL;
+		}
+		if((fd = open("/" _NTO_RUNNING_OWNERS, O_RDONLY)) != -1) {
+			addr = mmap(0, _syspage_ptr->num_cpu * sizeof(uint32_t), PROT_READ, MAP_SHARED, fd, 0);
+			if(addr != MAP_FAILED) {
+				running = addr;
+			}
+			close(fd);
+		}
+		state = 2;
+	}
+	return running;
+}
+
+static int
+owner_running(volatile uint32_t *running, unsigned owner) {
+	unsigned	i;
+
+	owner &= ~_NTO_SYNC_WAITING;
+	for(i = 0; i < _syspage_ptr->num_cpu; ++i) {
+		if(running[i] == owner) {
+			return 1;
+		}
+	}
+	return 0;
+}
+
+/*
+ * Try to get the mutex by spinning. Returns EOK with the mutex owned by
+ * id (count not yet bumped), EBUSY if the caller should block.
+ */
+int
+_mutex_spin(pthread_mutex_t *mutex, unsigned id) {
+	volatile uint32_t	*running;
+	unsigned			*spin_avg;
+	unsigned			owner;
+	int					n, limit;
+
+	if((running = running_owners()) == NULL) {
+		return EBUSY;
+	}
+	spin_avg = &__tls()->__spinavg;
+	limit = *spin_avg * 2 + SPIN_MIN;
+	if(limit > SPIN_MAX) {
+		limit = SPIN_MAX;
+	}
+	for(n = 0; n < limit; ++n) {
+		owner = *(volatile unsigned *)&mutex->__owner;
+		if(owner == 0) {
+			if(__mutex_smp_cmpxchg(&mutex->__owner, 0, id) == 0) {
+				*spin_avg += (n - (int)*spin_avg) >> SPIN_SHIFT;
+				return EOK;
+			}
+		} else if(owner >= _NTO_SYNC_DEAD || !owner_running(running, owner)) {
+			// Not a plain locked mutex, or its owner isn't going to
+			// release it any time soon.
+			break;
+		}
+	}
+	*spin_avg += (SPIN_MIN - (int)*spin_avg) >> SPIN_SHIFT;
+	return EBUSY;
+}
+
+int
+pthread_mutex_setdefaultadaptive(int adaptive) {
+	_mutex_adaptive_default = (adaptive & PTHREAD_ADAPTIVE_MASK) != PTHREAD_ADAPTIVE_DISABLE;
+	return EOK;
+}
+
+__SRCVERSION("_mutex_spin.c $Rev: 153052 $");
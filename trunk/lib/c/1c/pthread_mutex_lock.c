@@ -22,6 +22,7 @@
 #include <pthread.h> 
 #include <sys/neutrino.h>
 #include "cpucfg.h"
+#include "mutex.h"
 
 // This function must not be a cancellation point
 // This function must not return EINTR
@@ -55,6 +56,14 @@ int
 		}
 	}
 
+	// Adaptive, and the owner is running on another cpu? Spin a bit first.
+	if(!(mutex->__count & _NTO_SYNC_PRIOCEILING) && _MUTEX_ADAPTIVE(mutex)) {
+		if(_mutex_spin(mutex, id) == EOK) {
+			++mutex->__count;
+			return EOK;
+		}
+	}
+
 	// Someone else owns it. Wait for it. Or, ceiling case, enter kernel.
 	if((ret = SyncMutexLock_r((sync_t *)mutex)) != EOK) {
 		return ret;
@@ -21,13 +21,14 @@
 #include <pthread.h>
 #include <errno.h>
 #include "cpucfg.h"
+#include "rwlock.h"
 
 int pthread_rwlock_destroy(pthread_rwlock_t *l)
 {
 	int status, id = LIBC_TLS()->__owner;
 
 	if ((status = pthread_mutex_lock(&l->__lock)) == EOK) {
-		if ((l->__owner == id) || (l->__active == 0)) {
+		if ((l->__owner == id) || ((l->__active & ~_RWLOCK_WAITERS) == 0)) {
 			l->__heavy = l->__active = l->__owner = -2U;
 			pthread_cond_broadcast(&l->__rcond);
 			pthread_cond_destroy(&l->__rcond);
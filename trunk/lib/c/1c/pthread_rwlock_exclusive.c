@@ -21,13 +21,16 @@
 #include <errno.h>
 #include <pthread.h> 
 #include "cpucfg.h"
+#include "rwlock.h"
 
 static void
 _exclusive_cancel(void *data) {
 	pthread_rwlock_t *l = data;
 
 	// determine who (if anybody) we should wakeup
-	if ((--l->__blockedwriters != 0) && (l->__active == 0)) {
+	--l->__blockedwriters;
+	_rwlock_waiters(l);
+	if ((l->__blockedwriters != 0) && ((l->__active & _RWLOCK_READERS) == 0)) {
 		// only wakup a writer
 		pthread_cond_signal(&l->__wcond);
 	} else if (l->__blockedreaders != 0) {
@@ -46,14 +49,21 @@ _pthread_timedrwlock_exclusive(pthread_rwlock_t* l, int preventblock, const stru
 
 		if (l->__owner == id) {
 			status = EDEADLK;
-		} else if ((preventblock) && (l->__active != 0)) {
+		} else if ((preventblock) && ((l->__active & _RWLOCK_READERS) != 0)) {
 			status = EBUSY;
 		} else {
 	
+			// no new readers get past the waiters flag once it's set
 			l->__blockedwriters++;
+			_rwlock_waiters(l);
 			pthread_cleanup_push(_exclusive_cancel, l);
 
-			while (l->__active != 0) {
+			while ((l->__active & _RWLOCK_READERS) != 0) {
+				if (preventblock) {
+					// a reader got in before the flag was set
+					status = EBUSY;
+					break;
+				}
 				if ((status = (t ?	pthread_cond_timedwait(&l->__wcond, &l->__lock, t) :
 									pthread_cond_wait(&l->__wcond, &l->__lock))) != EOK) {
 					break;
@@ -66,6 +76,8 @@ _pthread_timedrwlock_exclusive(pthread_rwlock_t* l, int preventblock, const stru
 			if (status == EOK) {
 				l->__active = -1;
 				l->__owner = id;
+			} else {
+				_rwlock_waiters(l);
 			}
 		}
 
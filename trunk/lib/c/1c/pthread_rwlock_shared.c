@@ -21,6 +21,7 @@
 #include <errno.h>
 #include <pthread.h> 
 #include "cpucfg.h"
+#include "rwlock.h"
 
 static void
 _shared_cancel(void *data) {
@@ -28,9 +29,10 @@ _shared_cancel(void *data) {
 
 	// reset count
 	--l->__blockedreaders;
+	_rwlock_waiters(l);
 
 	// determine who (if anybody) we should wakeup
-	if ((l->__blockedwriters != 0) && (l->__active == 0)) {
+	if ((l->__blockedwriters != 0) && ((l->__active & _RWLOCK_READERS) == 0)) {
 		pthread_cond_signal(&l->__wcond);
 	} else if (l->__blockedreaders != 0) {
 		pthread_cond_broadcast(&l->__rcond);
@@ -44,8 +46,21 @@ _shared_cancel(void *data) {
 
 static int
 _pthread_timedrwlock_shared(pthread_rwlock_t *l, int preventblock, const struct timespec *t) {
-	int status, id = LIBC_TLS()->__owner;
+	int status, id;
+	unsigned v;
+
+	// fast path, no writer and nobody waiting
+	for (;;) {
+		v = *_RWLOCK_ACTIVE(l);
+		if ((v & ~_RWLOCK_READERS) != 0 || v == _RWLOCK_READERS) {
+			break;
+		}
+		if (_smp_cmpxchg(_RWLOCK_ACTIVE(l), v, v + 1) == v) {
+			return EOK;
+		}
+	}
 
+	id = LIBC_TLS()->__owner;
 	if ((status = pthread_mutex_lock(&l->__lock)) == EOK) {
 
 		if (l->__owner == id) {
@@ -53,6 +68,7 @@ _pthread_timedrwlock_shared(pthread_rwlock_t *l, int preventblock, const struct
 		} else {
 
 			l->__blockedreaders++;
+			_rwlock_waiters(l);
 			pthread_cleanup_push(_shared_cancel, l);
 			while ((l->__active == -1) ||
 				((l->__blockedwriters != 0) && !(l->__heavy))) {
@@ -71,8 +87,9 @@ _pthread_timedrwlock_shared(pthread_rwlock_t *l, int preventblock, const struct
 			l->__blockedreaders--;
 
 			if (status == EOK) {
-				l->__active++;
+				atomic_add(_RWLOCK_ACTIVE(l), 1);
 			}
+			_rwlock_waiters(l);
 		}
 
 		pthread_mutex_unlock(&l->__lock);
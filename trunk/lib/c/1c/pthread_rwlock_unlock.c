@@ -22,11 +22,25 @@
 #include <errno.h>
 #include <sys/neutrino.h>
 #include "cpucfg.h"
+#include "rwlock.h"
 
 int
 pthread_rwlock_unlock(pthread_rwlock_t *l) {
-	int status, altstat = EOK, id = LIBC_TLS()->__owner;
+	int status, altstat = EOK, id;
+	unsigned v;
 
+	// fast path, a reader with nobody waiting
+	for (;;) {
+		v = *_RWLOCK_ACTIVE(l);
+		if ((v & ~_RWLOCK_READERS) != 0 || v == 0) {
+			break;
+		}
+		if (_smp_cmpxchg(_RWLOCK_ACTIVE(l), v, v - 1) == v) {
+			return EOK;
+		}
+	}
+
+	id = LIBC_TLS()->__owner;
 	if ((status = pthread_mutex_lock(&l->__lock)) == EOK) {
 
 		// determine if the lock is read or write locked and unlock it
@@ -35,14 +49,15 @@ pthread_rwlock_unlock(pthread_rwlock_t *l) {
 			if (l->__owner == id) {
 				// this thread is the writer
 				l->__active = 0;
+				_rwlock_waiters(l);
 				l->__heavy = (l->__blockedreaders > 0);
 				l->__owner = -2U;
 			} else {
 				// this thread does not own the writer lock
 				status = EPERM;
 			}
-		} else if (l->__active > 0) {
-			--l->__active;			// I am a reader
+		} else if ((l->__active >= 0) && ((l->__active & _RWLOCK_READERS) != 0)) {
+			atomic_sub(_RWLOCK_ACTIVE(l), 1);	// I am a reader
 
 			// if the heavy flag is set, see if it can be cleared
 			l->__heavy = (l->__heavy) ? (l->__blockedreaders > 0) : l->__heavy;
@@ -52,7 +67,7 @@ pthread_rwlock_unlock(pthread_rwlock_t *l) {
 		}
 
 		// determine if we should signal a writer or broadcast to readers
-		if ((l->__blockedwriters != 0) && (l->__active == 0) && !(l->__heavy)) {
+		if ((l->__blockedwriters != 0) && ((l->__active & _RWLOCK_READERS) == 0) && !(l->__heavy)) {
 			altstat = pthread_cond_signal(&l->__wcond);
 			}
 		else if (l->__blockedreaders != 0) {
@@ -23,6 +23,7 @@
 #include <pthread.h> 
 #include <sys/neutrino.h>
 #include "cpucfg.h"
+#include "mutex.h"
 
 // This function must not be a cancellation point
 // This function must not return EINTR
@@ -56,6 +57,14 @@ int
 		}
 	}
 
+	// Adaptive, and the owner is running on another cpu? Spin a bit first.
+	if(!(mutex->__count & _NTO_SYNC_PRIOCEILING) && _MUTEX_ADAPTIVE(mutex)) {
+		if(_mutex_spin(mutex, id) == EOK) {
+			++mutex->__count;
+			return EOK;
+		}
+	}
+
 	if(!TIMESPEC_VALID(abs_timeout)) {
 		return EINVAL;
 	}
@@ -25,6 +25,8 @@
 #include <pthread.h>
 #include <sys/neutrino.h>
 
+extern int _nsem_take(sem_t *);
+
 int
 sem_timedwait(sem_t *sem, const struct timespec *abs_timeout) {
 	uint64_t	t = timespec2nsec(abs_timeout);
@@ -33,6 +35,9 @@ sem_timedwait(sem_t *sem, const struct timespec *abs_timeout) {
 	if(sem->__owner == _NTO_SYNC_NAMED_SEM) {
 		int		status;
 
+		if(_nsem_take(sem) == 1) {
+			return 0;
+		}
 		if(TimerTimeout(CLOCK_REALTIME, TIMER_ABSTIME | _NTO_TIMEOUT_SEND | _NTO_TIMEOUT_REPLY, 0, &t, 0) == -1) {
 			return -1;
 		}
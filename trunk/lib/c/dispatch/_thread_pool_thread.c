@@ -19,6 +19,8 @@
 
 
 #include <sys/dispatch.h>
+#include <sys/neutrino.h>
+#include <sys/syspage.h>
 #include <errno.h>
 #include <atomic.h>
 #include <stdlib.h>
@@ -29,12 +31,111 @@ struct _pool_context {
 	thread_pool_t		*pool;
 	void *ctp;
 	unsigned			flags;
+	int					cpu;
 };
 
+// Moving average over about the last 8 samples
+#define POOL_AVG(_avg, _sample)	((_avg) = (_avg) - ((_avg) >> 3) + ((_sample) >> 3))
+
 void *_thread_pool_thread(thread_pool_t *pool, void *ctp);
 void *_thread_pool_reserve_thread(void *data);
 void *_thread_pool_context_thread(void *data);
 
+static unsigned _isqrt(unsigned n) {
+	unsigned	r = 0, b = 1 << 30;
+
+	while(b > n) {
+		b >>= 2;
+	}
+	while(b) {
+		if(n >= r + b) {
+			n -= r + b;
+			r = (r >> 1) + b;
+		} else {
+			r >>= 1;
+		}
+		b >>= 2;
+	}
+	return r;
+}
+
+/*
+ * The water marks to go by. In adaptive mode, by Little's law the number
+ * of threads busy is the message rate times the service time. Keeping
+ * about the square root of that waiting on top keeps the chance of a
+ * message having to queue in the kernel small without a lot of idle
+ * threads, and more are kept while messages are finding the pool empty.
+ * lo_water is a floor and hi_water a ceiling for all this.
+ * Called with inline_lock held.
+ */
+void _thread_pool_water(thread_pool_t *pool, unsigned *lo, unsigned *hi) {
+	struct _pool_properties *props = pool->props;
+	uint64_t	busy16;
+	unsigned	want, inc;
+
+	if(!(pool->flags & POOL_FLAG_ADAPTIVE)) {
+		*lo = pool->pool_attr.lo_water;
+		*hi = pool->pool_attr.hi_water;
+		return;
+	}
+
+	busy16 = 0;
+	if(props->arrival_avg != 0) {
+		busy16 = (props->service_avg << 4) / props->arrival_avg;
+		if(busy16 > 0xffffff) {
+			busy16 = 0xffffff;
+		}
+	}
+	inc = __max(pool->pool_attr.increment, 1);
+	want = 1 + (_isqrt((unsigned)busy16) + 3) / 4 + ((props->dry_avg * inc) >> 6);
+	want = __max(want, pool->pool_attr.lo_water);
+	want = __min(want, pool->pool_attr.hi_water);
+	*lo = want;
+	*hi = __min(want + __max(want, inc), pool->pool_attr.hi_water);
+}
+
+// Keep track of how long the pool has no threads waiting for a message.
+static void _thread_pool_waiting(struct _pool_properties *props, unsigned before, unsigned after) {
+	if(before != 0 && after == 0) {
+		props->dry_start = ClockCycles();
+		props->dry_count++;
+	} else if(before == 0 && after != 0 && props->dry_start != 0) {
+		props->dry_time += ClockCycles() - props->dry_start;
+		props->dry_start = 0;
+	}
+}
+
+// Pick the cpu with the fewest of our threads on it, -1 for don't care.
+static int _thread_pool_cpu(thread_pool_t *pool, struct _pool_properties *props) {
+	unsigned	i, best;
+
+	if(!(pool->flags & POOL_FLAG_CPU_AFFINITY)) {
+		return -1;
+	}
+	if(props->num_cpu == 0) {
+		props->num_cpu = __min(_syspage_ptr->num_cpu, _POOL_MAX_CPU);
+	}
+	if(props->num_cpu < 2) {
+		return -1;
+	}
+	best = 0;
+	for(i = 1; i < props->num_cpu; i++) {
+		if(props->cpu_threads[i] < props->cpu_threads[best]) {
+			best = i;
+		}
+	}
+	props->cpu_threads[best]++;
+	return best;
+}
+
+// A thread is leaving the pool. Called with inline_lock held.
+static void _thread_pool_exit(struct _pool_context *pcp, struct _pool_properties *props) {
+	props->thread_exits++;
+	if(pcp->cpu != -1) {
+		props->cpu_threads[pcp->cpu]--;
+	}
+}
+
 static void _thread_cleanup(void *data) {
 	struct _pool_context *pcp = data;
 	thread_pool_t        *pool = pcp->pool;
@@ -42,8 +143,10 @@ static void _thread_cleanup(void *data) {
 
 	props = (struct _pool_properties *)pool->props;
 	_mutex_lock(&(props->inline_lock));
+	_thread_pool_waiting(props, pool->waiting, pool->waiting - 1);
 	pool->waiting--;
 	pool->created--;
+	_thread_pool_exit(pcp, props);
 	//Optimize on exit by only signalling once
 	if(pool->flags & POOL_FLAG_CHANGING) {
 		pthread_cond_signal(&(props->pool_cond));
@@ -58,23 +161,38 @@ static void _thread_pool_update(thread_pool_t *pool, int w_adj, int n_adj) {
 	int	     add=0;
 	struct _pool_properties *props;
 	int realwaiting;
+	unsigned lo_water, hi_water;
 
 	props = (struct _pool_properties *)pool->props;
 	_mutex_lock(&(props->inline_lock));
+	_thread_pool_waiting(props, pool->waiting, pool->waiting + w_adj);
 	pool->waiting += w_adj;
 	props->newthreads += n_adj;
+	if (w_adj < 0) {
+		// a thread has just received a message
+		uint64_t now = ClockCycles();
+
+		if (props->messages++ != 0)
+			POOL_AVG(props->arrival_avg, now - props->last_arrival);
+		props->last_arrival = now;
+		if (pool->waiting == 0)
+			props->dry_avg += (256 - props->dry_avg) >> 3;
+		else
+			props->dry_avg -= props->dry_avg >> 3;
+	}
+	_thread_pool_water(pool, &lo_water, &hi_water);
 	realwaiting = (pool->waiting + props->newthreads);
-	if ((realwaiting < (pool->pool_attr.lo_water + props->reserved_threads) ) && 
+	if ((realwaiting < (lo_water + props->reserved_threads) ) && 
 			(pool->created < (pool->pool_attr.maximum + props->reserved_threads))) {
-		if (pool->created < (pool->pool_attr.lo_water + props->reserved_threads))
-			add = (pool->pool_attr.lo_water + props->reserved_threads) - pool->created;
+		if (pool->created < (lo_water + props->reserved_threads))
+			add = (lo_water + props->reserved_threads) - pool->created;
 		else {
 			// routine increment
 			add = pool->pool_attr.increment;
 			// but never allow more than hi_water waiting
 			// this takes care of very strange increment values
-			if ((realwaiting + add) > (pool->pool_attr.hi_water + props->reserved_threads))
-				add = (pool->pool_attr.hi_water + props->reserved_threads) - realwaiting;
+			if ((realwaiting + add) > (hi_water + props->reserved_threads))
+				add = (hi_water + props->reserved_threads) - realwaiting;
 		}
 		// but not more than maximum
 		if ((pool->created + add) > (pool->pool_attr.maximum + props->reserved_threads))
@@ -217,6 +335,8 @@ void *_thread_pool_thread(thread_pool_t *pool, void *ctp) {
 	struct _pool_context pcp;
 	struct _pool_properties *props;
 	void *old_ctp;
+	uint64_t start, service;
+	unsigned lo_water, hi_water;
 
 	props = (struct _pool_properties *)pool->props;
 
@@ -224,6 +344,19 @@ void *_thread_pool_thread(thread_pool_t *pool, void *ctp) {
 	pcp.ctp = ctp;
 	pcp.flags = PCP_FLAG_WAITING;
 
+	_mutex_lock(&(props->inline_lock));
+	props->thread_creates++;
+	pcp.cpu = _thread_pool_cpu(pool, props);
+	_mutex_unlock(&(props->inline_lock));
+	// With the threads spread over the cpus like this, the kernel can hand
+	// a message to a thread that runs on the cpu it was sent from.
+	if(pcp.cpu != -1 && ThreadCtl(_NTO_TCTL_RUNMASK, (void *)(1 << pcp.cpu)) == -1) {
+		_mutex_lock(&(props->inline_lock));
+		props->cpu_threads[pcp.cpu]--;
+		pcp.cpu = -1;
+		_mutex_unlock(&(props->inline_lock));
+	}
+
 	pthread_cleanup_push(&_thread_cleanup, &pcp);
 
 	do {
@@ -235,6 +368,7 @@ void *_thread_pool_thread(thread_pool_t *pool, void *ctp) {
 		// call update, decrement waiting, newthreads unchanged
 		_thread_pool_update(pool, -1, 0);
 
+		start = ClockCycles();
 		if (pool->pool_attr.handler_func(ctp) == -1) {
 			ctp = old_ctp; 
 			/* Fall thru so we update stats and potential exit */
@@ -244,13 +378,18 @@ void *_thread_pool_thread(thread_pool_t *pool, void *ctp) {
 			*/
 		}
 
+		service = ClockCycles() - start;
+
 		_mutex_lock(&(props->inline_lock));
+		POOL_AVG(props->service_avg, service);
+		_thread_pool_water(pool, &lo_water, &hi_water);
 		// exit if we are over the high water mark _and_
 		// over the low water mark also
-		if ((pool->waiting >= (pool->pool_attr.hi_water + props->reserved_threads)) &&
-        (pool->waiting >= (pool->pool_attr.lo_water + props->reserved_threads))) {
+		if ((pool->waiting >= (hi_water + props->reserved_threads)) &&
+        (pool->waiting >= (lo_water + props->reserved_threads))) {
 			break;
 		}
+		_thread_pool_waiting(props, pool->waiting, pool->waiting + 1);
 		pool->waiting++;
 		_mutex_unlock(&(props->inline_lock));
 		pcp.flags |= PCP_FLAG_WAITING;
@@ -258,6 +397,7 @@ void *_thread_pool_thread(thread_pool_t *pool, void *ctp) {
 
 	pthread_cleanup_pop(0);
 	pool->created--;
+	_thread_pool_exit(&pcp, props);
 	//Optimize on exit by only signalling once
 	if(pool->flags & POOL_FLAG_CHANGING) {
 		pthread_cond_signal(&(props->pool_cond));
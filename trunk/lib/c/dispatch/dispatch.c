@@ -63,12 +63,12 @@ dispatch_context_t *dispatch_context_alloc(dispatch_t *dpp) {
 			errno = ENOMEM;
 			return NULL;
 		}
-		if((ctp->message_context.extra = calloc(1, sizeof(struct _extended_context))) == NULL) {
+		if((ctp->message_context.extra = calloc(1, sizeof(struct _dispatch_extended_context))) == NULL) {
 			free(ctp);
 			errno = ENOMEM;
 			return NULL;
 		}
-		ctp->message_context.extra->length = sizeof(struct _extended_context);
+		ctp->message_context.extra->length = sizeof(struct _dispatch_extended_context);
 
 		ctp->message_context.dpp = (dispatch_t *) dpp;
 		ctp->message_context.msg = (resmgr_iomsgs_t *)((char *)ctp + offsetof(message_context_t, iov) + _DPP(dpp)->nparts_max * sizeof(ctp->message_context.iov[0]));
@@ -86,12 +86,94 @@ dispatch_context_t *dispatch_context_alloc(dispatch_t *dpp) {
 	return NULL;
 }
 
-void dispatch_context_free(dispatch_context_t *ctp) {
+static struct _dispatch_batch *_dispatch_batch(resmgr_context_t *ctp) {
+	struct _extended_context	*extra = ctp->extra;
+
+	// Contexts not from dispatch_context_alloc() don't have the room
+	if(extra == NULL || extra->length < sizeof(struct _dispatch_extended_context)) {
+		return NULL;
+	}
+	return &((struct _dispatch_extended_context *)extra)->batch;
+}
 
+void dispatch_context_free(dispatch_context_t *ctp) {
+	struct _dispatch_batch	*bp;
+
+	// Don't leave the senders of messages still parked in a batch blocked
+	if((bp = _dispatch_batch(&ctp->resmgr_context)) != NULL) {
+		(void)dispatch_msgreply_flush(ctp);
+		while(bp->rnext < bp->rcount) {
+			if(bp->rcv[bp->rnext].rcvid > 0) {
+				MsgError(bp->rcv[bp->rnext].rcvid, EAGAIN);
+			}
+			bp->rnext++;
+		}
+	}
 	free(ctp->message_context.extra);
 	free(ctp);
 }
 
+int dispatch_msgreply_flush(dispatch_context_t *ctp) {
+	struct _dispatch_batch	*bp;
+	int						i, n, ret = 0;
+
+	if((bp = _dispatch_batch(&ctp->resmgr_context)) == NULL) {
+		return 0;
+	}
+	// MsgReplyMulti() stops at a reply it can't make (the client went
+	// away...), so step over that one and carry on with the rest
+	for(i = 0; i < bp->pcount; i += n + 1) {
+		if((n = MsgReplyMulti(&bp->rep[i], bp->pcount - i)) == -1) {
+			n = 0;
+		}
+		if(i + n < bp->pcount) {
+			ret = -1;
+		}
+	}
+	bp->pcount = 0;
+	return ret;
+}
+
+int dispatch_msgreplyv(dispatch_context_t *ctp, int rcvid, int status, const iov_t *iov, int parts) {
+	struct _dispatch_batch	*bp;
+	struct _msg_reply_entry	*rep;
+	char					*dst;
+	int						i, bytes;
+
+	// Only hold the reply back while the rest of a batch is being handled
+	if((bp = _dispatch_batch(&ctp->resmgr_context)) == NULL || bp->rcount < 2 ||
+			bp->pcount >= _DISPATCH_BATCH_MAX || rcvid <= 0) {
+		goto now;
+	}
+	for(bytes = i = 0; i < parts; i++) {
+		bytes += GETIOVLEN(&iov[i]);
+	}
+	if(bytes > _DISPATCH_BATCH_MSGSIZE) {
+		goto now;
+	}
+
+	rep = &bp->rep[bp->pcount];
+	dst = bp->pbuf[bp->pcount++];
+	rep->rcvid = rcvid;
+	rep->status = status;
+	rep->msg = dst;
+	rep->bytes = bytes;
+	for(i = 0; i < parts; i++) {
+		memcpy(dst, GETIOVBASE(&iov[i]), GETIOVLEN(&iov[i]));
+		dst += GETIOVLEN(&iov[i]);
+	}
+	if(bp->rnext >= bp->rcount) {
+		return dispatch_msgreply_flush(ctp);
+	}
+	return 0;
+
+now:
+	if(bp && bp->pcount) {
+		(void)dispatch_msgreply_flush(ctp);
+	}
+	return MsgReplyv(rcvid, status, iov, parts);
+}
+
 int _dispatch_attach(dispatch_t *dpp, void *ctrl, unsigned attach_type) {
 	void			**ctrlptr = NULL;
 	unsigned 		new_context_size = 0;
@@ -209,10 +291,66 @@ int _dispatch_attach(dispatch_t *dpp, void *ctrl, unsigned attach_type) {
 	return 0;
 }
 
+static int _dispatch_receive_batch(dispatch_context_t *ctp, struct _dispatch_batch *bp) {
+	dispatch_t				*dpp = ctp->message_context.dpp;
+	struct _msg_receive_entry	*rcv = bp->rcv;
+	int						i, n;
+
+	rcv[0].msg = ctp->message_context.msg;
+	rcv[0].bytes = ctp->message_context.msg_max_size;
+	for(i = 1; i < _DISPATCH_BATCH_MAX; i++) {
+		rcv[i].msg = bp->rbuf[i - 1];
+		rcv[i].bytes = sizeof bp->rbuf[i - 1];
+	}
+
+	if((n = MsgReceiveMulti(dpp->chid, rcv, _DISPATCH_BATCH_MAX, 0)) == -1) {
+		if(errno == ENOSYS || errno == ENOTSUP) {
+			// Older kernel, or a channel it won't batch on
+			dpp->flags |= _DISPATCH_NO_BATCH;
+			return MsgReceive(dpp->chid, ctp->message_context.msg, ctp->message_context.msg_max_size, &ctp->message_context.info);
+		}
+		return -1;
+	}
+	bp->rcount = n;
+	bp->rnext = 1;
+	if(rcv[0].rcvid != 0) {
+		ctp->message_context.info = rcv[0].info;
+	}
+	return rcv[0].rcvid;
+}
+
 static dispatch_context_t *dispatch_block_receive_all(dispatch_context_t *ctp, 
                                                       int (*block_func)(int chid, void *msg, 
 													                    int bytes, struct _msg_info *info)) {
 	dispatch_t				*dpp = ((message_context_t *) ctp)->dpp;
+	struct _dispatch_batch	*bp = NULL;
+
+	if(block_func == MsgReceive && (dpp->flags & (DISPATCH_FLAG_BATCH | _DISPATCH_NO_BATCH)) == DISPATCH_FLAG_BATCH) {
+		bp = _dispatch_batch(&ctp->resmgr_context);
+	}
+
+top:
+	if(bp) {
+		// Hand out the rest of the last batch without going into the kernel
+		if(bp->rnext < bp->rcount) {
+			struct _msg_receive_entry	*rcv = &bp->rcv[bp->rnext++];
+
+			ctp->message_context.id = -1;
+			ctp->message_context.info.msglen = 0;
+			if((ctp->message_context.rcvid = rcv->rcvid) == 0) {
+				memcpy(ctp->message_context.msg, rcv->msg, sizeof(struct _pulse));
+			} else {
+				ctp->message_context.info = rcv->info;
+				memcpy(ctp->message_context.msg, rcv->msg, rcv->info.msglen);
+			}
+			goto rest;
+		}
+		// Anything not replied to yet goes back before we block again
+		if(bp->pcount) {
+			(void)dispatch_msgreply_flush(ctp);
+		}
+		bp->rnext = bp->rcount = 0;
+	}
 
 	if(dpp->flags & _DISPATCH_TIMEOUT) {
 		if(timer_timeout(CLOCK_MONOTONIC, _NTO_TIMEOUT_RECEIVE, 0, &dpp->timeout, 0) == -1) {
@@ -230,9 +368,15 @@ static dispatch_context_t *dispatch_block_receive_all(dispatch_context_t *ctp,
 	ctp->message_context.info.msglen = 0;
 
 again:
-	if((ctp->message_context.rcvid = block_func(dpp->chid, ctp->message_context.msg, ctp->message_context.msg_max_size, &ctp->message_context.info)) == -1 && errno != ETIMEDOUT) {
+	if(bp) {
+		ctp->message_context.rcvid = _dispatch_receive_batch(ctp, bp);
+	} else {
+		ctp->message_context.rcvid = block_func(dpp->chid, ctp->message_context.msg, ctp->message_context.msg_max_size, &ctp->message_context.info);
+	}
+	if(ctp->message_context.rcvid == -1 && errno != ETIMEDOUT) {
 		return NULL;
 	}
+rest:
 	// Doing a network transaction and not all the message was send, so get the rest...
 	if(ctp->message_context.rcvid > 0 && ctp->message_context.info.srcmsglen > ctp->message_context.info.msglen && ctp->message_context.info.msglen < ctp->message_context.msg_max_size) {
 		int						n;
@@ -240,6 +384,9 @@ again:
 		if((n = MsgRead_r(ctp->message_context.rcvid, (char *)ctp->message_context.msg + ctp->message_context.info.msglen,
 				ctp->message_context.msg_max_size - ctp->message_context.info.msglen, ctp->message_context.info.msglen)) < 0) {
 			MsgError(ctp->message_context.rcvid, -n);
+			if(bp) {
+				goto top;
+			}
 			goto again;
 		}
 		ctp->message_context.info.msglen += n;
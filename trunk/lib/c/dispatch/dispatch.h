@@ -35,6 +35,7 @@
 #define _DISPATCH_ONLY_RESMGR		0x00000001
 #define _DISPATCH_ONLY_SELECT		0x00000002
 #define _DISPATCH_TIMEOUT			0x00000004
+#define _DISPATCH_NO_BATCH			0x00000008
 
 #define _VEC_VALID					0x80000000
 
@@ -175,6 +176,36 @@ void *_dispatch_vector_grow(void *vec, int new_num);
 int _dispatch_attach(dispatch_t *dpp, void *ctrl, unsigned type);
 int _dispatch_set_contextsize(dispatch_t *dpp, unsigned type);
 
+/*
+ * Batched receive, for a dispatch created with DISPATCH_FLAG_BATCH.
+ * dispatch_block() pulls up to _DISPATCH_BATCH_MAX short messages out of
+ * the kernel at once and hands them out one per call. Short replies made
+ * with dispatch_msgreplyv() while a batch is being handed out are copied
+ * into pbuf[] and go back with one MsgReplyMulti() once the last message
+ * of the batch is replied to, or before dispatch_block() goes back into
+ * the kernel. The parked messages are served one after the other by the
+ * thread that received them, so this suits a single threaded server
+ * rather than a thread pool.
+ */
+#define _DISPATCH_BATCH_MAX			8
+#define _DISPATCH_BATCH_MSGSIZE		256
+
+struct _dispatch_batch {
+	int							rnext;		/* next parked message to hand out */
+	int							rcount;		/* messages received in this batch */
+	int							pcount;		/* replies held back in rep[] */
+	struct _msg_receive_entry	rcv[_DISPATCH_BATCH_MAX];
+	struct _msg_reply_entry		rep[_DISPATCH_BATCH_MAX];
+	char						rbuf[_DISPATCH_BATCH_MAX - 1][_DISPATCH_BATCH_MSGSIZE];
+	char						pbuf[_DISPATCH_BATCH_MAX][_DISPATCH_BATCH_MSGSIZE];
+};
+
+struct _dispatch_extended_context {
+	struct _extended_context	extra;		/* must be first */
+	struct _dispatch_batch		batch;
+};
+
+
 #define _DISPATCH_CHANNEL_COIDDEATH		0x40000000
 #define _DISPATCH_CONTEXT_ALLOCED		0x80000000
 
@@ -194,12 +225,29 @@ struct _dispatch {
 	_sigwait_control		*sigwait_ctrl;
 };
 
+#define _POOL_MAX_CPU		32
+
 struct _pool_properties {
 	pthread_mutex_t inline_lock;
 	pthread_cond_t pool_cond;
 	unsigned newthreads;
 	unsigned reserved_threads;
 	unsigned control_threads;
+	/* The rest is only looked at with inline_lock held */
+	uint64_t last_arrival;		/* ClockCycles() of the last message */
+	uint64_t arrival_avg;		/* moving averages, in cycles */
+	uint64_t service_avg;
+	uint64_t dry_start;			/* no threads waiting since then */
+	uint64_t dry_time;
+	unsigned dry_avg;			/* share of messages that emptied the pool, /256 */
+	unsigned dry_count;
+	uint64_t messages;
+	unsigned thread_creates;
+	unsigned thread_exits;
+	unsigned num_cpu;
+	unsigned short cpu_threads[_POOL_MAX_CPU];
 };
 
+void _thread_pool_water(thread_pool_t *pool, unsigned *lo, unsigned *hi);
+
 /* __SRCVERSION("dispatch.h $Rev: 167031 $"); */
@@ -24,6 +24,8 @@
 #include <string.h>
 #include <stdlib.h>
 #include <sys/dispatch.h>
+#include <sys/neutrino.h>
+#include <sys/syspage.h>
 #include "dispatch.h"
 
 void *_thread_pool_context_thread(void *data);
@@ -283,4 +285,43 @@ int thread_pool_limits(thread_pool_t *pool, int lowater, int hiwater,
 	return thread_pool_control(pool, &tpattr, lower, upper, flags);
 }
 
+static uint64_t _cycles_to_nsec(uint64_t cycles) {
+	uint64_t	cps = SYSPAGE_ENTRY(qtime)->cycles_per_sec;
+
+	return cps ? (cycles * 1000) / (cps / 1000000 ? cps / 1000000 : 1) : 0;
+}
+
+/* Snapshot of how the pool is doing, see POOL_FLAG_ADAPTIVE. */
+int thread_pool_stats(thread_pool_t *pool, thread_pool_stats_t *stats) {
+	struct _pool_properties *props;
+	unsigned lo_water, hi_water;
+	uint64_t dry;
+
+	props = (struct _pool_properties *)pool->props;
+	memset(stats, 0, sizeof(*stats));
+
+	_mutex_lock(&(props->inline_lock));
+	_thread_pool_water(pool, &lo_water, &hi_water);
+	stats->created = pool->created;
+	stats->waiting = pool->waiting;
+	stats->lo_water = lo_water;
+	stats->hi_water = hi_water;
+	stats->messages = props->messages;
+	stats->arrival_nsec = props->arrival_avg;
+	stats->service_nsec = props->service_avg;
+	dry = props->dry_time;
+	if(props->dry_start != 0) {
+		dry += ClockCycles() - props->dry_start;
+	}
+	stats->dry_count = props->dry_count;
+	stats->thread_creates = props->thread_creates;
+	stats->thread_exits = props->thread_exits;
+	_mutex_unlock(&(props->inline_lock));
+
+	stats->arrival_nsec = _cycles_to_nsec(stats->arrival_nsec);
+	stats->service_nsec = _cycles_to_nsec(stats->service_nsec);
+	stats->dry_nsec = _cycles_to_nsec(dry);
+	return 0;
+}
+
 __SRCVERSION("thread_pool_ctrl.c $Rev: 167279 $");
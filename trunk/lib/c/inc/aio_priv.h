@@ -45,6 +45,13 @@ struct _aio_prio_list {
 
 #define _AIO_PRIO_LIST_LOW   (8)
 
+/* fds being worked on are hashed to the context doing them */
+#define _AIO_FD_HASH         (32)
+#define _AIO_FD_HASHFN(fd)   ((unsigned)(fd) & (_AIO_FD_HASH - 1))
+
+/* most requests a worker takes on, or sends in one message, at a time */
+#define _AIO_BATCH_MAX       (16)
+
 struct _aio_context;
 struct _aio_control_block {
 	pthread_mutex_t       cb_mutex;
@@ -55,6 +62,8 @@ struct _aio_control_block {
 	thread_pool_t         *tp;
 	struct _aio_context   *ct_list;
 	struct _aio_context   *ct_free;
+	struct _aio_context   *ct_fdhash[_AIO_FD_HASH];
+	unsigned              cb_runmask;
 };
 
 struct _aio_waiter {
@@ -71,4 +71,10 @@ struct _connect_ctrl {
 
 int _connect_ctrl(struct _connect_ctrl *ctrl, const char *path, unsigned response_len, void *response);
 
+/* Client side cache of path manager resolutions (_connect_cache.c) */
+extern int __connect_cache;
+int _connect_cache_lookup(struct _connect_ctrl *ctrl, const char *path, void *buffer, unsigned *genp);
+void _connect_cache_store(struct _connect_ctrl *ctrl, const char *path, const void *buffer, unsigned gen);
+void _connect_cache_flush(void);
+
 /* __SRCVERSION("connect.h $Rev: 205764 $"); */
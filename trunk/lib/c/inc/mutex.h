@@ -0,0 +1,33 @@
+/*
+ * $QNXLicenseC:
+ * Copyright 2007, QNX Software Systems. All Rights Reserved.
+ * 
+ * You must obtain a written license from and pay applicable license fees to QNX 
+ * Software Systems before you may reproduce, modify or distribute this software, 
+ * or any work that includes all or part of this software.   Free development 
+ * licenses are available for evaluation and non-commercial purposes.  For more 
+ * information visit http://licensing.qnx.com or email licensing@qnx.com.
+ *  
+ * This file may contain contributions from others.  Please review this entire 
+ * file for other proprietary rights or license notices, as well as the QNX 
+ * Development Suite License Guide at http://licensing.qnx.com/license-guide/ 
+ * for other information.
+ * $
+ */
+
+#include <pthread.h>
+
+/*
+ * Adaptive mutexes spin in user space while the owner is running on
+ * another cpu, instead of going straight into SyncMutexLock(). The
+ * kernel keeps the sync owner id of each cpu's running thread in a page
+ * procnto publishes read-only at _NTO_RUNNING_OWNERS (SMP only).
+ */
+
+extern int	_mutex_adaptive_default;
+
+extern int	_mutex_spin(pthread_mutex_t *__mutex, unsigned __id);
+
+#define _MUTEX_ADAPTIVE(m)	(((m)->__count & _NTO_SYNC_ADAPTIVE) || _mutex_adaptive_default)
+
+/* __SRCVERSION("mutex.h $Rev: 153052 $"); */
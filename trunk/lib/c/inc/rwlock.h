@@ -0,0 +1,62 @@
+/*
+ * $QNXLicenseC:
+ * Copyright 2007, QNX Software Systems. All Rights Reserved.
+ * 
+ * You must obtain a written license from and pay applicable license fees to QNX 
+ * Software Systems before you may reproduce, modify or distribute this software, 
+ * or any work that includes all or part of this software.   Free development 
+ * licenses are available for evaluation and non-commercial purposes.  For more 
+ * information visit http://licensing.qnx.com or email licensing@qnx.com.
+ *  
+ * This file may contain contributions from others.  Please review this entire 
+ * file for other proprietary rights or license notices, as well as the QNX 
+ * Development Suite License Guide at http://licensing.qnx.com/license-guide/ 
+ * for other information.
+ * $
+ */
+
+
+
+
+
+#include <atomic.h>
+#include <pthread.h>
+
+/*
+ * An uncontended read lock or unlock doesn't take __lock, it just moves
+ * the count in __active with a compare and swap. That is only allowed
+ * while _RWLOCK_WAITERS is clear. The flag is set, with __lock held,
+ * before any thread waits, which sends everybody through __lock where the
+ * writer preference and __heavy logic are. Since readers may be changing
+ * __active at the same time, anything done to it under __lock while it
+ * isn't write locked has to be atomic too.
+ *
+ *	__active == -1				write locked
+ *	__active & _RWLOCK_WAITERS	threads are blocked, or about to be
+ *	__active & _RWLOCK_READERS	number of read locks held
+ */
+#define _RWLOCK_WAITERS		0x40000000
+#define _RWLOCK_READERS		(_RWLOCK_WAITERS - 1)
+
+#define _RWLOCK_ACTIVE(l)	((volatile unsigned *)&(l)->__active)
+
+/* Set or clear _RWLOCK_WAITERS after changing __blocked*, __lock held */
+static __inline void _rwlock_waiters(pthread_rwlock_t *l) {
+	volatile unsigned	*active = _RWLOCK_ACTIVE(l);
+	unsigned			v;
+
+	if (l->__blockedwriters || l->__blockedreaders) {
+		if (!(*active & _RWLOCK_WAITERS)) {
+			atomic_set(active, _RWLOCK_WAITERS);
+		}
+	} else {
+		do {
+			v = *active;
+			if ((int)v < 0 || !(v & _RWLOCK_WAITERS)) {
+				break;
+			}
+		} while (_smp_cmpxchg(active, v, v & ~_RWLOCK_WAITERS) != v);
+	}
+}
+
+/* __SRCVERSION("rwlock.h $Rev: 153052 $"); */
@@ -66,6 +66,23 @@ typedef struct
     long secs; /* time in secs since beginning of day */
 } Dstrule;
 
+#define _TZ_YEAR0	70	/* first tm_year with precomputed DST transitions */
+#define _TZ_NYEARS	100	/* number of years precomputed */
+
+typedef struct _Tzrules
+{  /* a parsed TZ; never changed or freed once in use */
+    struct _Tzrules *next;  /* all rules made so far */
+    const char *tzstr;      /* TZ string they were made from */
+    char *tzone;            /* reformatted as ":std:dst:off:dstoff:rules" */
+    char *name[2];          /* tzname[] */
+    long tzoff;             /* standard offset, secs east of UTC */
+    long tzoffdst;          /* daylight offset, secs east of UTC */
+    int dst_state;          /* as set by _Getrules() */
+    int daylight;
+    Dstrule rules[2];       /* start and end of daylight time */
+    long trans[_TZ_NYEARS][2]; /* rules[] in secs from the start of each year */
+} _Tzrules;
+
 #else
 		/* type definitions */
 typedef struct
@@ -82,13 +99,15 @@ const char * _Gentime(const struct tm *, const _Tinfo *,
 Dstrule * _Getdst(const char *);
 const char * _Gettime(const char *, int, int *);
 #ifdef __QNX__
-int _Isdst(const struct tm *, long tzoff, long tzoffdst);
+int _Isdst(const struct tm *, const _Tzrules *, long tzoff, long tzoffdst);
+long _Dstsecs(const Dstrule *, int);
 #else
 int _Isdst(const struct tm *);
 #endif
 const char *_Getzone(void);
 #ifdef __QNX__
 char *(_Tzset)(void);
+const _Tzrules *_Tzget(void);
 Dstrule *_Getrules(int *);
 enum {
 	__GMTIME_CALL=0,
@@ -0,0 +1,36 @@
+/*
+ * $QNXLicenseC:
+ * Copyright 2007, QNX Software Systems. All Rights Reserved.
+ * 
+ * You must obtain a written license from and pay applicable license fees to QNX 
+ * Software Systems before you may reproduce, modify or distribute this software, 
+ * or any work that includes all or part of this software.   Free development 
+ * licenses are available for evaluation and non-commercial purposes.  For more 
+ * information visit http://licensing.qnx.com or email licensing@qnx.com.
+ *  
+ * This file may contain contributions from others.  Please review this entire 
+ * file for other proprietary rights or license notices, as well as the QNX 
+ * Development Suite License Guide at http://licensing.qnx.com/license-guide/ 
+ * for other information.
+ * $
+ */
+
+
+
+
+#include <sys/neutrino.h>
+
+extern int __MsgReceiveMulti_r(int chid, struct _msg_receive_entry *rcv, int nrcv, unsigned flags);
+
+int MsgReceiveMulti_r(int chid, struct _msg_receive_entry *rcv, int nrcv, unsigned flags) {
+	int			ret;
+
+	ret = __MsgReceiveMulti_r(chid, rcv, nrcv, flags);
+	if(ret >= 0 && rcv[0].rcvid == -1) {
+		rcv[0].rcvid = ret;
+		ret = 1;
+	}
+	return ret;
+}
+
+__SRCVERSION("msgreceivemulti_r.c $Rev: 153052 $");
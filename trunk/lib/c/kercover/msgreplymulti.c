@@ -0,0 +1,49 @@
+/*
+ * $QNXLicenseC:
+ * Copyright 2007, QNX Software Systems. All Rights Reserved.
+ * 
+ * You must obtain a written license from and pay applicable license fees to QNX 
+ * Software Systems before you may reproduce, modify or distribute this software, 
+ * or any work that includes all or part of this software.   Free development 
+ * licenses are available for evaluation and non-commercial purposes.  For more 
+ * information visit http://licensing.qnx.com or email licensing@qnx.com.
+ *  
+ * This file may contain contributions from others.  Please review this entire 
+ * file for other proprietary rights or license notices, as well as the QNX 
+ * Development Suite License Guide at http://licensing.qnx.com/license-guide/ 
+ * for other information.
+ * $
+ */
+
+
+
+
+#include <sys/neutrino.h>
+
+extern int __MsgReplyMulti(const struct _msg_reply_entry *rep, int nrep);
+
+/*
+ * The kernel stops at the first reply it can't do in the batch (a long
+ * reply, a client in another address space that hasn't been set up for
+ * it, a network connection...). That one goes through MsgReply() and the
+ * batch carries on after it. Returns the number of replies done; if that's
+ * less than nrep, errno is from the one that failed.
+ */
+int MsgReplyMulti(const struct _msg_reply_entry *rep, int nrep) {
+	int			done, ret;
+
+	for(done = 0; done < nrep; done += ret) {
+		if((ret = __MsgReplyMulti(rep + done, nrep - done)) == -1) {
+			return done ? done : -1;
+		}
+		if(ret == 0) {
+			if(MsgReply(rep[done].rcvid, rep[done].status, rep[done].msg, rep[done].bytes) == -1) {
+				return done ? done : -1;
+			}
+			ret = 1;
+		}
+	}
+	return done;
+}
+
+__SRCVERSION("msgreplymulti.c $Rev: 153052 $");
@@ -0,0 +1,42 @@
+/*
+ * $QNXLicenseC:
+ * Copyright 2007, QNX Software Systems. All Rights Reserved.
+ * 
+ * You must obtain a written license from and pay applicable license fees to QNX 
+ * Software Systems before you may reproduce, modify or distribute this software, 
+ * or any work that includes all or part of this software.   Free development 
+ * licenses are available for evaluation and non-commercial purposes.  For more 
+ * information visit http://licensing.qnx.com or email licensing@qnx.com.
+ *  
+ * This file may contain contributions from others.  Please review this entire 
+ * file for other proprietary rights or license notices, as well as the QNX 
+ * Development Suite License Guide at http://licensing.qnx.com/license-guide/ 
+ * for other information.
+ * $
+ */
+
+
+
+
+#include <sys/neutrino.h>
+
+extern int __MsgReplyMulti_r(const struct _msg_reply_entry *rep, int nrep);
+
+int MsgReplyMulti_r(const struct _msg_reply_entry *rep, int nrep) {
+	int			done, ret;
+
+	for(done = 0; done < nrep; done += ret) {
+		if((ret = __MsgReplyMulti_r(rep + done, nrep - done)) < 0) {
+			return done ? done : ret;
+		}
+		if(ret == 0) {
+			if((ret = MsgReply_r(rep[done].rcvid, rep[done].status, rep[done].msg, rep[done].bytes)) < 0) {
+				return done ? done : ret;
+			}
+			ret = 1;
+		}
+	}
+	return done;
+}
+
+__SRCVERSION("msgreplymulti_r.c $Rev: 153052 $");
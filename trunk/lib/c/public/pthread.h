@@ -130,6 +130,7 @@ __BEGIN_DECLS
 #define _NTO_SYNC_NOERRORCHECK	0x40000000	/* mutexes */
 #define _NTO_SYNC_PRIOCEILING	0x20000000	/* mutexes */
 #define _NTO_SYNC_PRIONONE		0x10000000	/* mutexes */
+#define _NTO_SYNC_ADAPTIVE		0x08000000	/* mutexes */
 #define _NTO_SYNC_COUNTMASK		0x00ffffff	/* mutexes */
 /* On owner */
 #define _NTO_SYNC_MUTEX_FREE	0x00000000	/*    0  mutexes, and old cond, sem, spin */
@@ -324,6 +325,10 @@ extern int pthread_setspecific(pthread_key_t __key, const void *__value);
 #define PTHREAD_ERRORCHECK_ENABLE			0x00
 #define PTHREAD_ERRORCHECK_DISABLE			0x04
 
+#define PTHREAD_ADAPTIVE_MASK			0x08
+#define PTHREAD_ADAPTIVE_DISABLE			0x00
+#define PTHREAD_ADAPTIVE_ENABLE				0x08
+
 #define _NTO_ATTR_FLAGS					0x0000ffff	/* These flags are verified for each type */
 
 #define _NTO_ATTR_MASK					0x000f0000
@@ -391,6 +396,9 @@ extern int pthread_mutex_unlock(pthread_mutex_t *__mutex);
 #if defined(__EXT_QNX)
 extern int pthread_mutexattr_getrecursive(const pthread_mutexattr_t *__attr, int *__recursive);
 extern int pthread_mutexattr_setrecursive(pthread_mutexattr_t *__attr, int __recursive);
+extern int pthread_mutexattr_getadaptive(const pthread_mutexattr_t *__attr, int *__adaptive);
+extern int pthread_mutexattr_setadaptive(pthread_mutexattr_t *__attr, int __adaptive);
+extern int pthread_mutex_setdefaultadaptive(int __adaptive);
 #endif
 #if defined(__EXT_XOPEN_EX)
 extern int pthread_mutexattr_gettype(const pthread_mutexattr_t *__attr, int *__type);
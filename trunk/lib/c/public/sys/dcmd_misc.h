@@ -34,6 +34,19 @@
 #define DCMD_MISC_MQGETATTR		__DIOF(_DCMD_MISC, 1, struct mq_attr)
 #define DCMD_MISC_MQSETATTR		__DIOT(_DCMD_MISC, 2, struct mq_attr)
 #define DCMD_MISC_MQSETCLOSEMSG	__DIOT(_DCMD_MISC, 4, struct { char __data[64];})
+#define DCMD_MISC_SEMPOST		__DION(_DCMD_MISC, 5)
+
+/*
+ * A named semaphore served by procnto may be mmap()ed MAP_SHARED from
+ * its descriptor to get at the count.  Tokens are taken and given with
+ * atomic operations on 'value'; 'waiters' counts the clients blocked in
+ * the server, which a poster wakes with DCMD_MISC_SEMPOST.
+ */
+struct _sem_shared {
+	volatile unsigned	value;
+	volatile unsigned	waiters;
+	unsigned			reserved[6];
+};
 
 #define _INTERACT_TYPE_POINTER       0x0001          /* pointer packet */
 #define _INTERACT_TYPE_KEY           0x0002          /* keyboard packet */
@@ -202,6 +202,7 @@ int sigwait_detach(dispatch_t *dpp, int signo, int flags);
  */
 
 #define DISPATCH_FLAG_NOLOCK		0x00000001
+#define DISPATCH_FLAG_BATCH			0x00000100	/* receive several short messages per kernel call */
 
 enum dispatch_type {
 	DISPATCH_ERROR = -1,
@@ -222,13 +223,15 @@ typedef union _dispatch_context {
 } dispatch_context_t;
 
 dispatch_t				*dispatch_create(void);
-dispatch_t				*dispatch_create_channel(int chid, unsigned reserved);
+dispatch_t				*dispatch_create_channel(int chid, unsigned flags);
 dispatch_context_t 		*dispatch_block(dispatch_context_t *ctp);
 void					dispatch_unblock(dispatch_context_t *ctp);
 int 					dispatch_handler(dispatch_context_t *ctp);
 int 					dispatch_timeout(dispatch_t *dpp, struct timespec *reltime);
 dispatch_context_t 		*dispatch_context_alloc(dispatch_t *dpp);
 void					dispatch_context_free(dispatch_context_t *ctp);
+int						dispatch_msgreplyv(dispatch_context_t *ctp, int rcvid, int status, const iov_t *iov, int parts);
+int						dispatch_msgreply_flush(dispatch_context_t *ctp);
 int 					dispatch_destroy(dispatch_t *dpp);
 
 dispatch_context_t *select_rearm(dispatch_context_t *ctp, int fd);
@@ -244,6 +247,8 @@ dispatch_context_t *select_rearm(dispatch_context_t *ctp, int fd);
 #define	POOL_FLAG_CHANGING		0x00000008
 #define POOL_FLAG_RESERVE     		0x00000010
 #define POOL_FLAG_CONTROL     	0x00000020
+#define POOL_FLAG_ADAPTIVE		0x00000040
+#define POOL_FLAG_CPU_AFFINITY	0x00000080
 
 typedef struct _thread_pool		thread_pool_t;
 
@@ -293,6 +298,29 @@ int				thread_pool_control(thread_pool_t *__pool, thread_pool_attr_t *__attr,
 int				thread_pool_limits(thread_pool_t *__pool, int __lowater, int __hiwater, 
 							         int __maximum, int __increment, unsigned __flags);
 
+/*
+ * With POOL_FLAG_ADAPTIVE, lo_water is only a floor and hi_water and
+ * maximum only ceilings; the pool keeps as many threads waiting as the
+ * observed message rate and service time call for. The values below are
+ * the ones currently in use.
+ */
+typedef struct _thread_pool_stats {
+	unsigned				created;
+	unsigned				waiting;
+	unsigned				lo_water;
+	unsigned				hi_water;
+	_Uint64t				messages;
+	_Uint64t				arrival_nsec;	/* average time between messages */
+	_Uint64t				service_nsec;	/* average time in handler_func */
+	_Uint64t				dry_nsec;		/* total time with no threads waiting */
+	unsigned				dry_count;		/* times the pool ran out of waiting threads */
+	unsigned				thread_creates;
+	unsigned				thread_exits;
+	unsigned				reserved[9];
+} thread_pool_stats_t;
+
+int				thread_pool_stats(thread_pool_t *__pool, thread_pool_stats_t *__stats);
+
 extern thread_pool_attr_t *thread_pool_attr_default;
 
 __END_DECLS
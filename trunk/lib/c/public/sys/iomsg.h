@@ -233,6 +233,7 @@ enum _io_connect_extra_type {
 #define _IO_CONNECT_RET_NOCTTY		0x00040000	/* No controling terminal defined  */
 #define _IO_CONNECT_RET_CHROOT		0x00080000	/* chroot_len field in link reply is valid */
 #define _IO_CONNECT_RET_MSG			0x00100000	/* Connect to server and send new message */
+#define _IO_CONNECT_RET_PREFIX		0x00200000	/* resolved_len field in link reply is valid */
 
 #define _IO_CONNECT_RET_TYPE_MASK	0x0001e000	/* Mask for returned file type */
 #define _IO_CONNECT_RET_FTYPE		0x00008000	/* File type was matched, _io_connect_ftype_reply expected */
@@ -244,7 +245,7 @@ enum _io_connect_extra_type {
 
 /* _io_connect reply redirecting resolution to other entries */
 struct _io_connect_link_reply {
-	_Uint32t					reserved1;
+	_Uint32t					resolved_len;	/* same servers for any path with these first bytes */
     _Uint32t                    file_type;      /*_FTYPE_? in sys/ftype.h */
 	_Uint8t						eflag;          /* _IO_CONNECT_EFLAG_? */
 	_Uint8t						reserved2[1];
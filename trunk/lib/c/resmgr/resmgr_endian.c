@@ -28,6 +28,7 @@
 #include <sys/dcmd_all.h>
 #include <sys/dcmd_blk.h>
 #include <sys/dcmd_chr.h>
+#include <sys/dispatch.h>
 #include <sys/iomsg.h>
 #include <sys/neutrino.h>
 #include <sys/pathmsg.h>
@@ -439,7 +440,7 @@ struct _xendian_context	*xendian;
 			return(-1);
 		}
 	}
-	return(MsgReplyv(ctp->rcvid, ctp->status, iov, parts));
+	return(dispatch_msgreplyv((dispatch_context_t *)ctp, ctp->rcvid, ctp->status, iov, parts));
 }
 
 int resmgr_msgreply(resmgr_context_t *ctp, void *ptr, int len)
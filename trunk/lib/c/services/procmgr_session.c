@@ -25,9 +25,12 @@
 #include <sys/procmgr.h>
 #include <sys/procmsg.h>
 #include <sys/netmgr.h>
+#include <sys/pathmsg.h>
+#include "connect.h"
 
 int procmgr_session(uint32_t nd, pid_t sid, int id, unsigned event) {
 	proc_session_t			msg;
+	int						ret;
 
 	// @@@@ Should make this work remotely
 	if(nd != ND_LOCAL_NODE) {
@@ -40,7 +43,13 @@ int procmgr_session(uint32_t nd, pid_t sid, int id, unsigned event) {
 	msg.i.id = id;	
 	msg.i.event = event;
 
-	return MsgSendnc(PROCMGR_COID, &msg.i, sizeof msg.i, 0, 0);
+	ret = MsgSendnc(PROCMGR_COID, &msg.i, sizeof msg.i, 0, 0);
+
+	// Whether we have a controlling terminal is part of proc's path resolutions
+	if(ret != -1 && (event == PROCMGR_SESSION_SETSID || event == PROCMGR_SESSION_TCSETSID)) {
+		_connect_cache_flush();
+	}
+	return ret;
 }
 
 __SRCVERSION("procmgr_session.c $Rev: 153052 $");
@@ -0,0 +1 @@
+int								__connect_cache;
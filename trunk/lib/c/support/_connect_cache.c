@@ -0,0 +1,300 @@
+/*
+ * $QNXLicenseC:
+ * Copyright 2007, QNX Software Systems. All Rights Reserved.
+ * 
+ * You must obtain a written license from and pay applicable license fees to QNX 
+ * Software Systems before you may reproduce, modify or distribute this software, 
+ * or any work that includes all or part of this software.   Free development 
+ * licenses are available for evaluation and non-commercial purposes.  For more 
+ * information visit http://licensing.qnx.com or email licensing@qnx.com.
+ *  
+ * This file may contain contributions from others.  Please review this entire 
+ * file for other proprietary rights or license notices, as well as the QNX 
+ * Development Suite License Guide at http://licensing.qnx.com/license-guide/ 
+ * for other information.
+ * $
+ */
+
+/*
+ * Client side cache of path manager resolutions.
+ *
+ * Every open(), stat() or spawn of an absolute path starts by asking the
+ * path manager (proc) which servers are mounted along it, and only then
+ * talks to those servers. The answer only changes when the pathname space
+ * does, and proc publishes a generation number in the system page that it
+ * bumps on every change, so a process that opens paths under the same
+ * mount points over and over can remember proc's answers and skip that
+ * round trip.
+ *
+ * proc's lookup walks its nodes until a component of the path has none,
+ * and the servers it returns depend only on how far it got. When it says
+ * so (_IO_CONNECT_RET_PREFIX), the answer is remembered against that much
+ * of the path, the resolved prefix, and is used for any other path that
+ * starts with it. "/usr/lib/libc.so" and "/usr/bin/ls" both stop at the
+ * "usr" under "/", so both are answered by one entry keyed on "/usr".
+ * Only paths without "." or ".." components, repeated or trailing slashes
+ * are matched this way, since proc rewrites those. Other answers (a path
+ * that ends on a node, like /dev/null, or a chrooted process) are keyed
+ * on the path as given.
+ *
+ * The cache is opt-in: it's enabled by having CONNECT_CACHE in the
+ * environment when the process starts. It's direct mapped, and the key
+ * includes the requested file type. Only plain opens and combine messages
+ * that don't create anything are answered from it, and only link replies
+ * naming servers on the local node are remembered.
+ *
+ * Some of proc's answer depends on the process rather than the pathname
+ * space: the root directory, the pid and whether it's a session leader
+ * without a controlling terminal. chroot() and procmgr_session() flush the
+ * cache, and a change of pid (fork) is noticed on the next lookup. A
+ * session leader that loses its controlling terminal some other way won't
+ * pick up a new one on a later open of a cached tty path.
+ *
+ * Lookups only ever try the lock, so a thread (or signal handler) that
+ * finds it held just goes to proc.
+ */
+
+#include <stdlib.h>
+#include <stddef.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <string.h>
+#include <pthread.h>
+#include <sys/syspage.h>
+#include <sys/pathmsg.h>
+#include <sys/netmgr.h>
+#include "connect.h"
+
+#define CONNECT_CACHE_ENTRIES	32		/* direct mapped (power of 2) */
+#define CONNECT_CACHE_PATHMAX	128		/* longest path remembered */
+#define CONNECT_CACHE_DATAMAX	384		/* server entries and resolved path */
+
+#define CONNECT_HASH_INIT		2166136261U
+#define CONNECT_HASH_STEP(h, c)	(((h) ^ (uint8_t)(c)) * 16777619U)
+
+struct connect_cache_entry {
+	unsigned						generation;		/* 0 if unused */
+	uint32_t						hash;
+	uint32_t						file_type;
+	int								status;
+	uint16_t						path_len;
+	uint16_t						data_len;
+	int								prefix;			/* path is a resolved prefix, data has no path */
+	struct _io_connect_link_reply	reply;
+	char							data[CONNECT_CACHE_DATAMAX];
+	char							path[CONNECT_CACHE_PATHMAX];
+};
+
+static struct connect_cache_entry	*connect_cache;
+static pid_t						connect_cache_pid;
+static pthread_mutex_t				connect_cache_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static unsigned connect_cache_generation(void) {
+	return ((volatile struct system_private_entry *)SYSPAGE_ENTRY(system_private))->pathmgr_generation;
+}
+
+static uint32_t connect_cache_hash(const char *path, unsigned len, uint32_t file_type) {
+	uint32_t						hash;
+
+	hash = CONNECT_HASH_INIT;
+	while(len--) {
+		hash = CONNECT_HASH_STEP(hash, *path++);
+	}
+	return hash ^ file_type;
+}
+
+/*
+ * Does proc see path exactly as it's written? It rewrites "." and ".."
+ * components and drops repeated and trailing slashes.
+ */
+static int connect_cache_plain(const char *path) {
+	const char						*end;
+
+	while(*path == '/') {
+		for(end = path + 1; *end != '/' && *end != '\0'; end++) {
+			/* nothing */
+		}
+		switch(end - path) {
+		case 1:
+			return 0;
+		case 2:
+			if(path[1] == '.') {
+				return 0;
+			}
+			break;
+		case 3:
+			if(path[1] == '.' && path[2] == '.') {
+				return 0;
+			}
+			break;
+		}
+		path = end;
+	}
+	return 1;
+}
+
+static struct connect_cache_entry *connect_cache_find(uint32_t hash, uint32_t file_type, unsigned gen,
+		const char *path, unsigned len, int prefix) {
+	struct connect_cache_entry		*cep;
+
+	cep = &connect_cache[hash & (CONNECT_CACHE_ENTRIES - 1)];
+	if(cep->generation == gen && cep->hash == hash && cep->file_type == file_type &&
+			cep->prefix == prefix && cep->path_len == len && memcmp(cep->path, path, len) == 0) {
+		return cep;
+	}
+	return NULL;
+}
+
+/*
+ * Look for proc's answer for path. If there is one, the link reply and
+ * buffer are filled in as proc would have and the connect status is
+ * returned. Otherwise -1 is returned and *genp is set to the generation
+ * to hand to _connect_cache_store() with proc's answer, or 0 if the
+ * request isn't one the cache deals with.
+ */
+int _connect_cache_lookup(struct _connect_ctrl *ctrl, const char *path, void *buffer, unsigned *genp) {
+	struct _io_connect				*msg = ctrl->msg;
+	struct _io_connect_link_reply	*reply = &ctrl->reply->link;
+	struct connect_cache_entry		*cep;
+	unsigned						gen, len, i;
+	uint32_t						hash;
+	int								status;
+
+	*genp = 0;
+	if(!__connect_cache || path[0] != '/' || msg->eflag != 0 || (msg->ioflag & O_CREAT) ||
+			(ctrl->flags & (FLAG_TEST_ENTRY | FLAG_TEST_ND_ONLY | FLAG_NO_RETRY))) {
+		return -1;
+	}
+	switch(msg->subtype) {
+	case _IO_CONNECT_OPEN:
+	case _IO_CONNECT_COMBINE:
+	case _IO_CONNECT_COMBINE_CLOSE:
+		break;
+	default:
+		return -1;
+	}
+	if((gen = connect_cache_generation()) == 0 || (len = strlen(path)) >= CONNECT_CACHE_PATHMAX) {
+		return -1;
+	}
+
+	if(pthread_mutex_trylock(&connect_cache_mutex) != EOK) {
+		return -1;
+	}
+	if(connect_cache_pid != getpid()) {
+		if(connect_cache) {
+			memset(connect_cache, 0x00, CONNECT_CACHE_ENTRIES * sizeof *connect_cache);
+		}
+		connect_cache_pid = getpid();
+	}
+	status = -1;
+	*genp = gen;
+	if(connect_cache) {
+		cep = connect_cache_find(connect_cache_hash(path, len, msg->file_type), msg->file_type, gen, path, len, 0);
+
+		// Try each leading run of components as a resolved prefix
+		if(cep == NULL && connect_cache_plain(path)) {
+			hash = CONNECT_HASH_INIT;
+			for(i = 0; cep == NULL && i < len; i++) {
+				hash = CONNECT_HASH_STEP(hash, path[i]);
+				if(i > 0 && (path[i + 1] == '/' || path[i + 1] == '\0')) {
+					cep = connect_cache_find(hash ^ msg->file_type, msg->file_type, gen, path, i + 1, 1);
+				}
+			}
+		}
+
+		if(cep && !cep->prefix && sizeof cep->reply + cep->data_len <= msg->reply_max) {
+			*reply = cep->reply;
+			memcpy(buffer, cep->data, cep->data_len);
+			status = cep->status;
+			*genp = 0;
+		} else if(cep && cep->prefix && sizeof cep->reply + cep->data_len + len + 1 < msg->reply_max) {
+			// proc would have sent the servers and the path as given
+			*reply = cep->reply;
+			reply->path_len = len + 1;
+			memcpy(buffer, cep->data, cep->data_len);
+			memcpy((char *)buffer + cep->data_len, path, len + 1);
+			status = cep->status;
+			*genp = 0;
+		}
+	}
+	pthread_mutex_unlock(&connect_cache_mutex);
+	return status;
+}
+
+/*
+ * Remember proc's answer for path, which it gave while the pathname
+ * space was at generation gen.
+ */
+void _connect_cache_store(struct _connect_ctrl *ctrl, const char *path, const void *buffer, unsigned gen) {
+	struct _io_connect_link_reply	*reply = &ctrl->reply->link;
+	const struct _io_connect_entry	*entry = buffer;
+	struct connect_cache_entry		*cep;
+	unsigned						len, data_len, i;
+	int								prefix;
+
+	if((ctrl->status & (_IO_CONNECT_RET_FLAG | _IO_CONNECT_RET_TYPE_MASK)) !=
+			(_IO_CONNECT_RET_FLAG | _IO_CONNECT_RET_LINK) || reply->nentries == 0) {
+		return;
+	}
+	for(i = 0; i < reply->nentries; i++) {
+		if(ND_NODE_CMP(entry[i].nd, ND_LOCAL_NODE) != 0) {
+			return;
+		}
+	}
+	len = strlen(path);
+	data_len = reply->nentries * sizeof *entry;
+
+	// Key it on the resolved prefix if proc gave one and sent back the path as it was
+	prefix = 0;
+	if((ctrl->status & _IO_CONNECT_RET_PREFIX) && reply->resolved_len > 1 && reply->resolved_len <= len &&
+			(path[reply->resolved_len] == '/' || path[reply->resolved_len] == '\0') &&
+			reply->path_len == len + 1 && memcmp((const char *)buffer + data_len, path, len) == 0 &&
+			connect_cache_plain(path)) {
+		prefix = 1;
+		len = reply->resolved_len;
+	} else {
+		data_len += reply->path_len;
+	}
+	if(data_len > CONNECT_CACHE_DATAMAX) {
+		return;
+	}
+
+	if(pthread_mutex_trylock(&connect_cache_mutex) != EOK) {
+		return;
+	}
+	if(connect_cache == NULL) {
+		connect_cache = calloc(CONNECT_CACHE_ENTRIES, sizeof *connect_cache);
+	}
+	if(connect_cache != NULL && connect_cache_pid == getpid()) {
+		uint32_t						hash = connect_cache_hash(path, len, ctrl->msg->file_type);
+
+		cep = &connect_cache[hash & (CONNECT_CACHE_ENTRIES - 1)];
+		cep->generation = gen;
+		cep->hash = hash;
+		cep->file_type = ctrl->msg->file_type;
+		/* The umask is only wanted when creating, which is never cached */
+		cep->status = ctrl->status & ~(_IO_CONNECT_RET_UMASK | _IO_CONNECT_RET_PREFIX);
+		cep->prefix = prefix;
+		cep->path_len = len;
+		cep->data_len = data_len;
+		cep->reply = *reply;
+		memcpy(cep->data, buffer, data_len);
+		memcpy(cep->path, path, len);
+	}
+	pthread_mutex_unlock(&connect_cache_mutex);
+}
+
+/*
+ * Something about the process that proc's answers depend on has changed.
+ */
+void _connect_cache_flush(void) {
+	if(connect_cache == NULL) {
+		return;
+	}
+	pthread_mutex_lock(&connect_cache_mutex);
+	memset(connect_cache, 0x00, CONNECT_CACHE_ENTRIES * sizeof *connect_cache);
+	pthread_mutex_unlock(&connect_cache_mutex);
+}
+
+__SRCVERSION("_connect_cache.c $Rev: 153052 $");
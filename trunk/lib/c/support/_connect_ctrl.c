@@ -203,15 +203,30 @@ static int _connect_request(struct _connect_ctrl *ctrl, const char *prefix, unsi
 	register struct _io_connect_link_reply	*reply = &(ctrl->reply->link);
 	register int							fd;
 	int										ftype;
+	int										cached;
+	unsigned								cache_gen;
 
-	if((fd = ConnectAttach(entry->nd, entry->pid, entry->chid, ctrl->base, _NTO_COF_CLOEXEC)) != -1) {
-		msg->handle = entry->handle;
-		msg->eflag = reply->eflag;
+	msg->handle = entry->handle;
+	msg->eflag = reply->eflag;
+
+	//Proc's answer for an absolute path may already be known (see _connect_cache.c)
+	cached = -1;
+	cache_gen = 0;
+	if(entry == &_connect_proc_entry && !prefix) {
+		cached = _connect_cache_lookup(ctrl, path + path_skip, buffer, &cache_gen);
+	}
+
+	if(cached != -1 || (fd = ConnectAttach(entry->nd, entry->pid, entry->chid, ctrl->base, _NTO_COF_CLOEXEC)) != -1) {
+		if(cached != -1) {
+			ctrl->status = cached;
+			fd = -1;
 
 		//Get the status of the node in question along with all of the node entries associated with it
-		if((ctrl->status = _connect_io(ctrl, fd, prefix, prefix_len, path + path_skip, buffer, entry)) == -1) {
+		} else if((ctrl->status = _connect_io(ctrl, fd, prefix, prefix_len, path + path_skip, buffer, entry)) == -1) {
 			ConnectDetach_r(fd);
 			return(-1);
+		} else if(cache_gen) {
+			_connect_cache_store(ctrl, path + path_skip, buffer, cache_gen);
 		}
 
 		//Do we want any particular type of server connections, otherwise use what we got
@@ -233,7 +248,9 @@ static int _connect_request(struct _connect_ctrl *ctrl, const char *prefix, unsi
 		if((ctrl->status & (_IO_CONNECT_RET_FLAG | _IO_CONNECT_RET_TYPE_MASK)) ==
 		                   (_IO_CONNECT_RET_FLAG | _IO_CONNECT_RET_LINK)) {
 
-			ConnectDetach_r(fd);
+			if(fd != -1) {
+				ConnectDetach_r(fd);
+			}
 
 			//Nuke the chroot_len reply field if that flag not set
 			if(!(ctrl->status & _IO_CONNECT_RET_CHROOT)) {
@@ -74,6 +74,7 @@ extern int						__ealready_value;
 extern int						_Multi_threaded;
 extern int						__posixly_correct;
 extern int						__dir_keep_symlink;
+extern int						__connect_cache;
 
 extern void 					__my_thread_exit(void *);
 
@@ -159,6 +160,9 @@ void _init_libc(int argc, char *argv[], char *arge[], auxv_t auxv[], void (*exit
 		if (getenv("DIR_KEEP_SYMLINK") != NULL) {
 			__dir_keep_symlink = 1;
 		}
+		if (getenv("CONNECT_CACHE") != NULL) {
+			__connect_cache = 1;
+		}
 		if (SYSPAGE_ENTRY(system_private)->private_flags & SYSTEM_PRIVATE_FLAG_EALREADY_NEW) {
 			__ealready_value = EALREADY_NEW;
 		} else {
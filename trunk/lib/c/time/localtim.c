@@ -103,7 +103,7 @@ long _Tzoff_dst(void)
 struct tm *(localtime)(const time_t *tod)
 	{	/* convert to local time structure */
 #ifdef __QNX__
-	_Tzset();
+	/* _Ttotm() picks up any change to TZ */
 	return (_Ttotm(0, *tod, -1, __LOCALTIME_CALL));
 #else
 	return (_Ttotm(0, *tod + _Tzoff(), -1));
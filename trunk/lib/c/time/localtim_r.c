@@ -32,7 +32,7 @@ _STD_BEGIN
 struct tm *(localtime_r)(const time_t *tod, struct tm *t)
 	{	/* convert to local time structure */
 #ifdef __QNX__
-	_Tzset();
+	/* _Ttotm() picks up any change to TZ */
 	return (_Ttotm(t, *tod, -1, __LOCALTIME_CALL));
 #else
 	return (_Ttotm(t, *tod + _Tzoff(), -1));
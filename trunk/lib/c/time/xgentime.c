@@ -356,7 +356,9 @@ const char *_Gentime(const struct tm *t, const _Tinfo *tin,
     		val = strtol(p, 0, 10);
     		if (0 < *pn && 0 < t->tm_isdst)
     		{   /* adjust time zone offset for DST */
-        		val += (_Tzoff_dst()-_Tzoff());
+        		const _Tzrules *tzp = _Tzget();
+
+        		val += (tzp->tzoffdst - tzp->tzoff);
     		}
     		val = (val/3600)*100+(val % 3600)/60;
     		if (0 <= val)
@@ -66,17 +66,73 @@ _TLS_DATA_DEF_DT(static, rules_t, rules, 0, free_tls);
 #endif
 
 #ifdef __QNX__
-int _Isdst(const struct tm *t, long tzoff, long tzoffdst)
+long _Dstsecs(const Dstrule *rule, int year)
+	{	/* seconds from the start of year (as tm_year) to rule */
+	long secs;
+	int leapyear;
+	int j;
+	int d, m1, yy0, yy1, yy2, dow;
+
+	secs = 0L;
+	leapyear = ISLEAP(year+1900);
+	switch (rule->rtype) {
+		case JTYPE: // Julian day type 
+			secs = (rule->day - 1) * SECSPERDAY;
+			if (leapyear && rule->day >= 60)
+				secs += SECSPERDAY;
+			break;
+		case ZTYPE: // Zero Julian day type
+			secs = rule->day * SECSPERDAY;
+			break;
+		case MTYPE: // Month type
+			secs = 0;
+			for (j = 0; j < rule->mon - 1; ++j)
+				secs += mon_lengths[leapyear][j] * SECSPERDAY;
+			/*
+			** Use Zeller's Congruence to get day-of-week of first day of
+			** month.
+			*/
+			m1 = (rule->mon + 9) % 12 + 1;
+			yy0 = (rule->mon <= 2) ? (year - 1) : year;
+			yy0 += 1900; // normalise year 
+			yy1 = yy0 / 100;
+			yy2 = yy0 % 100;
+			dow = ((26 * m1 - 2) / 10 +
+				1 + yy2 + yy2 / 4 + yy1 / 4 - 2 * yy1) % 7;
+			if (dow < 0)
+				dow += DAYSPERWEEK;
+			/*
+			** "dow" is the day-of-week of the first day of the month.  Get
+			** the day-of-month (zero-origin) of the first "dow" day of the
+			** month.
+			*/
+			d = rule->day - dow;
+			if (d < 0)
+				d += DAYSPERWEEK;
+			for (j = 1; j < rule->week; ++j) {
+				if (d + DAYSPERWEEK >= mon_lengths[leapyear][rule->mon - 1])
+					break;
+				d += DAYSPERWEEK;
+			}
+			/*
+			** "d" is the day-of-month (zero-origin) of the day we want.
+			*/
+			secs += d * SECSPERDAY;
+			break;
+		default:
+			break;
+	}
+	return (secs + rule->secs);
+	}
+
+int _Isdst(const struct tm *t, const _Tzrules *tzp, long tzoff, long tzoffdst)
 #else
 int _Isdst(const struct tm *t)
 #endif
 	{	/* test whether Daylight Savings Time in effect */
 #ifdef __QNX__
-	Dstrule *rules;
-	int  dst_state;
-	
-	if ((rules = _Getrules(&dst_state)) == NULL)
-		return dst_state;
+	if (tzp->dst_state <= 0)
+		return tzp->dst_state;
 #else
 	Dstrule *pr;
 	dst_t *polddst = _TLS_DATA_PTR(olddst);
@@ -108,63 +164,16 @@ int _Isdst(const struct tm *t)
     int south = 0;  // southern hemisphere (where start > end)
     int START = 0, END = 1;
 		long seconds[2]; // in secs, from beginning of year
-		int leapyear;
-		int i,j;	
-		int d, m1, yy0, yy1, yy2, dow;
 		long currsecs; // seconds from beginning of year for current time
-
-		seconds[0] = 0L;
-		seconds[1] = 0L;
-		leapyear = ISLEAP(t->tm_year+1900);
-   	for (i=0; i < 2; i++) {
-			switch ((rules[i]).rtype) {
-				case JTYPE: // Julian day type 
-          seconds[i] = ((rules[i]).day - 1) * SECSPERDAY;
-          if (leapyear && (rules[i]).day >= 60)
-            seconds[i] += SECSPERDAY;
-					break;
-				case ZTYPE: // Zero Julian day type
-          seconds[i] = (rules[i]).day * SECSPERDAY;
-          break;
-				case MTYPE: // Month type
-          seconds[i] = 0;
-          for (j = 0; j < (rules[i]).mon - 1; ++j)
-            seconds[i] += mon_lengths[leapyear][j] * SECSPERDAY;
-          /*
-          ** Use Zeller's Congruence to get day-of-week of first day of
-          ** month.
-          */
-          m1 = ((rules[i]).mon + 9) % 12 + 1;
-          yy0 = ((rules[i]).mon <= 2) ? (t->tm_year - 1) : t->tm_year;
-					yy0 += 1900; // normalise year 
-          yy1 = yy0 / 100;
-          yy2 = yy0 % 100;
-          dow = ((26 * m1 - 2) / 10 +
-            1 + yy2 + yy2 / 4 + yy1 / 4 - 2 * yy1) % 7;
-          if (dow < 0)
-            dow += DAYSPERWEEK;
-          /*
-          ** "dow" is the day-of-week of the first day of the month.  Get
-          ** the day-of-month (zero-origin) of the first "dow" day of the
-          ** month.
-          */
-          d = (rules[i]).day - dow;
-          if (d < 0)
-            d += DAYSPERWEEK;
-          for (j = 1; j < (rules[i]).week; ++j) {
-            if (d + DAYSPERWEEK >= mon_lengths[leapyear][(rules[i]).mon - 1])
-                break;
-            d += DAYSPERWEEK;
-          }
-          /*
-          ** "d" is the day-of-month (zero-origin) of the day we want.
-          */
-          seconds[i] += d * SECSPERDAY;
-					break;
-				default:
-					break;
-			}
-			seconds[i] += (rules[i]).secs;
+		int y;
+
+		y = t->tm_year - _TZ_YEAR0;
+		if (0 <= y && y < _TZ_NYEARS) {
+			seconds[START] = tzp->trans[y][START];
+			seconds[END] = tzp->trans[y][END];
+		} else {
+			seconds[START] = _Dstsecs(&tzp->rules[START], t->tm_year);
+			seconds[END] = _Dstsecs(&tzp->rules[END], t->tm_year);
 		}
 		// check to see if start > end 
 		if (seconds[START] > seconds[END])
@@ -108,6 +108,7 @@ struct tm *_Ttotm(struct tm *t, time_t secsarg, int isdst)
 #endif
 	{	/* convert scalar time to time structure */
 #ifdef __QNX__
+	const _Tzrules *tzp;
 	long tzoffdst;
 	long tzoff;
 	static struct tm ts;
@@ -115,21 +116,22 @@ struct tm *_Ttotm(struct tm *t, time_t secsarg, int isdst)
 	uint64_t secs;
 
 	lsecsarg = _TBIAS + (uint64_t)secsarg;
-	tzoffdst = _Tzoff_dst();
+	tzp = _Tzget();
+	tzoffdst = tzp->tzoffdst;
 	if (t == 0)
 		t = &ts;
 	t->tm_isdst = isdst;
 	switch (ct) {
 		case __GMTIME_CALL:
 			t = adjust_tm(lsecsarg, t);
-			t->tm_zone = tzname[(0 < t->tm_isdst ? 1 : 0)];
+			t->tm_zone = tzp->name[(0 < t->tm_isdst ? 1 : 0)];
 			t->tm_gmtoff = 0;
 			break;
 		case __LOCALTIME_CALL:
-			tzoff = _Tzoff();
+			tzoff = tzp->tzoff;
 			secs = lsecsarg + tzoff;
 			t = adjust_tm(secs, t);
-			t->tm_isdst = _Isdst(t, tzoff, tzoffdst); 
+			t->tm_isdst = _Isdst(t, tzp, tzoff, tzoffdst); 
 			if (t->tm_isdst > 0) { // 
 				secs = lsecsarg + tzoffdst;
 				t = adjust_tm(secs, t);
@@ -137,24 +139,23 @@ struct tm *_Ttotm(struct tm *t, time_t secsarg, int isdst)
 			}
 			else 
 				t->tm_gmtoff = tzoff;
-			t->tm_zone = tzname[(0 < t->tm_isdst ? 1 : 0)];
+			t->tm_zone = tzp->name[(0 < t->tm_isdst ? 1 : 0)];
 			break;
 		case __MKTIME_CALL:
-			tzoff = _Tzoff();
+			tzoff = tzp->tzoff;
 			t = adjust_tm(lsecsarg, t);
 			if (isdst == 0) { // isdst == 0
 				t->tm_isdst = isdst;
 			}
 			else {
-				int  dst_state;
-				if (_Getrules(&dst_state) == NULL)
+				if (tzp->dst_state <= 0)
 					t->tm_isdst = 0;
 				else	if (isdst <= 0)
-					t->tm_isdst = _Isdst(t, 0, 0);
+					t->tm_isdst = _Isdst(t, tzp, 0, 0);
 			}
 
 			/* set up proper zone */
-			t->tm_zone = tzname[(0 < t->tm_isdst ? 1 : 0)];
+			t->tm_zone = tzp->name[(0 < t->tm_isdst ? 1 : 0)];
 			if (t->tm_isdst > 0) // dst is on
 				t->tm_gmtoff = tzoffdst;
 			else 
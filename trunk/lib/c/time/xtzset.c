@@ -251,6 +251,170 @@ static char *reformat(const char *s)
 #endif
 
 static const char *defzone = ":";
+
+#ifdef __QNX__
+#include <pthread.h>
+#include <stdio.h>
+#include <sys/cpuinline.h>
+
+#define TZBUFSIZE	128	/* room for the default zone on the fast path */
+
+/*
+ * Each TZ string seen is parsed once into a _Tzrules, along with the
+ * daylight time transitions for each year in its table. They're never
+ * changed or freed once tzcur has pointed at them, so localtime_r(),
+ * mktime() and strftime() read them without taking tzset_mutex; the
+ * mutex is only taken when TZ doesn't match the current rules.
+ */
+static pthread_mutex_t tzset_mutex = PTHREAD_RMUTEX_INITIALIZER;
+static _Tzrules *tzlist;	/* every set of rules made, newest first */
+static _Tzrules *volatile tzcur;	/* the ones in use */
+static const _Tzrules tznone = {0, "", ":", {"", ""}};
+
+static const char *curtz(char *buf, size_t size)
+	{	/* get TZ or the default zone; NULL if the default won't fit in buf */
+	const char *tz;
+
+	if ((tz = getenv("TZ")) == 0)
+		{	/* Pick a default timezone */
+#ifdef _CS_TIMEZONE
+		size_t len;
+
+		if ((len = confstr(_CS_TIMEZONE, buf, size)) > size)
+			return (0);
+		if (len > 0)
+			tz = buf;
+		else
+#endif
+			tz = "UTC0";
+		}
+	return (tz);
+	}
+
+static _Tzrules *newrules(const char *tz)
+	{	/* parse tz, leaving _Times pointing at the result */
+	_Tzrules *tzp;
+	const char *s, *p;
+	Dstrule *pr;
+	int i, y, pn;
+
+	if ((s = reformat(tz)) == 0)
+		s = defzone;
+	if ((tzp = (_Tzrules *)calloc(1, sizeof (*tzp))) == 0)
+		return (0);
+	if ((tzp->tzstr = strdup(tz)) == 0
+		|| (tzp->tzone = strdup(s)) == 0)
+		{
+		free((void *)tzp->tzstr);
+		free(tzp);
+		return (0);
+		}
+
+	_Times._Tzone = tzp->tzone;
+	_Times._Isdst = "";
+	tzp->tzoff = _Tzoff();
+	tzp->tzoffdst = _Tzoff_dst();
+	if ((pr = _Getrules(&tzp->dst_state)) != 0)
+		{	/* remember the rules, and when they fall in each year */
+		tzp->rules[0] = pr[0];
+		tzp->rules[1] = pr[1];
+		for (y = 0; y < _TZ_NYEARS; ++y)
+			for (i = 0; i < 2; ++i)
+				tzp->trans[y][i] = _Dstsecs(&tzp->rules[i], _TZ_YEAR0 + y);
+		}
+
+	for (i = 0; i < 2; ++i)
+		{
+		p = _Gettime(tzp->tzone, i, &pn);
+		if (pn <= 0 || (tzp->name[i] = malloc(pn + 1)) == 0)
+			tzp->name[i] = "";
+		else
+			memcpy(tzp->name[i], p, pn), tzp->name[i][pn] = '\0';
+		}
+	tzp->daylight = _Times._Isdst[0] != '\0' && pn > 0;
+	return (tzp);
+	}
+
+char	*tzname[2];
+long	timezone;
+int		daylight;
+
+static char *(__Tzset)(void)
+	{	/* make the rules for TZ current; called with tzset_mutex held */
+	_Tzrules *tzp;
+	const char *tz;
+	char buf[TZBUFSIZE];
+
+	if ((tz = curtz(buf, sizeof (buf))) == 0)
+		{	/* default zone is long, get all of it */
+#ifdef _CS_TIMEZONE
+		size_t len, len2;
+		char *tmp;
+
+		for (;;) {
+			if ((len = confstr(_CS_TIMEZONE, 0, 0)) > 0 && (tmp = alloca(len + 1)) != NULL) {
+				if ((len2 = confstr(_CS_TIMEZONE, tmp, len + 1)) > len)
+					continue;
+				tz = tmp;
+			}
+			break;
+		}
+		if (!tz)
+#endif
+			tz = "UTC0";
+		}
+
+	if ((tzp = tzcur) != 0 && strcmp(tzp->tzstr, tz) == 0)
+		return (tzp->tzone);
+
+	for (tzp = tzlist; tzp != 0; tzp = tzp->next)
+		if (strcmp(tzp->tzstr, tz) == 0)
+			break;
+	if (tzp == 0)
+		{	/* haven't seen this one before */
+		if ((tzp = newrules(tz)) == 0)
+			return (tzcur != 0 ? tzcur->tzone : (char *)defzone);
+		tzp->next = tzlist;
+		tzlist = tzp;
+		}
+
+	_Times._Tzone = tzp->tzone;
+	_Times._Isdst = "";
+	timezone = -tzp->tzoff;
+	tzname[0] = tzp->name[0];
+	tzname[1] = tzp->name[1];
+	daylight = tzp->daylight;
+
+	/* everything in *tzp must be visible before the pointer is */
+	__cpu_membarrier();
+	tzcur = tzp;
+	return (tzp->tzone);
+	}
+
+const _Tzrules *_Tzget(void)
+	{	/* get the current rules, only locking if TZ has changed */
+	const _Tzrules *tzp;
+	const char *tz;
+	char buf[TZBUFSIZE];
+
+	if ((tzp = tzcur) == 0 || (tz = curtz(buf, sizeof (buf))) == 0
+		|| strcmp(tz, tzp->tzstr) != 0)
+		{
+		if (_Multi_threaded) pthread_mutex_lock(&tzset_mutex);
+		(void)__Tzset();
+		if (_Multi_threaded) pthread_mutex_unlock(&tzset_mutex);
+		if ((tzp = tzcur) == 0)
+			tzp = &tznone;
+		}
+	return (tzp);
+	}
+
+char *(_Tzset)(void)
+	{	/* set time zone information */
+	return (_Tzget()->tzone);
+	}
+
+#else
 static char *tzone;
 static char *tzstr;
 
@@ -302,19 +466,10 @@ char	*tzname[2];
 long	timezone;
 int		daylight;
 
-#ifdef __QNX__
-char *(__Tzset)(void) {
-#else
 char *(_Tzset)(void) {
-#endif
 	int pn;
 	const char *p;
-#ifdef __QNX__
-	int i;
-	char *oldtz, *newtz;
-#else
 	char **tz;
-#endif
 
 	if(learnzone())
 		return tzone;
@@ -324,19 +479,6 @@ char *(_Tzset)(void) {
 	timezone = -_Tzoff();
 	(void)_Getrules(NULL);
 
-#ifdef __QNX__
-	for (i = 0; i < 2; ++i) {
-		oldtz = tzname[i];
-		p = _Gettime(_Times._Tzone, i, &pn);
-		if (pn <= 0)
-			newtz = NULL;
-		else if ((newtz = malloc(pn + 1)) != NULL)
-			memcpy(newtz, p, pn), newtz[pn] = '\0';
-		tzname[i] = (newtz != NULL) ? newtz : "";
-		if (oldtz != NULL && *oldtz != '\0')
-			free(oldtz);
-	}
-#else
 	p = _Gettime(_Times._Tzone, 0, &pn);
 	tz = &tzname[0];
 	if(*tz && (*tz)[0])
@@ -354,26 +496,11 @@ char *(_Tzset)(void) {
 		memcpy(*tz, p, pn), (*tz)[pn] = '\0';
 	else
 		*tz = "";
-#endif
 
 	daylight = _Times._Isdst[0] != '\0' && pn > 0;
 
 	return tzone;
 }
-
-#ifdef __QNX__
-#include <pthread.h>
-#include <stdio.h>
-static pthread_mutex_t tzset_mutex = PTHREAD_RMUTEX_INITIALIZER;
-
-char *(_Tzset)(void) {
-char *tzsetp;
-
-	if (_Multi_threaded) pthread_mutex_lock(&tzset_mutex);
-	tzsetp = __Tzset();
-	if (_Multi_threaded) pthread_mutex_unlock(&tzset_mutex);
-	return(tzsetp);
-}
 #endif
 
 _STD_END
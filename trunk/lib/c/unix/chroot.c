@@ -86,7 +86,10 @@ int chroot(const char *path) {
 	msg.path_len = strlen(buffer) + 1;
 	SETIOV(iov + 0, &msg, offsetof(struct _io_connect, path));
 	SETIOV(iov + 1, buffer, msg.path_len);
-	return MsgSendv(PATHMGR_COID, iov, 2, 0, 0);
+	if((fd = MsgSendv(PATHMGR_COID, iov, 2, 0, 0)) != -1) {
+		_connect_cache_flush();
+	}
+	return fd;
 }
 
 __SRCVERSION("chroot.c $Rev: 153052 $");
@@ -31,8 +31,14 @@
 #include <stdio.h>
 #include <string.h>
 #include <ctype.h>
+#include <sys/stat.h>
 #include <libelf_int.h>
 
+#if !defined(__WIN32__) && !defined(__NT__)
+#define ELF_HAVE_MMAP
+#include <sys/mman.h>
+#endif
+
 //
 // This is for Solaris, because min is not defined in sun's stdlib.h
 //
@@ -51,6 +57,18 @@ static int _elf_read(Elf *elf, void *buf, off_t offset, size_t bytes) {
 		return 0;
 	}
 
+	if(elf->e_map) {
+		offset += elf->e_offset;
+		if(offset < 0 || offset >= elf->e_mapsize) {
+			return 0;
+		}
+		if(bytes > elf->e_mapsize - offset) {
+			bytes = elf->e_mapsize - offset;
+		}
+		memcpy(buf, elf->e_map + offset, bytes);
+		return bytes;
+	}
+
 	if(elf->e_curroffset != (elf->e_offset + offset)) {
 		if(lseek(elf->e_fd, elf->e_offset + offset, SEEK_SET) < 0) {
 			return -1;
@@ -106,6 +124,49 @@ static int _elf_fill(Elf *elf, off_t offset, size_t bytes) {
 	return bytes - towrite;
 }
 
+/*
+ * Map the whole file read-only for ELF_C_READ_MMAP. If it can't be
+ * mapped we quietly fall back to reading it like ELF_C_READ.
+ */
+static int _elf_map(Elf *elf) {
+#ifdef ELF_HAVE_MMAP
+	struct stat		st;
+	void			*map;
+
+	if(fstat(elf->e_fd, &st) == -1 || !S_ISREG(st.st_mode) || st.st_size == 0) {
+		return 0;
+	}
+	if((map = mmap(0, st.st_size, PROT_READ, MAP_PRIVATE, elf->e_fd, 0)) == MAP_FAILED) {
+		return 0;
+	}
+	elf->e_map = map;
+	elf->e_mapsize = st.st_size;
+	return 1;
+#else
+	return 0;
+#endif
+}
+
+/*
+ * Section types that Elf32_swap*() rewrites in place when the file
+ * isn't in host byte order.
+ */
+static int _elf_scn_swapped(Elf *elf, Elf32_Word type) {
+	if(!elf->xlat) {
+		return 0;
+	}
+	switch(type) {
+	case SHT_DYNSYM:
+	case SHT_SYMTAB:
+	case SHT_REL:
+	case SHT_RELA:
+		return 1;
+	default:
+		break;
+	}
+	return 0;
+}
+
 static int _elf_is_archive(Elf *elf) {
 	char			ident[SARMAG];
 	struct ar_hdr	arhdr;
@@ -280,6 +341,13 @@ static int _elf_destroy(Elf *elf) {
 		free(elf->e_rawfile);
 	}
 
+#ifdef ELF_HAVE_MMAP
+	// archive members share the mapping of the archive
+	if(elf->e_map && elf->e_archive == NULL) {
+		munmap(elf->e_map, elf->e_mapsize);
+	}
+#endif
+
 	if(elf->e_arhdrp) {
 		if(elf->e_arhdrp->ar_name) {
 			free(elf->e_arhdrp->ar_name);
@@ -419,11 +487,16 @@ Elf *elf_begin(int fd, Elf_Cmd cmd, Elf *ref) {
 
 	case ELF_C_RDWR:
 	case ELF_C_READ:
+	case ELF_C_READ_MMAP:
 		if(!ref) {
 			if(!(elf = _elf_create(fd))) {
 				return 0;
 			}
 
+			if(cmd == ELF_C_READ_MMAP) {
+				_elf_map(elf);
+			}
+
 			if(!_elf_is_archive(elf)) {
 				char		*e_ident;
 				size_t		size;
@@ -441,6 +514,8 @@ Elf *elf_begin(int fd, Elf_Cmd cmd, Elf *ref) {
 
 				elf->e_archive = ref;
 				elf->e_offset = ref->e_offset;
+				elf->e_map = ref->e_map;
+				elf->e_mapsize = ref->e_mapsize;
 
 				if(!(arhdr = elf_getarhdr(elf))) {
 					elf_end(elf);
@@ -719,6 +794,22 @@ char *elf_rawfile(Elf *elf, size_t *ptr) {
 	if(!elf->e_rawfile) {
 		Elf_Arhdr			*arhdr;
 
+		if(elf->e_map) {
+			// Point straight into the mapping, nothing to free later
+			if(arhdr = elf_getarhdr(elf)) {
+				if(elf->e_offset + arhdr->ar_size > elf->e_mapsize) {
+					return 0;
+				}
+				if(ptr) {
+					*ptr = arhdr->ar_size;
+				}
+				return elf->e_map + elf->e_offset;
+			}
+			if(ptr) {
+				*ptr = elf->e_mapsize;
+			}
+			return elf->e_map;
+		}
 		if(arhdr = elf_getarhdr(elf)) {
 			if(!(elf->e_rawfile = malloc(arhdr->ar_size))) {
 				return 0;
@@ -1171,12 +1262,21 @@ Elf_Data *elf_getdata(Elf_Scn *scn, Elf_Data *data) {
 					if(dp = _elf32_newdata(scn, shdr.sh_size)) {
 						_elf_read(scn->s_elf, dp->d_buf, shdr.sh_offset, shdr.sh_size);
 #else
-					if(dp = _elf32_newdata(scn, shdr.sh_type == SHT_NOBITS ? 0 : shdr.sh_size)) {
+					if(elf->e_map && shdr.sh_type != SHT_NOBITS && !_elf_scn_swapped(elf, shdr.sh_type)
+							&& elf->e_offset + shdr.sh_offset + shdr.sh_size <= elf->e_mapsize) {
+						/* point into the mapping rather than copying the section */
+						if(dp = _elf32_newdata(scn, 0)) {
+							dp->d_buf = elf->e_map + elf->e_offset + shdr.sh_offset;
+							dp->d_size = shdr.sh_size;
+						}
+					} else if(dp = _elf32_newdata(scn, shdr.sh_type == SHT_NOBITS ? 0 : shdr.sh_size)) {
 						if(shdr.sh_type == SHT_NOBITS) {
 							dp->d_size = shdr.sh_size;
 						} else {
 							_elf_read(scn->s_elf, dp->d_buf, shdr.sh_offset, shdr.sh_size);
 						}
+					}
+					if(dp) {
 #endif
 
 						switch(shdr.sh_type) {
@@ -48,6 +48,7 @@ typedef enum {
 	ELF_C_FDDONE,
 	ELF_C_FDREAD,
 	ELF_C_RDWR,
+	ELF_C_READ_MMAP,
 	ELF_C_NUM
 } Elf_Cmd;
 
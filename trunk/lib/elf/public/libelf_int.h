@@ -74,6 +74,9 @@ struct Elf {
 
 	char			*e_rawfile;
 
+	char			*e_map;			/* read-only file mapping (ELF_C_READ_MMAP) */
+	size_t			e_mapsize;
+
 	Elf_Arsym		*e_arsymp;
 	unsigned		e_numsyms;
 
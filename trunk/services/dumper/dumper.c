@@ -41,6 +41,8 @@
 #include <sys/slog.h>
 #include <sys/slogcodes.h>
 #include <sys/resource.h>
+#include <sys/syspage.h>
+#include <time.h>
 
 static iofunc_attr_t			attr;
 static resmgr_connect_funcs_t	connect;
@@ -52,9 +54,11 @@ pid_t		match_pid = -1;
 char		*dump_dir, *dump_path;
 uintptr_t	pagesize;
 char		*membuf;
+size_t		membufsize;
 pthread_t	cur_tid = 0;
 int			verbose = 0;
 int         gzlevel = -1;
+int         gzthreads = 0;
 
 long	max_core_size = RLIM_INFINITY;
 int		sequential_dumps = 0;
@@ -65,6 +69,18 @@ int 	world_readable = 0;
 
 #define vprintf(x) { if (verbose) printf x; }
 
+/* process memory is read this many pages at a time */
+#define DUMP_READ_PAGES		16
+
+/* per-dump counters for the summary logged when a dump completes */
+static struct {
+	uint64_t			nread;		/* bytes read from /proc/<pid>/as */
+	uint64_t			nwritten;	/* bytes handed to the output */
+	uint64_t			nsparse;	/* zero bytes left as holes */
+	off_t				extent;		/* end of the last hole */
+	struct timespec		start, mem, end;
+} dump_stats;
+
 #define roundup(x, y)  ((((x)+((y)-1))/(y))*(y))
 
 #ifndef NDEBUG
@@ -77,6 +93,11 @@ int dumper_close_ocb(resmgr_context_t *ctp, void *reserved, iofunc_ocb_t *ocb);
 int dumper_devctl(resmgr_context_t *ctp, io_devctl_t *msg, iofunc_ocb_t *ocb);
 void DeliverNotifies(pid_t pid);
 int get_ldd_mapinfos(int fd, procfs_mapinfo **infos, int *ninfos);
+int gzpipe_init(int nthreads, int level);
+void gzpipe_start(FILE *fp);
+int gzpipe_write(const void *buf, unsigned len);
+off_t gzpipe_tell(void);
+int gzpipe_finish(void);
 
 #define OFFENDING_THREAD(base, size, mapinfoptr) ((mapinfoptr)->vaddr >= base && \
 						(mapinfoptr)->vaddr < (base + size))
@@ -86,7 +107,7 @@ off_t dump_tell( FILE *fp )
 	if (gzlevel == -1) {
 		return ftell(fp);
 	} else {
-		return gztell((gzFile)fp);
+		return gzpipe_tell();
 	}
 }
 
@@ -109,8 +130,9 @@ static int dump_write(FILE *core_fp, const void *addr, int nr, long *size)
 	if (gzlevel == -1) {
 		n = fwrite(addr, 1, wsize, core_fp );
 	} else {
-		n = gzwrite((gzFile)core_fp, (void *)addr, wsize);
+		n = (gzpipe_write(addr, wsize) == EOK) ? wsize : 0;
 	}
+	dump_stats.nwritten += n;
 
 	if ((n<wsize) && (verbose))
 	{
@@ -129,13 +151,70 @@ static int dump_seek(FILE *core_fp, off_t off)
 	if (gzlevel == -1)
 	  fseek( core_fp, off, SEEK_SET );
 	else
-	  if (gzseek((gzFile)core_fp, off, SEEK_SET) == -1) {
+	  if (off < gzpipe_tell()) {
 		  printf("gzseek backwards. Current %d, off %d, Failed.\n", dump_tell(core_fp), off);
 		  exit(-1);
+	  } else {
+		  gzpipe_write(NULL, off - gzpipe_tell());
 	  }
     return 1;
 }
 
+static int zero_page(const char *addr, int nr)
+{
+	const unsigned	*p = (const unsigned *)addr;
+	int				i;
+
+	for (i = 0; i < nr / sizeof *p; i++) {
+		if (p[i] != 0)
+			return 0;
+	}
+	for (i *= sizeof *p; i < nr; i++) {
+		if (addr[i] != 0)
+			return 0;
+	}
+	return 1;
+}
+
+/*
+ * Write process memory. In a plain core file, pages that are all zero
+ * are seeked over instead of written, leaving holes; dump() makes sure
+ * the file is extended past a trailing hole.
+ */
+static int dump_data(FILE *core_fp, const char *addr, int nr, long *size)
+{
+	int		off, n, hole = 0;
+
+	if (gzlevel != -1 || *size < nr) {
+		return dump_write(core_fp, addr, nr, size);
+	}
+	for (off = 0; off < nr; off += n) {
+		n = min(pagesize, nr - off);
+		if (zero_page(addr + off, n)) {
+			hole += n;
+			continue;
+		}
+		if (hole) {
+			fseek(core_fp, hole, SEEK_CUR);
+			*size -= hole;
+			dump_stats.nsparse += hole;
+			hole = 0;
+		}
+		if (dump_write(core_fp, addr + off, n, size) == -1)
+			return -1;
+	}
+	if (hole) {
+		off_t	here;
+
+		fseek(core_fp, hole, SEEK_CUR);
+		*size -= hole;
+		dump_stats.nsparse += hole;
+		if ((here = ftell(core_fp)) > dump_stats.extent)
+			dump_stats.extent = here;
+	}
+	return 1;
+}
+
 struct memelfnote {
 	const char      *name;
 	unsigned int    datasz;
@@ -224,6 +303,8 @@ off_t	here, there;
 				}
 				if ((num = read( fd, membuf, rsize)) != rsize) {
 					memset(membuf, -1, pagesize);
+				} else {
+					dump_stats.nread += num;
 				}
 			}
 			if( dump_write( fp, membuf, num, size) == -1)
@@ -232,9 +313,9 @@ off_t	here, there;
 		return;
 	}
 	
-	memset( membuf, 0, sizeof membuf );
-	for (i = 0; i < mem->size; i+= pagesize ) {
-		if(dump_write( fp, membuf, min( pagesize, mem->size - i ), size) == -1)
+	memset( membuf, 0, membufsize );
+	for (i = 0; i < mem->size; i+= membufsize ) {
+		if(dump_data( fp, membuf, min( membufsize, mem->size - i ), size) == -1)
 			return;
 	}
 	there = dump_tell(fp);
@@ -246,8 +327,10 @@ off_t	here, there;
 		/* read memory here */
 //		dprintf(("attempting to read @ %#llx\n", mem->vaddr + i ));
 		if ( (num = read( fd, membuf, pagesize )) != pagesize ) {
-			memset( membuf, -1, sizeof membuf );
+			memset( membuf, -1, pagesize );
 			num = pagesize;
+		} else {
+			dump_stats.nread += num;
 		}
 		if(dump_write( fp, membuf, num, size) == -1)
 			return;
@@ -264,24 +347,27 @@ off_t	here, there;
 
 void dump_memory( int fd, FILE *fp, procfs_mapinfo *mem, long *size )
 {
-int		num, i, ok = 1;
+int		num, n, i, ok = 1;
 
 	dprintf(("dumping %lld bytes of memory at %#llx\n", mem->size, mem->vaddr ));
 
-	for (i = 0; i < mem->size; i+= pagesize ) {
+	for (i = 0; i < mem->size; i += n ) {
+		n = min(membufsize, mem->size - i);
 		/* read memory here */
 		if ( ok ) {
-			num = read( fd, membuf, min(pagesize, mem->size - i) );
+			if ( (num = read( fd, membuf, n )) < 0 )
+				num = 0;
+			dump_stats.nread += num;
+			if ( num != n ) {
+				dprintf(("cut short at %d+%d\n", i, num ));
+				memset( membuf + num, -1, n - num );
+				ok = 0;
+			}
 		} else {
-			memset( membuf, -1, sizeof membuf );
-			num = pagesize;
+			memset( membuf, -1, n );
 		}
-		if(dump_write( fp, membuf, min(pagesize, mem->size - i), size) == -1)
+		if(dump_data( fp, membuf, n, size) == -1)
 			return;
-		if ( num != pagesize ) {
-			dprintf(("cut short at %d+%d\n", i, num ));
-			ok = 0;
-		}
 	}
 }
 
@@ -378,7 +464,8 @@ uint64_t			cur_tid_base = 0, cur_tid_size = 0;
 	}
 
 	pagesize = sysconf( _SC_PAGESIZE );
-	if ( membuf == NULL && ((membuf = malloc( pagesize )) == NULL) ) {
+	membufsize = pagesize * DUMP_READ_PAGES;
+	if ( membuf == NULL && ((membuf = malloc( membufsize )) == NULL) ) {
 		goto bailout;
 	}
 
@@ -656,6 +743,7 @@ uint64_t			cur_tid_base = 0, cur_tid_size = 0;
 	}
 
 	dump_seek( fp, dataoff );
+	clock_gettime(CLOCK_MONOTONIC, &dump_stats.mem);
 
 	for ( j = 0; j < seg; j++ ) {
 		if ( lseek( fd, mem[j].vaddr, SEEK_SET ) == -1 )
@@ -724,6 +812,28 @@ int n;
 	return corepath;
 }
 
+static unsigned elapsed_ms(struct timespec *from, struct timespec *to)
+{
+	return (to->tv_sec - from->tv_sec) * 1000 + (to->tv_nsec - from->tv_nsec) / 1000000;
+}
+
+static void dump_summary(pid_t pid, const char *path)
+{
+	unsigned	hdr_ms, mem_ms, total_ms;
+
+	hdr_ms = elapsed_ms(&dump_stats.start, &dump_stats.mem);
+	mem_ms = elapsed_ms(&dump_stats.mem, &dump_stats.end);
+	total_ms = elapsed_ms(&dump_stats.start, &dump_stats.end);
+
+	slogf( _SLOG_SETCODE( _SLOGC_DUMPER, 0 ), _SLOG_INFO,
+		"dump pid %d %s: read %llu written %llu sparse %llu bytes, setup %u ms memory %u ms total %u ms",
+		(int)pid, path ?: "", dump_stats.nread, dump_stats.nwritten, dump_stats.nsparse,
+		hdr_ms, mem_ms, total_ms );
+	vprintf(("dump of pid %d: read %llu, wrote %llu, skipped %llu zero bytes; setup %u ms, memory %u ms, total %u ms\n",
+		(int)pid, dump_stats.nread, dump_stats.nwritten, dump_stats.nsparse,
+		hdr_ms, mem_ms, total_ms ));
+}
+
 int dump(uint32_t nd, pid_t pid, long size ) {
 	int							fd;
 	int							ret;
@@ -781,6 +891,10 @@ int dump(uint32_t nd, pid_t pid, long size ) {
 			gid = info.egid;
 	}
 
+	memset(&dump_stats, 0, sizeof dump_stats);
+	clock_gettime(CLOCK_MONOTONIC, &dump_stats.start);
+	dump_stats.mem = dump_stats.start;
+
 	path[0] = '\0';
 	if(nd != -1) {
 		if(dump_dir) {
@@ -801,12 +915,9 @@ int dump(uint32_t nd, pid_t pid, long size ) {
 	strcat(path, basename(map->path));
 	dump_path = gen_dump_path(path);
 
-	if (gzlevel == -1) {
-		fp = fopen(dump_path, "w");
-	} else {
-		fp = (FILE *)gzopen(dump_path, "w");
-		if (fp)
-		  gzsetparams((gzFile)fp, gzlevel, 0);
+	fp = fopen(dump_path, "w");
+	if (fp && gzlevel != -1) {
+		gzpipe_start(fp);
 	}
 	
 	if(!fp) {
@@ -819,13 +930,19 @@ int dump(uint32_t nd, pid_t pid, long size ) {
 	ret = elfcore(fd, fp, map->path, size);
 	
 	if (gzlevel == -1) {
-		fclose(fp);
-	} else {
-		gzclose((gzFile)fp);
+		/* a core ending in a hole still needs its full length */
+		fflush(fp);
+		if (dump_stats.extent > lseek(fileno(fp), 0, SEEK_END)) {
+			ftruncate(fileno(fp), dump_stats.extent);
+		}
+	} else if (gzpipe_finish() != EOK && ret == EOK) {
+		ret = EIO;
 	}
+	fclose(fp);
 	close(fd);
 
-
+	clock_gettime(CLOCK_MONOTONIC, &dump_stats.end);
+	dump_summary(pid, dump_path);
 
 	return ret;
 }
@@ -912,11 +1029,14 @@ int main(int argc, char *argv[])
 	/* We also want some physical memory for our stack.  */
 	init_stack();
 	
-	while ( (c = getopt( argc, argv, "Dd:p:ns:vmPwtz:" )) != -1 ) {
+	while ( (c = getopt( argc, argv, "Dd:j:p:ns:vmPwtz:" )) != -1 ) {
 		switch(c) {
 		case 'd':
 			dump_dir = optarg;
 			break;
+		case 'j':
+			gzthreads = atoi(optarg);
+			break;
 		case 'n':
 			sequential_dumps = 1;
 			break;
@@ -967,6 +1087,16 @@ int main(int argc, char *argv[])
 		}
 	}
 
+	if ( gzlevel != -1 ) {
+		if ( gzthreads <= 0 ) {
+			gzthreads = min(_syspage_ptr->num_cpu, 4);
+		}
+		if ( gzpipe_init( gzthreads, gzlevel ) != EOK ) {
+			fprintf(stderr, "%s: Unable to start compression threads.\n", argv[0]);
+			exit(EXIT_FAILURE);
+		}
+	}
+
 	if ( process ) {
 		requested = 1;
 		return dump( ND_LOCAL_NODE, process, max_core_size );
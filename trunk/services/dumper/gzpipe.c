@@ -0,0 +1,299 @@
+/*
+ * $QNXLicenseC:
+ * Copyright 2007, QNX Software Systems. All Rights Reserved.
+ * 
+ * You must obtain a written license from and pay applicable license fees to QNX 
+ * Software Systems before you may reproduce, modify or distribute this software, 
+ * or any work that includes all or part of this software.   Free development 
+ * licenses are available for evaluation and non-commercial purposes.  For more 
+ * information visit http://licensing.qnx.com or email licensing@qnx.com.
+ *  
+ * This file may contain contributions from others.  Please review this entire 
+ * file for other proprietary rights or license notices, as well as the QNX 
+ * Development Suite License Guide at http://licensing.qnx.com/license-guide/ 
+ * for other information.
+ * $
+ */
+
+
+
+
+/*
+ * Parallel gzip output for dumper.
+ *
+ * The dump is cut into fixed size chunks which are deflated by a pool
+ * of worker threads, each into a complete gzip member, and written out
+ * in order by the dumping thread. A file of concatenated members is a
+ * valid gzip file, so gunzip and zcat read the result as usual.
+ *
+ * The zlib we link against predates the gzip wrapper in deflateInit2(),
+ * so the member header and trailer are put together by hand.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+#include <zlib.h>
+
+#define GZ_CHUNK		(128 * 1024)
+#define GZ_HDRSIZE		10
+#define GZ_TRLSIZE		8
+#define GZ_OUTSIZE		(GZ_HDRSIZE + GZ_CHUNK + (GZ_CHUNK >> 8) + 64 + GZ_TRLSIZE)
+
+enum { ZJOB_IDLE, ZJOB_QUEUED, ZJOB_BUSY, ZJOB_DONE };
+
+struct zjob {
+	int				state;
+	int				err;
+	unsigned		inlen;
+	unsigned		outlen;
+	unsigned char	*in;
+	unsigned char	*out;
+};
+
+static pthread_mutex_t	zmutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t	zcond = PTHREAD_COND_INITIALIZER;
+static struct zjob		*zjobs;
+static int				nzjobs;
+static int				zhead;		/* oldest job not yet written */
+static int				zfill;		/* job being filled */
+static int				zlevel;
+static off_t			zpos;		/* uncompressed offset */
+static int				zerr;
+static FILE				*zfp;
+static int				zstarting;	/* workers not yet through deflateInit2() */
+static int				zworkers;	/* workers able to deflate */
+static z_stream			zinline;	/* used by the writer when there are none */
+
+static void put_le32(unsigned char *p, unsigned long v)
+{
+	p[0] = v; p[1] = v >> 8; p[2] = v >> 16; p[3] = v >> 24;
+}
+
+static int deflate_job(z_stream *zs, struct zjob *job)
+{
+	unsigned char	*p = job->out;
+	unsigned long	crc;
+
+	memset(p, 0, GZ_HDRSIZE);
+	p[0] = 0x1f;
+	p[1] = 0x8b;
+	p[2] = Z_DEFLATED;
+	p[9] = 3;			/* OS_CODE unix */
+
+	zs->next_in = job->in;
+	zs->avail_in = job->inlen;
+	zs->next_out = p + GZ_HDRSIZE;
+	zs->avail_out = GZ_OUTSIZE - GZ_HDRSIZE - GZ_TRLSIZE;
+	if (deflate(zs, Z_FINISH) != Z_STREAM_END) {
+		deflateReset(zs);
+		return EIO;
+	}
+	p = zs->next_out;
+	deflateReset(zs);
+
+	crc = crc32(crc32(0L, Z_NULL, 0), job->in, job->inlen);
+	put_le32(p, crc);
+	put_le32(p + 4, job->inlen);
+	job->outlen = (p + GZ_TRLSIZE) - job->out;
+	return EOK;
+}
+
+static void *gz_worker(void *arg)
+{
+	z_stream		zs;
+	struct zjob		*job;
+	int				i, err;
+
+	memset(&zs, 0, sizeof zs);
+	err = deflateInit2(&zs, zlevel, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+
+	/* let gzpipe_init() know whether this worker can take jobs */
+	pthread_mutex_lock(&zmutex);
+	zstarting--;
+	if (err == Z_OK) {
+		zworkers++;
+	}
+	pthread_cond_broadcast(&zcond);
+	if (err != Z_OK) {
+		pthread_mutex_unlock(&zmutex);
+		return NULL;
+	}
+
+	for (;;) {
+		/* oldest queued job first, so the writer waits as little as possible */
+		job = NULL;
+		for (i = 0; i < nzjobs; i++) {
+			struct zjob	*j = &zjobs[(zhead + i) % nzjobs];
+
+			if (j->state == ZJOB_QUEUED) {
+				job = j;
+				break;
+			}
+		}
+		if (job == NULL) {
+			pthread_cond_wait(&zcond, &zmutex);
+			continue;
+		}
+		job->state = ZJOB_BUSY;
+		pthread_mutex_unlock(&zmutex);
+
+		err = deflate_job(&zs, job);
+
+		pthread_mutex_lock(&zmutex);
+		job->err = err;
+		job->state = ZJOB_DONE;
+		pthread_cond_broadcast(&zcond);
+	}
+	return NULL;
+}
+
+/*
+ * Start the compression threads. Called once; the threads and buffers
+ * stay around for the life of the daemon. If no worker can be started
+ * the dumping thread deflates each chunk itself.
+ */
+int gzpipe_init(int nthreads, int level)
+{
+	pthread_attr_t	attr;
+	pthread_t		tid;
+	int				i;
+
+	if (nthreads < 1) {
+		nthreads = 1;
+	}
+	zlevel = level;
+	nzjobs = 2 * nthreads;
+	if ((zjobs = calloc(nzjobs, sizeof *zjobs)) == NULL) {
+		return ENOMEM;
+	}
+	for (i = 0; i < nzjobs; i++) {
+		zjobs[i].in = malloc(GZ_CHUNK);
+		zjobs[i].out = malloc(GZ_OUTSIZE);
+		if (zjobs[i].in == NULL || zjobs[i].out == NULL) {
+			return ENOMEM;
+		}
+	}
+
+	pthread_attr_init(&attr);
+	pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+	pthread_mutex_lock(&zmutex);
+	for (i = 0; i < nthreads; i++) {
+		if (pthread_create(&tid, &attr, gz_worker, NULL) == EOK) {
+			zstarting++;
+		}
+	}
+	while (zstarting) {
+		pthread_cond_wait(&zcond, &zmutex);
+	}
+	i = zworkers;
+	pthread_mutex_unlock(&zmutex);
+	pthread_attr_destroy(&attr);
+
+	if (i == 0 && deflateInit2(&zinline, zlevel, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+		return ENOMEM;
+	}
+	return EOK;
+}
+
+/* write out the oldest job once its worker is done with it, zmutex held */
+static void gz_retire(void)
+{
+	struct zjob	*job = &zjobs[zhead];
+
+	while (job->state == ZJOB_QUEUED || job->state == ZJOB_BUSY) {
+		pthread_cond_wait(&zcond, &zmutex);
+	}
+	if (job->state == ZJOB_DONE && !zerr) {
+		if (job->err != EOK) {
+			zerr = job->err;
+		} else if (fwrite(job->out, 1, job->outlen, zfp) != job->outlen) {
+			zerr = errno ? errno : EIO;
+		}
+	}
+	job->state = ZJOB_IDLE;
+	job->inlen = 0;
+	zhead = (zhead + 1) % nzjobs;
+}
+
+static void gz_queue(void)
+{
+	struct zjob	*job = &zjobs[zfill];
+
+	if (zworkers == 0) {
+		/* single threaded, the job is done by the time it is queued */
+		job->err = deflate_job(&zinline, job);
+		pthread_mutex_lock(&zmutex);
+		job->state = ZJOB_DONE;
+	} else {
+		pthread_mutex_lock(&zmutex);
+		job->state = ZJOB_QUEUED;
+	}
+	zfill = (zfill + 1) % nzjobs;
+	pthread_cond_broadcast(&zcond);
+	if (zfill == zhead) {
+		/* every slot is in flight, wait for the oldest one */
+		gz_retire();
+	}
+	pthread_mutex_unlock(&zmutex);
+}
+
+/* begin a new compressed dump on fp */
+void gzpipe_start(FILE *fp)
+{
+	zfp = fp;
+	zpos = 0;
+	zerr = EOK;
+}
+
+/*
+ * Append len bytes to the dump; a NULL buf appends zeros, which is
+ * how forward seeks are done.
+ */
+int gzpipe_write(const void *buf, unsigned len)
+{
+	const unsigned char	*p = buf;
+
+	while (len) {
+		struct zjob	*job = &zjobs[zfill];
+		unsigned	n = GZ_CHUNK - job->inlen;
+
+		if (n > len) {
+			n = len;
+		}
+		if (p) {
+			memcpy(job->in + job->inlen, p, n);
+			p += n;
+		} else {
+			memset(job->in + job->inlen, 0, n);
+		}
+		job->inlen += n;
+		zpos += n;
+		len -= n;
+		if (job->inlen == GZ_CHUNK) {
+			gz_queue();
+		}
+	}
+	return zerr;
+}
+
+off_t gzpipe_tell(void)
+{
+	return zpos;
+}
+
+/* queue the last partial chunk and write out everything in flight */
+int gzpipe_finish(void)
+{
+	if (zjobs[zfill].inlen) {
+		gz_queue();
+	}
+	pthread_mutex_lock(&zmutex);
+	while (zhead != zfill) {
+		gz_retire();
+	}
+	pthread_mutex_unlock(&zmutex);
+	return zerr;
+}
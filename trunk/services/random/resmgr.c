@@ -42,6 +42,7 @@ static int dev_random_read( resmgr_context_t *ctp, io_read_t *msg,
     int status;
     int bytes_used;
     uint8_t local_data[1024];
+    iov_t iov;
 
     status = iofunc_read_verify( ctp, msg, ocb, NULL );
     if( status != EOK ) {
@@ -64,7 +65,11 @@ static int dev_random_read( resmgr_context_t *ctp, io_read_t *msg,
         yarrow_output( Yarrow, local_data, bytes_used );
     }
 
-    MsgReply( ctp->rcvid, bytes_used, local_data, bytes_used );
+    /* Short reads are held back and replied to along with the rest of
+       the batch they came in with */
+    SETIOV( &iov, local_data, bytes_used );
+    dispatch_msgreplyv( (dispatch_context_t *)ctp, ctp->rcvid, bytes_used, 
+                        &iov, 1 );
 
     return  _RESMGR_NOREPLY;
 }
@@ -72,7 +77,7 @@ static int dev_random_read( resmgr_context_t *ctp, io_read_t *msg,
 
 static void * resmgr_thread( void *p )
 {
-    resmgr_context_t         *ctp;
+    dispatch_context_t       *ctp;
     resmgr_connect_funcs_t   connect_funcs;
     resmgr_io_funcs_t        io_funcs;
     iofunc_attr_t            io_attr;
@@ -81,7 +86,9 @@ static void * resmgr_thread( void *p )
     int                      id2;
     dispatch_t               *dispatch;
 
-    dispatch = dispatch_create();
+    /* Everything is handled on this one thread, so let it pick up
+       several reads per kernel call when the device is busy */
+    dispatch = dispatch_create_channel( -1, DISPATCH_FLAG_BATCH );
     if( dispatch == NULL )
     {
         slogf( _SLOGC_CHAR, _SLOG_CRITICAL, 
@@ -113,26 +120,26 @@ static void * resmgr_thread( void *p )
     }
 
     
-    ctp = resmgr_context_alloc( dispatch );
+    ctp = dispatch_context_alloc( dispatch );
     if( ctp == NULL )
     {
         slogf( _SLOGC_CHAR, _SLOG_CRITICAL, 
-               "random: Unable to allocate resmgr context: %s.", 
+               "random: Unable to allocate dispatch context: %s.", 
                strerror( errno ) );
         return NULL;
     }
 
     while( 1 )
     {
-        ctp = resmgr_block( ctp );
+        ctp = dispatch_block( ctp );
         if( ctp == NULL )
         {
             slogf( _SLOGC_CHAR, _SLOG_CRITICAL, 
-                   "random: resmgr_block() failed: %s.", strerror( errno ) );
+                   "random: dispatch_block() failed: %s.", strerror( errno ) );
             return NULL;
         }
 
-        resmgr_handler( ctp );
+        dispatch_handler( ctp );
     }
 
     return NULL;
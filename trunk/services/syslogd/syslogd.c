@@ -151,8 +151,6 @@ char	*ConfFile = _PATH_LOGCONF;
 char	*PidFile = _PATH_LOGPID;
 char	ctty[] = _PATH_CONSOLE;
 
-#define FDMASK(fd)	(1 << (fd))
-
 #define	dprintf		if (Debug) printf
 
 #define MAXUNAMES	20	/* maximum number of user names */
@@ -167,6 +165,42 @@ char	ctty[] = _PATH_CONSOLE;
 #define MARK		0x008	/* this message is a mark */
 #define LOG_INTERNAL_ERROR 0x010
 
+#ifdef __QNXNTO__
+/*
+ * Files, ttys and the console are each written by a thread of their
+ * own, fed through a bounded queue, so that a slow device can't hold
+ * up the threads receiving messages.  When a queue is full, new
+ * messages are dropped and counted.  The writer hands whatever has
+ * piled up to a single writev(), and fsyncs files at most every
+ * SyncMsec milliseconds or SyncCount messages (group commit).
+ */
+#define LOGQ_BATCH	32		/* lines per writev() */
+
+struct logq_ent {
+	char		*line;
+	int		len;
+	uint64_t	stamp;			/* when it was queued, nsec */
+};
+
+struct logq {
+	pthread_t	tid;
+	pthread_mutex_t	mutex;
+	pthread_cond_t	cond;
+	int		fd;
+	short		type;
+	char		*name;
+	int		quit;
+	int		err;			/* write error, reported by fprintlog */
+	unsigned	head, count, size;
+	struct logq_ent	*ent;
+	unsigned	unsynced;		/* lines written since the last fsync */
+	uint64_t	lastsync;
+	/* counters */
+	unsigned	queued, written, dropped, reported, fsyncs;
+	uint64_t	lat_total, lat_max;	/* queue to write, nsec */
+};
+#endif
+
 /*
  * This structure represents the files that will have log
  * copies printed.
@@ -195,6 +229,9 @@ struct filed {
 	int	f_prevlen;			/* length of f_prevline */
 	int	f_prevcount;			/* repetition cnt of prevline */
 	int	f_repeatcount;			/* number of "repeated" msgs */
+#ifdef __QNXNTO__
+	struct	logq *f_q;			/* writer thread, if any */
+#endif
 };
 
 /*
@@ -237,6 +274,9 @@ int	MarkInterval = 20 * 60;	/* interval between marks in seconds */
 int	MarkSeq = 0;		/* mark sequence number */
 #ifdef __QNXNTO__
 int	threads = 5;
+int	LogQLen = 256;		/* lines queued per destination, 0 writes inline */
+int	SyncMsec = 0;		/* fsync files at most this often... */
+int	SyncCount = 0;		/* ...or after this many lines */
 #endif
 
 
@@ -261,6 +301,12 @@ int printline(char *hname, char *msg);
 int logmsg(int pri, char *msg, char *from, int flags);
 int wallmsg(struct filed *f, struct iovec *iov);
 int cfline(char *line, struct filed *f);
+#ifdef __QNXNTO__
+static int logq_start(struct filed *f);
+static void logq_stop(struct filed *f);
+static int logq_put(struct filed *f, struct iovec *iov, int cnt);
+static void logq_report(struct filed *f, int all);
+#endif
   
 int
 main(argc, argv)
@@ -281,7 +327,7 @@ main(argc, argv)
 	void die(), domark(), init(), reapchild();
 
 #ifdef __QNXNTO__
-	while ((ch = getopt(argc, argv, "df:m:t:")) != EOF)
+	while ((ch = getopt(argc, argv, "df:m:q:s:t:")) != EOF)
 #else
 	while ((ch = getopt(argc, argv, "df:m:")) != EOF)
 #endif
@@ -296,6 +342,14 @@ main(argc, argv)
 			MarkInterval = atoi(optarg) * 60;
 			break;
 #ifdef __QNXNTO__
+		case 'q':		/* queue depth per destination */
+			LogQLen = atoi(optarg);
+			break;
+		case 's':		/* group commit: msec[,count] */
+			SyncMsec = atoi(optarg);
+			if ((p = strchr(optarg, ',')) != NULL)
+				SyncCount = atoi(p + 1);
+			break;
 		case 't':
 			threads = atoi(optarg);
 			break;
@@ -385,7 +439,7 @@ if (!InetInuse){
 				//die(0);
 				goto out;
 		} else {
-			inetm = FDMASK(finet);
+			inetm = 1;
 			InetInuse = 1;
 			dprintf("socket open...\n");
 		}
@@ -404,7 +458,7 @@ out:
 #endif
 
 	for (;;) {
-		long readfds = inetm;
+		fd_set readfds;
 		int nfds;
 
 		if (S){
@@ -412,10 +466,12 @@ out:
 			goto sig_HUP;
 			}
 		errno = 0;
-		readfds = inetm;
-		dprintf("readfds = %#lx\n", readfds);
+		FD_ZERO(&readfds);
+		if (inetm)
+			FD_SET(finet, &readfds);
+		dprintf("select on %d\n", inetm ? finet : -1);
 		(void) sigsetmask(omask);
-		nfds = select(20, (fd_set *) &readfds, (fd_set *) NULL,
+		nfds = select(inetm ? finet + 1 : 0, &readfds, (fd_set *) NULL,
 		    (fd_set *) NULL, (struct timeval *) NULL);
 		if (nfds == 0)
 			continue;
@@ -436,9 +492,9 @@ out:
 			continue;
 		}
 		sigblock(sigmask(SIGHUP)|sigmask(SIGALRM));
-		dprintf("got a message (%d, %#lx)\n", nfds, readfds);
+		dprintf("got a message (%d)\n", nfds);
 
-		if (readfds & inetm) {
+		if (inetm && FD_ISSET(finet, &readfds)) {
 			len = sizeof frominet;
 			i = recvfrom(finet, line, MAXLINE, 0,
 			    (struct sockaddr *) &frominet, &len);
@@ -460,7 +516,7 @@ usage(void)
 	(void) fprintf(stderr,
 #ifdef __QNXNTO__
 
-	    "usage: syslogd [-f conffile] [-m markinterval] [-t threads]\n");
+	    "usage: syslogd [-f conffile] [-m markinterval] [-q queuelen] [-s msec[,count]] [-t threads]\n");
 #else
 	    "usage: syslogd [-f conffile] [-m markinterval] \n");
 #endif
@@ -787,6 +843,23 @@ fprintlog(f, flags, msg)
 			v->iov_base = "\n";
 			v->iov_len = 1;
 		}
+#ifdef __QNXNTO__
+		if (f->f_q != NULL) {
+			if (f->f_q->err) {
+				/* the writer gave up on this destination */
+				int e = f->f_q->err;
+
+				logq_stop(f);
+				(void) close(f->f_file);
+				f->f_type = F_UNUSED;
+				errno = e;
+				logerror(f->f_un.f_fname);
+				break;
+			}
+			logq_put(f, iov, 6);
+			break;
+		}
+#endif
 		reopencnt= 0;
 		sigrepcnt= 0;
 	again:
@@ -1087,6 +1160,10 @@ domark()
 			fprintlog(f, 0, (char *)NULL);
 			BACKOFF(f);
 		}
+#ifdef __QNXNTO__
+		if (f->f_q != NULL)
+			logq_report(f, 0);
+#endif
 	}
 	(void) alarm(TIMERINTVL);
 }
@@ -1120,6 +1197,10 @@ die(sig)
 		/* flush any pending output */
 		if (f->f_prevcount)
 			fprintlog(f, 0, (char *)NULL);
+#ifdef __QNXNTO__
+		if (f->f_q != NULL)
+			logq_stop(f);
+#endif
 	}
 	if (sig) {
 		dprintf("syslogd: exiting on signal %d\n", sig);
@@ -1146,6 +1227,14 @@ init()
 
 	dprintf("init\n");
 
+#ifdef __QNXNTO__
+	/* log the writer counters while the files are still open */
+	for (f = Files; f != NULL; f = f->f_next) {
+		if (f->f_q != NULL)
+			logq_report(f, 1);
+	}
+#endif
+
 	/*
 	 *  Close all open log files.
 	 */
@@ -1154,6 +1243,10 @@ init()
 		/* flush any pending output */
 		if (f->f_prevcount)
 			fprintlog(f, 0, (char *)NULL);
+#ifdef __QNXNTO__
+		if (f->f_q != NULL)
+			logq_stop(f);
+#endif
 
 		switch (f->f_type) {
 		  case F_FILE:
@@ -1356,6 +1449,10 @@ cfline(line, f)
 			f->f_type = F_FILE;
 		if (strcmp(p, ctty) == 0)
 			f->f_type = F_CONSOLE;
+#ifdef __QNXNTO__
+		if (LogQLen > 0 && logq_start(f) == -1)
+			logerror("writer thread");
+#endif
 		break;
 
 	case '*':
@@ -1447,6 +1544,254 @@ dprintf("got msg...\n");
 }
 #endif
 
+#ifdef __QNXNTO__
+#include <errno.h>
+#include <stdlib.h>
+#include <time.h>
+
+static uint64_t
+logq_now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/*
+ * Write a batch, picking up after short writes.  Ttys get reopened on
+ * EIO/EBADF as fprintlog() does; any other error is left in q->err.
+ */
+static void
+logq_writev(struct logq *q, struct iovec *iov, int n)
+{
+	int r, tries = 0;
+
+	while (n > 0) {
+		if ((r = writev(q->fd, iov, n)) < 0) {
+			if (errno == EINTR && ++tries <= 3)
+				continue;
+			if ((errno == EIO || errno == EBADF) &&
+			    q->type != F_FILE && tries++ < 3) {
+				(void) close(q->fd);
+				if ((q->fd = open(q->name, O_WRONLY|O_APPEND, 0)) >= 0)
+					continue;
+			}
+			q->err = errno ? errno : EIO;
+			return;
+		}
+		while (n > 0 && r >= iov->iov_len) {
+			r -= iov->iov_len;
+			iov++;
+			n--;
+		}
+		if (n > 0) {
+			iov->iov_base = (char *)iov->iov_base + r;
+			iov->iov_len -= r;
+		}
+	}
+}
+
+static void
+logq_sync(struct logq *q, uint64_t t, int force)
+{
+	if (q->type != F_FILE || q->unsynced == 0 || (!SyncMsec && !SyncCount))
+		return;
+	if (force || (SyncCount && q->unsynced >= SyncCount) ||
+	    (SyncMsec && t - q->lastsync >= (uint64_t)SyncMsec * 1000000)) {
+		/* call the function, not the no-op fsync() macro above */
+		(void) (fsync)(q->fd);
+		q->fsyncs++;
+		q->unsynced = 0;
+		q->lastsync = t;
+	}
+}
+
+static void *
+logq_writer(void *arg)
+{
+	struct logq *q = arg;
+	struct logq_ent batch[LOGQ_BATCH];
+	struct iovec iov[LOGQ_BATCH];
+	struct timespec ts;
+	uint64_t t, lat;
+	int i, n;
+
+	pthread_mutex_lock(&q->mutex);
+	for (;;) {
+		while (q->count == 0 && !q->quit) {
+			if (q->unsynced && SyncMsec) {
+				/* wake up for the fsync that is due */
+				clock_gettime(CLOCK_REALTIME, &ts);
+				ts.tv_sec += SyncMsec / 1000;
+				ts.tv_nsec += (SyncMsec % 1000) * 1000000;
+				if (ts.tv_nsec >= 1000000000) {
+					ts.tv_sec++;
+					ts.tv_nsec -= 1000000000;
+				}
+				if (pthread_cond_timedwait(&q->cond, &q->mutex, &ts) == ETIMEDOUT)
+					break;
+			} else {
+				pthread_cond_wait(&q->cond, &q->mutex);
+			}
+		}
+		if (q->count == 0 && q->quit)
+			break;
+
+		n = q->count < LOGQ_BATCH ? q->count : LOGQ_BATCH;
+		for (i = 0; i < n; i++) {
+			batch[i] = q->ent[(q->head + i) % q->size];
+			iov[i].iov_base = batch[i].line;
+			iov[i].iov_len = batch[i].len;
+		}
+		q->head = (q->head + n) % q->size;
+		q->count -= n;
+		pthread_mutex_unlock(&q->mutex);
+
+		if (n > 0 && !q->err)
+			logq_writev(q, iov, n);
+		t = logq_now();
+		q->unsynced += n;
+		logq_sync(q, t, 0);
+
+		pthread_mutex_lock(&q->mutex);
+		for (i = 0; i < n; i++) {
+			lat = t - batch[i].stamp;
+			q->lat_total += lat;
+			if (lat > q->lat_max)
+				q->lat_max = lat;
+			free(batch[i].line);
+		}
+		q->written += n;
+	}
+	pthread_mutex_unlock(&q->mutex);
+	logq_sync(q, logq_now(), 1);
+	return NULL;
+}
+
+static int
+logq_start(struct filed *f)
+{
+	struct logq *q;
+
+	if ((q = calloc(1, sizeof(*q))) == NULL)
+		return -1;
+	if ((q->ent = calloc(LogQLen, sizeof(*q->ent))) == NULL) {
+		free(q);
+		return -1;
+	}
+	q->size = LogQLen;
+	q->fd = f->f_file;
+	q->type = f->f_type;
+	q->name = f->f_un.f_fname;
+	q->lastsync = logq_now();
+	pthread_mutex_init(&q->mutex, NULL);
+	pthread_cond_init(&q->cond, NULL);
+	if (pthread_create(&q->tid, NULL, logq_writer, q) != EOK) {
+		pthread_cond_destroy(&q->cond);
+		pthread_mutex_destroy(&q->mutex);
+		free(q->ent);
+		free(q);
+		return -1;
+	}
+	f->f_q = q;
+	return 0;
+}
+
+/*
+ * Let the writer drain its queue and exit.  It may have reopened
+ * a tty, so the descriptor is handed back to the filed.
+ */
+static void
+logq_stop(struct filed *f)
+{
+	struct logq *q = f->f_q;
+
+	pthread_mutex_lock(&q->mutex);
+	q->quit = 1;
+	pthread_cond_signal(&q->cond);
+	pthread_mutex_unlock(&q->mutex);
+	pthread_join(q->tid, NULL);
+
+	f->f_file = q->fd;
+	f->f_q = NULL;
+	pthread_cond_destroy(&q->cond);
+	pthread_mutex_destroy(&q->mutex);
+	free(q->ent);
+	free(q);
+}
+
+static int
+logq_put(struct filed *f, struct iovec *iov, int cnt)
+{
+	struct logq *q = f->f_q;
+	struct logq_ent *e;
+	char *line, *p;
+	int i, len;
+
+	for (len = 0, i = 0; i < cnt; i++)
+		len += iov[i].iov_len;
+	if ((line = malloc(len)) == NULL) {
+		pthread_mutex_lock(&q->mutex);
+		q->dropped++;
+		pthread_mutex_unlock(&q->mutex);
+		return -1;
+	}
+	for (p = line, i = 0; i < cnt; i++) {
+		memcpy(p, iov[i].iov_base, iov[i].iov_len);
+		p += iov[i].iov_len;
+	}
+
+	pthread_mutex_lock(&q->mutex);
+	if (q->count == q->size) {
+		q->dropped++;
+		pthread_mutex_unlock(&q->mutex);
+		free(line);
+		return -1;
+	}
+	e = &q->ent[(q->head + q->count) % q->size];
+	e->line = line;
+	e->len = len;
+	e->stamp = logq_now();
+	if (q->count++ == 0)
+		pthread_cond_signal(&q->cond);
+	q->queued++;
+	pthread_mutex_unlock(&q->mutex);
+	return 0;
+}
+
+/*
+ * Log the writer counters: from domark() only when messages have been
+ * dropped since the last report, from init() always.
+ */
+static void
+logq_report(struct filed *f, int all)
+{
+	struct logq *q = f->f_q;
+	unsigned written, dropped, fsyncs, avg_us, max_us;
+	char buf[MAXPATHLEN + 160];
+
+	pthread_mutex_lock(&q->mutex);
+	written = q->written;
+	dropped = q->dropped;
+	fsyncs = q->fsyncs;
+	avg_us = written ? (unsigned)(q->lat_total / written / 1000) : 0;
+	max_us = (unsigned)(q->lat_max / 1000);
+	if (!all && dropped == q->reported) {
+		pthread_mutex_unlock(&q->mutex);
+		return;
+	}
+	q->reported = dropped;
+	pthread_mutex_unlock(&q->mutex);
+
+	(void) sprintf(buf, "syslogd: %s: %u written, %u dropped, %u fsyncs, "
+	    "latency avg %u max %u usec", f->f_un.f_fname, written, dropped,
+	    fsyncs, avg_us, max_us);
+	dprintf("%s\n", buf);
+	logmsg(LOG_SYSLOG|LOG_INFO, buf, LocalHostName, ADDDATE);
+}
+#endif
+
 #ifdef __QNXNTO__
 #include <sys/dispatch.h>
 #include <sys/iofunc.h>
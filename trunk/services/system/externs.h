@@ -95,6 +95,10 @@ extern const char			os_version_string[];
 
 extern unsigned				__cpu_flags;
 
+//Kept by the kernel's TLB shootdown code
+extern struct tlb_flush_stats	tlb_flush_stats[];
+extern unsigned				tlb_flush_received[];
+
 #undef INITSOUL
 #define INITSOUL(a,b,c,d,e)		= { 0, a, 0, 0, sizeof(b), 0, c, c }
 
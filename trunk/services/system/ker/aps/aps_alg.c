@@ -117,6 +117,9 @@ set_factors () {
 	uint64_t	min_t64; 
 	uint64_t	max_factor; 
 	   
+	//the rfus are about to change under the merit order, so have choose_thread_to_schedule() ignore it until it's rebuilt
+	merit_num = 0; 
+
 	//This assumes all budgets sum to 100% 
 	//all this would be a lot easier with floats, but we cant do floating point in the kernel. 
  
@@ -181,10 +184,92 @@ set_factors () {
     		}
 	}
 	
+	INTR_LOCK(&aps_lock);
+	merit_rebuild();
+	INTR_UNLOCK(&aps_lock);
 }
 
 
-    
+
+/* merit order
+ *
+ * The winner of choose_thread_to_schedule() is the partition with the largest tuple
+ * (starvation, runable, prio, -rfu). The first three elements change with every ready/block, so they
+ * are cheap to collect in one pass over the partitions, but comparing rfus is what makes the second pass
+ * touch every partition. merit_order[] keeps the partition ids sorted by increasing rfu so the second pass can
+ * visit them best-rfu-first and stop as soon as nobody left can win.
+ *
+ * rfu only grows between window rotations, and only for the partition being billed, so keeping the order is
+ * moving one partition to the right after a microbill (merit_billed) plus a re-sort when the window rotates or
+ * budgets change (merit_rebuild). Both run under aps_lock. Most microbills don't overtake the next partition and
+ * cost one comparison; the others binary search for the new position. Readers don't take the lock: merit_gen is
+ * odd while the order is being changed and the reader falls back to walking by partition id if it saw a change.
+ */
+
+uint8_t			merit_order[APS_MAX_PARTITIONS];
+static uint8_t		merit_pos[APS_MAX_PARTITIONS]; 	/* inverse of merit_order[] */
+int			merit_num;			/* number of valid entries in merit_order[] */ 
+volatile uint32_t	merit_gen;
+
+void
+merit_rebuild(void) {
+	int		i, j, ap;
+	uint32_t	rfu;
+
+	merit_gen++;
+	MEM_BARRIER_WR();
+	if (merit_num != num_ppg) { 
+		//partitions were added. Start from id order, the sort below fixes it
+		for (i=0; i<num_ppg; i++) merit_order[i] = i;
+		merit_num = num_ppg;
+	}
+	//insertion sort: after a window rotation the old order is usually still nearly right
+	for (i=1; i<merit_num; i++) { 
+		ap = merit_order[i];
+		rfu = RELATIVE_FRACTION_USED(actives_ppg[ap]); 
+		for (j=i; j>0 && RELATIVE_FRACTION_USED(actives_ppg[merit_order[j-1]]) > rfu; j--) { 
+			merit_order[j] = merit_order[j-1];
+		}
+		merit_order[j] = ap;
+	}
+	for (i=0; i<merit_num; i++) merit_pos[merit_order[i]] = i;
+	MEM_BARRIER_WR();
+	merit_gen++;
+}
+
+void
+merit_billed(int ap) {
+	int		pos, lo, hi, mid, i;
+	uint32_t	rfu;
+
+	if (merit_num != num_ppg) return; //a merit_rebuild() is on its way 
+	pos = merit_pos[ap];
+	rfu = RELATIVE_FRACTION_USED(actives_ppg[ap]);
+	if (pos+1 >= merit_num || RELATIVE_FRACTION_USED(actives_ppg[merit_order[pos+1]]) >= rfu) return; 
+	
+	//everything after pos is still sorted: find the last partition there with a smaller rfu
+	lo = pos+1;
+	hi = merit_num-1;
+	while (lo < hi) { 
+		mid = (lo+hi+1) / 2;
+		if (RELATIVE_FRACTION_USED(actives_ppg[merit_order[mid]]) < rfu) {
+			lo = mid;
+		} else {
+			hi = mid-1;
+		}
+	}
+
+	merit_gen++;
+	MEM_BARRIER_WR();
+	for (i=pos; i<lo; i++) { 
+		merit_order[i] = merit_order[i+1];
+		merit_pos[merit_order[i]] = i;
+	}
+	merit_order[lo] = ap;
+	merit_pos[ap] = lo;
+	MEM_BARRIER_WR();
+	merit_gen++;
+}
 
 
 
@@ -236,7 +321,11 @@ THREAD  *choose_thread_to_schedule(THREAD *pcur_candidate_thread, int *prun_as_c
 	uint32_t		sleeping_ap_set; /* non-zero aps which are not ready to run */
 	uint32_t		cpu = KERNCPU;
 	THREAD			*ptrds_per_ap[APS_MAX_PARTITIONS]; 
+	uint32_t		sb_per_ap[APS_MAX_PARTITIONS]; 
+	uint32_t		sb_top;		/* largest starvation metric of any ready partition */ 
+	unsigned		top_prio;	/* highest priority of any ready partition */ 
 	int 			free_time, underload, prio_enable;	/*booleans*/ 
+	uint64_t		start_cycles = ClockCycles(); 
 #if aps_debugging
 	int			all_at_limit_bmp; 	/* boolean */
 	int			all_at_limit; 		/* boolean */ 
@@ -294,6 +383,8 @@ THREAD  *choose_thread_to_schedule(THREAD *pcur_candidate_thread, int *prun_as_c
 			least_relative_fraction_used = ~0; 
    		}
 		sb_best_starvation_metric = 0; 
+		sb_top = 0;
+		top_prio = 0;
 		
 
 		/* scan all partitions to see which are over/under budget to deterimine which of these 3 modes we are in:
@@ -313,7 +404,7 @@ THREAD  *choose_thread_to_schedule(THREAD *pcur_candidate_thread, int *prun_as_c
 			pap = actives_ppg[ap]; 
 			prio = DISPATCH_HIGHEST_PRI((DISPATCH*)pap);
 			if (!prio) { 
-				sleeping_ap_set |= 1<<ap; 
+				sleeping_ap_set |= 1u<<ap; 
 				SB_PARTITION_IS_NOT_READY(ap); 
 				ptrds_per_ap[ap]=NULL;
 				continue;
@@ -339,7 +430,7 @@ THREAD  *choose_thread_to_schedule(THREAD *pcur_candidate_thread, int *prun_as_c
 					}
 				}
 				if(!prio) {
-					sleeping_ap_set |= 1<<ap; 
+					sleeping_ap_set |= 1u<<ap; 
 					//Note with BMP different processors can have a different number of sleeping APs. The sleeping
 					//AP count is for our processor. 
 					SB_PARTITION_IS_NOT_READY(ap); 
@@ -351,6 +442,10 @@ THREAD  *choose_thread_to_schedule(THREAD *pcur_candidate_thread, int *prun_as_c
 			ptrds_per_ap[ap]=ptrd; 
 
 			CRASHCHECK(ptrd == NULL);
+
+			sb_per_ap[ap] = SB_STARVATION_METRIC(ap, ptrd); 
+			if (sb_per_ap[ap] > sb_top) sb_top = sb_per_ap[ap];
+			if (ptrd->priority > top_prio) top_prio = ptrd->priority; 
 			
 			//Can this partition run on this cpu?
 			runable_ap_set |= (uint32_t)(runable || THREAD_IS_RUNNING_CRITICAL(ptrd)) <<ap;
@@ -414,20 +509,45 @@ THREAD  *choose_thread_to_schedule(THREAD *pcur_candidate_thread, int *prun_as_c
 		}
 #endif
 		
-		for (ap=0; ap<num_ppg; ap++) { 
+		/* Walk the partitions in merit order, i.e. least rfu first. Once the best so far has the top starvation metric,
+		 * runable and priority that any partition has, only a smaller rfu could beat it, and everything after it in
+		 * merit order has a larger one. If the order changed under us while walking, walk again by id. 
+		 */
+		{ 
+		THREAD		*init_best_thread = pbest_thread;
+		int		init_best_runable = best_runable;
+		uint32_t	init_least_rfu = least_relative_fraction_used;
+		int		top_runable = (runable_ap_set != 0); 
+		uint32_t	gen = merit_gen;
+		uint8_t		*order;
+		int		i;
+
+		MEM_BARRIER_RD();
+		order = ((gen & 1) || merit_num != num_ppg) ? NULL : merit_order; 
+
+		for ( ;; ) { 
+		for (i=0; i<num_ppg; i++) { 
 			uint32_t	rfu;
 			THREAD		*ptrd;
 			uint32_t	sb_starvation_metric;
 
+			ap = order ? order[i] : i; 
 			ptrd = ptrds_per_ap[ap];
 			if (!ptrd) continue; 
-			runable = 0 != (runable_ap_set&(1<<ap)); 
+			runable = 0 != (runable_ap_set&(1u<<ap)); 
+
+			if (order && pbest_thread && sb_best_starvation_metric >= sb_top && best_runable >= top_runable 
+				&& (!prio_enable || pbest_thread->priority >= top_prio) 
+				&& RELATIVE_FRACTION_USED(actives_ppg[ap]) >= least_relative_fraction_used) {
+				//nobody from here on can win
+				break;
+			}
 			
 			//this if-tree finds the best ap by comparing the tuple (runable, priority, relative_fraction)
 			//As soon as it knows an ap has lost, it avoids computing the remaining elements
 			//As soon as it knows an ap has won, it avoids testing the remaining elements, but still has to compute 
 			//them to save as the best tuple. 
-			sb_starvation_metric = SB_STARVATION_METRIC(ap, ptrd); 
+			sb_starvation_metric = sb_per_ap[ap]; 
 			if (sb_starvation_metric < sb_best_starvation_metric) { 
 					//loose because someone else is starving 
 					continue;
@@ -472,7 +592,18 @@ THREAD  *choose_thread_to_schedule(THREAD *pcur_candidate_thread, int *prun_as_c
 			best_runable = runable;                                              
 			pbest_thread = ptrd;            
 			least_relative_fraction_used = rfu;
-   	 	}// endfor ap=0
+   	 	}// endfor i=0
+		if (!order) break;
+		MEM_BARRIER_RD();
+		if (gen == merit_gen) break; 
+		//merit order was changed by a microbill on another cpu. Start over, in id order
+		order = NULL;
+		pbest_thread = init_best_thread;
+		best_runable = init_best_runable;
+		least_relative_fraction_used = init_least_rfu;
+		sb_best_starvation_metric = 0; 
+		} //endfor ;;
+		}
 		//@@@ a speed optimization might be 3 different loops optomized for each case of free_time, underload, 
 		//and all_at_load	
 		
@@ -499,6 +630,7 @@ THREAD  *choose_thread_to_schedule(THREAD *pcur_candidate_thread, int *prun_as_c
 			if (pbest_thread) UPD_BILL_AS_CRIT(pbest_thread, competing_ap_set!=0) 
 			if(prun_as_crit) *prun_as_crit = (competing_ap_set!=0);
 
+			aps_trace_sched_latency(cpu, (uint32_t)(ClockCycles() - start_cycles)); 
 			return pbest_thread;
 		}
 		// the scheduling windows rotated while we were choosing, so our choice is bogus. Try one more time.
@@ -507,6 +639,7 @@ THREAD  *choose_thread_to_schedule(THREAD *pcur_candidate_thread, int *prun_as_c
 	
 	//More than 1 retry? Shouldnt be pssible. Means we were hit with TWO clock interrupts while we were choosing. 
 	if (ker_verbose >=3) kprintf("APS:2 clock intrs while choosing\n");
+	aps_trace_sched_latency(cpu, (uint32_t)(ClockCycles() - start_cycles)); 
 	return pbest_thread;
 
 } // end choose_thread
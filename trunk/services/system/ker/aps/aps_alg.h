@@ -94,5 +94,11 @@ extern int      sb_partition_is_ready[APS_MAX_PARTITIONS][PROCESSORS_MAX];
 #define SB_PARTITION_IS_NOT_READY(ap) (sb_partition_is_ready[ap][KERNCPU] = 0)  
 
 
+/* merit order: partition ids sorted by increasing relative fraction used, see aps_alg.c */
+extern	uint8_t		merit_order[APS_MAX_PARTITIONS];
+extern	int		merit_num;
+extern	volatile uint32_t	merit_gen;
+
+
 __SRCVERSION("aps_alg.h $Rev: 153052 $"); 
 
@@ -150,6 +150,7 @@ reinit_window_parms(int new_windowsize_ms)
 		remaining_bankruptcy_grace = max_bankruptcy_grace;  
 		
 		cur_hist_index =0; 
+		merit_num = 0; 
 		for (ap=0;ap<num_ppg;ap++) { 
 			PPG *ppg;
 			ppg = actives_ppg[ap]; 
@@ -167,6 +168,12 @@ reinit_window_parms(int new_windowsize_ms)
 		if (system_ppg) system_ppg->critical_budget_in_cycles = NUM_PROCESSORS * windowsize_in_cycles; 
 		
 		zero_idle_cycles(); 
+		zero_cpu_bills(); 
+		//every rfu is back to its minimum, and choose_thread_to_schedule() has been ignoring the merit order since
+		//merit_num was cleared
+		INTR_LOCK(&aps_lock);
+		merit_rebuild(); 
+		INTR_UNLOCK(&aps_lock);
    		 hist_index_w2 = hist_index_w3 = 0; //PR27890 
 		/* no need to call set_factors() since budgets in percent have not changed */ 
     		if (curr_window_rotations == sched_window_rotations) return EOK; 
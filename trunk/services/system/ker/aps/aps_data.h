@@ -86,8 +86,9 @@ extern	uint64_t	cycles_per_bucket;
  */
 
 
-/* ppg_entry defines the main partition data strucure. It is an extenstion of object.h:DISPATCH */ 
-#define APS_MAX_PARTITIONS 8
+/* ppg_entry defines the main partition data strucure. It is an extenstion of object.h:DISPATCH.
+ * The partition sets in aps_alg.c are uint32_t bitmaps, so there can be at most 32 */ 
+#define APS_MAX_PARTITIONS 32
 
 
 struct ppg_entry {
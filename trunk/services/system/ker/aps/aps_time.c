@@ -64,6 +64,19 @@ uint64_t 	last_time_raw;       /* last raw time for any processor */
 /* last raw times read per processor, used to calculate how long a thread has been running on a particular cpu*/
 uint64_t	cur_time_raw[PROCESSORS_MAX];
 
+/* per-cpu billing accumulators. 
+ *
+ * microbill_one_cpu() keeps the running totals (ppg->used_cycles etc.) current, since that's what the scheduler
+ * looks at, but puts the time for the current bucket into the billing cpu's own accumulator rather than into
+ * ppg->usage_hist[cur_hist_index]. fold_cpu_bills() moves the accumulators into the buckets when the tick rotates the
+ * window. That keeps other cpus' microbills off the history cache lines, which matters once there are many partitions.
+ */
+struct aps_cpu_bill { 
+	uint32_t	usage[APS_MAX_PARTITIONS];
+	uint32_t	critical[APS_MAX_PARTITIONS];
+	uint32_t	idle;
+} aps_cpu_bill[PROCESSORS_MAX];
+
 
 
 /* ------------------------------------------------------------------
@@ -86,6 +99,38 @@ void init_microbill() {
 
 
 
+/* ------------------------------------------------------------------
+ * zero_cpu_bills() 
+ * 
+ * discard the per-cpu accumulators. For when the whole scheduling history is reset. 
+ */ 
+void zero_cpu_bills(void) {
+	memset(aps_cpu_bill, 0, sizeof(aps_cpu_bill));
+}
+
+
+/* ------------------------------------------------------------------
+ * fold_cpu_bills() 
+ * 
+ * add the per-cpu accumulators into the current bucket of the scheduling window. Call with aps_lock held. 
+ */ 
+static void fold_cpu_bills(void) {
+	struct aps_cpu_bill	*bill;
+	int			cpu, ap;
+	
+	for (cpu=0; cpu<NUM_PROCESSORS; cpu++) { 
+		bill = &aps_cpu_bill[cpu];
+		for (ap=0; ap<num_ppg; ap++) { 
+			actives_ppg[ap]->usage_hist[cur_hist_index] += bill->usage[ap];
+			actives_ppg[ap]->critical_usage_hist[cur_hist_index] += bill->critical[ap];
+			bill->usage[ap] = bill->critical[ap] = 0;
+		}
+		idle_hist[cur_hist_index] += bill->idle;
+		bill->idle = 0;
+	}
+}
+
+
 /* ------------------------------------------------------------------
  * microbill_one_cpu 
  * 
@@ -119,14 +164,15 @@ microbill_one_cpu(THREAD *thp, int cpu, uint64_t new_time_raw) {
 	
 	/* Idle threads don't get accounted */
 	if(thp->priority != 0) {
-		ppg->usage_hist[cur_hist_index] += delta;
+		aps_cpu_bill[cpu].usage[ppg->dpp.id] += delta;
 		ppg->used_cycles += delta;
 		if (thp->sched_flags&AP_SCHED_BILL_AS_CRIT) { 
-			ppg->critical_usage_hist[cur_hist_index] += delta; 
+			aps_cpu_bill[cpu].critical[ppg->dpp.id] += delta; 
 			ppg->critical_cycles_used += delta;
 		}
+		if (delta) merit_billed(ppg->dpp.id); 
 	} else { 
-		idle_hist[cur_hist_index] += delta;
+		aps_cpu_bill[cpu].idle += delta;
 		idle_cycles += delta;
 	}
 	cur_time_raw[cpu] = new_time_raw;
@@ -280,6 +326,8 @@ int rdecl ppg_tick_hook(void) {
 	 * the running totals, and then making the last slot the current slot 
 	 */
 	INTR_LOCK(&aps_lock);
+	//the current bucket gets what the cpus have billed since the last tick
+	fold_cpu_bills(); 
 	//rotate the scheduling window and check for wrap
 	if(++cur_hist_index >= ts_buckets ) cur_hist_index =0; 
 	for(i = 0; i < num_ppg; i++) {
@@ -303,9 +351,14 @@ int rdecl ppg_tick_hook(void) {
 	idle_cycles_lasttick = idle_cycles; 
 	idle_cycles -= idle_hist[cur_hist_index];
 	idle_hist[cur_hist_index]=0; 
+	//every rfu just dropped by a different amount
+	merit_rebuild(); 
 	sched_window_rotations++;
 	INTR_UNLOCK(&aps_lock);
 
+	//once per window, report how long scheduling decisions have been taking
+	if (cur_hist_index == 0) aps_trace_window_rotated(); 
+
 	/* Bankrupcy handling */ 
 	
 	//to minumize bankruptcy checking overhead, only check when current thread is billed critical
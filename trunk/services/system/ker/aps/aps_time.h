@@ -40,5 +40,8 @@ extern uint64_t		max_microbill_cycles;
 
 extern uint32_t		cycles_left_in_tick; /* only valid if microbill() has been recently called */ 
 
+/* to lock access to global timing variables, and the merit order in aps_alg.c */
+extern struct intrspin	aps_lock;
+
 __SRCVERSION("aps_time.h $Rev: 153052 $"); 
 
@@ -45,5 +45,43 @@ sched_trace_initial_parms_ppg() {
 }
 
 
+
+/* scheduling-decision latency
+ *
+ * choose_thread_to_schedule() reports how many ClockCycles() each decision took. Each cpu keeps its own count, total
+ * and maximum for the current scheduling window, and ppg_tick_hook() has them emitted as one
+ * _NTO_TRACE_SYS_APS_SCHED_LAT event per cpu whenever the window wraps. 
+ */
+static struct { 
+	uint32_t	count;
+	uint32_t	max;
+	uint64_t	total;
+} sched_lat[PROCESSORS_MAX];
+
+void
+aps_trace_sched_latency(int cpu, uint32_t cycles) {
+	sched_lat[cpu].count++;
+	sched_lat[cpu].total += cycles;
+	if (cycles > sched_lat[cpu].max) sched_lat[cpu].max = cycles;
+}
+
+void
+aps_trace_window_rotated(void) {
+	int		cpu;
+	uint32_t	count;
+	
+	for (cpu=0; cpu<NUM_PROCESSORS; cpu++) { 
+		count = sched_lat[cpu].count; 
+		if (count) { 
+			trace_emit_sys_aps_sched_lat(cpu, count, (uint32_t)(sched_lat[cpu].total/count), sched_lat[cpu].max);
+		}
+		//the counts of other cpus may be bumped while we do this. Losing a decision from a report is harmless.
+		sched_lat[cpu].count = 0;
+		sched_lat[cpu].total = 0;
+		sched_lat[cpu].max = 0;
+	}
+}
+
+
 __SRCVERSION("aps_trace.c $Rev: 153052 $"); 
 
@@ -108,6 +108,12 @@ if(new->runmask & (1 << RUNCPU)) {
 	new->state = STATE_RUNNING;
 	SB_PARTITION_IS_RUNNING(new->dpp->id);
 	new->runcpu = KERNCPU;
+	if(new->intrlat_level != 0) {
+		intrlat_running(new);
+	}
+	if(running_owners != NULL) {
+		running_owners[KERNCPU] = SYNC_OWNER(new);
+	}
 
 	trace_emit_th_state(new, STATE_RUNNING);
 
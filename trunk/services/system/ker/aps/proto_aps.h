@@ -196,6 +196,14 @@ DISPATCH *aps_select_ppg(PROCESS *prp, int id);
 void set_factors (); 
 
 
+/* 
+ * merit_rebuild: re-sorts the merit order after the rfu of many partitions changed: window rotation, new
+ * budgets, new partitions. merit_billed: moves one partition after its rfu grew. Call both with aps_lock held.
+ */
+void merit_rebuild(void);
+void merit_billed(int ap);
+
+
 
 
 /*-------------------------------
@@ -245,6 +253,9 @@ THREAD *choose_between(THREAD *a, THREAD *b);
 /* initalize microbill */ 
 void init_microbill();
 
+/* discard the per-cpu billing accumulators, used when the scheduling history is wiped */
+void zero_cpu_bills(void);
+
 
 /* record time spend in the current thread since the last call to microbill(). Call when the state
  * of a running thread changes or a thread jumps partitions 
@@ -290,6 +301,11 @@ void handle_bankruptcy(THREAD *act, PPG *ppg);
 /* trace out intial budgets and names */ 
 void sched_trace_initial_parms_ppg();
 
+/* scheduling-decision latency: account one run of choose_thread_to_schedule() on this cpu, and emit the
+ * per-cpu summaries once per scheduling window */
+void aps_trace_sched_latency(int cpu, uint32_t cycles);
+void aps_trace_window_rotated(void);
+
 
 /* ----------------------------------------------------------------------------------------------
  * from aps_application_error.c 
@@ -165,6 +165,8 @@ VALUE( IPI_RESCHED,			IPI_RESCHED );
 VALUE( IPI_TIMESLICE,		IPI_TIMESLICE );
 VALUE( IPI_TLB_FLUSH,		IPI_TLB_FLUSH );
 VALUE( IPI_TLB_SAFE,		IPI_TLB_SAFE );
+VALUE( TLB_FLUSH_NPAGES_MASK,	TLB_FLUSH_NPAGES_MASK );
+VALUE( TLB_FLUSH_ALL,		TLB_FLUSH_ALL );
 VALUE( IPI_CONTEXT_SAVE,	IPI_CONTEXT_SAVE );
 VALUE( IPI_CHECK_INTR,      IPI_CHECK_INTR );
 VALUE( IPI_INTR_MASK,	    IPI_INTR_MASK );
@@ -187,6 +187,7 @@ EXT PROCESS					*actives_prp[PROCESSORS_MAX];
 EXT PROCESS					*aspaces_prp[PROCESSORS_MAX];
 EXT const struct fault_handlers		*volatile xfer_handlers[PROCESSORS_MAX];
 EXT struct cpupage_entry	*cpupageptr[PROCESSORS_MAX];
+EXT volatile uint32_t		*running_owners;
 #if !COND_EXT(HAVE_KERSTACK_STORAGE)
 	EXT uintptr_t			ker_stack[PROCESSORS_MAX];
 #endif
@@ -196,6 +197,9 @@ EXT MEMMGR					memmgr;
 EXT memclass_id_t			sys_memclass_id;	// generic system ram memory class
 EXT void					(rdecl *mark_running)(THREAD *act);
 EXT THREAD					*actives_pcr[PROCESSORS_MAX];
+EXT volatile unsigned		tlb_flush_pending[PROCESSORS_MAX];
+EXT unsigned				tlb_flush_received[PROCESSORS_MAX];
+EXT struct tlb_flush_stats	tlb_flush_stats[PROCESSORS_MAX];
 EXT HASH	sync_hash        INIT1(0x3ff);	// Must be a mask
 
 
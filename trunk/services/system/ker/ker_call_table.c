@@ -132,7 +132,10 @@
 	pref##_bad,				\
 	pref##_bad,             \
                                                         \
-        pref##_mt_ctl         \
+        pref##_mt_ctl,        \
+							\
+	pref##_msg_receivemulti,\
+	pref##_msg_replymulti	\
 
 int kdecl (* ker_call_table[])() ={
 	MK_KERTABLE(ker)
@@ -632,6 +635,14 @@ int kdecl _trace_ker_msg_replyv(THREAD *act, struct kerargs_msg_replyv *kap)
 		_TRACE_IN_F_0PTR(__KER_MSG_REPLYV, kap->rcvid, kap->status);
 	}
 }
+int kdecl _trace_ker_msg_receivemulti(THREAD *act, struct kerargs_msg_receivemulti *kap)
+{
+	_TRACE_IN_F_0PTR(__KER_MSG_RECEIVEMULTI, kap->chid, kap->nrcv);
+}
+int kdecl _trace_ker_msg_replymulti(THREAD *act, struct kerargs_msg_replymulti *kap)
+{
+	_TRACE_IN_F_0PTR(__KER_MSG_REPLYMULTI, kap->nrep, NULL);
+}
 int kdecl _trace_ker_msg_readv(THREAD *act, struct kerargs_msg_readv *kap)
 {
 	if(_TRACE_CALL_ARG_WIDE&trace_masks.ker_call_masks[__KER_MSG_READV]) {
@@ -1512,6 +1523,14 @@ static void _trace_ex_ker_msg_replyv(THREAD *act, struct kerargs_msg_replyv *kap
 {
 	_TRACE_OUT_F(__KER_MSG_REPLYV, NULL);
 }
+static void _trace_ex_ker_msg_receivemulti(THREAD *act, struct kerargs_msg_receivemulti *kap)
+{
+	_TRACE_OUT_F(__KER_MSG_RECEIVEMULTI, NULL);
+}
+static void _trace_ex_ker_msg_replymulti(THREAD *act, struct kerargs_msg_replymulti *kap)
+{
+	_TRACE_OUT_F(__KER_MSG_REPLYMULTI, NULL);
+}
 static void _trace_ex_ker_msg_readv(THREAD *act, struct kerargs_msg_readv *kap)
 {
 	if(_TRACE_CALL_ARG_WIDE&trace_masks.ker_call_masks[__KER_MSG_READV]) {
@@ -403,6 +403,28 @@ ker_msg_sendv(THREAD *act, struct kerargs_msg_sendv *kap) {
 	while((thp != NULL) && (thp->internal_flags & _NTO_ITF_MSG_DELIVERY)) {
 		thp = thp->next.thread;
 	}
+#endif
+#if defined(VARIANT_smp)
+	// If the first receiver can't run on this cpu, look for one that can,
+	// e.g. from a thread pool with its threads spread over the cpus. The
+	// message is then served on the cpu it was sent from. Only receivers
+	// at the head's priority are considered, so the choice never changes
+	// the priority the message is served at (e.g. on a fixed priority
+	// channel) compared to taking the head.
+	if((thp != NULL) && !(thp->internal_flags & _NTO_ITF_RCVPULSE) &&
+	   (thp->runmask & (1 << KERNCPU))) {
+		THREAD	*alt;
+
+		for(alt = thp->next.thread; alt != NULL; alt = alt->next.thread) {
+			if(alt->internal_flags & _NTO_ITF_RCVPULSE) break;
+			if(alt->priority != thp->priority) continue;
+			if(alt->internal_flags & _NTO_ITF_MSG_DELIVERY) continue;
+			if((alt->runmask & (1 << KERNCPU)) == 0) {
+				thp = alt;
+				break;
+			}
+		}
+	}
 #endif
 	if((thp != NULL) && !(thp->internal_flags & _NTO_ITF_RCVPULSE) ) {
 
@@ -1383,6 +1405,280 @@ xfer_err:
 	return status;
 }
 
+/*
+ * Batched receive and reply, so that a busy server can move several
+ * messages through one kernel entry.
+ *
+ * Only what the fast paths above already do without switching address
+ * space is batched: buffered (short) messages and pulses on the receive
+ * side, short replies that the client picks up in specret on the reply
+ * side. Anything else ends the batch and is left for MsgReceivev() and
+ * MsgReplyv().
+ *
+ * All of the copying is done with the kernel unlocked and all of the state
+ * changes in one locked section afterwards, so a preemption before the
+ * lock simply restarts the whole call.
+ */
+#define MSG_MULTI_MAX	16
+
+int kdecl
+ker_msg_receivemulti(THREAD *act, struct kerargs_msg_receivemulti *kap) {
+	CHANNEL						*chp;
+	CONNECT						*cop;
+	THREAD						*thp;
+	VECTOR						*chvec;
+	struct _msg_receive_entry	*rcv;
+	THREAD						*batch[MSG_MULTI_MAX];
+	int							 chid, nrcv, n, i;
+
+	chid = act->last_chid = kap->chid;		// Used for priority boost
+	chvec = &act->process->chancons;
+
+	if(chid & _NTO_GLOBAL_CHANNEL) {
+		chid &= ~_NTO_GLOBAL_CHANNEL;
+		chvec = &chgbl_vector;
+	}
+	if((chp = vector_lookup(chvec, chid)) == NULL  ||
+	   chp->type != TYPE_CHANNEL) {
+	   	lock_kernel();
+		return ESRCH;
+	}
+	if(chp->flags & (_NTO_CHF_ASYNC | _NTO_CHF_GLOBAL)) {
+		return ENOTSUP;
+	}
+	if(kap->flags != 0  ||  (nrcv = kap->nrcv) <= 0) {
+		return EINVAL;
+	}
+	if(nrcv > MSG_MULTI_MAX) {
+		nrcv = MSG_MULTI_MAX;
+	}
+	rcv = kap->rcv;
+	WR_VERIFY_PTR(act, rcv, nrcv * sizeof(*rcv));
+	WR_PROBE_INT(act, rcv, nrcv * sizeof(*rcv) / sizeof(int));
+
+	// Copy out everything at the head of the send queue which we can.
+	n = 0;
+	for(thp = pril_first(&chp->send_queue); thp != NULL  &&  n < nrcv; thp = thp->next.thread) {
+		void		*msg = rcv[n].msg;
+		int			 bytes = rcv[n].bytes;
+		unsigned	 type = TYPE_MASK(thp->type);
+
+		if(bytes < 0) {
+			break;
+		}
+		if(type == TYPE_PULSE) {
+			PULSE *pup = (PULSE *)(void *)thp;
+
+			if(xferpulse(act, msg, -bytes, pup->code, pup->value, pup->id)) {
+				break;
+			}
+			rcv[n].rcvid = 0;
+		} else {
+			if(type != TYPE_THREAD  ||
+			   thp->state != STATE_SEND  ||
+			   !(thp->flags & _NTO_TF_BUFF_MSG)  ||
+			   (thp->internal_flags & _NTO_ITF_MSG_DELIVERY)  ||
+			   IMTO(thp, STATE_REPLY)) {
+				break;
+			}
+			cop = thp->blocked_on;
+			if(cop->flags & COF_NETCON) {
+				break;
+			}
+			if(xfer_cpy_diov(act, msg, thp->args.msbuff.buff, -bytes, thp->args.msbuff.msglen)) {
+				break;
+			}
+			STUFF_RCVINFO(thp, cop, &rcv[n].info);
+			if(rcv[n].info.msglen > bytes) {
+				rcv[n].info.msglen = bytes;
+			}
+			rcv[n].rcvid = (thp->tid << 16) | cop->scoid;
+		}
+		batch[n++] = thp;
+	}
+
+	if(n == 0) {
+		struct kerargs_msg_receivev	rkap;
+
+		// Nothing we can batch, so this is an ordinary receive into the
+		// first entry, blocking if need be. The rcvid is returned as for
+		// MsgReceive() and the entry's rcvid is left at -1 so the library
+		// can tell the two results apart.
+		rcv[0].rcvid = -1;
+		rkap.chid = kap->chid;
+		rkap.rmsg = rcv[0].msg;
+		rkap.rparts = -rcv[0].bytes;
+		rkap.info = &rcv[0].info;
+		rkap.coid = 0;
+		return ker_msg_receivev(act, &rkap);
+	}
+
+	lock_kernel();
+	_TRACE_COMM_IPC_RET(act);
+	act->timeout_flags = 0;
+	act->restart = NULL;
+
+	if((thp = act->client) != 0) {
+		/* need to clear client's server field */
+		act->client = 0;
+		thp->args.ms.server = 0;
+	}
+
+	// The send queue is in priority order, so the first entry decides the
+	// priority we run at, exactly as if it had been received by itself.
+	for(i = 0; i < n; ++i) {
+		thp = batch[i];
+		if(TYPE_MASK(thp->type) == TYPE_PULSE) {
+			PULSE *pup = (PULSE *)(void *)thp;
+
+			if(i == 0) {
+				if(act->priority != pup->priority  &&  (chp->flags & _NTO_CHF_FIXED_PRIORITY) == 0) {
+					adjust_priority(act, pup->priority, act->process->default_dpp, 1);
+					act->real_priority = act->priority;
+				} else if(act->dpp != act->process->default_dpp) {
+					adjust_priority(act, act->priority, act->process->default_dpp, 1);
+				}
+			}
+			pulse_remove(chp->process, &chp->send_queue, pup);
+			continue;
+		}
+
+		thp->restart = NULL;
+		if(i == 0) {
+			thp->args.ms.server = act;
+			act->client = thp;
+			if((act->priority != thp->priority || act->dpp != thp->dpp) &&  (chp->flags & _NTO_CHF_FIXED_PRIORITY) == 0) {
+				AP_INHERIT_CRIT(act, thp);
+				adjust_priority(act, thp->priority, thp->dpp, 1);
+				if(act->real_priority != act->priority) act->real_priority = act->priority;
+			} else {
+				AP_CLEAR_CRIT(act);
+			}
+		}
+
+		pril_rem(&chp->send_queue, thp);
+		thp->state = STATE_REPLY;
+		snap_time(&thp->timestamp_last_block,0);
+		_TRACE_TH_EMIT_STATE(thp, REPLY);
+		LINKPRIL_BEG(chp->reply_queue, thp, THREAD);
+	}
+
+	SETKSTATUS(act, n);
+	return ENOERROR;
+}
+
+int kdecl
+ker_msg_replymulti(THREAD *act, struct kerargs_msg_replymulti *kap) {
+	struct _msg_reply_entry	*rep;
+	THREAD					*batch[MSG_MULTI_MAX];
+	CONNECT					*cops[MSG_MULTI_MAX];
+	int						 status[MSG_MULTI_MAX];
+	int						 lens[MSG_MULTI_MAX];
+	int						 nrep, n, i;
+
+	if((nrep = kap->nrep) <= 0) {
+		return EINVAL;
+	}
+	if(nrep > MSG_MULTI_MAX) {
+		nrep = MSG_MULTI_MAX;
+	}
+	rep = kap->rep;
+	RD_VERIFY_PTR(act, rep, nrep * sizeof(*rep));
+	RD_PROBE_INT(act, rep, nrep * sizeof(*rep) / sizeof(int));
+
+	// Same checks as ker_msg_replyv(), but the batch ends at anything
+	// which isn't a short reply to a local client we can leave to specret.
+	for(n = 0; n < nrep; ++n) {
+		CONNECT		*cop;
+		THREAD		*thp;
+		int			 rcvid = rep[n].rcvid;
+		int			 len = rep[n].bytes;
+		uintptr_t	 base = (uintptr_t)rep[n].msg;
+
+		if((cop = vector_lookup(&act->process->chancons, MCINDEX(rcvid))) == NULL  ||
+		   cop->type != TYPE_CONNECTION  ||
+		   cop->process == NULL  ||
+		   (cop->flags & COF_NETCON)) {
+			break;
+		}
+		if((thp = vector_lookup(&cop->process->threads, MTINDEX(rcvid))) == NULL  ||
+		   thp->state != STATE_REPLY  ||
+		   thp->aspace_prp == NULL  ||
+		   (thp->internal_flags & (_NTO_ITF_SPECRET_PENDING | _NTO_ITF_UNBLOCK_QUEUED))) {
+			break;
+		}
+		if(thp->blocked_on != cop) {
+			CONNECT *cop1 = cop;
+			cop = thp->blocked_on;
+			if((cop->flags & COF_VCONNECT) == 0 || cop->un.lcl.cop != cop1) {
+				break;
+			}
+		}
+		if(len < 0  ||  len > sizeof(thp->args.msbuff.buff)) {
+			break;
+		}
+		// The reply is staged in the client, so each one only once.
+		for(i = 0; i < n; ++i) {
+			if(batch[i] == thp) break;
+		}
+		if(i < n) {
+			break;
+		}
+		// As in ker_msg_replyv(), so a MsgRead() on another cpu doesn't
+		// take the reply being copied in for the client's message.
+		thp->flags &= ~(_NTO_TF_BUFF_MSG | _NTO_TF_SHORT_MSG);
+		if(len != 0) {
+			if((base + len - 1 < base) || !WITHIN_BOUNDRY(base, base + len - 1, act->process->boundry_addr)) {
+				break;
+			}
+			if(xfer_memcpy(thp->args.msbuff.buff, (void *)base, len)) {
+				break;
+			}
+			thp->args.msbuff.msglen = len;
+		}
+		batch[n] = thp;
+		cops[n] = cop;
+		status[n] = rep[n].status;
+		lens[n] = len;
+	}
+
+	if(n == 0) {
+		// The library replies to the first entry with MsgReplyv().
+		return EOK;
+	}
+
+	lock_kernel();
+	for(i = 0; i < n; ++i) {
+		THREAD	*thp = batch[i];
+		CONNECT	*cop = cops[i];
+
+		thp->flags &= ~(_NTO_TF_BUFF_MSG | _NTO_TF_SHORT_MSG | _NTO_TF_UNBLOCK_REQ);
+		if(lens[i] != 0) {
+			thp->blocked_on = thp;
+			thp->flags |= (_NTO_TF_BUFF_MSG | _NTO_TF_SHORT_MSG);
+		}
+		_TRACE_COMM_EMIT_REPLY(thp, cop, thp->tid+1);
+
+		if(thp->args.ms.server != 0) {
+			thp->args.ms.server->client = 0;
+			thp->args.ms.server = 0;
+		}
+
+		thp->restart = NULL;
+		LINKPRIL_REM(thp);
+		if(--cop->links == 0) {
+			connect_detach(cop, thp->priority);
+		}
+
+		ready(thp);
+		SETKSTATUS(thp, status[i]);
+	}
+	act->restart = NULL;
+
+	SETKSTATUS(act, n);
+	return ENOERROR;
+}
+
 int kdecl
 ker_msg_error(THREAD *act, struct kerargs_msg_error *kap) {
 	CONNECT				*cop;
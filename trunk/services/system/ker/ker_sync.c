@@ -101,6 +101,9 @@ ker_sync_create(THREAD *act, struct kerargs_sync_create *kap) {
 				if(attr->__flags & PTHREAD_ERRORCHECK_DISABLE) {
 					count |= _NTO_SYNC_NOERRORCHECK;
 				}
+				if(attr->__flags & PTHREAD_ADAPTIVE_ENABLE) {
+					count |= _NTO_SYNC_ADAPTIVE;
+				}
 			}
 #ifndef IGNORE_OLD_SYNC_CREATE
 		} else {
@@ -99,6 +99,18 @@ union kerargs {
 		KARGSLOT(int32_t	sparts);
 	} msg_replyv;
 
+	struct kerargs_msg_receivemulti {
+		KARGSLOT(int32_t					chid);
+		KARGSLOT(struct _msg_receive_entry	*rcv);
+		KARGSLOT(int32_t					nrcv);
+		KARGSLOT(uint32_t					flags);
+	} msg_receivemulti;
+
+	struct kerargs_msg_replymulti {
+		KARGSLOT(struct _msg_reply_entry	*rep);
+		KARGSLOT(int32_t					nrep);
+	} msg_replymulti;
+
 	struct kerargs_msg_readv {
 		KARGSLOT(int32_t	rcvid);
 		KARGSLOT(IOV		*rmsg);
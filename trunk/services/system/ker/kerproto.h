@@ -36,6 +36,8 @@ int           kdecl ker_connect_flags(THREAD *act, struct kerargs_connect_flags
 int           kdecl ker_msg_sendv(THREAD *act, struct kerargs_msg_sendv *kap);
 int           kdecl ker_msg_receivev(THREAD *act, struct kerargs_msg_receivev *kap);
 int           kdecl ker_msg_replyv(THREAD *act, struct kerargs_msg_replyv *kap);
+int           kdecl ker_msg_receivemulti(THREAD *act, struct kerargs_msg_receivemulti *kap);
+int           kdecl ker_msg_replymulti(THREAD *act, struct kerargs_msg_replymulti *kap);
 int           kdecl ker_msg_sendpulse(THREAD *act, struct kerargs_msg_sendpulse *kap);
 int           kdecl ker_msg_error(THREAD *act, struct kerargs_msg_error *kap);
 int           kdecl ker_msg_readv(THREAD *act, struct kerargs_msg_readv *kap);
@@ -163,6 +165,13 @@ int           rdecl interrupt_unmask(int intr, INTERRUPT *itp);
 int           rdecl interrupt_mask_vector(unsigned vector, int id);
 int           rdecl interrupt_unmask_vector(unsigned vector, int id);
 int           rdecl get_interrupt_level(THREAD *act, unsigned vector);
+void          rdecl intrlat_init(unsigned num_levels);
+void          rdecl intrlat_attach(int level);
+void          rdecl intrlat_queue_start(INTRLEVEL *lp);
+void          rdecl intrlat_handler_enter(INTERRUPT *itp);
+void          rdecl intrlat_handler_exit(INTERRUPT *itp);
+void          rdecl intrlat_event(THREAD *thp, INTERRUPT *isr);
+void          rdecl intrlat_running(THREAD *thp);
 
 unsigned            (xferiov_pos)(CPU_REGISTERS *regs);
 int                 (xferiov)(THREAD *sthp, IOV *dst, IOV *src, int dparts, int sparts, int doff, int soff);
@@ -235,6 +244,7 @@ void                trace_emit_th_state(THREAD *thp, int state);
 void				trace_emit_sys_aps_name(uint32_t id, char *name);
 void				trace_emit_sys_aps_budgets(uint32_t id, uint32_t percent, uint32_t critical);
 void				trace_emit_sys_aps_bankruptcy(uint32_t id, pid_t pid, int32_t tid);
+void				trace_emit_sys_aps_sched_lat(uint32_t cpu, uint32_t count, uint32_t avg, uint32_t max);
 void				trace_emit_address(THREAD *thp, unsigned vaddr);
 
 void                waitpage_status_get(THREAD *thp, debug_thread_t *dtp);
@@ -221,6 +221,8 @@ if (trace_masks.system_mask[_NTO_TRACE_SYS_APS_NAME]&_TRACE_ENTER_SYSTEM) aps_na
 if (trace_masks.system_mask[_NTO_TRACE_SYS_APS_BUDGETS]&_TRACE_ENTER_SYSTEM) aps_budgets_em(id, percent, critical);
 #define _TRACE_SYS_APS_BANKRUPTCY(id,pid,tid) \
 if (trace_masks.system_mask[_NTO_TRACE_SYS_APS_BNKR]&_TRACE_ENTER_SYSTEM) aps_bankruptcy_em(id, pid, tid);
+#define _TRACE_SYS_APS_SCHED_LAT(cpu,count,avg,max) \
+if (trace_masks.system_mask[_NTO_TRACE_SYS_APS_SCHED_LAT]&_TRACE_ENTER_SYSTEM) aps_sched_lat_em(cpu, count, avg, max);
 
 #define _TRACE_SYS_EMIT_ADDRESS(thp,vaddr)\
 if (trace_masks.system_mask[_NTO_TRACE_SYS_ADDRESS]&_TRACE_ENTER_SYSTEM) trace_emit_address((thp),(vaddr));
@@ -254,6 +256,7 @@ if (trace_masks.system_mask[_NTO_TRACE_SYS_ADDRESS]&_TRACE_ENTER_SYSTEM) trace_e
 #define _TRACE_SYS_APS_NAME(id,name)
 #define _TRACE_SYS_APS_BUDGETS(id,percent,critical)
 #define _TRACE_SYS_APS_BANKRUPTCY(id,pid,tid)
+#define _TRACE_SYS_APS_SCHED_LAT(cpu,count,avg,max)
 #define _TRACE_SYS_EMIT_ADDRESS(thp,vaddr)
 
 #endif
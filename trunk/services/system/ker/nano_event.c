@@ -305,6 +305,11 @@ intrevent_add(const struct sigevent *evp, THREAD *thp, INTERRUPT *isr) {
 			evp = &ev_copy;
 		}
 	};
+	if(SIGEV_GET_TYPE(evp) == SIGEV_INTR) {
+		// Only an InterruptWait() event readies thp itself. sigevent_exe()
+		// drops the stamp again if thp turns out not to be waiting.
+		intrlat_event(thp, isr);
+	}
 
 #if !defined(VARIANT_smp)	/* PDB: condition is true */
 	//
@@ -738,6 +743,11 @@ sigevent_exe(const struct sigevent *evp, THREAD *thp, int deliver) {
 				ready(thp);
 			} else {
 				thp->flags |= _NTO_TF_INTR_PENDING;
+				// Not readied by this event; keep a stamp only if an
+				// earlier one readied thp and it hasn't run yet.
+				if(thp->state != STATE_READY) {
+					thp->intrlat_level = 0;
+				}
 			}
 		}
 		break;
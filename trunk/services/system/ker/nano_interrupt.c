@@ -89,6 +89,7 @@ interrupt_init() {
 	}
 	interrupt_level = _scalloc((num_external_levels+NUM_HOOK_RTNS) * sizeof(*interrupt_level));
 	interrupt_level += NUM_HOOK_RTNS; //Point at first external level
+	intrlat_init(num_external_levels);
 
 	// Set the mask count of all interrupt levels to one, point at
 	// appropriate info entry.
@@ -206,6 +207,7 @@ interrupt_attach(int level, const struct sigevent *(*handler)(void *area, int id
 	*owner = itp;
 
 	if(count == 0) {
+		intrlat_attach(level);
 		/* enable level when first handler gets installed */
 		do { } while(interrupt_unmask(level, NULL) != 0);
 	}
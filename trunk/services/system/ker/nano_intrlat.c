@@ -0,0 +1,174 @@
+/*
+ * $QNXLicenseC:
+ * Copyright 2007, QNX Software Systems. All Rights Reserved.
+ *
+ * You must obtain a written license from and pay applicable license fees to QNX
+ * Software Systems before you may reproduce, modify or distribute this software,
+ * or any work that includes all or part of this software.   Free development
+ * licenses are available for evaluation and non-commercial purposes.  For more
+ * information visit http://licensing.qnx.com or email licensing@qnx.com.
+ *
+ * This file may contain contributions from others.  Please review this entire
+ * file for other proprietary rights or license notices, as well as the QNX
+ * Development Suite License Guide at http://licensing.qnx.com/license-guide/
+ * for other information.
+ * $
+ */
+
+#include "externs.h"
+
+//
+// Always-on interrupt latency histograms.
+//
+// For every interrupt level that has ever had a handler attached we keep,
+// per cpu, log2 histograms (in ClockCycles() units) of:
+//
+//	entry		- from the kernel starting to process the level's queue
+//				  to each handler being called. Later handlers on a shared
+//				  level include the time of the ones before them.
+//	handler		- how long the handler ran.
+//	dispatch	- from an event being queued for the attaching thread to that
+//				  thread being made running.
+//
+// The entry and handler samples come from the CPU specific interrupt
+// dispatch code (only x86 kernel.S calls intrlat_queue_start() and friends
+// for now). The dispatch samples come from intrevent_add() and mark_running(),
+// so they're collected on every CPU.
+//
+// A cpu only ever writes its own histograms, and a given level can't nest on
+// itself, so the start stamps can live with the histograms without locking.
+// Only the low 32 bits of ClockCycles() are kept; nothing here is expected
+// to take anywhere near a wrap.
+//
+
+struct intrlat {
+	uint32_t				start;			// level processing started
+	uint32_t				handler_start;	// current handler called
+	struct intrlat_entry	hist;
+};
+
+static struct intrlat		**intrlat_levels;
+static unsigned				intrlat_num_levels;
+
+static unsigned
+intrlat_bucket(uint32_t cycles) {
+	if(cycles >> 16) {
+		if(cycles >> 24) return 24 + byte_log2[cycles >> 24];
+		return 16 + byte_log2[cycles >> 16];
+	}
+	if(cycles >> 8) return 8 + byte_log2[cycles >> 8];
+	return byte_log2[cycles];
+}
+
+static struct intrlat *
+intrlat_get(unsigned level) {
+	struct intrlat	*ilp;
+
+	if(level >= intrlat_num_levels) return NULL;
+	ilp = intrlat_levels[level];
+	if(ilp == NULL) return NULL;
+	return &ilp[RUNCPU];
+}
+
+void rdecl
+intrlat_init(unsigned num_levels) {
+	intrlat_levels = _scalloc(num_levels * sizeof(*intrlat_levels));
+	if(intrlat_levels != NULL) {
+		intrlat_num_levels = num_levels;
+	}
+}
+
+//
+// Called when a handler is attached to an external level. The histograms
+// are kept after the last detach so that they survive a driver restart.
+//
+void rdecl
+intrlat_attach(int level) {
+	struct intrlat	*ilp;
+
+	if((unsigned)level >= intrlat_num_levels) return;
+	if(intrlat_levels[level] != NULL) return;
+	ilp = _scalloc(NUM_PROCESSORS * sizeof(*ilp));
+	if(ilp == NULL) return;	// no histograms for this level, not fatal
+	intrlat_levels[level] = ilp;
+}
+
+void rdecl
+intrlat_queue_start(INTRLEVEL *lp) {
+	struct intrlat	*ilp;
+
+	ilp = intrlat_get(lp - interrupt_level);
+	if(ilp != NULL) {
+		ilp->start = (uint32_t)ClockCycles();
+	}
+}
+
+void rdecl
+intrlat_handler_enter(INTERRUPT *itp) {
+	struct intrlat	*ilp;
+	uint32_t		now;
+
+	ilp = intrlat_get(itp->level);
+	if(ilp != NULL) {
+		now = (uint32_t)ClockCycles();
+		ilp->handler_start = now;
+		ilp->hist.entry[intrlat_bucket(now - ilp->start)]++;
+	}
+}
+
+void rdecl
+intrlat_handler_exit(INTERRUPT *itp) {
+	struct intrlat	*ilp;
+
+	ilp = intrlat_get(itp->level);
+	if(ilp != NULL) {
+		ilp->hist.handler[intrlat_bucket((uint32_t)ClockCycles() - ilp->handler_start)]++;
+	}
+}
+
+//
+// A SIGEV_INTR event is being queued for thp. If it's still waiting to run
+// from an earlier one, the earlier stamp is kept.
+//
+void rdecl
+intrlat_event(THREAD *thp, INTERRUPT *isr) {
+	if(thp == NULL || isr == NULL || (unsigned)isr->level >= intrlat_num_levels) return;
+	if(thp->intrlat_level == 0) {
+		thp->intrlat_stamp = (uint32_t)ClockCycles();
+		thp->intrlat_level = isr->level + 1;
+	}
+}
+
+void rdecl
+intrlat_running(THREAD *thp) {
+	struct intrlat	*ilp;
+
+	ilp = intrlat_get(thp->intrlat_level - 1);
+	if(ilp != NULL) {
+		ilp->hist.dispatch[intrlat_bucket((uint32_t)ClockCycles() - thp->intrlat_stamp)]++;
+	}
+	thp->intrlat_level = 0;
+}
+
+//
+// Copy out the histograms of one cpu for a level, for procfs.
+// Returns the first level at or after 'level' which has histograms,
+// -1 if there are no more.
+//
+int rdecl
+intrlat_query(unsigned level, unsigned cpu, unsigned *vector, struct intrlat_entry *hist) {
+	struct intrlat	*ilp;
+
+	if(cpu >= NUM_PROCESSORS) return -1;
+	for( ;; ) {
+		if(level >= intrlat_num_levels) return -1;
+		ilp = intrlat_levels[level];
+		if(ilp != NULL) break;
+		++level;
+	}
+	*vector = _TRACE_INT_NUM(&interrupt_level[level]);
+	memcpy(hist, &ilp[cpu].hist, sizeof(*hist));
+	return level;
+}
+
+__SRCVERSION("nano_intrlat.c $Rev: 153052 $");
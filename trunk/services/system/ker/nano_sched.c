@@ -286,6 +286,12 @@ mark_running_default(THREAD *new) {
 
 	new->state = STATE_RUNNING;
 	new->runcpu = KERNCPU;
+	if(new->intrlat_level != 0) {
+		intrlat_running(new);
+	}
+	if(running_owners != NULL) {
+		running_owners[KERNCPU] = SYNC_OWNER(new);
+	}
 
 	_TRACE_TH_EMIT_STATE(new, RUNNING);
 
@@ -151,6 +151,7 @@ chk_lock();
 	thp->last_chid = -1;
 	thp->syscall = -1;
 	thp->client = 0;
+	thp->intrlat_level = 0;
 	snap_time(&thp->start_time, 1);
 	//no need to init thp->timestamp_since_block since we start READY
 
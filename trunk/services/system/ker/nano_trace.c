@@ -530,6 +530,38 @@ void aps_bankruptcy_em(uint32_t partition_id, pid_t pid, int tid)
 }
 
 
+// Emits APS scheduler decision latency for one cpu over the last scheduling window
+void aps_sched_lat_em(uint32_t cpu, uint32_t count, uint32_t avg_cycles, uint32_t max_cycles)
+{
+	struct buf {
+		uint32_t	cpu;
+		uint32_t	count;
+		uint32_t	avg_cycles;
+		uint32_t	max_cycles;
+	} buf;
+	uint32_t header=_TRACE_MAKE_CODE(
+	                                 RUNCPU,
+	                                 _TRACE_STRUCT_S,
+									 _TRACE_SYSTEM_C,
+	                                 _NTO_TRACE_SYS_APS_SCHED_LAT
+	                                );
+	buf.cpu = cpu;
+	buf.count = count;
+	buf.avg_cycles = avg_cycles;
+	buf.max_cycles = max_cycles;
+	if(_TRACE_CKH_EXE_EHB(
+								trace_masks.class_system_ehd_p,
+								trace_masks.system_ehd_p[_NTO_TRACE_SYS_APS_SCHED_LAT],
+								header,
+								(void *)&buf,
+								sizeof(buf)
+							   )) {
+		add_trace_buffer(header, (void *)&buf, _TRACE_ROUND_UP(sizeof(buf)) );
+	}
+	return;
+}
+
+
 // Emits time control events
 void time_em(uint32_t msb, uint32_t lsb)
 {
@@ -1895,4 +1927,9 @@ void trace_emit_sys_aps_bankruptcy(uint32_t id, pid_t pid, int32_t tid) {
 	return;
 }
 
+void trace_emit_sys_aps_sched_lat(uint32_t cpu, uint32_t count, uint32_t avg, uint32_t max) {
+	_TRACE_SYS_APS_SCHED_LAT(cpu, count, avg, max);
+	return;
+}
+
 __SRCVERSION("nano_trace.c $Rev: 206799 $");
@@ -17,15 +17,115 @@
 
 #include "externs.h"
 
+#if defined(CPU_TLB_RANGE_IPI)
+/*
+ * Add [start, start + npages) to the shootdown pending for the cpu.
+ * If the cpu hasn't taken the IPI for an earlier request yet, the two
+ * are merged so it only has to handle one. Once the merged range grows
+ * past TLB_FLUSH_RANGE_MAX pages it becomes a full flush.
+ */
+static void
+tlb_pend(int cpu, uintptr_t start, unsigned npages) {
+	unsigned	old;
+	unsigned	new;
+	uintptr_t	first;
+	uintptr_t	last;
+	uintptr_t	old_first;
+	uintptr_t	old_last;
+	unsigned	n;
+
+	do {
+		old = tlb_flush_pending[cpu];
+		if(old == TLB_FLUSH_ALL) break;
+		if(npages == TLB_FLUSH_ALL) {
+			new = TLB_FLUSH_ALL;
+		} else if(old == 0) {
+			new = start | npages;
+		} else {
+			// Work with the last page rather than the end so that
+			// ranges at the top of the address space don't wrap.
+			first = start;
+			last = start + (npages - 1) * __PAGESIZE;
+			old_first = old & ~TLB_FLUSH_NPAGES_MASK;
+			old_last = old_first + ((old & TLB_FLUSH_NPAGES_MASK) - 1) * __PAGESIZE;
+			if(old_first < first) first = old_first;
+			if(old_last > last) last = old_last;
+			n = ((last - first) / __PAGESIZE) + 1;
+			if(n > TLB_FLUSH_RANGE_MAX) {
+				new = TLB_FLUSH_ALL;
+			} else {
+				new = first | n;
+			}
+		}
+	} while(_smp_cmpxchg(&tlb_flush_pending[cpu], old, new) != old);
+}
+#endif
+
 void rdecl
 smp_flush_tlb(void) {
 	int i;
 
+	tlb_flush_stats[KERNCPU].requests++;
 	for(i = 0; i < NUM_PROCESSORS; ++i) {
 		if((i != KERNCPU) && alives[i]) {
+#if defined(CPU_TLB_RANGE_IPI)
+			tlb_pend(i, 0, TLB_FLUSH_ALL);
+#endif
 			SENDIPI(i, IPI_TLB_FLUSH);
+			tlb_flush_stats[KERNCPU].ipis++;
+		}
+	}
+}
+
+/*
+ * Shoot down the translations for the pages from start to end (inclusive)
+ * on the other cpus. If adp is non-NULL the range is in that user address
+ * space, and only the cpus that have it loaded need to be told - a cpu
+ * running some other process had its user TLB entries dropped when it
+ * switched page directories, and cpus that are idle or running a proc
+ * thread keep the last user aspace lazily loaded, so they stay in
+ * aspaces_prp[] and get the IPI.
+ */
+void rdecl
+smp_flush_tlb_range(ADDRESS *adp, uintptr_t start, uintptr_t end) {
+#if defined(CPU_TLB_RANGE_IPI)
+	struct tlb_flush_stats	*stats;
+	PROCESS					*prp;
+	unsigned				npages;
+	int						i;
+
+	stats = &tlb_flush_stats[KERNCPU];
+	stats->requests++;
+	start &= ~(__PAGESIZE - 1);
+	npages = ((end - start) / __PAGESIZE) + 1;
+	if(npages > TLB_FLUSH_RANGE_MAX) {
+		npages = TLB_FLUSH_ALL;
+	} else {
+		stats->ranged++;
+	}
+
+	// The page table updates have to be visible before we look at which
+	// aspace the other cpus have. vmm_aspace() sets aspaces_prp[] before
+	// loading the page directory, so any cpu we skip here will walk the
+	// new entries.
+	MEM_BARRIER_RW();
+	for(i = 0; i < NUM_PROCESSORS; ++i) {
+		if((i == KERNCPU) || !alives[i]) continue;
+		if(adp != NULL) {
+			prp = aspaces_prp[i];
+			if((prp == NULL) || (prp->memory != adp)) {
+				stats->skipped++;
+				continue;
+			}
 		}
+		tlb_pend(i, start, npages);
+		SENDIPI(i, IPI_TLB_FLUSH);
+		stats->ipis++;
 	}
+#else
+	// The other cpus can only drop their whole TLB
+	smp_flush_tlb();
+#endif
 }
 
 __SRCVERSION("smp_flush_tlb.c $Rev: 153052 $");
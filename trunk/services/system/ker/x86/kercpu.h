@@ -165,6 +165,8 @@ void smp_clr_INKERNEL_SPECRET(void);
 	#define atomic_clr(m, v)		smp_locked_and(m, ~(v))
 	#define HAVE_INKERNEL_STORAGE	1
 	#define INKERNEL_BITS_SHIFT	8
+	// The IPI_TLB_FLUSH handler understands tlb_flush_pending[] ranges
+	#define CPU_TLB_RANGE_IPI		1
 #else
 	#define atomic_set(m, v)	(*(m) |= (v))
 	#define atomic_clr(m, v)	(*(m) &= ~(v))
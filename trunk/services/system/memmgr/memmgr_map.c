@@ -20,7 +20,7 @@
 #include "mm_internal.h"
 
 static int (* const fs_check[])(const resmgr_io_funcs_t *, mem_map_t *, void *, OBJECT **) = {
-	devmem_check, devzero_check, imagefs_check 
+	devmem_check, devzero_check, imagefs_check, namedsem_check
 };
 
 int
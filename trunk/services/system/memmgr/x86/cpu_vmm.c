@@ -455,6 +455,8 @@ cpu_pte_manipulate(struct mm_pte_manipulate *data) {
 	unsigned			op;
 	part_id_t		mpid;
 	PROCESS *			prp;
+	uintptr_t			flush_first;
+	uintptr_t			flush_last;
 
 	#define PMF_USER		0x0001 // mapping in user address range
 	#define PMF_ACTIVE		0x0002 // can use the active page table
@@ -533,6 +535,7 @@ cpu_pte_manipulate(struct mm_pte_manipulate *data) {
 
 	r = EOK;
 	cr0 = 0; // Dummy assignment to shut GCC up.
+	flush_first = flush_last = 0;
 	pa_status = 0; //shut Lint up.
 	prp = adp ? object_from_data(adp, address_cookie) : NULL;
 	mpid = mempart_getid(prp, sys_memclass_id);
@@ -691,7 +694,11 @@ cpu_pte_manipulate(struct mm_pte_manipulate *data) {
 				}
 			}
 #else
-			flags |= PMF_SMPFLUSH;
+			if(!(flags & PMF_SMPFLUSH)) {
+				flags |= PMF_SMPFLUSH;
+				flush_first = curr;
+			}
+			flush_last = curr;
 #endif
 		}
 		curr += __PAGESIZE;
@@ -712,7 +719,11 @@ cpu_pte_manipulate(struct mm_pte_manipulate *data) {
 		flushtlb();
 	}
 	if(flags & PMF_SMPFLUSH) {
-		SMP_FLUSH_TLB();
+		if(flags & PMF_INVLPG) {
+			SMP_FLUSH_TLB_RANGE((flags & PMF_USER) ? adp : NULL, flush_first, flush_last);
+		} else {
+			SMP_FLUSH_TLB();
+		}
 	}
 	data->start = curr;
 	return r;
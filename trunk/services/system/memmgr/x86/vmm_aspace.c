@@ -25,8 +25,11 @@ vmm_aspace(PROCESS *actprp, PROCESS **pactprp) {
 
 	if((adp = actprp->memory)) {
 		InterruptDisable();
-		ldpgdir(adp->cpu.ptroot_paddr);
+		// Publish the new aspace before loading it (the load is
+		// serializing) so that smp_flush_tlb_range() never skips a
+		// cpu that could have cached the old translations.
 		*pactprp = actprp;
+		ldpgdir(adp->cpu.ptroot_paddr);
 		InterruptEnable();
 	}
 }
@@ -698,6 +698,45 @@ static const resmgr_connect_funcs_t tymem_connect_funcs = {
 };
 
 
+/*
+ * Adaptive mutexes in libc spin only while the owner is running. Give
+ * the kernel a page for the sync owner id of each cpu's active thread,
+ * mapped in the system address space so it can be written whatever
+ * aspace is loaded, and publish the same page read-only in the pathname
+ * space for libc to mmap().
+ */
+static void
+running_owners_init(void) {
+	mem_map_t		msg;
+	OBJECT			*obp;
+	void			*addr;
+	size_t			size;
+	int				r;
+
+	if(NUM_PROCESSORS < 2) {
+		return;
+	}
+	memset(&msg, 0, sizeof(msg));
+	msg.i.flags = MAP_ANON | MAP_SHARED;
+	msg.i.len = __PAGESIZE;
+	if(!(obp = pathmgr_object_attach(NULL, 0, _NTO_RUNNING_OWNERS, OBJECT_MEM_SHARED, 0, &msg))) {
+		return;
+	}
+	obp->mem.pm.mode = S_IFNAM | S_IRUSR | S_IRGRP | S_IROTH;
+	proc_mux_lock(&obp->mem.mm.mux);
+	r = memmgr.mmap(NULL, 0, __PAGESIZE, PROT_READ | PROT_WRITE, MAP_SHARED, obp, 0, 0, 0, NOFD, &addr, &size, obp->hdr.mpid);
+	proc_mux_unlock(&obp->mem.mm.mux);
+	if(r != EOK) {
+		pathmgr_object_detach(obp);
+		pathmgr_object_done(obp);
+		return;
+	}
+	// The page is zero filled, so no cpu claims an owner yet. The
+	// reference from the attach is kept for as long as the kernel uses it.
+	running_owners = addr;
+}
+
+
 void 
 devmem_init(void) {
 	resmgr_attr_t	rattr;
@@ -712,6 +751,7 @@ devmem_init(void) {
 	//RUSH3: structure
 	resmgr_attach(dpp, NULL, "/dev/tymem", _FTYPE_TYMEM, _RESMGR_FLAG_DIR, &tymem_connect_funcs, &tymem_io_funcs, 0);
 	rsrcdbmgr_proc_devno("dev", &mem_devno, -1, 0);
+	running_owners_init();
 }
 
 
@@ -27,6 +27,31 @@
 #include <sys/elf_nto.h>
 #include <pathmgr_object.h>
 
+struct image_name {
+	const char					*path;		/* not NUL terminated at len */
+	const char					*comp;		/* last component, as handed to readdir */
+	union image_dirent			*match;		/* last live entry with exactly this path */
+	union image_dirent			*link;		/* first live symlink with exactly this path */
+	union image_dirent			*attr;		/* dirent supplying an implicit dir's attributes */
+	uint32_t					hash;
+	int32_t						next;
+	int32_t						parent;
+	uint32_t					child;
+	uint32_t					nchildren;
+	uint16_t					len;
+	uint16_t					index;
+	int							isdir;
+};
+
+struct image_index {
+	size_t						size;
+	unsigned					mask;
+	unsigned					nnames;
+	int32_t						*buckets;
+	struct image_name			*names;
+	char						**children;
+};
+
 struct image_data {
 	struct image_header			*addr;
 	union image_dirent			*dir;
@@ -35,6 +60,12 @@ struct image_data {
 	size_t						pg_offset;
 	OBJECT						*obp;
 	int							in_user_space;
+	pthread_mutex_t				mutex;
+	struct image_index			*index;
+	int							index_stale;
+	unsigned					nfiles;
+	union image_dirent			**files;
+	size_t						index_size;
 };
 
 static struct image_ocb {
@@ -170,6 +201,238 @@ image_getdir_children(union image_dirent *startdir, char *path, char ***children
 	return ncount;
 }
 
+/*
+ Hashed directory index.
+
+ Walking every dirent on each open gets expensive once an image holds
+ a few thousand files, so when the image is mounted we build a hash of
+ every live path plus every directory prefix implied by a path. Names
+ are entered in image order, which keeps the children of a directory in
+ the same order image_getdir_children() would report them. The whole
+ index is a single _smalloc'd block so its size is easy to account for.
+ Unlinking an entry marks the index stale and it is rebuilt on the next
+ lookup. If we can't get the memory we fall back to the linear scans.
+*/
+#define IMAGE_NEXT_DIRENT(dir)	((union image_dirent *)((uintptr_t)(dir) + (dir)->attr.size))
+#define IMAGE_HASH_INIT			2166136261U
+#define IMAGE_HASH_STEP(h, c)	(((h) ^ (uint8_t)(c)) * 16777619U)
+
+static uint32_t
+image_hash(const char *path, unsigned len) {
+	uint32_t	hash = IMAGE_HASH_INIT;
+
+	while(len-- != 0) {
+		hash = IMAGE_HASH_STEP(hash, *path++);
+	}
+	return hash;
+}
+
+static int
+image_name_find(struct image_index *idx, const char *path, unsigned len, uint32_t hash) {
+	int32_t						i;
+	struct image_name			*np;
+
+	for(i = idx->buckets[hash & idx->mask]; i >= 0; i = np->next) {
+		np = &idx->names[i];
+		if(np->hash == hash && np->len == len && memcmp(np->path, path, len) == 0) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+static int
+image_name_enter(struct image_index *idx, const char *path, unsigned len, const char *comp, int parent) {
+	uint32_t					hash = image_hash(path, len);
+	struct image_name			*np;
+	int							i;
+
+	if((i = image_name_find(idx, path, len, hash)) < 0) {
+		i = idx->nnames++;
+		np = &idx->names[i];
+		memset(np, 0, sizeof *np);
+		np->path = path;
+		np->len = len;
+		np->comp = comp;
+		np->hash = hash;
+		np->parent = parent;
+		np->next = idx->buckets[hash & idx->mask];
+		idx->buckets[hash & idx->mask] = i;
+		if(parent >= 0) {
+			idx->names[parent].nchildren++;
+		}
+	}
+	return i;
+}
+
+static struct image_index *
+image_index_build(struct image_data *image) {
+	union image_dirent			*dir, *lastdir;
+	struct image_index			*idx;
+	struct image_name			*np, *pp;
+	unsigned					maxnames, nbuckets, nchild, i;
+	size_t						size;
+	char						*p;
+	int							root;
+
+	/* Each path yields at most one name per component, plus the root */
+	maxnames = 1;
+	for(dir = image->dir; dir->attr.size; dir = IMAGE_NEXT_DIRENT(dir)) {
+		if((p = image_get_path(dir))) {
+			for(maxnames++; *p; p++) {
+				if(*p == '/') {
+					maxnames++;
+				}
+			}
+		}
+	}
+	for(nbuckets = 16; nbuckets < maxnames * 2; nbuckets <<= 1) {
+		/* nothing to do */
+	}
+
+	size = sizeof *idx + maxnames * (sizeof *idx->names + sizeof *idx->children)
+			+ nbuckets * sizeof *idx->buckets;
+	if(!(idx = _smalloc(size))) {
+		return NULL;
+	}
+	idx->size = size;
+	idx->mask = nbuckets - 1;
+	idx->nnames = 0;
+	idx->names = (struct image_name *)(idx + 1);
+	idx->children = (char **)(idx->names + maxnames);
+	idx->buckets = (int32_t *)(idx->children + maxnames);
+	memset(idx->buckets, 0xff, nbuckets * sizeof *idx->buckets);
+
+	root = image_name_enter(idx, "", 0, NULL, -1);
+	lastdir = NULL;
+	for(dir = image->dir; dir->attr.size; dir = IMAGE_NEXT_DIRENT(dir)) {
+		char					*entry_name;
+		unsigned				start, end;
+		int						parent;
+
+		if(!(entry_name = image_get_path(dir))) {
+			continue;
+		}
+		if(S_ISDIR(dir->attr.mode)) {
+			lastdir = dir;
+		}
+
+		/* Enter every directory prefix of the path, recording it as a child of the previous one */
+		parent = root;
+		for(start = 0;;) {
+			pp = &idx->names[parent];
+			if(!pp->isdir) {
+				pp->isdir = 1;
+				pp->attr = lastdir;
+			}
+			pp->index = ((uintptr_t)entry_name - (uintptr_t)image->dir) + pp->len;
+
+			while(entry_name[start] == '/') {
+				start++;
+			}
+			if(entry_name[start] == '\0') {
+				break;
+			}
+			for(end = start; entry_name[end] && entry_name[end] != '/'; end++) {
+				/* nothing to do */
+			}
+			i = image_name_enter(idx, entry_name, end, &entry_name[start], parent);
+			if(entry_name[end] == '\0') {
+				break;
+			}
+			parent = i;
+			start = end;
+		}
+
+		/* Finally the entry itself; normally this is the last component just entered */
+		np = &idx->names[image_name_enter(idx, entry_name, strlen(entry_name), NULL, -1)];
+		np->match = dir;
+		if(S_ISLNK(dir->attr.mode) && !np->link) {
+			np->link = dir;
+		}
+	}
+
+	/* Lay the per-directory child arrays out back to back */
+	nchild = 0;
+	for(i = 0; i < idx->nnames; i++) {
+		np = &idx->names[i];
+		np->child = nchild;
+		nchild += np->nchildren;
+		np->nchildren = 0;
+	}
+	for(i = 0; i < idx->nnames; i++) {
+		np = &idx->names[i];
+		if(np->parent >= 0) {
+			pp = &idx->names[np->parent];
+			idx->children[pp->child + pp->nchildren++] = (char *)np->comp;
+		}
+	}
+
+	return idx;
+}
+
+static int
+image_file_cmp(const void *a, const void *b) {
+	const union image_dirent	*fa = *(union image_dirent * const *)a;
+	const union image_dirent	*fb = *(union image_dirent * const *)b;
+
+	if(fa->file.offset < fb->file.offset) return -1;
+	if(fa->file.offset > fb->file.offset) return 1;
+	return 0;
+}
+
+/*
+ Regular files sorted by data offset, so imagefs_fname() can binary search.
+ Entries with ino == 0 are kept, they're [data=uip]. This never changes
+ after mount, so it doesn't need the index lock.
+*/
+static void
+image_files_build(struct image_data *image) {
+	union image_dirent			*dir;
+	unsigned					n;
+
+	image->files = NULL;
+	image->nfiles = 0;
+	n = 0;
+	for(dir = image->dir; dir->attr.size; dir = IMAGE_NEXT_DIRENT(dir)) {
+		if(S_ISREG(dir->attr.mode) && dir->file.size != 0) {
+			n++;
+		}
+	}
+	if(n == 0 || !(image->files = _smalloc(n * sizeof *image->files))) {
+		return;
+	}
+	for(dir = image->dir; dir->attr.size; dir = IMAGE_NEXT_DIRENT(dir)) {
+		if(S_ISREG(dir->attr.mode) && dir->file.size != 0) {
+			image->files[image->nfiles++] = dir;
+		}
+	}
+	qsort(image->files, image->nfiles, sizeof *image->files, image_file_cmp);
+	image->index_size += image->nfiles * sizeof *image->files;
+}
+
+static void
+image_index_free(struct image_data *image) {
+	if(image->index) {
+		image->index_size -= image->index->size;
+		_sfree(image->index, image->index->size);
+		image->index = NULL;
+	}
+}
+
+/* Must be called with image->mutex held */
+static struct image_index *
+image_index_get(struct image_data *image) {
+	if(image->index_stale) {
+		image_index_free(image);
+		if((image->index = image_index_build(image))) {
+			image->index_size += image->index->size;
+			image->index_stale = 0;
+		}
+	}
+	return image->index;
+}
+
 static int 
 image_read(resmgr_context_t *ctp, io_read_t *msg, void *vocb) {
 	struct image_ocb			*ocb = vocb;
@@ -539,14 +802,13 @@ static resmgr_io_funcs_t image_io_funcs = {
    entry is returned.  This is the case with internal directory 
    references.
 
- This is kind of wastefull in terms of search time, but is cheap
- since it uses the existing in memory structure, even though we
- have to iterate over all the entries each open.
+ This is kind of wastefull in terms of search time, so it's only
+ used when we couldn't get memory for the hashed index below.
 */
 #define LOOKUP_INT_DIR	0x1
 #define LOOKUP_INT_LNK	0x2
 static union image_dirent *
-image_lookup(struct image_data *image, struct _io_connect *connect, int *state) {
+image_lookup_scan(struct image_data *image, struct _io_connect *connect, int *state) {
 	union image_dirent			*dir, *altdir, *lnkdir, *matchdir, *lastdir = 0;
 	char						*entry_name, *name = connect->path;
 	int							len, entry_len;
@@ -601,6 +863,101 @@ image_lookup(struct image_data *image, struct _io_connect *connect, int *state)
 	return altdir;
 }
 
+/*
+ Same preferences as image_lookup_scan(), answered from the hash index:
+ each '/' in the path is a candidate symlink prefix (shortest first),
+ then the path itself is either an entry or an implied directory.
+*/
+static union image_dirent *
+image_lookup_index(struct image_index *idx, const char *name, int *state) {
+	struct image_name			*np;
+	uint32_t					hash;
+	unsigned					i;
+	int							n;
+
+	hash = IMAGE_HASH_INIT;
+	for(i = 0; name[i]; i++) {
+		if(i != 0 && name[i] == '/') {
+			if((n = image_name_find(idx, name, i, hash)) >= 0 && idx->names[n].link) {
+				*state = LOOKUP_INT_LNK;
+				return idx->names[n].link;
+			}
+		}
+		hash = IMAGE_HASH_STEP(hash, name[i]);
+	}
+
+	if((n = image_name_find(idx, name, i, hash)) >= 0) {
+		np = &idx->names[n];
+		if(np->match) {
+			*state = 0;
+			return np->match;
+		}
+		if(np->isdir && np->attr) {
+			*state = LOOKUP_INT_DIR;
+			return np->attr;
+		}
+	}
+	*state = LOOKUP_INT_DIR;
+	return NULL;
+}
+
+static union image_dirent *
+image_lookup(struct image_data *image, struct _io_connect *connect, int *state) {
+	struct image_index			*idx;
+	union image_dirent			*dir;
+
+	pthread_mutex_lock(&image->mutex);
+	if((idx = image_index_get(image))) {
+		dir = image_lookup_index(idx, connect->path, state);
+		pthread_mutex_unlock(&image->mutex);
+		if(!dir) {
+			errno = ENOENT;
+		}
+		return dir;
+	}
+	pthread_mutex_unlock(&image->mutex);
+	return image_lookup_scan(image, connect, state);
+}
+
+/*
+ Give an ocb its own copy of a directory's child list, so the index can
+ be rebuilt underneath open directories.
+*/
+static int
+image_getdir(struct image_data *image, char *path, char ***children, uint16_t *childcount, uint16_t *index) {
+	struct image_index			*idx;
+	struct image_name			*np;
+	unsigned					count;
+	int							n;
+
+	pthread_mutex_lock(&image->mutex);
+	if(!(idx = image_index_get(image))) {
+		pthread_mutex_unlock(&image->mutex);
+		return image_getdir_children(image->dir, path, children, childcount, index);
+	}
+
+	count = 0;
+	*children = NULL;
+	if((n = image_name_find(idx, path, strlen(path), image_hash(path, strlen(path)))) >= 0) {
+		np = &idx->names[n];
+		count = min(np->nchildren, 0xffff);
+		if(count != 0) {
+			if((*children = _smalloc(count * sizeof(char **)))) {
+				memcpy(*children, &idx->children[np->child], count * sizeof(char **));
+			} else {
+				count = 0;
+			}
+		}
+		if(np->isdir) {
+			*index = np->index;
+		}
+	}
+	pthread_mutex_unlock(&image->mutex);
+
+	*childcount = count;
+	return count;
+}
+
 static int 
 image_link_redirect(resmgr_context_t *ctp, io_open_t *msg, 
 							   struct image_symlink *symlinkp, int redirect) {
@@ -716,7 +1073,7 @@ image_open(resmgr_context_t *ctp, io_open_t *msg, void *handle, void *extra) {
 		ocb->index = 0;
 		if (notmatch == LOOKUP_INT_DIR || S_ISDIR(dire->attr.mode)) {
 			//kprintf("Get directory children [%s]\n", msg->connect.path);
-			(void)image_getdir_children(image->dir, msg->connect.path, &ocb->children, &ocb->childcount, &ocb->index);
+			(void)image_getdir(image, msg->connect.path, &ocb->children, &ocb->childcount, &ocb->index);
 			if(notmatch != LOOKUP_INT_DIR) {
 				ocb->index = 0;
 			}
@@ -787,6 +1144,7 @@ image_unlink(resmgr_context_t *ctp, io_unlink_t *msg, void *handle, void *extra)
 			}
 
 			dire->attr.ino = 0;
+			image->index_stale = 1;
 		}
 		r = dire->attr.ino ? EROFS : EOK;
 		IMAGE_ADDRESSABLE_DONE(image);
@@ -1008,6 +1366,12 @@ imagefs_mount(paddr_t paddr, unsigned size, unsigned offset, unsigned flags, str
 	image->pg_offset = pg_offset;
 	image->obp = obp;
 	image->in_user_space = in_user_space;
+	pthread_mutex_init(&image->mutex, NULL);
+	image->index = NULL;
+	image->index_stale = 1;
+	image->index_size = 0;
+	image_files_build(image);
+	(void)image_index_get(image);
 	pathmgr_object_clone(obp);
 
 	// Hide the image pointer in the object - imagefs_fname needs it.
@@ -1025,6 +1389,11 @@ imagefs_mount(paddr_t paddr, unsigned size, unsigned offset, unsigned flags, str
 
 fail5:
 	pathmgr_object_done(obp);
+	image_index_free(image);
+	if(image->files) {
+		_sfree(image->files, image->nfiles * sizeof *image->files);
+	}
+	pthread_mutex_destroy(&image->mutex);
 	//Undo rsrcdbmgr_proc_devno() above
 	rsrcdbmgr_proc_devno(NULL, &image->devno, -1, 0);
 
@@ -1137,6 +1506,7 @@ imagefs_check(const resmgr_io_funcs_t *funcs, mem_map_t *msg, void *handle, OBJE
 				// since we're going to damage the R/W data when we run.
 				msg->i.flags = (msg->i.flags & ~MAP_TYPE) | MAP_SHARED;
 				dire->attr.ino = 0;
+				image->index_stale = 1;
 			}
 		} else {
 			// Is it aligned by page?
@@ -1173,13 +1543,35 @@ imagefs_fname(OBJECT *obp, unsigned off, size_t max, char *dest) {
 
 	IMAGE_ADDRESSABLE_SAVE(image, old_aspace);
 	name = "";
-	for(dir = image->dir; dir->attr.size; dir = (union image_dirent *)((uintptr_t)dir + dir->attr.size)) {
-		// Don't skip ino == 0 entries, they're [data=uip]
-		if(S_ISREG(dir->attr.mode)) {
-			if((off >= dir->file.offset) && (off < (dir->file.offset + dir->file.size))) {
-				//RUSH3: prefix with mount path?
+	if(image->files) {
+		unsigned	lo, hi, mid;
+
+		// Find the last file starting at or before off
+		lo = 0;
+		hi = image->nfiles;
+		while(lo < hi) {
+			mid = (lo + hi) / 2;
+			if(image->files[mid]->file.offset <= off) {
+				lo = mid + 1;
+			} else {
+				hi = mid;
+			}
+		}
+		if(lo != 0) {
+			dir = image->files[lo - 1];
+			if(off < (dir->file.offset + dir->file.size)) {
 				name = dir->file.path;
-				break;
+			}
+		}
+	} else {
+		for(dir = image->dir; dir->attr.size; dir = (union image_dirent *)((uintptr_t)dir + dir->attr.size)) {
+			// Don't skip ino == 0 entries, they're [data=uip]
+			if(S_ISREG(dir->attr.mode)) {
+				if((off >= dir->file.offset) && (off < (dir->file.offset + dir->file.size))) {
+					//RUSH3: prefix with mount path?
+					name = dir->file.path;
+					break;
+				}
 			}
 		}
 	}
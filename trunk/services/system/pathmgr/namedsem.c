@@ -48,6 +48,7 @@ struct semaphore;
 #include <sys/resource.h>
 #include <sys/sysmgr.h>
 #include <unistd.h>
+#include "pathmgr_object.h"
 
 /* POSIX allows either behaviour, historical QNX clips to 0, I like -ve */
 #undef  SEM_NEG_COUNT
@@ -68,6 +69,8 @@ typedef struct semaphore {
 	char				*name;
 	blocked_t			*blocked;
 	struct semaphore	*link;
+	OBJECT				*obp;
+	struct _sem_shared	*shared;
 } semaphore_t;
 
 typedef struct {
@@ -165,6 +168,8 @@ blocked_t	*blk;
 	if ((blk = sem->blocked) != NULL) {
 		*rcvid = blk->rcvid, *pri = blk->priority;
 		++sem->attr.nbytes;
+		if (sem->shared != NULL)
+			atomic_sub(&sem->shared->waiters, 1);
 		sem->blocked = blk->link;
 		(void)blocked_item(blk);
 	}
@@ -188,6 +193,8 @@ blocked_t	**head, *b;
 				else
 					MsgError(b->rcvid, error);
 				++sem->attr.nbytes;
+				if (sem->shared != NULL)
+					atomic_sub(&sem->shared->waiters, 1);
 				*head = b->link;
 				(void)blocked_item(b);
 			}
@@ -198,6 +205,86 @@ blocked_t	**head, *b;
 	}
 }
 
+/*
+ *  Back the semaphore count with a page of shared memory that clients
+ *  can mmap() from their descriptor, so that uncontended sem_post() and
+ *  sem_wait() are atomic operations in the client rather than messages.
+ *  The server keeps 'attr.nbytes' as minus the number of clients blocked
+ *  here.  Without the page everything goes through the server as before.
+ */
+static void share_sem(semaphore_t *sem)
+{
+mem_map_t	msg;
+OBJECT		*obp;
+void		*addr;
+size_t		size;
+int			r;
+
+	memset(&msg, 0, sizeof(msg));
+	msg.i.flags = MAP_ANON | MAP_SHARED;
+	msg.i.len = __PAGESIZE;
+	if ((obp = object_create(OBJECT_MEM_SHARED, &msg, NULL, sys_memclass_id)) == NULL)
+		return;
+	pathmgr_object_clone(obp);
+	proc_mux_lock(&obp->mem.mm.mux);
+	r = memmgr.mmap(NULL, 0, __PAGESIZE, PROT_READ | PROT_WRITE, MAP_SHARED, obp, 0, 0, 0, NOFD, &addr, &size, obp->hdr.mpid);
+	proc_mux_unlock(&obp->mem.mm.mux);
+	if (r != EOK) {
+		pathmgr_object_done(obp);
+		return;
+	}
+	sem->obp = obp;
+	sem->shared = addr;
+	sem->shared->value = sem->attr.nbytes;
+	sem->shared->waiters = 0;
+	sem->attr.nbytes = 0;
+}
+
+static void unshare_sem(semaphore_t *sem)
+{
+	if (sem->shared != NULL) {
+		(void)memmgr.munmap(NULL, (uintptr_t)sem->shared, __PAGESIZE, 0, sem->obp->hdr.mpid);
+		pathmgr_object_done(sem->obp);
+		sem->shared = NULL, sem->obp = NULL;
+	}
+}
+
+/*
+ *  Current value of the semaphore (-ve is the number of blocked clients).
+ */
+static int value_sem(semaphore_t *sem)
+{
+	return((sem->shared != NULL) ? (int)sem->shared->value + sem->attr.nbytes : sem->attr.nbytes);
+}
+
+/*
+ *  Take a token from a shared semaphore count.
+ */
+static int take_sem(semaphore_t *sem)
+{
+unsigned	v;
+
+	while ((v = sem->shared->value) != 0) {
+		if (_smp_cmpxchg(&sem->shared->value, v, v - 1) == v)
+			return(1);
+	}
+	return(0);
+}
+
+/*
+ *  Hand shared semaphore tokens to blocked clients (in queue order).
+ */
+static void wake_sem(semaphore_t *sem)
+{
+unsigned	pri;
+int			rcvid;
+
+	while (sem->blocked != NULL && take_sem(sem)) {
+		(void)dequeue_client(sem, &rcvid, &pri);
+		MsgReply(rcvid, 0, NULL, 0);
+	}
+}
+
 /*
  *  Create a new semaphore, and link into the list of created semaphores.
  */
@@ -215,6 +302,8 @@ semaphore_t	*sem;
 			memcpy(&sem->attr, attr, sizeof(iofunc_attr_t));
 			sem->attr.nbytes = sem->initial = ((initial != NULL) ? *initial : head->initial);
 			sem->blocked = NULL;
+			sem->obp = NULL, sem->shared = NULL;
+			share_sem(sem);
 			sem->link = head->link, head->link = sem;
 			++head->attr.nbytes;
 			return(sem);
@@ -265,6 +354,7 @@ semaphore_t	**sp;
 	}
 	if ((!sem->attr.nlink && !sem->attr.count) || force) {
 		unblock_clients(sem, NULL, -1, EBADF);
+		unshare_sem(sem);
 		_sfree(sem->name, strlen(sem->name) + 1);
 		_sfree(sem, sizeof(semaphore_t));
 	}
@@ -278,12 +368,12 @@ static void detail_sem(resmgr_context_t *ctp, semaphore_t *sem, struct stat *st,
 	memset(st, 0, sizeof(struct stat));
 	st->st_ino = (uintptr_t)sem;
 #ifdef SEM_NEG_COUNT
-	st->st_size = sem->attr.nbytes;
+	st->st_size = value_sem(sem);
 #if !defined(_FILE_OFFSET_BITS) || _FILE_OFFSET_BITS == 32
 	st->st_size_hi = (st->st_size < 0) ? -1 : 0;
 #endif
 #else
-	st->st_size = (sem->attr.nbytes >= 0) ? sem->attr.nbytes : 0;
+	st->st_size = (value_sem(sem) >= 0) ? value_sem(sem) : 0;
 #endif
 	st->st_dev = (ctp->info.srcnd << ND_NODE_BITS) | sem->attr.mount->dev;
 	st->st_rdev = namespace ? S_INSEM : sem->attr.rdev;
@@ -406,7 +496,26 @@ int			error, nonblock;
 	if (msg->i.nbytes != 0)
 		return(EMSGSIZE);
 	_mutex_lock(&SemaphoreMutex);
-	if (sem->attr.nbytes > 0) {
+	if (sem->shared != NULL) {
+		/* Count ourselves before looking, so a client post can't miss us */
+		atomic_add(&sem->shared->waiters, 1);
+		if (take_sem(sem)) {
+			_IO_SET_READ_NBYTES(ctp, 0);
+			error = EOK;
+		}
+		else if (nonblock) {
+			error = EAGAIN;
+		}
+		else if (enqueue_client(sem, ctp) == NULL) {
+			error = ENOMEM;
+		}
+		else {
+			error = _RESMGR_NOREPLY;
+		}
+		if (error != _RESMGR_NOREPLY)
+			atomic_sub(&sem->shared->waiters, 1);
+	}
+	else if (sem->attr.nbytes > 0) {
 		--sem->attr.nbytes;
 		_IO_SET_READ_NBYTES(ctp, 0);
 		error = EOK;
@@ -430,7 +539,7 @@ int			error, nonblock;
 int resmgr_sem_write(resmgr_context_t *ctp, io_write_t *msg, RESMGR_OCB_T *ocb)
 {
 semaphore_t	*sem;
-unsigned	pri;
+unsigned	pri, v;
 int			error, nonblock, rcvid;
 
 	sem = OCB2SEM(ocb);
@@ -441,7 +550,21 @@ int			error, nonblock, rcvid;
 	if (msg->i.nbytes != 0)
 		return(EMSGSIZE);
 	_mutex_lock(&SemaphoreMutex);
-	if (sem->attr.nbytes >= SEM_VALUE_MAX) {
+	if (sem->shared != NULL) {
+		do {
+			if ((v = sem->shared->value) >= SEM_VALUE_MAX)
+				break;
+		} while (_smp_cmpxchg(&sem->shared->value, v, v + 1) != v);
+		if (v >= SEM_VALUE_MAX) {
+			error = EAGAIN;
+		}
+		else {
+			wake_sem(sem);
+			_IO_SET_WRITE_NBYTES(ctp, 0);
+			error = EOK;
+		}
+	}
+	else if (sem->attr.nbytes >= SEM_VALUE_MAX) {
 		error = EAGAIN;
 	}
 	else if (sem->attr.nbytes >= 0 || dequeue_client(sem, &rcvid, &pri) == NULL) {
@@ -505,15 +628,25 @@ int				error;
 	case DCMD_MISC_MQGETATTR:
 		memset(value = (struct mq_attr *)_DEVCTL_DATA(msg->i), 0, sizeof(struct mq_attr));
 #ifdef SEM_NEG_COUNT
-		value->mq_curmsgs = sem->attr.nbytes;
+		value->mq_curmsgs = value_sem(sem);
 #else
-		value->mq_curmsgs = (sem->attr.nbytes >= 0) ? sem->attr.nbytes : 0;
+		value->mq_curmsgs = (value_sem(sem) >= 0) ? value_sem(sem) : 0;
 #endif
 		if (ctp->info.flags & _NTO_MI_ENDIAN_DIFF) {
 			ENDIAN_SWAP32(&value->mq_curmsgs);
 		}
 		error = _RESMGR_PTR(ctp, &msg->o, sizeof(msg->o) + sizeof(struct mq_attr));
 		break;
+	case DCMD_MISC_SEMPOST:
+		/* A client bumped the shared count and saw blocked clients */
+		if (sem->shared == NULL)
+			return(ENOTTY);
+		_mutex_lock(&SemaphoreMutex);
+		wake_sem(sem);
+		_mutex_unlock(&SemaphoreMutex);
+		memset(&msg->o, 0, sizeof(msg->o));
+		error = _RESMGR_PTR(ctp, &msg->o, sizeof(msg->o));
+		break;
 	default:
 		error = iofunc_devctl_default(ctp, msg, ocb);
 		break;
@@ -536,6 +669,29 @@ struct _msg_info	info;
 	return(_RESMGR_NOREPLY);
 }
 
+/*
+ *  Handle client/libc mmap() of the shared semaphore count (memmgr).
+ */
+int namedsem_check(const resmgr_io_funcs_t *funcs, mem_map_t *msg, void *handle, OBJECT **pobp)
+{
+semaphore_t	*sem;
+
+	if (funcs != &SemIoFuncs)
+		return(-1);
+	if ((sem = OCB2SEM((RESMGR_OCB_T *)handle))->obp == NULL)
+		return(ENOTSUP);
+	if (msg != NULL) {
+		if ((((RESMGR_OCB_T *)handle)->ioflag & (_IO_FLAG_RD | _IO_FLAG_WR)) != (_IO_FLAG_RD | _IO_FLAG_WR))
+			return(EACCES);
+		if ((msg->i.flags & MAP_TYPE) != MAP_SHARED)
+			return(EINVAL);
+		if (msg->i.offset != 0 || msg->i.len > __PAGESIZE)
+			return(ENXIO);
+	}
+	*pobp = sem->obp;
+	return(EOK);
+}
+
 /*
  *  Handle filesystem/pathname "open()".  The directory can be opened
  *  for readdir but the semaphores cannot be accessed except for stat.
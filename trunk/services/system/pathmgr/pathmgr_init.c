@@ -151,6 +151,10 @@ void pathmgr_init(void) {
 	message_attr_t						mattr;
 	resmgr_attr_t						rattr;
 
+	/* Publish the pathname space generation before anything is attached */
+	pathmgr_generation_shared = &SYSPAGE_ENTRY(system_private)->pathmgr_generation;
+	*pathmgr_generation_shared = pathmgr_generation;
+
 	/* Redirect PATHMGR messages to path handler */
 	memset(&mattr, 0x00, sizeof(mattr));
 	mattr.flags = MSG_FLAG_CROSS_ENDIAN;
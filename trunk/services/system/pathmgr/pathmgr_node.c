@@ -20,11 +20,169 @@
 #include <string.h>
 #include <pthread.h>
 #include <kernel/nto.h>
+#include <sys/procfs.h>
 #include "pathmgr_node.h"
 #include "pathmgr_object.h"
 #include "pathmgr_proto.h"
 
 pthread_mutex_t		pathmgr_mutex = PTHREAD_MUTEX_INITIALIZER;
+unsigned			pathmgr_generation = 1;
+static _Uint32t		pathmgr_generation_unpublished;
+volatile _Uint32t	*pathmgr_generation_shared = &pathmgr_generation_unpublished;
+
+/*
+ * Nodes with many children (/dev, the root of a system with a lot
+ * of mount points) get a hash of their children so that each path
+ * component is found without walking the sibling list. The sibling
+ * list is still maintained since readdir and friends walk it.
+ */
+struct node_hash {
+	unsigned			mask;
+	NODE				*bucket[1];
+};
+
+static procfs_pathmgr_stats		node_stats;
+
+#define NODE_HASH_INIT			2166136261U
+#define NODE_HASH_STEP(h, c)	(((h) ^ (uint8_t)(c)) * 16777619U)
+
+static uint32_t node_hash_name(const char *name, unsigned len) {
+	uint32_t			hash = NODE_HASH_INIT;
+
+	while(len-- != 0) {
+		hash = NODE_HASH_STEP(hash, *name++);
+	}
+	return hash;
+}
+
+static void node_hash_insert(struct node_hash *hp, NODE *n) {
+	NODE				**bp;
+
+	bp = &hp->bucket[node_hash_name(n->name, n->len) & hp->mask];
+	n->hash_next = *bp;
+	*bp = n;
+}
+
+/*
+ * (Re)build the child hash of a node sized for its current number of
+ * children. If we can't get the memory we just keep using the list.
+ */
+static void node_hash_build(NODE *nop) {
+	struct node_hash	*hp;
+	unsigned			nbuckets;
+	NODE				*n;
+
+	for(nbuckets = NODE_HASH_THRESHOLD * 2; nbuckets < nop->nchildren * 2; nbuckets <<= 1) {
+		/* nothing to do */
+	}
+	if(!(hp = _smalloc(offsetof(struct node_hash, bucket) + nbuckets * sizeof *hp->bucket))) {
+		return;
+	}
+	hp->mask = nbuckets - 1;
+	memset(hp->bucket, 0x00, nbuckets * sizeof *hp->bucket);
+	for(n = nop->child; n; n = n->sibling) {
+		node_hash_insert(hp, n);
+	}
+	if(nop->hash) {
+		_sfree(nop->hash, offsetof(struct node_hash, bucket) + (nop->hash->mask + 1) * sizeof *nop->hash->bucket);
+	} else {
+		node_stats.hashed_nodes++;
+	}
+	nop->hash = hp;
+}
+
+static void node_hash_free(NODE *nop) {
+	if(nop->hash) {
+		_sfree(nop->hash, offsetof(struct node_hash, bucket) + (nop->hash->mask + 1) * sizeof *nop->hash->bucket);
+		nop->hash = NULL;
+		node_stats.hashed_nodes--;
+	}
+}
+
+static NODE *node_child_find(NODE *nop, const char *name, unsigned len, uint32_t hash) {
+	NODE					*n;
+
+	node_stats.lookups++;
+	if(nop->hash) {
+		node_stats.hashed_lookups++;
+		for(n = nop->hash->bucket[hash & nop->hash->mask]; n; n = n->hash_next) {
+			if(len == n->len && !memcmp(name, n->name, len)) {
+				break;
+			}
+		}
+		return n;
+	}
+
+	for(n = nop->child; n; n = n->sibling) {
+		if(len == n->len && !memcmp(name, n->name, len)) {
+			break;
+		}
+	}
+	return n;
+}
+
+static void node_child_insert(NODE *nop, NODE *n) {
+	n->sibling = nop->child;
+	n->parent = nop;
+	nop->child = n;
+	nop->nchildren++;
+	PATHMGR_GENERATION_BUMP();
+
+	if(nop->hash) {
+		node_hash_insert(nop->hash, n);
+		if(nop->nchildren > (nop->hash->mask + 1) * 2) {
+			node_hash_build(nop);
+		}
+	} else if(nop->nchildren > NODE_HASH_THRESHOLD) {
+		node_hash_build(nop);
+	}
+}
+
+static void node_child_remove(NODE *nop, NODE *n) {
+	NODE				*p, **pp;
+
+	/* Unlink from parent or siblings */
+	for(pp = &nop->child; (p = *pp); pp = &p->sibling) {
+		if(p == n) {
+			*pp = p->sibling;
+			break;
+		}
+	}
+	CRASHCHECK(p == NULL);
+	nop->nchildren--;
+	PATHMGR_GENERATION_BUMP();
+
+	if(nop->hash) {
+		if(nop->nchildren <= NODE_HASH_THRESHOLD / 2) {
+			node_hash_free(nop);
+		} else {
+			for(pp = &nop->hash->bucket[node_hash_name(n->name, n->len) & nop->hash->mask]; (p = *pp); pp = &p->hash_next) {
+				if(p == n) {
+					*pp = p->hash_next;
+					break;
+				}
+			}
+			CRASHCHECK(p == NULL);
+		}
+	}
+}
+
+/*
+ * Snapshot of the resolution statistics, reported through procfs.
+ */
+void pathmgr_node_stats(procfs_pathmgr_stats *stats) {
+	pthread_mutex_lock(&pathmgr_mutex);
+	*stats = node_stats;
+	stats->generation = pathmgr_generation;
+	pthread_mutex_unlock(&pathmgr_mutex);
+}
+
+/*
+ * Count a path resolution. Must be called with pathmgr_mutex held.
+ */
+void pathmgr_node_resolved(void) {
+	node_stats.resolves++;
+}
 
 /*
  * Allocate a node entry, initializing it to zero with the name stuffed
@@ -99,19 +257,16 @@ NODE *pathmgr_node_lookup(register NODE *nop, register const char *path, unsigne
 	lasttail = NULL;
 	while(*path) {
 		unsigned						len;
+		uint32_t						hash;
 
 		/* Skip any multiple slashes */
+		hash = NODE_HASH_INIT;
 		for(len = 0; path[len] && path[len] != '/'; len++) {
-			/* nothing to do */
+			hash = NODE_HASH_STEP(hash, path[len]);
 		}
 
 		/* Search current level for a match */
-		for(n = nop->child; n; n = n->sibling) {
-			if(len == n->len && !memcmp(path, n->name, len)) {
-				break;
-			}
-		}
-
+		n = node_child_find(nop, path, len, hash);
 
 		if(!n) {
 			/* No match found */
@@ -119,9 +274,7 @@ NODE *pathmgr_node_lookup(register NODE *nop, register const char *path, unsigne
 				/* If we are linking create a node */
 				if((n = pathmgr_node_alloc(path, len))) {
 					/* Link it to the parent */
-					n->sibling = nop->child;
-					n->parent = nop;
-					nop->child = n;
+					node_child_insert(nop, n);
 				} else {
 					/* If no memory clean up */
 					nop->links++;
@@ -221,17 +374,12 @@ void pathmgr_node_detach_flags(NODE *nop, unsigned flags) {
 
 		/* Remove the node */
 		while(nop->links == 0 && !nop->child) {
-			NODE				*p, **pp;
+			NODE				*p;
 
 			CRASHCHECK(nop->parent == NULL);
+			CRASHCHECK(nop->hash != NULL);
 			/* Unlink from parent or siblings */
-			for(pp = &nop->parent->child; (p = *pp); pp = &p->sibling) {
-				if(p == nop) {
-					*pp = p->sibling;
-					break;
-				}
-			}
-			CRASHCHECK(p == NULL);
+			node_child_remove(nop->parent, nop);
 
 			/* Rember the parent */
 			p = nop->parent;
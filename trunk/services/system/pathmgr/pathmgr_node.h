@@ -23,18 +23,25 @@
 
 #define INODE_XOR(value) ((int)value ^ 0x19071975)
 
+struct node_hash;
+
 struct node_entry {
 	NODE						*parent;
 	NODE						*sibling;
 	NODE						*child;
 	OBJECT						*object;
+	struct node_hash			*hash;			/* Child hash, once there are enough children */
+	NODE						*hash_next;		/* Chain in the parent's child hash */
 	uint16_t					links;			/* Number of current access to this node */
 	uint16_t					child_objects;	/* Number of children with objects */
 	uint16_t					flags;
 	uint16_t					len;
+	uint16_t					nchildren;		/* Number of nodes on the child list */
 	char						name[1];
 };
 
+#define NODE_HASH_THRESHOLD		16				/* Hash children once a node has more than this */
+
 #define NODE_FLAG_NOCHILD		0x0001			/* No children allowed on this node */
 #define NODE_FLAG_NONSERVER		0x0002			/* There is a non-server object on this node */
 #define NODE_FLAG_UNLINKING		0x0004			/* The node is being unlinked */
@@ -48,6 +55,15 @@ struct node_entry {
 #define PATHMGR_LOOKUP_NOAUTO	0x00000020		/* Avoid reporting autocreated objects if possible */
 
 extern pthread_mutex_t			pathmgr_mutex;
+extern unsigned					pathmgr_generation;
+extern volatile _Uint32t		*pathmgr_generation_shared;
+
+/*
+ * Must be called with pathmgr_mutex held whenever the node tree or its objects change.
+ * The new value is also published in the system page, where libc's connect cache
+ * checks it before reusing a resolution.
+ */
+#define PATHMGR_GENERATION_BUMP()	(*pathmgr_generation_shared = ++pathmgr_generation)
 
 #endif
 
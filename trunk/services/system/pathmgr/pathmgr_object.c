@@ -110,6 +110,7 @@ pathmgr_object_attach(PROCESS *prp, NODE *nop, const char *path, int type, unsig
 
 	/* Mark flags for quicker searching later */
 	object_set_flags(nop, obp);
+	PATHMGR_GENERATION_BUMP();
 
 	/* Increment child_object count in all ancesters */
 	while(nop->parent != nop && (nop = nop->parent)) {
@@ -169,6 +170,7 @@ pathmgr_object_detach(OBJECT *obp) {
 		CRASHCHECK(anc->child_objects == 0);
 		anc->child_objects--;
 	}
+	PATHMGR_GENERATION_BUMP();
 
 	/* Free the mutex */
 	pthread_mutex_unlock(&pathmgr_mutex);
@@ -198,6 +198,9 @@ int pathmgr_resolve_servers(resmgr_context_t *ctp, struct node_entry *node, stru
 		union object						*o;
 
 		pathmgr_node_access(n);
+		if(n == node) {
+			pathmgr_node_resolved();
+		}
 
 		snode_lookup = NULL;
 		for(o = n->object; o; o = o->hdr.next) {		
@@ -343,6 +346,16 @@ int pathmgr_resolve_servers(resmgr_context_t *ctp, struct node_entry *node, stru
 	proc_thread_pool_reserve_done();
 
 	ret = _IO_CONNECT_RET_LINK | _IO_CONNECT_RET_CHROOT;
+
+	/*
+	 If the lookup stopped at a component with no node, any other path
+	 that gets that far down the same nodes stops there too and gets the
+	 same servers.  Let the client know how much of the path that is.
+	*/
+	if(path[0] && linkp->chroot_len == 0 && !(local_flags & _PMFLAG_IS_LINK)) {
+		linkp->resolved_len = len + strcspn(path, "/");
+		ret |= _IO_CONNECT_RET_PREFIX;
+	}
 	if((prp = proc_lock_pid(ctp->info.pid))) {
 		linkp->umask = prp->umask;
 		ret |= _IO_CONNECT_RET_UMASK;
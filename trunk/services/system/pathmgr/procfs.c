@@ -1134,6 +1134,9 @@ static int procfs_devctl(resmgr_context_t *ctp, io_devctl_t *msg, void *vocb) {
 		procfs_regset				regset;
 		procfs_threadctl			threadctl;
 		procfs_channel				channel;
+		procfs_pathmgr_stats		pathmgr_stats;
+		procfs_tlb_stats			tlb_stats;
+		procfs_intrlat				intrlat;
 		struct sigevent				event;
 		uint32_t					flags;
 		pthread_t					tid;
@@ -1151,6 +1154,14 @@ static int procfs_devctl(resmgr_context_t *ctp, io_devctl_t *msg, void *vocb) {
 	case DCMD_ALL_GETMOUNTFLAGS:
 		break;
 
+	case DCMD_PROC_PATHMGR_STATS:
+	case DCMD_PROC_TLB_STATS:
+	case DCMD_PROC_INTRLAT:
+		if(ctp->info.flags & _NTO_MI_ENDIAN_DIFF) {
+			return EENDIAN;
+		}
+		break;
+
 	case DCMD_PROC_SYSINFO:
 		// syspage data is not endian-safe; client (pidin) must swap!
 		// [alternative is to fail this EENDIAN as below]
@@ -1245,6 +1256,50 @@ static int procfs_devctl(resmgr_context_t *ctp, io_devctl_t *msg, void *vocb) {
 		ret_val = nbytes = _syspage_ptr->total_size;
 		break;
 
+	case DCMD_PROC_PATHMGR_STATS:
+		pathmgr_node_stats(&ioctl->pathmgr_stats);
+		nbytes = sizeof ioctl->pathmgr_stats;
+		break;
+
+	case DCMD_PROC_TLB_STATS: {
+		unsigned	i;
+
+		memset(&ioctl->tlb_stats, 0, sizeof ioctl->tlb_stats);
+		ioctl->tlb_stats.num_cpu = min(NUM_PROCESSORS, NUM_ELTS(ioctl->tlb_stats.cpu));
+		for(i = 0; i < ioctl->tlb_stats.num_cpu; ++i) {
+			ioctl->tlb_stats.cpu[i].requests = tlb_flush_stats[i].requests;
+			ioctl->tlb_stats.cpu[i].ipis = tlb_flush_stats[i].ipis;
+			ioctl->tlb_stats.cpu[i].skipped = tlb_flush_stats[i].skipped;
+			ioctl->tlb_stats.cpu[i].ranged = tlb_flush_stats[i].ranged;
+			ioctl->tlb_stats.cpu[i].received = tlb_flush_received[i];
+		}
+		nbytes = sizeof ioctl->tlb_stats;
+		break;
+	}
+
+	case DCMD_PROC_INTRLAT: {
+		struct intrlat_entry	hist;
+		unsigned				vector;
+		int						level;
+
+		if(msg->i.nbytes < sizeof ioctl->intrlat) {
+			return EINVAL;
+		}
+		level = intrlat_query(ioctl->intrlat.level, ioctl->intrlat.cpu, &vector, &hist);
+		if(level == -1) {
+			return ESRCH;
+		}
+		ioctl->intrlat.level = level;
+		ioctl->intrlat.vector = vector;
+		ioctl->intrlat.num_cpu = NUM_PROCESSORS;
+		memset(ioctl->intrlat.reserved, 0, sizeof ioctl->intrlat.reserved);
+		memcpy(ioctl->intrlat.entry, hist.entry, sizeof ioctl->intrlat.entry);
+		memcpy(ioctl->intrlat.handler, hist.handler, sizeof ioctl->intrlat.handler);
+		memcpy(ioctl->intrlat.dispatch, hist.dispatch, sizeof ioctl->intrlat.dispatch);
+		nbytes = sizeof ioctl->intrlat;
+		break;
+	}
+
 	case DCMD_PROC_INFO:
 		if(DebugProcess(NTO_DEBUG_PROCESS_INFO, ocb->pid, 0, (union nto_debug_data *)&ioctl->info) == -1) {
 			return errno;
@@ -51,6 +51,9 @@ void pathmgr_node_unlink(NODE *nop);
 void pathmgr_node_access(NODE *node);
 void pathmgr_node_complete(NODE *node);
 NODE *pathmgr_node_clone(NODE *node);
+void pathmgr_node_resolved(void);
+struct _procfs_pathmgr_stats;
+void pathmgr_node_stats(struct _procfs_pathmgr_stats *stats);
 pid_t pathmgr_netmgr_pid(void);
 
 OBJECT *pathmgr_object_attach(PROCESS *prp, NODE *nop, const char *path, int type, unsigned flags, void *data);
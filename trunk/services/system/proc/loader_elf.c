@@ -22,6 +22,7 @@
 #include <errno.h>
 #include <share.h>
 #include <string.h>
+#include <time.h>
 #include <sys/stat.h>
 #include <sys/elf.h>
 #include <sys/elf_386.h>
@@ -43,6 +44,157 @@ struct seg {
 	int						read_in;
 };
 
+/*
+ * Small LRU cache of the headers of recently loaded files, keyed by
+ * device/inode/mtime/ctime/size, so that spawning the same program over
+ * and over doesn't re-read and re-validate its headers (and those
+ * of its interpreter) every time. The files are opened SH_DENYWR
+ * while they're being loaded, so the key can't go stale underneath us.
+ * Besides the ELF and program headers, an entry holds the first PT_NOTE
+ * segment, which is all elf_load() reads from the file besides the
+ * segment contents.
+ *
+ * File times only have a resolution of a second, so a file changed
+ * during the current second could be changed again without its key
+ * changing; such files aren't entered until their times are in the past.
+ *
+ * elf_load() runs on the loader thread's fixed stack, so the pieces are
+ * copied straight to and from its own ehdr, phdrs and note buffer, one
+ * at a time. An entry can be replaced between the copies; each one
+ * checks the entry is still there and the caller reads the file if not.
+ */
+#define ELF_CACHE_ENTRIES		8
+#define ELF_CACHE_MAXPHDRS		16
+#define ELF_CACHE_MAXNOTE		512
+
+static struct elf_cache {
+	dev_t					dev;
+	ino_t					ino;
+	time_t					mtime;
+	time_t					ctime;
+	off_t					size;
+	unsigned				stamp;
+	Elf32_Ehdr				ehdr;
+	Elf32_Phdr				phdrs[ELF_CACHE_MAXPHDRS];
+	int						note_phndx;
+	unsigned				note_size;
+	char					note[ELF_CACHE_MAXNOTE];
+}							elf_cache[ELF_CACHE_ENTRIES];
+static unsigned				elf_cache_clock;
+static pthread_mutex_t		elf_cache_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+// Called with elf_cache_mutex locked
+static struct elf_cache *
+elf_cache_find(const struct stat *st) {
+	struct elf_cache		*ecp;
+
+	if(st == NULL || (st->st_dev == 0 && st->st_ino == 0)) {
+		return NULL;
+	}
+	for(ecp = elf_cache; ecp < &elf_cache[ELF_CACHE_ENTRIES]; ecp++) {
+		if(ecp->stamp != 0 && ecp->ino == st->st_ino && ecp->dev == st->st_dev
+				&& ecp->mtime == st->st_mtime && ecp->ctime == st->st_ctime
+				&& ecp->size == st->st_size) {
+			ecp->stamp = ++elf_cache_clock;
+			return ecp;
+		}
+	}
+	return NULL;
+}
+
+static int
+elf_cache_ehdr(const struct stat *st, Elf32_Ehdr *ehdr) {
+	struct elf_cache		*ecp;
+
+	pthread_mutex_lock(&elf_cache_mutex);
+	if((ecp = elf_cache_find(st))) {
+		*ehdr = ecp->ehdr;
+	}
+	pthread_mutex_unlock(&elf_cache_mutex);
+	return ecp != NULL;
+}
+
+static int
+elf_cache_phdrs(const struct stat *st, Elf32_Phdr *phdrs, unsigned phnum) {
+	struct elf_cache		*ecp;
+
+	pthread_mutex_lock(&elf_cache_mutex);
+	if((ecp = elf_cache_find(st)) && ecp->ehdr.e_phnum == phnum) {
+		memcpy(phdrs, ecp->phdrs, sizeof *phdrs * phnum);
+	} else {
+		ecp = NULL;
+	}
+	pthread_mutex_unlock(&elf_cache_mutex);
+	return ecp != NULL;
+}
+
+static int
+elf_cache_note(const struct stat *st, int phndx, void *note, unsigned size) {
+	struct elf_cache		*ecp;
+
+	pthread_mutex_lock(&elf_cache_mutex);
+	if((ecp = elf_cache_find(st)) && ecp->note_phndx == phndx && ecp->note_size == size) {
+		memcpy(note, ecp->note, size);
+	} else {
+		ecp = NULL;
+	}
+	pthread_mutex_unlock(&elf_cache_mutex);
+	return ecp != NULL;
+}
+
+static void
+elf_cache_enter(const struct stat *st, const Elf32_Ehdr *ehdr, const Elf32_Phdr *phdrs) {
+	struct elf_cache		*ecp, *victim;
+	time_t					now;
+
+	if(st == NULL || (st->st_dev == 0 && st->st_ino == 0) || ehdr->e_phnum > ELF_CACHE_MAXPHDRS) {
+		return;
+	}
+	now = time(NULL);
+	if(st->st_mtime >= now || st->st_ctime >= now) {
+		return;
+	}
+	pthread_mutex_lock(&elf_cache_mutex);
+	victim = elf_cache;
+	for(ecp = elf_cache; ecp < &elf_cache[ELF_CACHE_ENTRIES]; ecp++) {
+		if(ecp->stamp != 0 && ecp->ino == st->st_ino && ecp->dev == st->st_dev) {
+			// Older version of the same file
+			victim = ecp;
+			break;
+		}
+		if(ecp->stamp < victim->stamp) {
+			victim = ecp;
+		}
+	}
+	victim->dev = st->st_dev;
+	victim->ino = st->st_ino;
+	victim->mtime = st->st_mtime;
+	victim->ctime = st->st_ctime;
+	victim->size = st->st_size;
+	victim->stamp = ++elf_cache_clock;
+	victim->ehdr = *ehdr;
+	memcpy(victim->phdrs, phdrs, sizeof *phdrs * ehdr->e_phnum);
+	victim->note_phndx = -1;
+	victim->note_size = 0;
+	pthread_mutex_unlock(&elf_cache_mutex);
+}
+
+static void
+elf_cache_enter_note(const struct stat *st, int phndx, const void *note, unsigned size) {
+	struct elf_cache		*ecp;
+
+	if(size > ELF_CACHE_MAXNOTE) {
+		return;
+	}
+	pthread_mutex_lock(&elf_cache_mutex);
+	if((ecp = elf_cache_find(st)) && ecp->note_phndx == -1) {
+		ecp->note_phndx = phndx;
+		ecp->note_size = size;
+		memcpy(ecp->note, note, size);
+	}
+	pthread_mutex_unlock(&elf_cache_mutex);
+}
+
 
 static void 
 debug_info(const void *vaddr, const Elf32_Phdr *phdr, int fd, const char *name) {
@@ -91,6 +243,8 @@ elf_load(int fd, const char *path, struct loader_startup *lsp, struct stat *stat
 		struct _proc_spawn_debug		i;
 		char							filler[_POSIX_PATH_MAX];
 	}						debug_msg;
+	int						cached;
+	struct stat				interpstat;
 
 
 	if (strlen(path) > ((sizeof(debug_msg) - offsetof(struct _proc_spawn_debug, name)) - 1)) {
@@ -100,17 +254,19 @@ elf_load(int fd, const char *path, struct loader_startup *lsp, struct stat *stat
 	//RUSH3: Rather than doing proc_read()'s in this function, we could mmap() 
 	//RUSH3: the file. More expensive if the executable's not already loaded,
 	//RUSH3: less if it is. Maybe look at sticky bit?
-	i = proc_read(fd, &ehdr, sizeof ehdr, 0);
-	if (i <= 0) {
-		// Unable to read header - return error so we don't try interpreter
-		return ENOEXEC;
-	}
-	if(i != sizeof ehdr
-		|| memcmp(ehdr.e_ident, ELFMAG, SELFMAG) 
-		|| ehdr.e_ident[EI_DATA] != ELFDATANATIVE 
-		|| ehdr.e_phentsize != sizeof *phdr) {
-		// Not an ELF file - try executing interpreter if necessary
-		return -1;
+	if(!(cached = elf_cache_ehdr(statlocal, &ehdr))) {
+		i = proc_read(fd, &ehdr, sizeof ehdr, 0);
+		if (i <= 0) {
+			// Unable to read header - return error so we don't try interpreter
+			return ENOEXEC;
+		}
+		if(i != sizeof ehdr
+			|| memcmp(ehdr.e_ident, ELFMAG, SELFMAG) 
+			|| ehdr.e_ident[EI_DATA] != ELFDATANATIVE 
+			|| ehdr.e_phentsize != sizeof *phdr) {
+			// Not an ELF file - try executing interpreter if necessary
+			return -1;
+		}
 	}
 	switch(ehdr.e_machine) {
 	case CPU_ELF_NUMBERS:
@@ -151,8 +307,11 @@ elf_load(int fd, const char *path, struct loader_startup *lsp, struct stat *stat
 	}
 
 	size = ehdr.e_phnum * sizeof(*phdrs);
-	if(proc_read(fd, phdrs, size, ehdr.e_phoff) != size) {
-		return ENOEXEC;
+	if(!cached || !(cached = elf_cache_phdrs(statlocal, phdrs, ehdr.e_phnum))) {
+		if(proc_read(fd, phdrs, size, ehdr.e_phoff) != size) {
+			return ENOEXEC;
+		}
+		elf_cache_enter(statlocal, &ehdr, phdrs);
 	}
 
 	base_reloc = 0;
@@ -236,7 +395,14 @@ elf_load(int fd, const char *path, struct loader_startup *lsp, struct stat *stat
 			if(0==phdr->p_filesz) break; //ignore zero-len .note headers. But return ENOEXEC if they are malformed sizes.
 			if(phdr->p_filesz >= sizeof *note)  {
 				size = min(phdr->p_filesz, sizeof buffer);
-				if(proc_read(fd, note, size, phdr->p_offset) == size) {
+				if(cached && elf_cache_note(statlocal, i, note, size)) {
+					// got it from the cache
+				} else if(proc_read(fd, note, size, phdr->p_offset) != size) {
+					size = 0;
+				} else if(!cached) {
+					elf_cache_enter_note(statlocal, i, note, size);
+				}
+				if(size != 0) {
 					while(size > 0) {
 						int				len;
 						Elf32_Word		*p;
@@ -422,7 +588,6 @@ elf_load(int fd, const char *path, struct loader_startup *lsp, struct stat *stat
 	}
 
 	if(lsp && interp) {
-		struct stat			interpstat;
 		int					fd2;
 
 		CRASHCHECK(auxv == NULL);
@@ -453,19 +618,29 @@ elf_load(int fd, const char *path, struct loader_startup *lsp, struct stat *stat
 			return errno == EBUSY ? ETXTBSY : ELIBACC;
 		}
 
-		if(proc_read(fd2, &ehdr, sizeof ehdr, 0) != sizeof ehdr || memcmp(ehdr.e_ident, ELFMAG, SELFMAG) ||
-					ehdr.e_ident[EI_DATA] != ELFDATANATIVE || ehdr.e_phentsize != sizeof *phdr) {
-			close(fd2);
-			return ELIBBAD;
+		/* Stuff the aux vector with the DEVICE/INODE of the interpreter */
+		interpstat.st_dev = 0;
+		interpstat.st_ino = 0;
+		(void) fstat(fd2, &interpstat);
+
+		phdrs = (Elf32_Phdr *)buffer;
+		if(!(cached = elf_cache_ehdr(&interpstat, &ehdr))) {
+			if(proc_read(fd2, &ehdr, sizeof ehdr, 0) != sizeof ehdr || memcmp(ehdr.e_ident, ELFMAG, SELFMAG) ||
+						ehdr.e_ident[EI_DATA] != ELFDATANATIVE || ehdr.e_phentsize != sizeof *phdr) {
+				close(fd2);
+				return ELIBBAD;
+			}
 		}
 		if(ehdr.e_phnum * sizeof *phdrs > sizeof buffer) {
 			close(fd2);
 			return ELIBBAD;
 		}
-		phdrs = (Elf32_Phdr *)buffer;
-		if(proc_read(fd2, phdrs, sizeof *phdrs * ehdr.e_phnum, ehdr.e_phoff) != sizeof *phdrs * ehdr.e_phnum) {
-			close(fd2);
-			return ELIBBAD;
+		if(!cached || !elf_cache_phdrs(&interpstat, phdrs, ehdr.e_phnum)) {
+			if(proc_read(fd2, phdrs, sizeof *phdrs * ehdr.e_phnum, ehdr.e_phoff) != sizeof *phdrs * ehdr.e_phnum) {
+				close(fd2);
+				return ELIBBAD;
+			}
+			elf_cache_enter(&interpstat, &ehdr, phdrs);
 		}
 
 		base_addr = ~0;
@@ -528,10 +703,6 @@ elf_load(int fd, const char *path, struct loader_startup *lsp, struct stat *stat
 		auxv->a_un.a_ptr = (void *)base_addr;
 		auxv++;
 
-		/* Stuff the aux vector with the DEVICE/INODE of the interpreter */
-		interpstat.st_dev = 0;
-		interpstat.st_ino = 0;
-		(void) fstat(fd2, &interpstat);
 		auxv->a_type = AT_INTP_DEVICE;
 		auxv->a_un.a_val = interpstat.st_dev;
 		auxv++;
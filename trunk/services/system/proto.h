@@ -75,6 +75,7 @@ void devmem_init(void);
 
 /* named semaphores */
 void namedsem_init(void);
+int namedsem_check(const resmgr_io_funcs_t *funcs, mem_map_t *msg, void *h, OBJECT **pobp);
 
 /* procfs.h */
 int proc_debug_destroy(resmgr_context_t *ctp, PROCESS *prp);
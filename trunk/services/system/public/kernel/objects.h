@@ -532,6 +532,8 @@ struct thread_entry {		// Also used for vthread_entry
 	FPU_REGISTERS	*fpudata;
 	volatile unsigned	ticker_using;
 	volatile uint64_t running_time;
+	uint32_t		 intrlat_stamp;	// ClockCycles() when an interrupt event was queued for us
+	int32_t			 intrlat_level;	// interrupt level + 1 of that event, 0 if none pending
 	struct cpu_thread_entry	cpu; // Must be just before 'reg' field.
 	CPU_REGISTERS	 reg;
 };
@@ -608,6 +610,19 @@ struct interrupt_entry {
 	struct cpu_intrsave		cpu;
 };
 
+//
+// Interrupt latency histograms, kept per interrupt level and per cpu by
+// nano_intrlat.c. Bucket n counts the samples of 2^n to 2^(n+1)-1 cycles
+// (bucket 0 also counts zero).
+//
+#define INTRLAT_BUCKETS		32
+
+struct intrlat_entry {
+	uint32_t				entry[INTRLAT_BUCKETS];		// start of level processing to handler call
+	uint32_t				handler[INTRLAT_BUCKETS];	// handler run time
+	uint32_t				dispatch[INTRLAT_BUCKETS];	// event queued to the attaching thread running
+};
+
 struct interrupt_query_entry {
 	struct interrupt_entry	info;
 	pid_t					pid;
@@ -240,6 +240,8 @@ int				mdriver_intr_attach(int);
 void          rdecl send_ipi(int cpu, int cmd);
 int           rdecl get_cpunum(void);
 void          rdecl smp_flush_tlb(void);
+void          rdecl smp_flush_tlb_range(ADDRESS *adp, uintptr_t start, uintptr_t end);
+int           rdecl intrlat_query(unsigned level, unsigned cpu, unsigned *vector, struct intrlat_entry *hist);
 
 void          rdecl crash(const char *file, int line);
 struct asinfo_entry;
@@ -110,6 +110,10 @@ struct _asyncmsg_connection_descriptor {
 
 #define ASYNCMSG_FLUSH_NONBLOCK 1
 
+/* asyncmsg_connect_attach() flag: only one thread ever puts on the
+ * connection, so the send queue is appended to without locking */
+#define ASYNCMSG_COF_SINGLE_PRODUCER	0x80000000
+
 #define ASYNCMSG_RECVBUF_ALLOC  1
 #define ASYNCMSG_RECVBUF_FREE   2
 
@@ -131,6 +135,9 @@ extern int asyncmsg_putv(int coid, const iov_t* iov, int parts, unsigned handle,
 
 extern struct _asyncmsg_get_header* asyncmsg_get(int chid);
 
+extern int asyncmsg_get_n(int chid, unsigned max, struct _asyncmsg_get_header **list);
+
+/* buffers from asyncmsg_malloc() go back with asyncmsg_free(), not free() */
 extern void *asyncmsg_malloc(size_t size);
 
 extern void asyncmsg_free(void *buf);
@@ -142,7 +142,10 @@ enum {
 
 	__KER_MT_CTL,                         /* 100          0x64 */
 
-	__KER_BAD						/* 101 		0x65 */
+	__KER_MSG_RECEIVEMULTI,			/* 101		0x65 */
+	__KER_MSG_REPLYMULTI,			/* 102		0x66 */
+
+	__KER_BAD						/* 103 		0x67 */
 	} ;
 
 #endif
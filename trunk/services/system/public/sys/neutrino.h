@@ -134,6 +134,25 @@ struct _msg_info {							/* _msg_info	_server_info */
 #define _NTO_MI_NET_CRED_DIRTY	0x00000200
 #define _NTO_MI_UNBLOCK_REQ		0x00000100
 
+/*
+ * Entries for MsgReceiveMulti() and MsgReplyMulti(). A message received
+ * with MsgReceiveMulti() is replied to in the usual way; the entries only
+ * let a server move several of them through one kernel call.
+ */
+struct _msg_receive_entry {
+	void						*msg;		/* in:  receive buffer */
+	_Int32t						bytes;		/* in:  size of receive buffer */
+	_Int32t						rcvid;		/* out: as returned by MsgReceive() */
+	struct _msg_info			info;		/* out: not filled in for pulses */
+};
+
+struct _msg_reply_entry {
+	_Int32t						rcvid;
+	_Int32t						status;
+	const void					*msg;
+	_Int32t						bytes;
+};
+
 struct _cred_info {
 	uid_t						ruid;
 	uid_t						euid;
@@ -331,6 +350,14 @@ struct _thread_runmask {
 #define RMSK_ISSET(cpu, p)	((p)[(cpu) / __INT_BITS__] & \
 		(1 << ((cpu) % __INT_BITS__)))
 
+/*
+ * On SMP systems procnto keeps the sync owner id of the thread running
+ * on each cpu (a _Uint32t per cpu, indexed by cpu number) in a read-only
+ * shared memory object at this path, below the root of the pathname
+ * space. Adaptive mutexes use it to tell whether the owner is running.
+ */
+#define _NTO_RUNNING_OWNERS		"dev/shmem/.running_owners"
+
 /*
  * Define channel flags
  */
@@ -483,6 +510,10 @@ extern int MsgReply(int __rcvid, int __status, const void *__msg, int __bytes);
 extern int MsgReply_r(int __rcvid, int __status, const void *__msg, int __bytes);
 extern int MsgReplyv(int __rcvid, int __status, const struct iovec *__iov, int __parts);
 extern int MsgReplyv_r(int __rcvid, int __status, const struct iovec *__iov, int __parts);
+extern int MsgReceiveMulti(int __chid, struct _msg_receive_entry *__rcv, int __nrcv, unsigned __flags);
+extern int MsgReceiveMulti_r(int __chid, struct _msg_receive_entry *__rcv, int __nrcv, unsigned __flags);
+extern int MsgReplyMulti(const struct _msg_reply_entry *__rep, int __nrep);
+extern int MsgReplyMulti_r(const struct _msg_reply_entry *__rep, int __nrep);
 extern int MsgReadiov(int __rcvid, const struct iovec *__iov, int __parts, int __offset, int __flags);
 extern int MsgReadiov_r(int __rcvid, const struct iovec *__iov, int __parts, int __offset, int __flags);
 extern int MsgRead(int __rcvid, void *__msg, int __bytes, int __offset);
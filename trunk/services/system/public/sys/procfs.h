@@ -106,6 +106,41 @@ typedef struct _procfs_threadctl {
 	char						data[1024];
 }							procfs_threadctl;
 
+typedef struct _procfs_pathmgr_stats {
+	_Uint64t					resolves;			/* pathname resolutions answered */
+	_Uint64t					lookups;			/* node tree component lookups */
+	_Uint64t					hashed_lookups;		/* lookups served by a child hash */
+	_Uint32t					hashed_nodes;		/* nodes currently carrying a child hash */
+	_Uint32t					generation;			/* bumped on every node tree/object change */
+}							procfs_pathmgr_stats;
+
+typedef struct _procfs_tlb_stats {
+	_Uint32t					num_cpu;			/* entries filled in below */
+	_Uint32t					reserved;
+	struct {
+		_Uint32t					requests;		/* shootdowns started on this cpu */
+		_Uint32t					ipis;			/* IPI_TLB_FLUSH's sent to other cpus */
+		_Uint32t					skipped;		/* cpus spared, aspace not loaded */
+		_Uint32t					ranged;			/* shootdowns using page invalidates */
+		_Uint32t					received;		/* IPI_TLB_FLUSH's taken by this cpu */
+		_Uint32t					reserved;
+	}							cpu[32];
+}							procfs_tlb_stats;
+
+#define PROCFS_INTRLAT_BUCKETS		32
+
+typedef struct _procfs_intrlat {
+	_Uint32t					level;			/* in: first level wanted, out: level reported */
+	_Uint32t					cpu;			/* in: cpu wanted */
+	_Uint32t					vector;			/* interrupt vector of the level */
+	_Uint32t					num_cpu;		/* number of cpus with histograms */
+	_Uint32t					reserved[4];
+	/* bucket n counts samples of 2^n to 2^(n+1)-1 ClockCycles() */
+	_Uint32t					entry[PROCFS_INTRLAT_BUCKETS];		/* level processing to handler call */
+	_Uint32t					handler[PROCFS_INTRLAT_BUCKETS];	/* handler run time */
+	_Uint32t					dispatch[PROCFS_INTRLAT_BUCKETS];	/* event to attaching thread running */
+}							procfs_intrlat;
+
 /* This call is made to obtain information stored in the system page.
    To get the whole syspage, two calls would have to be made. The 
    first gets the "total_size" entry, the second should be for this size.
@@ -348,6 +383,26 @@ typedef struct _procfs_threadctl {
 #define DCMD_PROC_DEL_MEMPARTID	__DIOT(_DCMD_PROC, __PROC_SUBCMD_PROCFS + 32, part_id_t)
 #define DCMD_PROC_CHG_MEMPARTID	__DIOT(_DCMD_PROC, __PROC_SUBCMD_PROCFS + 33, part_id_t)
 
+/* This call returns the path manager's pathname resolution statistics.
+   It may be issued on any procfs file descriptor.
+   Args: A procfs_pathmgr_stats structure is passed as an argument, and
+   this is filled in with the required information upon return. */
+#define DCMD_PROC_PATHMGR_STATS	__DIOF(_DCMD_PROC, __PROC_SUBCMD_PROCFS + 34, procfs_pathmgr_stats)
+
+/* This call returns the per-cpu TLB shootdown counters.
+   It may be issued on any procfs file descriptor.
+   Args: A procfs_tlb_stats structure is passed as an argument, and
+   this is filled in with the required information upon return. */
+#define DCMD_PROC_TLB_STATS		__DIOF(_DCMD_PROC, __PROC_SUBCMD_PROCFS + 35, procfs_tlb_stats)
+
+/* This call returns the kernel's interrupt latency histograms for one
+   cpu of one interrupt level. It may be issued on any procfs file descriptor.
+   Args: A procfs_intrlat structure is passed with the level and cpu to
+   start at. The first level at or above the one asked for that has
+   histograms is returned; ESRCH means there are no more. Step through
+   them by asking again for the returned level + 1. */
+#define DCMD_PROC_INTRLAT		__DIOTF(_DCMD_PROC, __PROC_SUBCMD_PROCFS + 36, procfs_intrlat)
+
 #include _NTO_HDR_(_packpop.h)
 
 __END_DECLS
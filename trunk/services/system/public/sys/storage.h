@@ -47,7 +47,7 @@ struct _thread_local_storage {
 	int							__tid;
 	unsigned					__owner;
 	void						*__stackaddr;
-	unsigned					__reserved1;
+	unsigned					__spinavg;		/* adaptive mutex spin average, libc */
 	unsigned					__numkeys;
 	void						**__keydata;	/* Indexed by pthread_key_t */
 	void						*__cleanup;
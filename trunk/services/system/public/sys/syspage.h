@@ -297,7 +297,8 @@ struct system_private_entry {
 	_SPPTR(struct tracebuf)			tracebuf;
 
 	_Paddr32t						kdump_info;
-	_Uint32t						spare[3];
+	_Uint32t						pathmgr_generation; /* bumped on pathname space changes, 0 if none */
+	_Uint32t						spare[2];
 	union kernel_entry {
 #if defined(SYSPAGE_TARGET_ALL) || defined(SYSPAGE_TARGET_X86)
 		struct x86_kernel_entry			x86;
@@ -177,7 +177,8 @@ enum {
 #define _NTO_TRACE_SYS_FUNC_ENTER   (0x0000000a)
 #define _NTO_TRACE_SYS_FUNC_EXIT    (0x0000000b)
 #define _NTO_TRACE_SYS_SLOG    		(0x0000000c)
-#define _NTO_TRACE_SYS_LAST			_NTO_TRACE_SYS_SLOG
+#define _NTO_TRACE_SYS_APS_SCHED_LAT (0x0000000d) /* per-window APS scheduling decision latency, per cpu */
+#define _NTO_TRACE_SYS_LAST			_NTO_TRACE_SYS_APS_SCHED_LAT
 
 #define _NTO_TRACE_COMM_SMSG        (0x00000000)
 #define _NTO_TRACE_COMM_SPULSE      (0x00000001)
@@ -37,6 +37,7 @@
 	#define SPINUNLOCK(spin)		((spin)->value = 0)
 	#define SENDIPI(cpu,cmd)		send_ipi(cpu,cmd)
 	#define SMP_FLUSH_TLB()			if(num_processors > 1) smp_flush_tlb()
+	#define SMP_FLUSH_TLB_RANGE(adp,s,e)	if(num_processors > 1) smp_flush_tlb_range(adp,s,e)
 	#define SMP_SPINVAR(class,var)	class intrspin_t var
 	#define INTR_LOCK(s)			InterruptLock(s)
 	/* the following ensure we don't enable interrupts during kernel initialization */
@@ -52,6 +53,7 @@
 	#define SPINUNLOCK(spin)		
 	#define SENDIPI(cpu,cmd)		
 	#define SMP_FLUSH_TLB()		
+	#define SMP_FLUSH_TLB_RANGE(adp,s,e)
 	#if defined(_lint)
 		#define SMP_SPINVAR(class,var) _to_semi
 	#else
@@ -90,4 +92,21 @@
 #define IPI_CLOCK_LOAD 		0x00000200
 #define IPI_CPU_SPECIFIC	0xffff0000
 
+//
+// Pending TLB shootdown for a CPU, consumed by the IPI_TLB_FLUSH handler.
+// The upper bits hold the page aligned starting address, the lower bits
+// the number of pages to invalidate. Zero means nothing is pending,
+// TLB_FLUSH_ALL asks for the whole TLB to be dropped.
+//
+#define TLB_FLUSH_NPAGES_MASK	0x00000fff
+#define TLB_FLUSH_ALL			TLB_FLUSH_NPAGES_MASK
+#define TLB_FLUSH_RANGE_MAX		32
+
+struct tlb_flush_stats {
+	unsigned	requests;		// shootdowns started on this CPU
+	unsigned	ipis;			// IPI_TLB_FLUSH's sent by this CPU
+	unsigned	skipped;		// CPUs not interrupted, aspace not loaded
+	unsigned	ranged;			// shootdowns that didn't need a full flush
+};
+
 /* __SRCVERSION("smpswitch.h $Rev: 174913 $"); */
@@ -377,6 +377,261 @@ static void qSort3 ( EState* s, Int32 loSt, Int32 hiSt, Int32 dSt )
 }
 
 
+/*---------------------------------------------*/
+/*--
+   Fallback sorting, for blocks which sortMain()
+   finds too repetitive.  Rather than randomising
+   the block and trying again, the rotations are
+   sorted by repeatedly doubling the length of the
+   sorted prefix (Manber & Myers), which takes
+   O(N log N) time whatever the block contains.
+
+   fmap[] (which is zptr) holds the rotations in
+   their current order.  A bit in bhtab marks the
+   start of each bucket of rotations known to be
+   equal so far, and eclass[i] is the bucket
+   holding rotation i+H, so sorting each bucket on
+   eclass[] extends the sorted prefix from H to 2H
+   characters.
+--*/
+
+#define SET_BH(zz)       bhtab[(zz) >> 5] |= (1U << ((zz) & 31))
+#define CLEAR_BH(zz)     bhtab[(zz) >> 5] &= ~(1U << ((zz) & 31))
+#define ISSET_BH(zz)     (bhtab[(zz) >> 5] & (1U << ((zz) & 31)))
+#define WORD_BH(zz)      bhtab[(zz) >> 5]
+#define UNALIGNED_BH(zz) ((zz) & 0x01f)
+
+#define FALLBACK_SMALL_THRESH 10
+#define FALLBACK_STACK_SIZE   100
+
+#define fpush(lz,hz) { stackLo[sp] = lz; \
+                       stackHi[sp] = hz; \
+                       sp++; }
+
+#define fpop(lz,hz) { sp--;              \
+                      lz = stackLo[sp];  \
+                      hz = stackHi[sp]; }
+
+static void fallbackSimpleSort ( UInt32* fmap,
+                                 UInt32* eclass,
+                                 Int32   lo,
+                                 Int32   hi )
+{
+   Int32  i, j;
+   UInt32 v, ec_v;
+
+   for (i = lo + 1; i <= hi; i++) {
+      v = fmap[i];
+      ec_v = eclass[v];
+      for (j = i; j > lo && eclass[fmap[j-1]] > ec_v; j--)
+         fmap[j] = fmap[j-1];
+      fmap[j] = v;
+   }
+}
+
+
+/*--
+   A 3-way quicksort of fmap[loSt .. hiSt] on
+   eclass[].  The pivot is chosen pseudo-randomly,
+   since repetitive blocks are exactly the ones
+   likely to defeat a median-of-three, and the
+   smaller partition is always sorted first, so
+   the stack stays below log2(N) entries.
+--*/
+static void fallbackQSort3 ( UInt32* fmap,
+                             UInt32* eclass,
+                             Int32   loSt,
+                             Int32   hiSt )
+{
+   Int32  unLo, unHi, ltLo, gtHi, n, m;
+   Int32  sp, lo, hi;
+   UInt32 med, r;
+   Int32  stackLo[FALLBACK_STACK_SIZE];
+   Int32  stackHi[FALLBACK_STACK_SIZE];
+
+   r = 0;
+   sp = 0;
+   fpush ( loSt, hiSt );
+
+   while (sp > 0) {
+
+      AssertH ( sp < FALLBACK_STACK_SIZE, 1004 );
+
+      fpop ( lo, hi );
+
+      if (hi - lo < FALLBACK_SMALL_THRESH) {
+         fallbackSimpleSort ( fmap, eclass, lo, hi );
+         continue;
+      }
+
+      r = r * 1103515245 + 12345;
+      med = eclass[fmap[lo + (Int32)((r >> 8) % (UInt32)(hi - lo + 1))]];
+
+      unLo = ltLo = lo;
+      unHi = gtHi = hi;
+
+      while (True) {
+         while (True) {
+            if (unLo > unHi) break;
+            if (eclass[fmap[unLo]] == med) {
+               swap(fmap[unLo], fmap[ltLo]); ltLo++; unLo++; continue;
+            };
+            if (eclass[fmap[unLo]] > med) break;
+            unLo++;
+         }
+         while (True) {
+            if (unLo > unHi) break;
+            if (eclass[fmap[unHi]] == med) {
+               swap(fmap[unHi], fmap[gtHi]); gtHi--; unHi--; continue;
+            };
+            if (eclass[fmap[unHi]] < med) break;
+            unHi--;
+         }
+         if (unLo > unHi) break;
+         swap(fmap[unLo], fmap[unHi]); unLo++; unHi--;
+      }
+
+      AssertD ( unHi == unLo-1, "bad termination in fallbackQSort3" );
+
+      if (gtHi < ltLo) continue;
+
+      n = min(ltLo-lo, unLo-ltLo); vswap(fmap, lo, unLo-n, n);
+      m = min(hi-gtHi, gtHi-unHi); vswap(fmap, unLo, hi-m+1, m);
+
+      n = lo + unLo - ltLo - 1;
+      m = hi - (gtHi - unHi) + 1;
+
+      if (n - lo > hi - m) {
+         fpush ( lo, n );
+         fpush ( m, hi );
+      } else {
+         fpush ( m, hi );
+         fpush ( lo, n );
+      }
+   }
+}
+
+
+/*--
+   Returns False, leaving zptr untouched, if the
+   working space can't be allocated; the caller
+   then randomises the block as before.
+--*/
+static Bool fallbackSort ( EState* s )
+{
+   Int32   ftab[256];
+   Int32   H, i, j, k, l, r, nNotDone, nBhtab;
+   UInt32  cc, cc1;
+   UInt32* eclass;
+   UInt32* bhtab;
+
+   bz_stream* strm   = s->strm;
+   UChar*     block  = s->block;
+   UInt32*    fmap   = s->zptr;
+   Int32      nblock = s->nblock;
+
+   nBhtab = 4 + (nblock / 32);
+   eclass = BZALLOC( nblock * sizeof(UInt32) );
+   bhtab  = BZALLOC( nBhtab * sizeof(UInt32) );
+   if (eclass == NULL || bhtab == NULL) {
+      if (eclass != NULL) BZFREE(eclass);
+      if (bhtab  != NULL) BZFREE(bhtab);
+      return False;
+   }
+
+   if (s->verbosity >= 4)
+      VPrintf0( "        fallback bucket sorting ...\n" );
+
+   /*--
+      Initial 1-character radix sort, which gives
+      the buckets for H == 1.
+   --*/
+   for (i = 0; i < 256; i++) ftab[i] = 0;
+   for (i = 0; i < nblock; i++) ftab[block[i]]++;
+   for (i = 1; i < 256; i++) ftab[i] += ftab[i-1];
+   for (i = 0; i < nblock; i++) {
+      j = block[i];
+      k = ftab[j] - 1;
+      ftab[j] = k;
+      fmap[k] = i;
+   }
+
+   for (i = 0; i < nBhtab; i++) bhtab[i] = 0;
+   for (i = 0; i < 256; i++) SET_BH(ftab[i]);
+
+   /*--
+      Alternating bits past the end of the block
+      stop the word-at-a-time scans below.
+   --*/
+   for (i = 0; i < 32; i++) {
+      SET_BH(nblock + 2*i);
+      CLEAR_BH(nblock + 2*i + 1);
+   }
+
+   H = 1;
+   while (True) {
+
+      if (s->verbosity >= 4)
+         VPrintf1( "        depth %6d has ", H );
+
+      j = 0;
+      for (i = 0; i < nblock; i++) {
+         if (ISSET_BH(i)) j = i;
+         k = fmap[i] - H; if (k < 0) k += nblock;
+         eclass[k] = j;
+      }
+
+      nNotDone = 0;
+      r = -1;
+      while (True) {
+
+         /*-- find the next non-singleton bucket, [l .. r] --*/
+         k = r + 1;
+         while (ISSET_BH(k) && UNALIGNED_BH(k)) k++;
+         if (ISSET_BH(k)) {
+            while (WORD_BH(k) == 0xffffffff) k += 32;
+            while (ISSET_BH(k)) k++;
+         }
+         l = k - 1;
+         if (l >= nblock) break;
+         while (!ISSET_BH(k) && UNALIGNED_BH(k)) k++;
+         if (!ISSET_BH(k)) {
+            while (WORD_BH(k) == 0x00000000) k += 32;
+            while (!ISSET_BH(k)) k++;
+         }
+         r = k - 1;
+         if (r >= nblock) break;
+
+         /*-- sort it, and mark where it splits --*/
+         nNotDone += (r - l + 1);
+         fallbackQSort3 ( fmap, eclass, l, r );
+
+         cc = eclass[fmap[l]];
+         for (i = l + 1; i <= r; i++) {
+            cc1 = eclass[fmap[i]];
+            if (cc != cc1) { SET_BH(i); cc = cc1; };
+         }
+      }
+
+      if (s->verbosity >= 4)
+         VPrintf1( "%6d unresolved strings\n", nNotDone );
+
+      H *= 2;
+      if (H > nblock || nNotDone == 0) break;
+   }
+
+   BZFREE(eclass);
+   BZFREE(bhtab);
+   return True;
+}
+
+#undef SET_BH
+#undef CLEAR_BH
+#undef ISSET_BH
+#undef WORD_BH
+#undef UNALIGNED_BH
+
+
 /*---------------------------------------------*/
 
 #define BIGFREQ(b) (ftab[((b)+1) << 8] - ftab[(b) << 8])
@@ -683,6 +938,11 @@ void blockSort ( EState* s )
                 s->workDone, s->nblock-1, 
                 (float)(s->workDone) / (float)(s->nblock-1) );
 
+   if (s->workDone > s->workLimit && s->firstAttempt &&
+       fallbackSort ( s )) {
+      if (s->verbosity >= 2)
+         VPrintf0( "    sorting aborted; used fallback sort\n" );
+   } else
    if (s->workDone > s->workLimit && s->firstAttempt) {
       if (s->verbosity >= 2)
          VPrintf0( "    sorting aborted; randomising block\n" );
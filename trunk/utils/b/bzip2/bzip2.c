@@ -281,6 +281,7 @@ Char    *progName;
 Char    progNameReally[FILE_NAME_LEN];
 FILE    *outputHandleJustInCase;
 Int32   workFactor;
+Int32   numThreads;
 
 void    panic                 ( Char* )   NORETURN;
 void    ioError               ( void )    NORETURN;
@@ -312,6 +313,17 @@ Bool myfeof ( FILE* f )
 }
 
 
+/*---------------------------------------------*/
+Int32 numProcessors ( void )
+{
+#if BZ_UNIX && defined(_SC_NPROCESSORS_ONLN)
+   long n = sysconf ( _SC_NPROCESSORS_ONLN );
+   if (n > 0) return (Int32)n;
+#endif
+   return 1;
+}
+
+
 /*---------------------------------------------*/
 void compressStream ( FILE *stream, FILE *zStream )
 {
@@ -327,6 +339,15 @@ void compressStream ( FILE *stream, FILE *zStream )
    if (ferror(stream)) goto errhandler_io;
    if (ferror(zStream)) goto errhandler_io;
 
+   if (numThreads > 1) {
+      if (verbosity >= 2) fprintf ( stderr, "\n" );
+      bzerr = bzParCompressStream ( stream, zStream, blockSize100k,
+                                    verbosity, workFactor, numThreads,
+                                    &nbytes_in, &nbytes_out );
+      if (bzerr == BZ_OK) goto closeup;
+      if (bzerr != BZ_SEQUENCE_ERROR) goto errhandler_par;
+   }
+
    bzf = bzWriteOpen ( &bzerr, zStream, 
                        blockSize100k, verbosity, workFactor );   
    if (bzerr != BZ_OK) goto errhandler;
@@ -346,6 +367,7 @@ void compressStream ( FILE *stream, FILE *zStream )
    bzWriteClose ( &bzerr, bzf, 0, &nbytes_in, &nbytes_out );
    if (bzerr != BZ_OK) goto errhandler;
 
+   closeup:
    if (ferror(zStream)) goto errhandler_io;
    ret = fflush ( zStream );
    if (ret == EOF) goto errhandler_io;
@@ -373,6 +395,7 @@ void compressStream ( FILE *stream, FILE *zStream )
 
    errhandler:
    bzWriteClose ( &bzerr_dummy, bzf, 1, &nbytes_in, &nbytes_out );
+   errhandler_par:
    switch (bzerr) {
       case BZ_MEM_ERROR:
          outOfMemory ();
@@ -398,6 +421,7 @@ Bool uncompressStream ( FILE *zStream, FILE *stream )
    UChar   unused[BZ_MAX_UNUSED];
    Int32   nUnused;
    UChar*  unusedTmp;
+   int     trailingGarbage;
 
    nUnused = 0;
    streamNo = 0;
@@ -408,6 +432,21 @@ Bool uncompressStream ( FILE *zStream, FILE *stream )
    if (ferror(stream)) goto errhandler_io;
    if (ferror(zStream)) goto errhandler_io;
 
+   if (numThreads > 1 && !smallMode) {
+      bzerr = bzParDecompressStream ( zStream, stream, numThreads,
+                                      &trailingGarbage );
+      if (bzerr == BZ_OK) {
+         if (trailingGarbage)
+            fprintf ( stderr, 
+                      "\n%s: %s: trailing garbage after EOF ignored\n",
+                      progName, inName );
+         goto closeup;
+      }
+      streamNo = 1;
+      if (bzerr != BZ_SEQUENCE_ERROR) goto errhandler;
+      streamNo = 0;
+   }
+
    while (True) {
 
       bzf = bzReadOpen ( 
@@ -438,6 +477,7 @@ Bool uncompressStream ( FILE *zStream, FILE *stream )
 
    }
 
+   closeup:
    if (ferror(zStream)) goto errhandler_io;
    ret = fclose ( zStream );
    if (ret == EOF) goto errhandler_io;
@@ -491,6 +531,7 @@ Bool testStream ( FILE *zStream )
    UChar   unused[BZ_MAX_UNUSED];
    Int32   nUnused;
    UChar*  unusedTmp;
+   int     trailingGarbage;
 
    nUnused = 0;
    streamNo = 0;
@@ -498,6 +539,21 @@ Bool testStream ( FILE *zStream )
    SET_BINARY_MODE(zStream);
    if (ferror(zStream)) goto errhandler_io;
 
+   if (numThreads > 1 && !smallMode) {
+      bzerr = bzParDecompressStream ( zStream, NULL, numThreads,
+                                      &trailingGarbage );
+      if (bzerr == BZ_OK) {
+         if (trailingGarbage)
+            fprintf ( stderr, 
+                      "\n%s: %s: trailing garbage after EOF ignored\n",
+                      progName, inName );
+         goto closeup;
+      }
+      streamNo = 1;
+      if (bzerr != BZ_SEQUENCE_ERROR) goto errhandler;
+      streamNo = 0;
+   }
+
    while (True) {
 
       bzf = bzReadOpen ( 
@@ -524,6 +580,7 @@ Bool testStream ( FILE *zStream )
 
    }
 
+   closeup:
    if (ferror(zStream)) goto errhandler_io;
    ret = fclose ( zStream );
    if (ret == EOF) goto errhandler_io;
@@ -1227,6 +1284,7 @@ void usage ( Char *fullProgName )
       "   -1 .. -9            set block size to 100k .. 900k\n"
       "   --repetitive-fast   compress repetitive blocks faster\n"
       "   --repetitive-best   compress repetitive blocks better\n"
+      "   --threads=N         use N threads (0: one per processor)\n"
       "\n"
       "   If invoked as `bzip2', default action is to compress.\n"
       "              as `bunzip2',  default action is to decompress.\n"
@@ -1354,6 +1412,7 @@ IntNative main ( IntNative argc, Char *argv[] )
    numFileNames            = 0;
    numFilesProcessed       = 0;
    workFactor              = 30;
+   numThreads              = 1;
 
    copyFileName ( inName,  "(none)" );
    copyFileName ( outName, "(none)" );
@@ -1453,6 +1512,11 @@ IntNative main ( IntNative argc, Char *argv[] )
       if (ISFLAG("--verbose"))           verbosity++;                else
       if (ISFLAG("--help"))              { usage ( progName ); exit ( 1 ); }
          else
+      if (strncmp ( aa->name, "--threads=", 10) == 0) {
+         numThreads = atoi ( aa->name + 10 );
+         if (numThreads <= 0) numThreads = numProcessors ();
+      }
+         else
          if (strncmp ( aa->name, "--", 2) == 0) {
             fprintf ( stderr, "%s: Bad flag `%s'\n", progName, aa->name );
             usage ( progName );
@@ -1461,6 +1525,7 @@ IntNative main ( IntNative argc, Char *argv[] )
    }
 
    if (verbosity > 4) verbosity = 4;
+   if (numThreads > 64) numThreads = 64;
    if (opMode == OM_Z && smallMode) blockSize100k = 2;
 
    if (srcMode == SM_F2O && numFileNames == 0) {
@@ -103,7 +103,6 @@ void default_bzfree ( void* opaque, void* addr )
 
 
 /*---------------------------------------------------*/
-static
 void prepare_new_block ( EState* s )
 {
    Int32 i;
@@ -199,7 +198,6 @@ int BZ_API(bzCompressInit)
 
 
 /*---------------------------------------------------*/
-static
 void add_pair_to_block ( EState* s )
 {
    Int32 i;
@@ -243,34 +241,6 @@ void flush_RL ( EState* s )
 }
 
 
-/*---------------------------------------------------*/
-#define ADD_CHAR_TO_BLOCK(zs,zchh0)               \
-{                                                 \
-   UInt32 zchh = (UInt32)(zchh0);                 \
-   /*-- fast track the common case --*/           \
-   if (zchh != zs->state_in_ch &&                 \
-       zs->state_in_len == 1) {                   \
-      UChar ch = (UChar)(zs->state_in_ch);        \
-      BZ_UPDATE_CRC( zs->blockCRC, ch );          \
-      zs->inUse[zs->state_in_ch] = True;          \
-      zs->block[zs->nblock] = (UChar)ch;          \
-      zs->nblock++;                               \
-      zs->state_in_ch = zchh;                     \
-   }                                              \
-   else                                           \
-   /*-- general, uncommon cases --*/              \
-   if (zchh != zs->state_in_ch ||                 \
-      zs->state_in_len == 255) {                  \
-      if (zs->state_in_ch < 256)                  \
-         add_pair_to_block ( zs );                \
-      zs->state_in_ch = zchh;                     \
-      zs->state_in_len = 1;                       \
-   } else {                                       \
-      zs->state_in_len++;                         \
-   }                                              \
-}
-
-
 /*---------------------------------------------------*/
 static
 Bool copy_input_until_stop ( EState* s )
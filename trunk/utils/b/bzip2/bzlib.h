@@ -216,6 +216,34 @@ BZ_EXTERN void BZ_API(bzWriteClose) (
       unsigned int* nbytes_in, 
       unsigned int* nbytes_out 
    );
+
+/*--
+   Whole-stream compression and decompression using
+   nThreads threads to work on blocks in parallel.
+   Both return BZ_SEQUENCE_ERROR, having consumed no
+   input, if they can't run in parallel (eg no memory
+   for the extra blocks, or for decompression, input
+   which isn't a regular file); the caller should then
+   fall back to the bzWrite/bzRead functions.
+--*/
+
+BZ_EXTERN int BZ_API(bzParCompressStream) (
+      FILE*         in,
+      FILE*         out,
+      int           blockSize100k,
+      int           verbosity,
+      int           workFactor,
+      int           nThreads,
+      unsigned int* nbytes_in,
+      unsigned int* nbytes_out
+   );
+
+BZ_EXTERN int BZ_API(bzParDecompressStream) (
+      FILE*         in,
+      FILE*         out,
+      int           nThreads,
+      int*          trailingGarbage
+   );
 #endif
 
 
@@ -215,6 +215,36 @@ extern UInt32 crc32Table[256];
 
 
 
+/*-- Adding a byte of input to the block being built. --*/
+
+#define ADD_CHAR_TO_BLOCK(zs,zchh0)               \
+{                                                 \
+   UInt32 zchh = (UInt32)(zchh0);                 \
+   /*-- fast track the common case --*/           \
+   if (zchh != zs->state_in_ch &&                 \
+       zs->state_in_len == 1) {                   \
+      UChar ch = (UChar)(zs->state_in_ch);        \
+      BZ_UPDATE_CRC( zs->blockCRC, ch );          \
+      zs->inUse[zs->state_in_ch] = True;          \
+      zs->block[zs->nblock] = (UChar)ch;          \
+      zs->nblock++;                               \
+      zs->state_in_ch = zchh;                     \
+   }                                              \
+   else                                           \
+   /*-- general, uncommon cases --*/              \
+   if (zchh != zs->state_in_ch ||                 \
+      zs->state_in_len == 255) {                  \
+      if (zs->state_in_ch < 256)                  \
+         add_pair_to_block ( zs );                \
+      zs->state_in_ch = zchh;                     \
+      zs->state_in_len = 1;                       \
+   } else {                                       \
+      zs->state_in_len++;                         \
+   }                                              \
+}
+
+
+
 /*-- Structure holding all the compression-side stuff. --*/
 
 typedef
@@ -296,6 +326,15 @@ blockSort ( EState* );
 extern void 
 compressBlock ( EState*, Bool );
 
+extern void 
+compressBlockDetached ( EState* );
+
+extern void 
+prepare_new_block ( EState* );
+
+extern void 
+add_pair_to_block ( EState* );
+
 extern void 
 bsInitWrite ( EState* );
 
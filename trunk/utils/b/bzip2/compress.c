@@ -504,6 +504,29 @@ void sendMTFValues ( EState* s )
 }
 
 
+/*---------------------------------------------------*/
+static
+void sendBlock ( EState* s )
+{
+   bsPutUChar ( s, 0x31 ); bsPutUChar ( s, 0x41 );
+   bsPutUChar ( s, 0x59 ); bsPutUChar ( s, 0x26 );
+   bsPutUChar ( s, 0x53 ); bsPutUChar ( s, 0x59 );
+
+   /*-- Now the block's CRC, so it is in a known place. --*/
+   bsPutUInt32 ( s, s->blockCRC );
+
+   /*-- Now a single bit indicating randomisation. --*/
+   if (s->blockRandomised) {
+      bsW(s,1,1); s->nBlocksRandomised++;
+   } else
+      bsW(s,1,0);
+
+   bsW ( s, 24, s->origPtr );
+   generateMTFValues ( s );
+   sendMTFValues ( s );
+}
+
+
 /*---------------------------------------------------*/
 void compressBlock ( EState* s, Bool is_last_block )
 {
@@ -531,25 +554,7 @@ void compressBlock ( EState* s, Bool is_last_block )
       bsPutUChar ( s, '0' + s->blockSize100k );
    }
 
-   if (s->nblock > 0) {
-
-      bsPutUChar ( s, 0x31 ); bsPutUChar ( s, 0x41 );
-      bsPutUChar ( s, 0x59 ); bsPutUChar ( s, 0x26 );
-      bsPutUChar ( s, 0x53 ); bsPutUChar ( s, 0x59 );
-
-      /*-- Now the block's CRC, so it is in a known place. --*/
-      bsPutUInt32 ( s, s->blockCRC );
-
-      /*-- Now a single bit indicating randomisation. --*/
-      if (s->blockRandomised) {
-         bsW(s,1,1); s->nBlocksRandomised++;
-      } else
-         bsW(s,1,0);
-
-      bsW ( s, 24, s->origPtr );
-      generateMTFValues ( s );
-      sendMTFValues ( s );
-   }
+   if (s->nblock > 0) sendBlock ( s );
 
 
    /*-- If this is the last block, add the stream trailer. --*/
@@ -571,6 +576,30 @@ void compressBlock ( EState* s, Bool is_last_block )
 }
 
 
+/*---------------------------------------------------*/
+/*--
+   Compress one non-empty block on its own, for the
+   parallel compressor.  No stream header or trailer
+   is written, and the block's bits are left in
+   quadrant [0 .. numZ-1] followed by the top bsLive
+   bits of bsBuff, for the caller to splice into the
+   stream.  The caller also keeps the combined CRC.
+--*/
+void compressBlockDetached ( EState* s )
+{
+   BZ_FINALISE_CRC ( s->blockCRC );
+   s->numZ = 0;
+
+   if (s->verbosity >= 2)
+      VPrintf3( "    block %d: crc = 0x%8x, size = %d\n",
+                s->blockNo, s->blockCRC, s->nblock );
+
+   blockSort ( s );
+   bsInitWrite ( s );
+   sendBlock ( s );
+}
+
+
 /*-------------------------------------------------------------*/
 /*--- end                                        compress.c ---*/
 /*-------------------------------------------------------------*/
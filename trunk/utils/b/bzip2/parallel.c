@@ -0,0 +1,968 @@
+/*-------------------------------------------------------------*/
+/*--- Parallel block compression and decompression          ---*/
+/*---                                            parallel.c ---*/
+/*-------------------------------------------------------------*/
+
+/*--
+  This file is a part of bzip2 and/or libbzip2, a program and
+  library for lossless, block-sorting data compression.
+
+  Copyright (C) 1996-1998 Julian R Seward.  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+
+  1. Redistributions of source code must retain the above copyright
+     notice, this list of conditions and the following disclaimer.
+
+  2. The origin of this software must not be misrepresented; you must 
+     not claim that you wrote the original software.  If you use this 
+     software in a product, an acknowledgment in the product 
+     documentation would be appreciated but is not required.
+
+  3. Altered source versions must be plainly marked as such, and must
+     not be misrepresented as being the original software.
+
+  4. The name of the author may not be used to endorse or promote 
+     products derived from this software without specific prior written 
+     permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS
+  OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+  DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+  GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+  Julian Seward, Guildford, Surrey, UK.
+  jseward@acm.org
+  bzip2/libbzip2 version 0.9.0 of 28 June 1998
+
+  This program is based on (at least) the work of:
+     Mike Burrows
+     David Wheeler
+     Peter Fenwick
+     Alistair Moffat
+     Radford Neal
+     Ian H. Witten
+     Robert Sedgewick
+     Jon L. Bentley
+
+  For more information on these sources, see the manual.
+--*/
+
+
+/*--
+   The parallel compressor and decompressor used by
+   bzip2 --threads.  This isn't part of Julian Seward's
+   bzip2-0.9.0 distribution.
+
+   Compression: the calling thread reads the input and
+   does the initial run-length coding, exactly as
+   bzCompress() would, so the blocks come out the same.
+   Each full block is handed to a worker thread which
+   sorts and codes it with compressBlockDetached(), and
+   the calling thread splices the finished blocks into
+   the output in order, keeping the combined CRC.  The
+   output is identical to that of bzWrite().
+
+   Decompression: blocks aren't byte aligned and their
+   length isn't recorded anywhere, so the (mapped) input
+   is scanned for the 48 bit block and end-of-stream
+   magic numbers.  Each piece of input between two marks
+   is copied into a one-block stream of its own and
+   handed to a worker to decompress, CRC checks and all.
+   The magic numbers can also turn up by chance inside
+   compressed data, so a piece which fails to decompress
+   is retried joined to the pieces after it, and only if
+   no such join works is the data considered corrupt.
+--*/
+
+#include "bzlib_private.h"
+
+#ifndef BZ_NO_STDIO
+
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+
+typedef unsigned long long UInt64;
+
+#define PAR_MAX_THREADS  64
+#define PAR_STACK_SIZE   (256 * 1024)
+#define PAR_IBUF_SIZE    65536
+#define PAR_OBUF_SIZE    65536
+
+#define PAR_BLOCK_MAGIC  0x314159265359ULL
+#define PAR_EOS_MAGIC    0x177245385090ULL
+#define PAR_MAGIC_MASK   0xffffffffffffULL
+
+/*--
+   No real block takes more than about 19M bits
+   (900000 20 bit codes and the tables), so this
+   bounds how far a failed piece is joined up.
+--*/
+#define PAR_MAX_PIECE    (24 * 1024 * 1024)
+
+
+/*---------------------------------------------------*/
+/*--- Worker threads                              ---*/
+/*---------------------------------------------------*/
+
+typedef
+   struct parJob {
+      struct parJob* next;
+      Bool           busy;      /* submitted, not yet retired */
+      Bool           done;      /* worker has finished with it */
+
+      /*-- compression: the block is in strm.state --*/
+      bz_stream      strm;
+
+      /*-- decompression --*/
+      UChar*         base;      /* the mapped input */
+      Int32          mark;      /* index of the mark the piece starts at */
+      UInt64         start;     /* bit range of the piece */
+      UInt64         end;
+      UChar*         synth;     /* the piece as a stream of its own */
+      UInt32         synthSize;
+      UChar*         out;       /* and decompressed */
+      UInt32         outSize;
+      UInt32         nOut;
+      UInt32         blockCRC;
+      Int32          ret;
+   }
+   ParJob;
+
+typedef
+   struct {
+      pthread_mutex_t mutex;
+      pthread_cond_t  workCond;  /* job queued, or shutting down */
+      pthread_cond_t  doneCond;  /* a job finished */
+      ParJob*         head;
+      ParJob*         tail;
+      Bool            shutdown;
+      Int32           nThreads;
+      pthread_t       threads[PAR_MAX_THREADS];
+      void            (*work) ( ParJob* );
+   }
+   ParPool;
+
+
+/*---------------------------------------------------*/
+static
+void* parWorker ( void* arg )
+{
+   ParPool* pool = (ParPool*)arg;
+   ParJob*  job;
+
+   pthread_mutex_lock ( &pool->mutex );
+   while (True) {
+      while (pool->head == NULL && !pool->shutdown)
+         pthread_cond_wait ( &pool->workCond, &pool->mutex );
+      if (pool->head == NULL) break;
+      job = pool->head;
+      pool->head = job->next;
+      if (pool->head == NULL) pool->tail = NULL;
+      pthread_mutex_unlock ( &pool->mutex );
+
+      pool->work ( job );
+
+      pthread_mutex_lock ( &pool->mutex );
+      job->done = True;
+      pthread_cond_broadcast ( &pool->doneCond );
+   }
+   pthread_mutex_unlock ( &pool->mutex );
+   return NULL;
+}
+
+
+/*---------------------------------------------------*/
+static
+Bool parStart ( ParPool* pool, Int32 nThreads, void (*work) ( ParJob* ) )
+{
+   pthread_attr_t attr;
+
+   pthread_mutex_init ( &pool->mutex, NULL );
+   pthread_cond_init ( &pool->workCond, NULL );
+   pthread_cond_init ( &pool->doneCond, NULL );
+   pool->head     = NULL;
+   pool->tail     = NULL;
+   pool->shutdown = False;
+   pool->work     = work;
+
+   pthread_attr_init ( &attr );
+   pthread_attr_setstacksize ( &attr, PAR_STACK_SIZE );
+   for (pool->nThreads = 0; pool->nThreads < nThreads; pool->nThreads++)
+      if (pthread_create ( &pool->threads[pool->nThreads], &attr,
+                           parWorker, pool ) != 0) break;
+   pthread_attr_destroy ( &attr );
+
+   if (pool->nThreads == 0) {
+      pthread_cond_destroy ( &pool->doneCond );
+      pthread_cond_destroy ( &pool->workCond );
+      pthread_mutex_destroy ( &pool->mutex );
+      return False;
+   }
+   return True;
+}
+
+
+/*---------------------------------------------------*/
+static
+void parStop ( ParPool* pool )
+{
+   Int32 i;
+
+   pthread_mutex_lock ( &pool->mutex );
+   pool->shutdown = True;
+   pthread_cond_broadcast ( &pool->workCond );
+   pthread_mutex_unlock ( &pool->mutex );
+   for (i = 0; i < pool->nThreads; i++)
+      pthread_join ( pool->threads[i], NULL );
+
+   pthread_cond_destroy ( &pool->doneCond );
+   pthread_cond_destroy ( &pool->workCond );
+   pthread_mutex_destroy ( &pool->mutex );
+}
+
+
+/*---------------------------------------------------*/
+static
+void parSubmit ( ParPool* pool, ParJob* job )
+{
+   job->next = NULL;
+   job->busy = True;
+   job->done = False;
+   pthread_mutex_lock ( &pool->mutex );
+   if (pool->tail == NULL) pool->head = job; else pool->tail->next = job;
+   pool->tail = job;
+   pthread_cond_signal ( &pool->workCond );
+   pthread_mutex_unlock ( &pool->mutex );
+}
+
+
+/*---------------------------------------------------*/
+static
+void parWait ( ParPool* pool, ParJob* job )
+{
+   pthread_mutex_lock ( &pool->mutex );
+   while (!job->done)
+      pthread_cond_wait ( &pool->doneCond, &pool->mutex );
+   pthread_mutex_unlock ( &pool->mutex );
+   job->busy = False;
+}
+
+
+/*---------------------------------------------------*/
+/*--- Bit stream output                           ---*/
+/*---------------------------------------------------*/
+
+/*--
+   Output goes to buf, which is written to handle
+   whenever it fills; with no handle, buf must be
+   big enough for everything put.
+--*/
+typedef
+   struct {
+      FILE*   handle;
+      UChar*  buf;
+      UInt32  bufN;
+      UInt32  bufSize;
+      UInt32  bsBuff;
+      Int32   bsLive;
+      UInt32  total;
+      Bool    ioError;
+   }
+   ParBits;
+
+
+/*---------------------------------------------------*/
+static
+void parInitBits ( ParBits* w, FILE* handle, UChar* buf, UInt32 bufSize )
+{
+   w->handle  = handle;
+   w->buf     = buf;
+   w->bufN    = 0;
+   w->bufSize = bufSize;
+   w->bsBuff  = 0;
+   w->bsLive  = 0;
+   w->total   = 0;
+   w->ioError = False;
+}
+
+
+/*---------------------------------------------------*/
+static
+void parFlushBuf ( ParBits* w )
+{
+   if (w->handle != NULL && w->bufN > 0) {
+      if (fwrite ( w->buf, sizeof(UChar), w->bufN, w->handle ) != w->bufN ||
+          ferror ( w->handle ))
+         w->ioError = True;
+      w->bufN = 0;
+   }
+}
+
+
+/*---------------------------------------------------*/
+#define parNEEDW(w)                             \
+{                                               \
+   while ((w)->bsLive >= 8) {                   \
+      (w)->buf[(w)->bufN] =                     \
+         (UChar)((w)->bsBuff >> 24);            \
+      (w)->bufN++;                              \
+      (w)->total++;                             \
+      if ((w)->bufN == (w)->bufSize)            \
+         parFlushBuf ( w );                     \
+      (w)->bsBuff <<= 8;                        \
+      (w)->bsLive -= 8;                         \
+   }                                            \
+}
+
+
+/*---------------------------------------------------*/
+static
+void parPutBits ( ParBits* w, Int32 n, UInt32 v )
+{
+   parNEEDW ( w );
+   if (n > 0) {
+      w->bsBuff |= (v << (32 - w->bsLive - n));
+      w->bsLive += n;
+   }
+}
+
+
+/*---------------------------------------------------*/
+static
+void parPutUInt32 ( ParBits* w, UInt32 u )
+{
+   parPutBits ( w, 16, (u >> 16) & 0xffffL );
+   parPutBits ( w, 16,  u        & 0xffffL );
+}
+
+
+/*---------------------------------------------------*/
+static
+void parFinishBits ( ParBits* w )
+{
+   parNEEDW ( w );
+   if (w->bsLive > 0) {
+      w->bsLive = 8;
+      parNEEDW ( w );
+   }
+   parFlushBuf ( w );
+}
+
+
+/*---------------------------------------------------*/
+/*--- Compression                                 ---*/
+/*---------------------------------------------------*/
+
+/*---------------------------------------------------*/
+static
+void parCompressWork ( ParJob* job )
+{
+   compressBlockDetached ( (EState*)(job->strm.state) );
+}
+
+
+/*---------------------------------------------------*/
+static
+EState* parNewBlock ( ParJob* job, Int32 blockNo )
+{
+   EState* s = (EState*)(job->strm.state);
+
+   prepare_new_block ( s );
+   s->blockNo = blockNo;
+   return s;
+}
+
+
+/*---------------------------------------------------*/
+/*--
+   Waits for the oldest block, and appends it
+   to the output.
+--*/
+static
+void parRetireBlock ( ParPool* pool, ParJob* job,
+                      ParBits* w, UInt32* combinedCRC )
+{
+   EState* s = (EState*)(job->strm.state);
+   UChar*  z = (UChar*)(s->quadrant);
+   Int32   i;
+
+   parWait ( pool, job );
+
+   *combinedCRC = (*combinedCRC << 1) | (*combinedCRC >> 31);
+   *combinedCRC ^= s->blockCRC;
+
+   for (i = 0; i < s->numZ; i++) parPutBits ( w, 8, z[i] );
+   if (s->bsLive > 0)
+      parPutBits ( w, s->bsLive, s->bsBuff >> (32 - s->bsLive) );
+}
+
+
+/*---------------------------------------------------*/
+int BZ_API(bzParCompressStream)
+                  ( FILE*         in,
+                    FILE*         out,
+                    int           blockSize100k,
+                    int           verbosity,
+                    int           workFactor,
+                    int           nThreads,
+                    unsigned int* nbytes_in,
+                    unsigned int* nbytes_out )
+{
+   ParPool  pool;
+   ParJob*  jobs;
+   ParBits  w;
+   EState*  s;
+   EState*  t;
+   UChar*   ibuf;
+   UChar*   obuf;
+   Int32    nJobs, cur, blockNo, i, n, ret;
+   UInt32   combinedCRC, total_in;
+
+   if (nbytes_in != NULL) *nbytes_in = 0;
+   if (nbytes_out != NULL) *nbytes_out = 0;
+
+   if (in == NULL || out == NULL ||
+       (blockSize100k < 1 || blockSize100k > 9) ||
+       (workFactor < 0 || workFactor > 250) ||
+       (verbosity < 0 || verbosity > 4) ||
+       nThreads < 1)
+      return BZ_PARAM_ERROR;
+   if (nThreads > PAR_MAX_THREADS) nThreads = PAR_MAX_THREADS;
+
+   if (ferror(in) || ferror(out))
+      return BZ_IO_ERROR;
+
+   /*--
+      One block more than there are threads, so that
+      input can be read while they're all busy.
+   --*/
+   nJobs = nThreads + 1;
+   jobs  = calloc ( nJobs, sizeof(ParJob) );
+   ibuf  = malloc ( PAR_IBUF_SIZE );
+   obuf  = malloc ( PAR_OBUF_SIZE );
+   for (i = 0; jobs != NULL && i < nJobs; i++) {
+      jobs[i].strm.bzalloc = NULL;
+      jobs[i].strm.bzfree  = NULL;
+      jobs[i].strm.opaque  = NULL;
+      if (bzCompressInit ( &jobs[i].strm, blockSize100k,
+                           verbosity, workFactor ) != BZ_OK) break;
+   }
+   if (jobs == NULL || i < nJobs || ibuf == NULL || obuf == NULL ||
+       !parStart ( &pool, nThreads, parCompressWork )) {
+      while (jobs != NULL && --i >= 0) bzCompressEnd ( &jobs[i].strm );
+      if (jobs != NULL) free ( jobs );
+      if (ibuf != NULL) free ( ibuf );
+      if (obuf != NULL) free ( obuf );
+      return BZ_SEQUENCE_ERROR;
+   }
+
+   ret         = BZ_OK;
+   combinedCRC = 0;
+   total_in    = 0;
+   blockNo     = 1;
+   cur         = 0;
+   s           = parNewBlock ( &jobs[cur], blockNo );
+
+   parInitBits ( &w, out, obuf, PAR_OBUF_SIZE );
+   parPutBits ( &w, 8, 'B' );
+   parPutBits ( &w, 8, 'Z' );
+   parPutBits ( &w, 8, 'h' );
+   parPutBits ( &w, 8, '0' + blockSize100k );
+
+   while (ret == BZ_OK) {
+      n = fread ( ibuf, sizeof(UChar), PAR_IBUF_SIZE, in );
+      if (ferror(in)) { ret = BZ_IO_ERROR; break; };
+      if (n == 0) break;
+      total_in += n;
+
+      for (i = 0; i < n; i++) {
+         ADD_CHAR_TO_BLOCK ( s, (UInt32)(ibuf[i]) );
+         if (s->nblock >= s->nblockMAX) {
+            parSubmit ( &pool, &jobs[cur] );
+            cur = (cur + 1) % nJobs;
+            if (jobs[cur].busy)
+               parRetireBlock ( &pool, &jobs[cur], &w, &combinedCRC );
+
+            /*-- any run in progress carries on into the next block --*/
+            t = parNewBlock ( &jobs[cur], ++blockNo );
+            t->state_in_ch  = s->state_in_ch;
+            t->state_in_len = s->state_in_len;
+            s->state_in_ch  = 256;
+            s->state_in_len = 0;
+            s = t;
+         }
+      }
+      if (w.ioError) ret = BZ_IO_ERROR;
+   }
+
+   if (ret == BZ_OK) {
+      if (s->state_in_ch < 256) add_pair_to_block ( s );
+      s->state_in_ch  = 256;
+      s->state_in_len = 0;
+      if (s->nblock > 0) {
+         parSubmit ( &pool, &jobs[cur] );
+         cur = (cur + 1) % nJobs;
+      }
+      for (i = 0; i < nJobs; i++) {
+         if (jobs[cur].busy)
+            parRetireBlock ( &pool, &jobs[cur], &w, &combinedCRC );
+         cur = (cur + 1) % nJobs;
+      }
+
+      parPutBits ( &w, 8, 0x17 ); parPutBits ( &w, 8, 0x72 );
+      parPutBits ( &w, 8, 0x45 ); parPutBits ( &w, 8, 0x38 );
+      parPutBits ( &w, 8, 0x50 ); parPutBits ( &w, 8, 0x90 );
+      parPutUInt32 ( &w, combinedCRC );
+      if (verbosity >= 2)
+         VPrintf1( "    final combined CRC = 0x%x\n   ", combinedCRC );
+      parFinishBits ( &w );
+      if (w.ioError) ret = BZ_IO_ERROR;
+   }
+
+   for (i = 0; i < nJobs; i++)
+      if (jobs[i].busy) parWait ( &pool, &jobs[i] );
+   parStop ( &pool );
+   for (i = 0; i < nJobs; i++) bzCompressEnd ( &jobs[i].strm );
+   free ( jobs );
+   free ( ibuf );
+   free ( obuf );
+
+   if (nbytes_in != NULL) *nbytes_in = total_in;
+   if (nbytes_out != NULL) *nbytes_out = w.total;
+   return ret;
+}
+
+
+/*---------------------------------------------------*/
+/*--- Decompression                               ---*/
+/*---------------------------------------------------*/
+
+#define PAR_MARK_BLOCK 1
+#define PAR_MARK_EOS   2
+#define PAR_MARK_END   3
+
+typedef
+   struct {
+      UInt64  pos;
+      Int32   kind;
+   }
+   ParMark;
+
+/*--
+   The marks found so far; the last one found is
+   PAR_MARK_END, at the end of the input, once the
+   scan has got there.
+--*/
+typedef
+   struct {
+      UChar*   base;
+      UInt64   nbits;
+      UInt64   scanFrom;
+      ParMark* marks;
+      Int32    nMarks;
+      Int32    maxMarks;
+      Bool     ended;
+   }
+   ParScan;
+
+
+/*---------------------------------------------------*/
+static
+UInt32 parGetBits ( UChar* base, UInt64 pos, Int32 n )
+{
+   UInt32 v = 0;
+
+   for (; n > 0; n--, pos++)
+      v = (v << 1) | ((base[pos >> 3] >> (7 - (pos & 7))) & 1);
+   return v;
+}
+
+
+/*---------------------------------------------------*/
+/*--
+   Finds the first magic number starting at or
+   after bit position from.
+--*/
+static
+Int32 parFindMark ( UChar* base, UInt64 nbits, UInt64 from, UInt64* where )
+{
+   UInt64 w, b, nbytes, c;
+   Int32  t, loaded;
+
+   nbytes = nbits >> 3;
+   w = 0;
+   loaded = 0;
+   for (b = from >> 3; b < nbytes; b++) {
+      w = (w << 8) | base[b];
+      if (loaded < 56) loaded += 8;
+      if (loaded < 48) continue;
+      for (t = 7; t >= 0; t--) {
+         c = (w >> t) & PAR_MAGIC_MASK;
+         if (c != PAR_BLOCK_MAGIC && c != PAR_EOS_MAGIC) continue;
+         if (loaded - t < 48) continue;
+         if (((b + 1) << 3) - t - 48 < from) continue;
+         *where = ((b + 1) << 3) - t - 48;
+         return (c == PAR_BLOCK_MAGIC) ? PAR_MARK_BLOCK : PAR_MARK_EOS;
+      }
+   }
+   return PAR_MARK_END;
+}
+
+
+/*---------------------------------------------------*/
+/*--
+   Scans far enough for marks [0 .. n] to be known,
+   if there are that many.  False if out of memory.
+--*/
+static
+Bool parNeedMark ( ParScan* sc, Int32 n )
+{
+   ParMark* m;
+
+   while (sc->nMarks <= n && !sc->ended) {
+      if (sc->nMarks == sc->maxMarks) {
+         m = realloc ( sc->marks, 2 * sc->maxMarks * sizeof(ParMark) );
+         if (m == NULL) return False;
+         sc->marks = m;
+         sc->maxMarks *= 2;
+      }
+      m = &sc->marks[sc->nMarks];
+      m->kind = parFindMark ( sc->base, sc->nbits, sc->scanFrom, &m->pos );
+      if (m->kind == PAR_MARK_END) {
+         m->pos = sc->nbits;
+         sc->ended = True;
+      }
+      sc->scanFrom = m->pos + 1;
+      sc->nMarks++;
+   }
+   return True;
+}
+
+
+/*---------------------------------------------------*/
+/*--
+   Decompresses the piece [job->start, job->end)
+   by making it a one-block stream; the stored block
+   CRC also serves as the stream's combined CRC.
+--*/
+static
+Int32 parDecodePiece ( ParJob* job )
+{
+   bz_stream strm;
+   ParBits   w;
+   UChar*    p;
+   UInt64    nbits, pos;
+   UInt32    need, oldIn, oldOut;
+   Int32     ret;
+
+   nbits = job->end - job->start;
+   if (nbits < 80 || nbits > PAR_MAX_PIECE) return BZ_DATA_ERROR;
+
+   need = (UInt32)((nbits + 7) >> 3) + 16;
+   if (job->synthSize < need) {
+      p = realloc ( job->synth, need );
+      if (p == NULL) return BZ_MEM_ERROR;
+      job->synth = p;
+      job->synthSize = need;
+   }
+   if (job->out == NULL) {
+      job->out = malloc ( 1000000 );
+      if (job->out == NULL) return BZ_MEM_ERROR;
+      job->outSize = 1000000;
+   }
+
+   job->blockCRC = parGetBits ( job->base, job->start + 48, 32 );
+
+   parInitBits ( &w, NULL, job->synth, job->synthSize );
+   parPutBits ( &w, 8, 'B' );
+   parPutBits ( &w, 8, 'Z' );
+   parPutBits ( &w, 8, 'h' );
+   parPutBits ( &w, 8, '9' );
+   pos = job->start;
+   if ((pos & 7) == 0) {
+      for (; nbits >= 8; nbits -= 8, pos += 8)
+         parPutBits ( &w, 8, job->base[pos >> 3] );
+   } else {
+      for (; nbits >= 8; nbits -= 8, pos += 8)
+         parPutBits ( &w, 8,
+            ((job->base[pos >> 3] << (pos & 7)) |
+             (job->base[(pos >> 3) + 1] >> (8 - (pos & 7)))) & 0xff );
+   }
+   parPutBits ( &w, (Int32)nbits,
+                parGetBits ( job->base, pos, (Int32)nbits ) );
+   parPutBits ( &w, 24, 0x177245 );
+   parPutBits ( &w, 24, 0x385090 );
+   parPutUInt32 ( &w, job->blockCRC );
+   parFinishBits ( &w );
+
+   strm.bzalloc = NULL;
+   strm.bzfree  = NULL;
+   strm.opaque  = NULL;
+   ret = bzDecompressInit ( &strm, 0, 0 );
+   if (ret != BZ_OK) return ret;
+
+   strm.next_in  = (char*)(job->synth);
+   strm.avail_in = w.bufN;
+   job->nOut = 0;
+   while (True) {
+      if (job->nOut == job->outSize) {
+         p = realloc ( job->out, 2 * job->outSize );
+         if (p == NULL) { ret = BZ_MEM_ERROR; break; };
+         job->out = p;
+         job->outSize *= 2;
+      }
+      strm.next_out  = (char*)(job->out + job->nOut);
+      strm.avail_out = job->outSize - job->nOut;
+      oldIn  = strm.avail_in;
+      oldOut = strm.avail_out;
+      ret = bzDecompress ( &strm );
+      job->nOut = job->outSize - strm.avail_out;
+      if (ret == BZ_STREAM_END) { ret = BZ_OK; break; };
+      if (ret != BZ_OK) break;
+      if (strm.avail_in == oldIn && strm.avail_out == oldOut)
+         { ret = BZ_DATA_ERROR; break; };
+   }
+
+   bzDecompressEnd ( &strm );
+   return ret;
+}
+
+
+/*---------------------------------------------------*/
+static
+void parDecompressWork ( ParJob* job )
+{
+   job->ret = parDecodePiece ( job );
+}
+
+
+/*---------------------------------------------------*/
+/*--
+   Waits for the jobs on marks [from .. to-1],
+   which are being skipped over.
+--*/
+static
+void parSkipMarks ( ParPool* pool, ParJob* jobs, Int32 nJobs,
+                    Int32 from, Int32 to )
+{
+   ParJob* job;
+
+   for (; from < to; from++) {
+      job = &jobs[from % nJobs];
+      if (job->busy && job->mark == from) parWait ( pool, job );
+   }
+}
+
+
+/*---------------------------------------------------*/
+/*--
+   A stream header has been found at byte offset h;
+   its first block (or end of stream) should start
+   straight after it.  Any marks before that must have
+   come from the previous stream's trailer.
+--*/
+static
+Int32 parNewStream ( ParScan* sc, ParPool* pool, ParJob* jobs, Int32 nJobs,
+                     UInt64 h, Int32* k, Int32* d )
+{
+   UInt64 expect = (h + 4) << 3;
+   Int32  e;
+
+   for (e = *k; ; e++) {
+      if (!parNeedMark ( sc, e )) return BZ_MEM_ERROR;
+      if (sc->marks[e].pos >= expect) break;
+   }
+   if (sc->marks[e].kind == PAR_MARK_END) return BZ_UNEXPECTED_EOF;
+   if (sc->marks[e].pos != expect) return BZ_DATA_ERROR;
+
+   parSkipMarks ( pool, jobs, nJobs, *k, e );
+   *k = e;
+   if (*d < e) *d = e;
+   return BZ_OK;
+}
+
+
+/*---------------------------------------------------*/
+static
+Bool parIsHeader ( UChar* p )
+{
+   return p[0] == 'B' && p[1] == 'Z' && p[2] == 'h' &&
+          p[3] >= '1' && p[3] <= '9';
+}
+
+
+/*---------------------------------------------------*/
+int BZ_API(bzParDecompressStream)
+                  ( FILE* in,
+                    FILE* out,
+                    int   nThreads,
+                    int*  trailingGarbage )
+{
+   struct stat st;
+   ParScan     sc;
+   ParPool     pool;
+   ParJob*     jobs;
+   ParJob*     job;
+   ParMark*    m;
+   UChar*      map;
+   long        off;
+   UInt64      nbytes, h;
+   Int32       nJobs, i, k, d, e, ret;
+   UInt32      combinedCRC;
+   Bool        finished;
+
+   if (trailingGarbage != NULL) *trailingGarbage = 0;
+   if (in == NULL || nThreads < 1) return BZ_PARAM_ERROR;
+   if (nThreads > PAR_MAX_THREADS) nThreads = PAR_MAX_THREADS;
+   if (ferror(in) || (out != NULL && ferror(out))) return BZ_IO_ERROR;
+
+   /*-- the whole input has to be mapped --*/
+   if (fstat ( fileno(in), &st ) == -1 || !S_ISREG(st.st_mode))
+      return BZ_SEQUENCE_ERROR;
+   off = ftell ( in );
+   if (off < 0 || st.st_size - off < 4 ||
+       (off_t)(size_t)st.st_size != st.st_size)
+      return BZ_SEQUENCE_ERROR;
+   map = mmap ( NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED,
+                fileno(in), 0 );
+   if (map == MAP_FAILED) return BZ_SEQUENCE_ERROR;
+
+   if (!parIsHeader ( map + off )) {
+      munmap ( map, (size_t)st.st_size );
+      return BZ_DATA_ERROR_MAGIC;
+   }
+
+   nJobs       = 2 * nThreads;
+   jobs        = calloc ( nJobs, sizeof(ParJob) );
+   nbytes      = (UInt64)(st.st_size - off);
+   sc.base     = map + off;
+   sc.nbits    = nbytes << 3;
+   sc.scanFrom = 0;
+   sc.nMarks   = 0;
+   sc.maxMarks = 64;
+   sc.ended    = False;
+   sc.marks    = malloc ( sc.maxMarks * sizeof(ParMark) );
+   if (jobs == NULL || sc.marks == NULL ||
+       !parStart ( &pool, nThreads, parDecompressWork )) {
+      if (jobs != NULL) free ( jobs );
+      if (sc.marks != NULL) free ( sc.marks );
+      munmap ( map, (size_t)st.st_size );
+      return BZ_SEQUENCE_ERROR;
+   }
+   for (i = 0; i < nJobs; i++) jobs[i].base = sc.base;
+
+   combinedCRC = 0;
+   finished    = False;
+   k           = 0;   /* next mark to retire */
+   d           = 0;   /* next mark to hand out */
+   ret = parNewStream ( &sc, &pool, jobs, nJobs, 0, &k, &d );
+
+   while (ret == BZ_OK && !finished) {
+
+      /*-- keep the workers busy --*/
+      while (d < k + nJobs) {
+         if (!parNeedMark ( &sc, d + 1 )) { ret = BZ_MEM_ERROR; break; };
+         if (d + 1 >= sc.nMarks) break;
+         if (sc.marks[d].kind == PAR_MARK_BLOCK) {
+            job = &jobs[d % nJobs];
+            job->mark  = d;
+            job->start = sc.marks[d].pos;
+            job->end   = sc.marks[d+1].pos;
+            parSubmit ( &pool, job );
+         }
+         d++;
+      }
+      if (ret != BZ_OK) break;
+
+      m = &sc.marks[k];
+      switch (m->kind) {
+
+         case PAR_MARK_BLOCK:
+            job = &jobs[k % nJobs];
+            parWait ( &pool, job );
+            e = k + 1;
+            if (job->ret == BZ_MEM_ERROR) { ret = BZ_MEM_ERROR; break; };
+
+            /*-- perhaps a chance magic number cut it short --*/
+            while (job->ret != BZ_OK) {
+               if (sc.marks[e].kind == PAR_MARK_END) {
+                  ret = (e == k + 1) ? BZ_UNEXPECTED_EOF : BZ_DATA_ERROR;
+                  break;
+               }
+               e++;
+               if (!parNeedMark ( &sc, e )) { ret = BZ_MEM_ERROR; break; };
+               if (sc.marks[e].pos - job->start > PAR_MAX_PIECE)
+                  { ret = BZ_DATA_ERROR; break; };
+               job->end = sc.marks[e].pos;
+               parDecompressWork ( job );
+               if (job->ret == BZ_MEM_ERROR) { ret = BZ_MEM_ERROR; break; };
+            }
+            if (ret != BZ_OK) break;
+            parSkipMarks ( &pool, jobs, nJobs, k + 1, e );
+
+            combinedCRC = (combinedCRC << 1) | (combinedCRC >> 31);
+            combinedCRC ^= job->blockCRC;
+            if (out != NULL && job->nOut > 0) {
+               if (fwrite ( job->out, sizeof(UChar), job->nOut, out )
+                      != job->nOut || ferror(out))
+                  { ret = BZ_IO_ERROR; break; };
+            }
+            k = e;
+            if (d < k) d = k;
+            break;
+
+         case PAR_MARK_EOS:
+            if (m->pos + 80 > sc.nbits) { ret = BZ_UNEXPECTED_EOF; break; };
+            if (parGetBits ( sc.base, m->pos + 48, 32 ) != combinedCRC)
+               { ret = BZ_DATA_ERROR; break; };
+            combinedCRC = 0;
+
+            /*-- another stream may follow, on a byte boundary --*/
+            h = (m->pos + 80 + 7) >> 3;
+            if (h + 4 <= nbytes && parIsHeader ( sc.base + h )) {
+               ret = parNewStream ( &sc, &pool, jobs, nJobs, h, &k, &d );
+            } else {
+               if (h < nbytes && trailingGarbage != NULL)
+                  *trailingGarbage = 1;
+               finished = True;
+            }
+            break;
+
+         default:
+            ret = BZ_UNEXPECTED_EOF;
+            break;
+      }
+   }
+
+   for (i = 0; i < nJobs; i++)
+      if (jobs[i].busy) parWait ( &pool, &jobs[i] );
+   parStop ( &pool );
+   for (i = 0; i < nJobs; i++) {
+      if (jobs[i].synth != NULL) free ( jobs[i].synth );
+      if (jobs[i].out != NULL) free ( jobs[i].out );
+   }
+   free ( jobs );
+   free ( sc.marks );
+   munmap ( map, (size_t)st.st_size );
+   return ret;
+}
+
+#endif
+
+
+/*-------------------------------------------------------------*/
+/*--- end                                        parallel.c ---*/
+/*-------------------------------------------------------------*/
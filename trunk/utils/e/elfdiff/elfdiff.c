@@ -129,7 +129,7 @@ int binary_diff(int fd1, int fd2, char *sections, int verbose) {
     return ED_ELFFAIL;
   }
 
-  if ((elf1 = elf_begin(fd1, ELF_C_READ, NULL)) != NULL) {
+  if ((elf1 = elf_begin(fd1, ELF_C_READ_MMAP, NULL)) != NULL) {
     kind1 = elf_kind(elf1);
     elf_end(elf1);
   } else {
@@ -137,7 +137,7 @@ int binary_diff(int fd1, int fd2, char *sections, int verbose) {
     return ED_NOELF1;
   }
 
-  if ((elf2 = elf_begin(fd2, ELF_C_READ, NULL)) != NULL) {
+  if ((elf2 = elf_begin(fd2, ELF_C_READ_MMAP, NULL)) != NULL) {
     kind2 = elf_kind(elf2);
     elf_end(elf2);
   } else {
@@ -559,12 +559,12 @@ int elf_diff(int fd1, int fd2, char *sections, int verbose) {
   int retval = ED_SUCCESS;
   Elf *elf[2];
 
-  if ((elf[0] = elf_begin(fd1,ELF_C_READ,NULL))==NULL) {
+  if ((elf[0] = elf_begin(fd1, ELF_C_READ_MMAP, NULL))==NULL) {
     if (verbose) fprintf(stderr, "elfdiff: Error reading ELF information from first input file.\n");
     return ED_ELFFAIL;
   }
 
-  if ((elf[1] = elf_begin(fd2,ELF_C_READ,NULL))==NULL) {
+  if ((elf[1] = elf_begin(fd2, ELF_C_READ_MMAP, NULL))==NULL) {
     if (verbose) fprintf(stderr, "elfdiff: Error reading ELF information from second input file.\n");
     elf_end(elf[0]);
     return ED_ELFFAIL;
@@ -615,12 +615,12 @@ int ar_diff(int fd1, int fd2, char *sections, int verbose) {
   Elf *elf[2];
   Elf_Cmd cmd[2];
 
-  if ((arf[0] = elf_begin(fd1,ELF_C_READ,NULL))==NULL) {
+  if ((arf[0] = elf_begin(fd1, ELF_C_READ_MMAP, NULL))==NULL) {
     if (verbose) fprintf(stderr, "elfdiff: Error reading AR information from first input file.\n");
     return ED_ELFFAIL;
   }
 
-  if ((arf[1] = elf_begin(fd2,ELF_C_READ,NULL))==NULL) {
+  if ((arf[1] = elf_begin(fd2, ELF_C_READ_MMAP, NULL))==NULL) {
     if (verbose) fprintf(stderr, "elfdiff: Error reading AR information from second input file.\n");
     elf_end(elf[0]);
     return ED_ELFFAIL;
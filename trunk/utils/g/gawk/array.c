@@ -24,23 +24,70 @@
  */
 
 /*
- * Tree walks (``for (iggy in foo)'') and array deletions use expensive
- * linear searching.  So what we do is start out with small arrays and
- * grow them as needed, so that our arrays are hopefully small enough,
- * most of the time, that they're pretty full and we're not looking at
- * wasted space.
+ * Arrays are hash tables with open addressing and linear probing.  Each
+ * slot holds the full hash code of its subscript next to the pointer to
+ * the element, so a probe only looks at an element whose code matches.
+ * Tables are powers of two in size and are kept at most half full,
+ * counting deleted slots.
  *
- * The decision is made to grow the array if the average chain length is
- * ``too big''. This is defined as the total number of entries in the table
- * divided by the size of the array being greater than some constant.
+ * Growing a big table all at once would stall the program for as long
+ * as it takes to rehash everything in it, so instead the new table is
+ * allocated and the old one is drained into it a few slots at a time,
+ * on each later operation on the array.  Until it's empty, lookups
+ * search both.  Drained slots are marked deleted, not cleared, so that
+ * the probe sequences through the old table stay intact.
+ *
+ * Array elements keep their Node_ahash nodes, since assoc_lookup()
+ * hands out pointers to their values that have to survive the table
+ * being grown (or drained) underneath them.
+ *
+ * Subscripts which are strings are interned: one node, whose text lives
+ * in a small-block arena along with its hash code, is shared by every
+ * array that uses that subscript.  Scripts which count and total the
+ * same keys in several arrays keep one copy of each key, and looking up
+ * one array with a subscript taken from another (for (k in a) b[k]...)
+ * needs neither hashing nor a string compare.
  */
 
-#define AVG_CHAIN_MAX	10   /* don't want to linear search more than this */
+#define AH_MINSIZE	16	/* smallest table */
+#define AH_DRAIN	16	/* old slots drained per operation */
 
 #include "awk.h"
 
-static NODE *assoc_find P((NODE *symbol, NODE *subs, int hash1));
-static void grow_table P((NODE *symbol));
+static NODE ah_deleted_node;	/* marks a deleted slot */
+#define AH_DELETED	(& ah_deleted_node)
+
+static AHTABLE strtab;		/* the interned subscripts */
+static unsigned long strcount;	/* and how many there are */
+
+/* what an interned string's block starts with; see istr_alloc() */
+union istr {
+	union istr *next;	/* on a free list */
+	unsigned long code;	/* in use: the hash code of the string */
+	double align;
+};
+
+/* subscripts from input and from the program are interned apart */
+#define ah_origin(n)	(((n)->flags & (MAYBE_NUM|NUMBER)) != 0)
+
+#define ah_live(e)	((e) != NULL && (e) != AH_DELETED)
+/* the table whose elements are the subscripts themselves */
+#define ah_key(t, e)	((t) == & strtab ? (e) : (e)->ahname)
+
+static unsigned long str_hash P((const char *s, size_t len));
+static unsigned long ah_code P((NODE *subs));
+static AHSLOT *ah_probe P((AHTABLE *t, AHSLOT *slots, unsigned long size,
+				unsigned long code, NODE *subs));
+static AHSLOT *ah_find P((AHTABLE *t, unsigned long code, NODE *subs));
+static void ah_place P((AHTABLE *t, unsigned long code, NODE *elem));
+static void ah_insert P((AHTABLE *t, unsigned long code, NODE *elem,
+				unsigned long count));
+static void ah_drain P((AHTABLE *t, unsigned long n));
+static void ah_grow P((AHTABLE *t, unsigned long count));
+static void ah_free P((AHTABLE *t));
+static NODE *intern P((NODE *subs, unsigned long code));
+static char *istr_alloc P((size_t len, unsigned long code));
+static void istr_free P((char *str, size_t len));
 
 /* concat_exp --- concatenate expression list into a single string */
 
@@ -95,21 +142,26 @@ void
 assoc_clear(symbol)
 NODE *symbol;
 {
-	int i;
-	NODE *bucket, *next;
+	AHTABLE *t;
+	AHSLOT *slots;
+	unsigned long i, size;
+	NODE *bucket;
 
-	if (symbol->var_array == NULL)
+	if ((t = symbol->var_array) == NULL)
 		return;
-	for (i = 0; i < symbol->array_size; i++) {
-		for (bucket = symbol->var_array[i]; bucket != NULL; bucket = next) {
-			next = bucket->ahnext;
+	for (slots = t->slots, size = t->size; slots != NULL;
+	     slots = (slots == t->slots ? t->old : NULL), size = t->oldsize) {
+		for (i = 0; i < size; i++) {
+			bucket = slots[i].elem;
+			if (! ah_live(bucket))
+				continue;
 			unref(bucket->ahname);
 			unref(bucket->ahvalue);
 			freenode(bucket);
 		}
-		symbol->var_array[i] = NULL;
 	}
-	free(symbol->var_array);
+	ah_free(t);
+	free((char *) t);
 	symbol->var_array = NULL;
 	symbol->array_size = symbol->table_size = 0;
 	symbol->flags &= ~ARRAYMAXED;
@@ -122,6 +174,21 @@ hash(s, len, hsize)
 register const char *s;
 register size_t len;
 unsigned long hsize;
+{
+	register unsigned long h;
+
+	h = str_hash(s, len);
+	if (h >= hsize)
+		h %= hsize;
+	return h;
+}
+
+/* str_hash --- the hash of a string, before reducing it to a table size */
+
+static unsigned long
+str_hash(s, len)
+register const char *s;
+register size_t len;
 {
 	register unsigned long h = 0;
 
@@ -200,48 +267,212 @@ unsigned long hsize;
 	}
 #endif /* ! VAXC */
 
-	if (h >= hsize)
-		h %= hsize;
 	return h;
 }
 
-/* assoc_find --- locate symbol[subs] */
+/* ah_code --- the hash code of a subscript, as kept in the array tables */
 
-static NODE *				/* NULL if not found */
-assoc_find(symbol, subs, hash1)
-NODE *symbol;
-register NODE *subs;
-int hash1;
+static unsigned long
+ah_code(subs)
+NODE *subs;
 {
-	register NODE *bucket;
-	NODE *s1, *s2;
+	register unsigned long h;
+
+	if ((subs->flags & INTERN) != 0)
+		return ((union istr *) subs->stptr)[-1].code;
+
+	/*
+	 * The tables are indexed by the low bits of the code, and the low
+	 * bits of an sdbm hash only depend on the low bits of the
+	 * characters, so stir the bits about (this is the finishing step
+	 * of Austin Appleby's MurmurHash3).
+	 */
+	h = str_hash(subs->stptr, subs->stlen) & 0xffffffffUL;
+	h ^= h >> 16;
+	h = (h * 0x85ebca6bUL) & 0xffffffffUL;
+	h ^= h >> 13;
+	h = (h * 0xc2b2ae35UL) & 0xffffffffUL;
+	h ^= h >> 16;
+	return h;
+}
 
-	for (bucket = symbol->var_array[hash1]; bucket != NULL;
-			bucket = bucket->ahnext) {
+/* ah_probe --- look for subs in one set of slots */
+
+static AHSLOT *				/* NULL if not found */
+ah_probe(t, slots, size, code, subs)
+AHTABLE *t;
+AHSLOT *slots;
+unsigned long size;
+unsigned long code;
+register NODE *subs;
+{
+	register AHSLOT *sp;
+	register unsigned long i, mask;
+	NODE *name;
+
+	mask = size - 1;
+	for (i = code & mask; (sp = &slots[i])->elem != NULL;
+			i = (i + 1) & mask) {
+		if (sp->code != code || sp->elem == AH_DELETED)
+			continue;
 		/*
 		 * This used to use cmp_nodes() here.  That's wrong.
 		 * Array indexes are strings; compare as such, always!
 		 */
-		s1 = bucket->ahname;
-		s1 = force_string(s1);
-		s2 = subs;
-
-		if (s1->stlen == s2->stlen) {
-			if (s1->stlen == 0	/* "" is a valid index */
-			    || STREQN(s1->stptr, s2->stptr, s1->stlen))
-				return bucket;
-		}
+		name = ah_key(t, sp->elem);
+		if (name != subs
+		    && (name->stlen != subs->stlen
+			|| (subs->stlen != 0	/* "" is a valid index */
+			    && memcmp(name->stptr, subs->stptr,
+					subs->stlen) != 0)))
+			continue;
+		/* an interned string also has to have come from the same place */
+		if (t == & strtab && ah_origin(name) != ah_origin(subs))
+			continue;
+		return sp;
 	}
 	return NULL;
 }
 
+/* ah_find --- locate the slot holding subs */
+
+static AHSLOT *				/* NULL if not found */
+ah_find(t, code, subs)
+AHTABLE *t;
+unsigned long code;
+NODE *subs;
+{
+	AHSLOT *sp;
+
+	if (t->slots == NULL)
+		return NULL;
+	if (t->old == NULL)
+		return ah_probe(t, t->slots, t->size, code, subs);
+
+	ah_drain(t, AH_DRAIN);
+	sp = ah_probe(t, t->slots, t->size, code, subs);
+	if (sp == NULL && t->old != NULL)
+		sp = ah_probe(t, t->old, t->oldsize, code, subs);
+	return sp;
+}
+
+/* ah_place --- put an element into the first free slot for it */
+
+static void
+ah_place(t, code, elem)
+AHTABLE *t;
+unsigned long code;
+NODE *elem;
+{
+	register AHSLOT *sp;
+	register unsigned long i, mask;
+
+	mask = t->size - 1;
+	for (i = code & mask; ah_live((sp = &t->slots[i])->elem);
+			i = (i + 1) & mask)
+		continue;
+	if (sp->elem == NULL)
+		t->used++;
+	sp->code = code;
+	sp->elem = elem;
+}
+
+/* ah_insert --- add an element that isn't there, growing if need be */
+
+static void
+ah_insert(t, code, elem, count)
+AHTABLE *t;
+unsigned long code;
+NODE *elem;
+unsigned long count;	/* elements in the table now */
+{
+	if ((t->used + 1) * 2 > t->size) {
+		/* finish off any grow in progress first */
+		ah_drain(t, t->oldsize);
+		if ((t->used + 1) * 2 > t->size)
+			ah_grow(t, count);
+	}
+	ah_place(t, code, elem);
+}
+
+/* ah_drain --- move up to n slots' worth of the old table to the new */
+
+static void
+ah_drain(t, n)
+AHTABLE *t;
+unsigned long n;
+{
+	AHSLOT *sp;
+	unsigned long end;
+
+	if (t->old == NULL)
+		return;
+	end = t->moved + n;
+	if (end > t->oldsize || end < t->moved)
+		end = t->oldsize;
+	for (sp = &t->old[t->moved]; sp < &t->old[end]; sp++) {
+		if (ah_live(sp->elem)) {
+			ah_place(t, sp->code, sp->elem);
+			sp->elem = AH_DELETED;	/* keep probes going */
+		}
+	}
+	t->moved = end;
+	if (t->moved == t->oldsize) {
+		free((char *) t->old);
+		t->old = NULL;
+		t->oldsize = t->moved = 0;
+	}
+}
+
+/* ah_grow --- start using a bigger (or cleaner) table */
+
+static void
+ah_grow(t, count)
+AHTABLE *t;
+unsigned long count;
+{
+	unsigned long newsize;
+
+	/*
+	 * Leave room for the elements there now to at least double before
+	 * the next grow.  The old table has no drain in progress, and will
+	 * be drained long before the new one gets to be half full.  With
+	 * a lot of deleted slots this can be a shrink.
+	 */
+	newsize = AH_MINSIZE;
+	while (newsize < (count + 1) * 4)
+		newsize *= 2;
+
+	if (t->slots != NULL) {
+		t->old = t->slots;
+		t->oldsize = t->size;
+		t->moved = 0;
+	}
+	emalloc(t->slots, AHSLOT *, newsize * sizeof(AHSLOT), "ah_grow");
+	memset(t->slots, '\0', newsize * sizeof(AHSLOT));
+	t->size = newsize;
+	t->used = 0;
+}
+
+/* ah_free --- release the slots of a table */
+
+static void
+ah_free(t)
+AHTABLE *t;
+{
+	if (t->slots != NULL)
+		free((char *) t->slots);
+	if (t->old != NULL)
+		free((char *) t->old);
+	memset(t, '\0', sizeof(AHTABLE));
+}
+
 /* in_array --- test whether the array element symbol[subs] exists or not */
 
 int
 in_array(symbol, subs)
 NODE *symbol, *subs;
 {
-	register int hash1;
 	int ret;
 
 	if (symbol->type == Node_param_list)
@@ -258,8 +489,7 @@ NODE *symbol, *subs;
 		free_temp(subs);
 		return 0;
 	}
-	hash1 = hash(subs->stptr, subs->stlen, (unsigned long) symbol->array_size);
-	ret = (assoc_find(symbol, subs, hash1) != NULL);
+	ret = (ah_find(symbol->var_array, ah_code(subs), subs) != NULL);
 	free_temp(subs);
 	return ret;
 }
@@ -277,7 +507,9 @@ NODE **
 assoc_lookup(symbol, subs)
 NODE *symbol, *subs;
 {
-	register int hash1;
+	AHTABLE *t;
+	AHSLOT *sp;
+	unsigned long code;
 	register NODE *bucket;
 
 	assert(symbol->type == Node_var_array || symbol->type == Node_var);
@@ -287,24 +519,20 @@ NODE *symbol, *subs;
 	if ((symbol->flags & SCALAR) != 0)
 		fatal("attempt to use scalar as array");
 
-	if (symbol->var_array == NULL) {
+	code = ah_code(subs);
+	if ((t = symbol->var_array) == NULL) {
 		if (symbol->type != Node_var_array) {
 			unref(symbol->var_value);
 			symbol->type = Node_var_array;
 		}
+		emalloc(t, AHTABLE *, sizeof(AHTABLE), "assoc_lookup");
+		memset(t, '\0', sizeof(AHTABLE));
+		symbol->var_array = t;
 		symbol->array_size = symbol->table_size = 0;	/* sanity */
 		symbol->flags &= ~ARRAYMAXED;
-		grow_table(symbol);
-		hash1 = hash(subs->stptr, subs->stlen,
-				(unsigned long) symbol->array_size);
-	} else {
-		hash1 = hash(subs->stptr, subs->stlen,
-				(unsigned long) symbol->array_size);
-		bucket = assoc_find(symbol, subs, hash1);
-		if (bucket != NULL) {
-			free_temp(subs);
-			return &(bucket->ahvalue);
-		}
+	} else if ((sp = ah_find(t, code, subs)) != NULL) {
+		free_temp(subs);
+		return &(sp->elem->ahvalue);
 	}
 
 	/* It's not there, install it. */
@@ -312,24 +540,15 @@ NODE *symbol, *subs;
 		warning("subscript of array `%s' is null string",
 			symbol->vname);
 
-	/* first see if we would need to grow the array, before installing */
-	symbol->table_size++;
-	if ((symbol->flags & ARRAYMAXED) == 0
-	    && symbol->table_size/symbol->array_size > AVG_CHAIN_MAX) {
-		grow_table(symbol);
-		/* have to recompute hash value for new size */
-		hash1 = hash(subs->stptr, subs->stlen,
-				(unsigned long) symbol->array_size);
-	}
-
 	getnode(bucket);
 	bucket->type = Node_ahash;
-	bucket->ahname = dupnode(subs);
+	bucket->ahname = intern(subs, code);
 	free_temp(subs);
 
 	bucket->ahvalue = Nnull_string;
-	bucket->ahnext = symbol->var_array[hash1];
-	symbol->var_array[hash1] = bucket;
+	ah_insert(t, code, bucket, (unsigned long) symbol->table_size);
+	symbol->table_size++;
+	symbol->array_size = t->size;
 	return &(bucket->ahvalue);
 }
 
@@ -339,8 +558,9 @@ void
 do_delete(symbol, tree)
 NODE *symbol, *tree;
 {
-	register int hash1;
-	register NODE *bucket, *last;
+	AHTABLE *t;
+	AHSLOT *sp;
+	register NODE *bucket;
 	NODE *subs;
 
 	if (symbol->type == Node_param_list) {
@@ -363,29 +583,10 @@ NODE *symbol, *tree;
 	}
 
 	subs = concat_exp(tree);	/* concat_exp returns string node */
-	hash1 = hash(subs->stptr, subs->stlen, (unsigned long) symbol->array_size);
+	t = symbol->var_array;
+	sp = ah_find(t, ah_code(subs), subs);
 
-	last = NULL;
-	for (bucket = symbol->var_array[hash1]; bucket != NULL;
-			last = bucket, bucket = bucket->ahnext) {
-		/*
-		 * This used to use cmp_nodes() here.  That's wrong.
-		 * Array indexes are strings; compare as such, always!
-		 */
-		NODE *s1, *s2;
-
-		s1 = bucket->ahname;
-		s1 = force_string(s1);
-		s2 = subs;
-
-		if (s1->stlen == s2->stlen) {
-			if (s1->stlen == 0	/* "" is a valid index */
-			    || STREQN(s1->stptr, s2->stptr, s1->stlen))
-				break;
-		}
-	}
-
-	if (bucket == NULL) {
+	if (sp == NULL) {
 		if (do_lint)
 			warning("delete: index `%s' not in array `%s'",
 				subs->stptr, symbol->vname);
@@ -393,21 +594,18 @@ NODE *symbol, *tree;
 		return;
 	}
 	free_temp(subs);
-	if (last != NULL)
-		last->ahnext = bucket->ahnext;
-	else
-		symbol->var_array[hash1] = bucket->ahnext;
+	bucket = sp->elem;
+	sp->elem = AH_DELETED;
 	unref(bucket->ahname);
 	unref(bucket->ahvalue);
 	freenode(bucket);
 	symbol->table_size--;
 	if (symbol->table_size <= 0) {
-		memset(symbol->var_array, '\0',
-			sizeof(NODE *) * symbol->array_size);
+		ah_free(t);
+		free((char *) t);
+		symbol->var_array = NULL;
 		symbol->table_size = symbol->array_size = 0;
 		symbol->flags &= ~ARRAYMAXED;
-		free((char *) symbol->var_array);
-		symbol->var_array = NULL;
 	}
 }
 
@@ -423,8 +621,8 @@ void
 do_delete_loop(symbol, tree)
 NODE *symbol, *tree;
 {
-	size_t i;
-	NODE *n, **lhs;
+	struct search l;
+	NODE **lhs;
 	Func_ptr after_assign = NULL;
 
 	if (symbol->type == Node_param_list) {
@@ -442,13 +640,11 @@ NODE *symbol, *tree;
 			symbol->vname);
 
 	/* get first index value */
-	for (i = 0; i < symbol->array_size; i++) {
-		if (symbol->var_array[i] != NULL) {
-			lhs = get_lhs(tree->lnode, & after_assign);
-			unref(*lhs);
-			*lhs = dupnode(symbol->var_array[i]->ahname);
-			break;
-		}
+	assoc_scan(symbol, &l);
+	if (l.retval != NULL) {
+		lhs = get_lhs(tree->lnode, & after_assign);
+		unref(*lhs);
+		*lhs = dupnode(l.retval);
 	}
 
 	/* blast the array in one shot */
@@ -464,10 +660,12 @@ struct search *lookat;
 {
 	lookat->sym = symbol;
 	lookat->idx = 0;
-	lookat->bucket = NULL;
 	lookat->retval = NULL;
-	if (symbol->var_array != NULL)
+	if (symbol->var_array != NULL) {
+		/* walk just the one table */
+		ah_drain(symbol->var_array, symbol->var_array->oldsize);
 		assoc_next(lookat);
+	}
 }
 
 /* assoc_next --- actually find the next element in array */
@@ -477,122 +675,151 @@ assoc_next(lookat)
 struct search *lookat;
 {
 	register NODE *symbol = lookat->sym;
+	AHTABLE *t;
+	NODE *bucket;
 	
 	if (symbol == NULL)
 		fatal("null symbol in assoc_next");
-	if (symbol->var_array == NULL || lookat->idx > symbol->array_size) {
-		lookat->retval = NULL;
-		return;
-	}
 	/*
-	 * This is theoretically unsafe.  The element bucket might have
-	 * been freed if the body of the scan did a delete on the next
-	 * element of the bucket.  The only way to do that is by array
-	 * reference, which is unlikely.  Basically, if the user is doing
-	 * anything other than an operation on the current element of an
-	 * assoc array while walking through it sequentially, all bets are
-	 * off.  (The safe way is to register all search structs on an
-	 * array with the array, and update all of them on a delete or
-	 * insert)
+	 * The body of the loop can add and delete elements.  Deleting is
+	 * fine, and so is adding, unless it makes the table grow; then the
+	 * walk carries on through the new table, and may see some
+	 * elements twice and miss others.  Deleting the whole array ends
+	 * the walk.
 	 */
-	if (lookat->bucket != NULL) {
-		lookat->retval = lookat->bucket->ahname;
-		lookat->bucket = lookat->bucket->ahnext;
+	if ((t = symbol->var_array) == NULL) {
+		lookat->retval = NULL;
 		return;
 	}
-	for (; lookat->idx < symbol->array_size; lookat->idx++) {
-		NODE *bucket;
-
-		if ((bucket = symbol->var_array[lookat->idx]) != NULL) {
+	for (; lookat->idx < t->size; lookat->idx++) {
+		bucket = t->slots[lookat->idx].elem;
+		if (ah_live(bucket)) {
 			lookat->retval = bucket->ahname;
-			lookat->bucket = bucket->ahnext;
 			lookat->idx++;
 			return;
 		}
 	}
 	lookat->retval = NULL;
-	lookat->bucket = NULL;
 	return;
 }
 
-/* grow_table --- grow a hash table */
+/* intern --- get the shared copy of a subscript, making it if need be */
 
-static void
-grow_table(symbol)
-NODE *symbol;
+static NODE *
+intern(subs, code)
+NODE *subs;
+unsigned long code;
 {
-	NODE **old, **new, *chain, *next;
-	int i, j;
-	unsigned long hash1;
-	unsigned long oldsize, newsize;
+	AHSLOT *sp;
+	NODE *r;
+
+	if ((subs->flags & INTERN) != 0)
+		return dupnode(subs);
 	/*
-	 * This is an array of primes. We grow the table by an order of
-	 * magnitude each time (not just doubling) so that growing is a
-	 * rare operation. We expect, on average, that it won't happen
-	 * more than twice.  The final size is also chosen to be small
-	 * enough so that MS-DOG mallocs can handle it. When things are
-	 * very large (> 8K), we just double more or less, instead of
-	 * just jumping from 8K to 64K.
+	 * Numbers keep their own nodes: the string is only what CONVFMT
+	 * made of the value, and comparisons need the value itself.
 	 */
-	static long sizes[] = { 13, 127, 1021, 8191, 16381, 32749, 65497,
-#if ! defined(MSDOS) && ! defined(OS2) && ! defined(atarist)
-				131101, 262147, 524309, 1048583, 2097169,
-				4194319, 8388617, 16777259, 33554467, 
-				67108879, 134217757, 268435459, 536870923,
-				1073741827
-#endif
-	};
-
-	/* find next biggest hash size */
-	newsize = oldsize = symbol->array_size;
-	for (i = 0, j = sizeof(sizes)/sizeof(sizes[0]); i < j; i++) {
-		if (oldsize < sizes[i]) {
-			newsize = sizes[i];
-			break;
-		}
-	}
+	if ((subs->flags & NUMBER) != 0)
+		return dupnode(subs);
+
+	if ((sp = ah_find(& strtab, code, subs)) != NULL)
+		return dupnode(sp->elem);
+
+	getnode(r);
+	r->type = Node_val;
+	r->flags = (subs->flags & (STRING|MAYBE_NUM|SCALAR))
+			| (STR|MALLOC|INTERN);
+	r->stlen = subs->stlen;
+	r->stptr = istr_alloc(subs->stlen, code);
+	memcpy(r->stptr, subs->stptr, subs->stlen);
+	r->stptr[r->stlen] = '\0';
+	r->stref = 1;
+	r->stfmt = -1;
+	r->numbr = 0.0;
+
+	ah_insert(& strtab, code, r, strcount);
+	strcount++;
+	return r;
+}
 
-	if (newsize == oldsize) {	/* table already at max (!) */
-		symbol->flags |= ARRAYMAXED;
-		return;
-	}
+/* unintern --- the last reference to an interned subscript has gone */
 
-	/* allocate new table */
-	emalloc(new, NODE **, newsize * sizeof(NODE *), "grow_table");
-	memset(new, '\0', newsize * sizeof(NODE *));
+void
+unintern(n)
+NODE *n;
+{
+	AHSLOT *sp;
 
-	/* brand new hash table, set things up and return */
-	if (symbol->var_array == NULL) {
-		symbol->table_size = 0;
-		goto done;
+	if ((sp = ah_find(& strtab, ah_code(n), n)) != NULL) {
+		sp->elem = AH_DELETED;
+		strcount--;
 	}
+	istr_free(n->stptr, n->stlen);
+	freenode(n);
+}
 
-	/* old hash table there, move stuff to new, free old */
-	old = symbol->var_array;
-	for (i = 0; i < oldsize; i++) {
-		if (old[i] == NULL)
-			continue;
+/*
+ * The text of interned subscripts is carved out of ISTR_CHUNK byte
+ * chunks in units of sizeof(union istr), the first of which holds the
+ * hash code.  Freed blocks go on a list for their size; blocks too big
+ * for the lists come from malloc.
+ */
+
+#define ISTR_UNIT	sizeof(union istr)
+#define ISTR_NLISTS	16
+#define ISTR_CHUNK	8192
+#define istr_units(len)	(1 + ((len) + 2 + ISTR_UNIT - 1) / ISTR_UNIT)
 
-		for (chain = old[i]; chain != NULL; chain = next) {
-			next = chain->ahnext;
-			hash1 = hash(chain->ahname->stptr,
-					chain->ahname->stlen, newsize);
+static union istr *istr_list[ISTR_NLISTS + 1];
+static char *istr_next;
+static size_t istr_left;
 
-			/* remove from old list, add to new */
-			chain->ahnext = new[hash1];
-			new[hash1] = chain;
+/* istr_alloc --- get space for an interned string of length len */
 
+static char *
+istr_alloc(len, code)
+size_t len;
+unsigned long code;
+{
+	union istr *p;
+	size_t units;
+
+	units = istr_units(len);
+	if (units > ISTR_NLISTS)
+		emalloc(p, union istr *, units * ISTR_UNIT, "istr_alloc");
+	else if ((p = istr_list[units]) != NULL)
+		istr_list[units] = p->next;
+	else {
+		if (istr_left < units * ISTR_UNIT) {
+			emalloc(istr_next, char *, ISTR_CHUNK, "istr_alloc");
+			istr_left = ISTR_CHUNK;
 		}
+		p = (union istr *) istr_next;
+		istr_next += units * ISTR_UNIT;
+		istr_left -= units * ISTR_UNIT;
 	}
-	free(old);
+	p->code = code;
+	return (char *) (p + 1);
+}
 
-done:
-	/*
-	 * note that symbol->table_size does not change if an old array,
-	 * and is explicitly set to 0 if a new one.
-	 */
-	symbol->var_array = new;
-	symbol->array_size = newsize;
+/* istr_free --- give back the space of an interned string */
+
+static void
+istr_free(str, len)
+char *str;
+size_t len;
+{
+	union istr *p;
+	size_t units;
+
+	p = (union istr *) str - 1;
+	units = istr_units(len);
+	if (units > ISTR_NLISTS)
+		free((char *) p);
+	else {
+		p->next = istr_list[units];
+		istr_list[units] = p;
+	}
 }
 
 /* pr_node --- print simple node info */
@@ -613,10 +840,12 @@ NODE *
 assoc_dump(symbol)
 NODE *symbol;
 {
-	int i;
+	AHTABLE *t;
+	AHSLOT *slots;
+	unsigned long i, size;
 	NODE *bucket;
 
-	if (symbol->var_array == NULL) {
+	if ((t = symbol->var_array) == NULL) {
 		printf("%s: empty (null)\n", symbol->vname);
 		return tmp_number((AWKNUM) 0);
 	}
@@ -626,12 +855,16 @@ NODE *symbol;
 		return tmp_number((AWKNUM) 0);
 	}
 
-	printf("%s: table_size = %d, array_size = %d\n", symbol->vname,
-			symbol->table_size, symbol->array_size);
+	printf("%s: table_size = %ld, array_size = %ld, used = %lu, old = %lu/%lu\n",
+			symbol->vname, symbol->table_size, symbol->array_size,
+			t->used, t->moved, t->oldsize);
 
-	for (i = 0; i < symbol->array_size; i++) {
-		for (bucket = symbol->var_array[i]; bucket != NULL;
-				bucket = bucket->ahnext) {
+	for (slots = t->slots, size = t->size; slots != NULL;
+	     slots = (slots == t->slots ? t->old : NULL), size = t->oldsize) {
+		for (i = 0; i < size; i++) {
+			bucket = slots[i].elem;
+			if (! ah_live(bucket))
+				continue;
 			printf("%s: I: [(%p, %ld, %s) len %d <%.*s>] V: [",
 				symbol->vname,
 				bucket->ahname,
@@ -348,6 +348,8 @@ typedef enum nodevals {
 	Node_final		/* sentry value, not legal */
 } NODETYPE;
 
+struct ahtable;
+
 /*
  * NOTE - this struct is a rather kludgey -- it is packed to minimize
  * space usage, at the expense of cleanliness.  Alter at own risk.
@@ -365,7 +367,7 @@ typedef struct exp_node {
 				struct exp_node *(*pptr)();
 				Regexp *preg;
 				struct for_loop_header *hd;
-				struct exp_node **av;
+				struct ahtable *av;
 				int r_ent;	/* range entered */
 			} r;
 			union {
@@ -399,11 +401,9 @@ typedef struct exp_node {
 #define	hlength	sub.hash.length
 #define	hvalue	sub.hash.value
 		struct {
-			struct exp_node *next;
 			struct exp_node *name;
 			struct exp_node *value;
 		} ahash;
-#define	ahnext	sub.ahash.next
 #define	ahname	sub.ahash.name
 #define	ahvalue	sub.ahash.value
 	} sub;
@@ -423,6 +423,7 @@ typedef struct exp_node {
 #		define	FUNC	1024	/* this parameter is really a
 					 * function name; see awk.y */
 #		define	FIELD	2048	/* this is a field */
+#		define	INTERN	4096	/* shared array subscript; see array.c */
 
 	char *vname;    /* variable's name */
 } NODE;
@@ -471,11 +472,30 @@ typedef struct for_loop_header {
 	NODE *incr;
 } FOR_LOOP_HEADER;
 
+/*
+ * An array's hash table: open addressing with linear probing.  Each slot
+ * keeps the full hash of its subscript, so most mismatches are rejected
+ * without touching the element.  When the table grows, the old one is
+ * drained into the new a few slots per operation; see array.c.
+ */
+typedef struct ahslot {
+	unsigned long code;	/* hash of the subscript */
+	NODE *elem;		/* Node_ahash, NULL if never used, or deleted */
+} AHSLOT;
+
+typedef struct ahtable {
+	AHSLOT *slots;
+	unsigned long size;	/* number of slots, a power of 2 */
+	unsigned long used;	/* slots that are not NULL */
+	AHSLOT *old;		/* table being drained, or NULL */
+	unsigned long oldsize;
+	unsigned long moved;	/* old[0 .. moved-1] have been drained */
+} AHTABLE;
+
 /* for "for(iggy in foo) {" */
 struct search {
 	NODE *sym;
 	size_t idx;
-	NODE *bucket;
 	NODE *retval;
 };
 
@@ -716,6 +736,7 @@ extern double _msc51bug;
 extern NODE *concat_exp P((NODE *tree));
 extern void assoc_clear P((NODE *symbol));
 extern unsigned int hash P((const char *s, size_t len, unsigned long hsize));
+extern void unintern P((NODE *n));
 extern int in_array P((NODE *symbol, NODE *subs));
 extern NODE **assoc_lookup P((NODE *symbol, NODE *subs));
 extern void do_delete P((NODE *symbol, NODE *tree));
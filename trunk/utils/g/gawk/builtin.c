@@ -1484,7 +1484,7 @@ int how_many, backdigs;
 	/*
 	 * create a private copy of the string
 	 */
-	if (t->stref > 1 || (t->flags & (PERM|FIELD)) != 0) {
+	if (t->stref > 1 || (t->flags & (PERM|FIELD|INTERN)) != 0) {
 		unsigned int saveflags;
 
 		saveflags = t->flags;
@@ -343,6 +343,12 @@ int flagval;
 		strcpy(sp, "FIELD");
 		sp += strlen(sp);
 	}
+	if (flagval & INTERN) {
+		if (sp != buffer)
+			*sp++ = '|';
+		strcpy(sp, "INTERN");
+		sp += strlen(sp);
+	}
 
 	return buffer;
 }
@@ -238,8 +238,17 @@ int freeold;
 #define INITIAL_SIZE	512
 #define MAX_SIZE	((unsigned long) ~0)	/* maximally portable ... */
 
+	/*
+	 * Only the fields that were asked for got parsed, so only those
+	 * need resetting.  A field that is still a FIELD node isn't
+	 * shared (dupnode() copies them), so it can be reset in place.
+	 */
 	NF = -1;
 	for (i = 1; i <= parse_high_water; i++) {
+		if ((fields_arr[i]->flags & FIELD) != 0) {
+			*fields_arr[i] = *Null_field;
+			continue;
+		}
 		unref(fields_arr[i]);
 		getnode(n);
 		*n = *Null_field;
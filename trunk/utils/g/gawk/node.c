@@ -241,7 +241,7 @@ NODE *n;
 	}
 	getnode(r);
 	*r = *n;
-	r->flags &= ~(PERM|TEMP|FIELD);
+	r->flags &= ~(PERM|TEMP|FIELD|INTERN);
 	r->flags |= MALLOC;
 	if (n->type == Node_val && (n->flags & STR) != 0) {
 		r->stref = 1;
@@ -401,6 +401,10 @@ register NODE *tmp;
 					tmp->stref--;
 				return;
 			}
+			if ((tmp->flags & INTERN) != 0) {
+				unintern(tmp);
+				return;
+			}
 			free(tmp->stptr);
 		}
 		freenode(tmp);
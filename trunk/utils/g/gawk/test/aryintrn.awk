@@ -0,0 +1,71 @@
+# aryintrn.awk --- array subscripts shared between arrays, and
+#		   arrays that grow and shrink a lot.
+#
+# Subscripts that came from input still compare as numbers when they
+# look like numbers, even when the same text is used as a subscript
+# from a string constant.  Nothing here depends on the order of a
+# for (k in a) walk.
+
+{
+	count[$1]++
+	bytes[$1] += $2
+}
+
+END {
+	const["10"] = 1
+	const["abc"] = 1
+
+	n = 0
+	for (k in count)
+		if (k < 9)
+			n++
+	print n, "input subscripts less than 9"
+	n = 0
+	for (k in const)
+		if (k < 9)
+			n++
+	print n, "constant subscripts less than 9"
+
+	t = 0
+	for (k in count)
+		t += bytes[k] * count[k]
+	print "weighted total", t
+
+	for (i = 0; i < 20000; i++)
+		big["k" i] = i
+	for (i = 0; i < 20000; i += 2)
+		delete big["k" i]
+	n = s = 0
+	for (k in big) {
+		n++
+		s += big[k]
+	}
+	print n, "left, sum", s
+	n = 0
+	for (i = 0; i < 20000; i++)
+		if (("k" i) in big)
+			n++
+	print n, "found"
+
+	for (k in big)
+		copy[k] = big[k]
+	delete big
+	n = 0
+	for (k in copy)
+		if (k in big)
+			n++
+	print n, "in big after delete"
+	for (i = 1; i < 20000; i += 2)
+		if (copy["k" i] != i)
+			print "copy[k" i "] is wrong"
+
+	x["hello"] = 1
+	for (k in x) {
+		delete x[k]
+		sub(/l+/, "L", k)
+		print k
+	}
+	y["hello"] = 1
+	for (k in y)
+		print k
+}
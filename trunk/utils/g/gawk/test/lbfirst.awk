@@ -0,0 +1,13 @@
+# lbfirst.awk --- distinct clients, using only the first field of
+# long lines, and deleting as it goes.
+{
+	if ($1 in seen)
+		delete seen[$1]
+	else
+		seen[$1] = NR
+}
+END {
+	for (c in seen)
+		n++
+	print n, "clients seen an odd number of times"
+}
@@ -0,0 +1,34 @@
+# lbgen.awk --- make a synthetic web server log for the logbench timings.
+#
+# Usage: gawk -v lines=N -v clients=C -v urls=U -f lbgen.awk
+#
+# Client and URL popularity is skewed, as in real logs: a few of each
+# account for most of the lines, and there is a long tail.
+
+function pick(n,	r)
+{
+	r = rand()
+	return int(n * r * r * r)
+}
+
+BEGIN {
+	if (lines == 0)
+		lines = 1000000
+	if (clients == 0)
+		clients = 50000
+	if (urls == 0)
+		urls = 20000
+	split("200 200 200 200 200 200 304 304 404 500", status, " ")
+	split("Jan Feb Mar Apr May Jun Jul Aug Sep Oct Nov Dec", month, " ")
+	srand(1)
+	for (i = 0; i < lines; i++) {
+		c = pick(clients)
+		printf("10.%d.%d.%d - - [%02d/%s/2000:%02d:%02d:%02d -0500] ",
+			int(c / 65536) % 256, int(c / 256) % 256, c % 256,
+			1 + i % 28, month[1 + int(i * 12 / lines)],
+			int(i / 3600) % 24, int(i / 60) % 60, i % 60)
+		printf("\"GET /docs/%d/page%d.html HTTP/1.0\" %s %d \"-\" \"Agent/%d\"\n",
+			pick(urls) % 97, pick(urls), status[1 + int(rand() * 10)],
+			200 + int(rand() * 20000), c % 7)
+	}
+}
@@ -0,0 +1,6 @@
+# lbhits.awk --- hits per client, the ten busiest.
+{ hits[$1]++ }
+END {
+	for (c in hits)
+		print hits[c], c | "sort -nr | sed 10q"
+}
@@ -0,0 +1,20 @@
+# lbstatus.awk --- status codes per day and client, with SUBSEP
+# subscripts, then errors per client.
+{
+	day = substr($4, 2, 11)
+	count[day, $1, $9]++
+}
+END {
+	for (k in count) {
+		split(k, part, SUBSEP)
+		if (part[3] >= 400)
+			errs[part[2]] += count[k]
+		days[part[1]]++
+	}
+	n = 0
+	for (c in errs)
+		n++
+	for (d in days)
+		nd++
+	print n, "clients with errors over", nd, "days"
+}
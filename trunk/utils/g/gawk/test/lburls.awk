@@ -0,0 +1,11 @@
+# lburls.awk --- hits and bytes per URL, kept in two arrays with the
+# same subscripts, and the average size of the pages with most hits.
+$9 == 200 {
+	hits[$7]++
+	bytes[$7] += $10
+}
+END {
+	for (u in hits)
+		if (hits[u] >= 100)
+			printf("%d %s %.0f\n", hits[u], u, bytes[u] / hits[u]) | "sort -nr | sed 10q"
+}
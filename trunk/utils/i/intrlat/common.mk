@@ -0,0 +1,14 @@
+ifndef QCONFIG
+QCONFIG=qconfig.mk
+endif
+include $(QCONFIG)
+
+INSTALLDIR = usr/sbin
+
+define PINFO
+PINFO DESCRIPTION=display kernel interrupt latency histograms
+endef
+
+USEFILE=$(PROJECT_ROOT)/$(NAME).c
+
+include $(MKFILES_ROOT)/qtargets.mk
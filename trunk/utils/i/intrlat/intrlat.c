@@ -0,0 +1,280 @@
+/*
+ * $QNXLicenseC:
+ * Copyright 2007, QNX Software Systems. All Rights Reserved.
+ *
+ * You must obtain a written license from and pay applicable license fees to QNX
+ * Software Systems before you may reproduce, modify or distribute this software,
+ * or any work that includes all or part of this software.   Free development
+ * licenses are available for evaluation and non-commercial purposes.  For more
+ * information visit http://licensing.qnx.com or email licensing@qnx.com.
+ *
+ * This file may contain contributions from others.  Please review this entire
+ * file for other proprietary rights or license notices, as well as the QNX
+ * Development Suite License Guide at http://licensing.qnx.com/license-guide/
+ * for other information.
+ * $
+ */
+
+#ifdef __USAGE
+%C - display kernel interrupt latency histograms
+
+%C	[-ac] [-v vector] [-t usec] [-i seconds [-n count]]
+Options:
+ -a          Show the histogram buckets as well as the summary.
+ -c          Report each cpu separately instead of summing them.
+ -v vector   Only report this interrupt vector.
+ -t usec     Mark any 99th percentile above usec, and exit with
+             status 1 if there was one.
+ -i seconds  Report what happened over each interval of this length,
+             instead of everything since boot.
+ -n count    Stop after this many intervals (default: run forever).
+
+Each line gives, for one interrupt vector, the number of samples and
+the 50th, 99th and 99.9th percentiles and the maximum, in microseconds:
+ entry       kernel starting on the vector to the handler being called
+ handler     time spent in the handler (InterruptAttach() only)
+ dispatch    event queued to the attaching thread being made running
+The histograms have power of two buckets, so the times shown are the
+upper bounds of the bucket the percentile falls in.
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <inttypes.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <devctl.h>
+#include <sys/procfs.h>
+#include <sys/syspage.h>
+
+#define NBUCKETS	PROCFS_INTRLAT_BUCKETS
+#define MAX_CPUS	32
+
+struct hist {
+	uint32_t	b[NBUCKETS];
+};
+
+struct vec {
+	struct vec	*next;
+	unsigned	level;
+	unsigned	vector;
+	struct hist	last[MAX_CPUS][3];	/* previous sample, for -i */
+	struct hist	cur[MAX_CPUS][3];
+};
+
+static const char	*kind_name[3] = { "entry", "handler", "dispatch" };
+
+static int			show_all;
+static int			per_cpu;
+static int			only_vector = -1;
+static unsigned		threshold_usec;
+static unsigned		num_cpu = 1;
+static double		usec_per_cycle;
+static struct vec	*vecs;
+
+static double
+bucket_usec(int n) {
+	/* upper bound of bucket n */
+	return (double)((uint64_t)2 << n) * usec_per_cycle;
+}
+
+static int
+percentile(const struct hist *h, uint64_t total, double pct) {
+	uint64_t	want, sum;
+	int			n;
+
+	want = (uint64_t)(total * pct);
+	if(want >= total) want = total - 1;
+	sum = 0;
+	for(n = 0; n < NBUCKETS; ++n) {
+		sum += h->b[n];
+		if(sum > want) break;
+	}
+	return n < NBUCKETS ? n : NBUCKETS - 1;
+}
+
+static int
+report_hist(const char *who, const char *kind, const struct hist *h) {
+	uint64_t	total;
+	int			n, max, p99, over;
+
+	total = 0;
+	max = -1;
+	for(n = 0; n < NBUCKETS; ++n) {
+		total += h->b[n];
+		if(h->b[n]) max = n;
+	}
+	if(total == 0) return 0;
+
+	p99 = percentile(h, total, 0.99);
+	over = threshold_usec && bucket_usec(p99) > threshold_usec;
+	printf("%-12s %-9s %10llu %10.1f %10.1f%c %10.1f %10.1f\n", who, kind,
+		(unsigned long long)total,
+		bucket_usec(percentile(h, total, 0.50)),
+		bucket_usec(p99), over ? '*' : ' ',
+		bucket_usec(percentile(h, total, 0.999)),
+		bucket_usec(max));
+	if(show_all) {
+		for(n = 0; n <= max; ++n) {
+			if(h->b[n]) {
+				printf("%24s < %10.1f us %10u\n", "", bucket_usec(n), (unsigned)h->b[n]);
+			}
+		}
+	}
+	return over;
+}
+
+static int
+fetch(int fd) {
+	procfs_intrlat	il;
+	struct vec		*vp, **owner;
+	unsigned		level, cpu;
+
+	level = 0;
+	for( ;; ) {
+		memset(&il, 0, sizeof(il));
+		il.level = level;
+		il.cpu = 0;
+		if(devctl(fd, DCMD_PROC_INTRLAT, &il, sizeof(il), NULL) != EOK) break;
+		level = il.level;
+		num_cpu = il.num_cpu < MAX_CPUS ? il.num_cpu : MAX_CPUS;
+
+		for(owner = &vecs; (vp = *owner) != NULL && vp->level < level; owner = &vp->next) {
+			/* nothing to do */
+		}
+		if(vp == NULL || vp->level != level) {
+			if((vp = calloc(1, sizeof(*vp))) == NULL) {
+				fprintf(stderr, "intrlat: %s\n", strerror(ENOMEM));
+				exit(EXIT_FAILURE);
+			}
+			vp->level = level;
+			vp->next = *owner;
+			*owner = vp;
+		}
+		vp->vector = il.vector;
+
+		for(cpu = 0; cpu < num_cpu; ++cpu) {
+			if(cpu != 0) {
+				il.level = level;
+				il.cpu = cpu;
+				if(devctl(fd, DCMD_PROC_INTRLAT, &il, sizeof(il), NULL) != EOK) break;
+			}
+			memcpy(vp->cur[cpu][0].b, il.entry, sizeof(il.entry));
+			memcpy(vp->cur[cpu][1].b, il.handler, sizeof(il.handler));
+			memcpy(vp->cur[cpu][2].b, il.dispatch, sizeof(il.dispatch));
+		}
+		++level;
+	}
+	if(vecs == NULL) {
+		fprintf(stderr, "intrlat: no interrupt latency histograms (%s)\n", strerror(errno));
+		return -1;
+	}
+	return 0;
+}
+
+static int
+report(int deltas) {
+	struct vec	*vp;
+	struct hist	h;
+	char		who[32];
+	unsigned	cpu;
+	int			k, n, over;
+
+	over = 0;
+	printf("%-12s %-9s %10s %10s %11s %10s %10s\n", "vector", "", "samples", "p50 us", "p99 us", "p99.9 us", "max us");
+	for(vp = vecs; vp != NULL; vp = vp->next) {
+		if(only_vector != -1 && vp->vector != (unsigned)only_vector) continue;
+		for(k = 0; k < 3; ++k) {
+			memset(&h, 0, sizeof(h));
+			for(cpu = 0; cpu < num_cpu; ++cpu) {
+				for(n = 0; n < NBUCKETS; ++n) {
+					uint32_t	v = vp->cur[cpu][k].b[n];
+
+					if(deltas) v -= vp->last[cpu][k].b[n];
+					if(per_cpu) {
+						h.b[n] = v;
+					} else {
+						h.b[n] += v;
+					}
+				}
+				if(per_cpu) {
+					snprintf(who, sizeof(who), "%u/cpu%u", vp->vector, cpu);
+					over |= report_hist(who, kind_name[k], &h);
+				}
+			}
+			if(!per_cpu) {
+				snprintf(who, sizeof(who), "%u", vp->vector);
+				over |= report_hist(who, kind_name[k], &h);
+			}
+		}
+	}
+	for(vp = vecs; vp != NULL; vp = vp->next) {
+		memcpy(vp->last, vp->cur, sizeof(vp->last));
+	}
+	return over;
+}
+
+int
+main(int argc, char *argv[]) {
+	int			fd, c, over;
+	unsigned	interval = 0;
+	int			count = -1;
+
+	while((c = getopt(argc, argv, "acv:t:i:n:")) != -1) {
+		switch(c) {
+		case 'a':
+			show_all = 1;
+			break;
+		case 'c':
+			per_cpu = 1;
+			break;
+		case 'v':
+			only_vector = strtoul(optarg, NULL, 0);
+			break;
+		case 't':
+			threshold_usec = strtoul(optarg, NULL, 0);
+			break;
+		case 'i':
+			interval = strtoul(optarg, NULL, 0);
+			break;
+		case 'n':
+			count = strtol(optarg, NULL, 0);
+			break;
+		default:
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	usec_per_cycle = 1000000.0 / (double)SYSPAGE_ENTRY(qtime)->cycles_per_sec;
+
+	if((fd = open("/proc", O_RDONLY)) == -1) {
+		fprintf(stderr, "intrlat: /proc: %s\n", strerror(errno));
+		exit(EXIT_FAILURE);
+	}
+	if(fetch(fd) == -1) {
+		exit(EXIT_FAILURE);
+	}
+
+	if(interval == 0) {
+		over = report(0);
+	} else {
+		over = 0;
+		report(0);
+		while(count != 0) {
+			sleep(interval);
+			if(fetch(fd) == -1) {
+				exit(EXIT_FAILURE);
+			}
+			printf("\n");
+			over |= report(1);
+			fflush(stdout);
+			if(count > 0) --count;
+		}
+	}
+	close(fd);
+	return over ? 1 : EXIT_SUCCESS;
+}
+
+__SRCVERSION("intrlat.c $Rev: 153052 $");
@@ -47,7 +47,10 @@ LIB_SOCKET_nto=socket
 LIB_SOCKET_linux=pthread
 LIB_SOCKET=$(LIB_SOCKET_$(OS))
 
-LIBS += $(LIBS_$(SECTION)) compat z lzo ucl
+LIB_THREAD_solaris=pthread
+LIB_THREAD_linux=pthread
+
+LIBS += $(LIBS_$(SECTION)) compat z lzo ucl $(LIB_THREAD_$(OS))
 
 include $(MKFILES_ROOT)/qmacros.mk
 
@@ -34,8 +34,13 @@
 #include <zlib.h>
 #include <lzo1x.h>
 #include <ucl/ucl.h>
+#include <limits.h>
 #include "xplatform.h"
 
+#if !(defined(__WIN32__) || defined(__NT__))
+	#define IFS_THREADS
+	#include <pthread.h>
+#endif
 
 struct soname_entry {
 	struct soname_entry	*next;
@@ -199,13 +204,19 @@ expand_out(int congruence, struct file_entry *fip) {
 }
 
 
-int
-ropen(struct file_entry *fip) {
-	int			 fd;
+static void
+rchdir(struct file_entry *fip) {
 	static char	*lastcd;
 
 	if(*fip->hostpath != '/'  &&  fip->attr  &&  lastcd != fip->attr->cd)
 		chdir(lastcd = fip->attr->cd);
+}
+
+int
+ropen(struct file_entry *fip) {
+	int			 fd;
+
+	rchdir(fip);
 
 	fd = open(fip->hostpath, O_RDONLY);
 	if(fd == -1) {
@@ -1618,6 +1629,7 @@ relocate(struct file_entry *fip, int text_addr, int data_addr, int ehdr_size, ch
 struct file_entry *
 locate_files(struct file_entry *list, int offset, char *destname) {
 	struct file_entry	*datalist;
+	struct file_entry	*duplist;
 	struct file_entry	*data;
 	struct file_entry	*fip;
 	struct file_entry	**owner;
@@ -1637,6 +1649,7 @@ locate_files(struct file_entry *list, int offset, char *destname) {
 	// this will leave some holes which we try and fill with data files later.
 	//
 	datalist = NULL;
+	duplist = NULL;
 	owner = &list;
 	group_id = 0;
 	for( ;; ) {
@@ -1739,6 +1752,12 @@ locate_files(struct file_entry *list, int offset, char *destname) {
 			fip->file_offset = RUP(offset, booter.pagesize);
 			offset = fip->file_offset + fip->size;
 			owner = &fip->next;
+		} else if(fip->same != NULL) {
+			// Duplicates take no space of their own, they're given
+			// the offset of their twin once it has been placed.
+			*owner = fip->next;
+			fip->next = duplist;
+			duplist = fip;
 		} else {
 			*owner = fip->next;
 			// Put the data file on its own sorted list, we'll deal with
@@ -1776,6 +1795,16 @@ locate_files(struct file_entry *list, int offset, char *destname) {
 		*owner = data;
 		data->file_offset = offset;
 	}
+
+	//
+	// Duplicate files follow their twin so the list stays in offset order.
+	//
+	while((data = duplist)) {
+		duplist = data->next;
+		data->file_offset = data->same->file_offset;
+		data->next = data->same->next;
+		data->same->next = data;
+	}
 	return(list);
 }
 
@@ -1833,6 +1862,302 @@ fixup_ram_offsets(struct file_entry *list)
 	}
 }
 
+//
+// Identical files are only stored once in the image. Only plain data
+// files are candidates - executables are relocated and stripped, so
+// what ends up in the image is not the host file.
+//
+struct dedup_entry {
+	struct dedup_entry	*next;
+	struct file_entry	*fip;
+};
+
+static unsigned		dedup_files_saved;
+static unsigned		dedup_bytes_saved;
+
+static int
+dedup_candidate(struct file_entry *fip) {
+	if(fip->attr == NULL || fip->attr->mode != S_IFREG) return(0);
+	if(!(fip->flags & FILE_FLAGS_CRC_VALID)) return(0);
+	if(fip->flags & (FILE_FLAGS_EXEC|FILE_FLAGS_SO|FILE_FLAGS_BOOT|FILE_FLAGS_STARTUP)) return(0);
+	if(fip->linker != NULL || fip->bootargs != NULL) return(0);
+	if(fip->attr->page_align) return(0);
+	return(fip->size != 0);
+}
+
+static int
+dedup_same(struct file_entry *a, struct file_entry *b) {
+	char		cmpbuf[sizeof(copybuf)];
+	int			fda, fdb;
+	unsigned	nbytes;
+	unsigned	n;
+
+	fda = ropen(a);
+	fdb = ropen(b);
+	for(nbytes = a->size; nbytes != 0; nbytes -= n) {
+		n = MIN(nbytes, sizeof(copybuf));
+		if(read(fda, copybuf, n) != n) break;
+		if(read(fdb, cmpbuf, n) != n) break;
+		if(memcmp(copybuf, cmpbuf, n) != 0) break;
+	}
+	close(fda);
+	close(fdb);
+	return(nbytes == 0);
+}
+
+static void
+dedup_files(struct file_entry *list) {
+	struct file_entry	*fip;
+	struct dedup_entry	**hash;
+	struct dedup_entry	*entries;
+	struct dedup_entry	*dp;
+	unsigned			num;
+	unsigned			nhash;
+	unsigned			bucket;
+
+	num = 0;
+	for(fip = list; fip != NULL; fip = fip->next) {
+		if(dedup_candidate(fip)) ++num;
+	}
+	if(num < 2) return;
+
+	for(nhash = 16; nhash < num; nhash <<= 1) {
+		// nothing to do
+	}
+	hash = calloc(nhash, sizeof(*hash));
+	entries = malloc(num * sizeof(*entries));
+	if(hash == NULL || entries == NULL) {
+		error_exit("No memory for duplicate file table.\n");
+	}
+
+	num = 0;
+	for(fip = list; fip != NULL; fip = fip->next) {
+		if(!dedup_candidate(fip)) continue;
+		bucket = (fip->host_file_crc ^ (fip->size * 0x9e3779b1)) & (nhash - 1);
+		for(dp = hash[bucket]; dp != NULL; dp = dp->next) {
+			if(dp->fip->host_file_crc == fip->host_file_crc
+			 && dp->fip->size == fip->size
+			 && dedup_same(dp->fip, fip)) {
+				break;
+			}
+		}
+		if(dp != NULL) {
+			fip->same = dp->fip;
+			++dedup_files_saved;
+			dedup_bytes_saved += fip->size;
+		} else {
+			dp = &entries[num++];
+			dp->fip = fip;
+			dp->next = hash[bucket];
+			hash[bucket] = dp;
+		}
+	}
+	free(entries);
+	free(hash);
+}
+
+#ifdef IFS_THREADS
+//
+// While the image is being written (and possibly compressed), worker
+// threads read the data files ahead of the writer. The writer still
+// consumes them in list order, so the image is the same as when the
+// files are read one at a time.
+//
+#define PREFETCH_MAX_JOBS	16
+#define PREFETCH_WINDOW		(16 M)
+
+struct prefetch_entry {
+	struct file_entry	*fip;
+	char				*path;
+	char				*buf;
+	unsigned			nbytes;
+	int					state;		// 0 - pending, 1 - loaded, -1 - failed
+	int					err;
+};
+
+static struct {
+	pthread_mutex_t			mutex;
+	pthread_cond_t			cond;
+	struct prefetch_entry	*entries;
+	unsigned				num;
+	unsigned				next;		// Next entry for a worker to load
+	unsigned				done;		// Entries consumed by the writer
+	unsigned				bytes;		// Loaded but not yet written
+	unsigned				nthreads;
+	pthread_t				threads[PREFETCH_MAX_JOBS];
+} prefetch = { PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER };
+
+static int
+prefetch_candidate(struct file_entry *fip) {
+	if(fip->attr->mode != S_IFREG) return(0);
+	if(fip->same != NULL || fip->bootargs != NULL) return(0);
+	if(fip->flags & (FILE_FLAGS_EXEC|FILE_FLAGS_SO)) return(0);
+	return(fip->size != 0);
+}
+
+//
+// Workers can't rely on the current directory (ropen() changes it as
+// it goes), so work out the absolute path of each file up front.
+//
+static char *
+prefetch_path(struct file_entry *fip) {
+	char	cwd[PATH_MAX+1];
+	char	*path;
+
+	rchdir(fip);
+	if(*fip->hostpath == '/' || getcwd(cwd, sizeof(cwd)) == NULL) {
+		path = strdup(fip->hostpath);
+	} else {
+		path = malloc(strlen(cwd) + strlen(fip->hostpath) + 2);
+		if(path != NULL) sprintf(path, "%s/%s", cwd, fip->hostpath);
+	}
+	if(path == NULL) {
+		error_exit("No memory for file path.\n");
+	}
+	return(path);
+}
+
+static void *
+prefetch_thread(void *arg) {
+	struct prefetch_entry	*pe;
+	unsigned				size;
+	unsigned				nbytes;
+	char					*buf;
+	int						fd;
+	int						n;
+	int						err;
+
+	pthread_mutex_lock(&prefetch.mutex);
+	while(prefetch.next < prefetch.num) {
+		pe = &prefetch.entries[prefetch.next];
+		size = pe->fip->size;
+		// Don't get too far ahead of the writer, but always let through
+		// the entry that it's waiting on.
+		if(prefetch.next != prefetch.done && prefetch.bytes + size > PREFETCH_WINDOW) {
+			pthread_cond_wait(&prefetch.cond, &prefetch.mutex);
+			continue;
+		}
+		++prefetch.next;
+		prefetch.bytes += size;
+		pthread_mutex_unlock(&prefetch.mutex);
+
+		err = 0;
+		nbytes = 0;
+		n = 0;
+		if((buf = malloc(size)) == NULL) {
+			err = ENOMEM;
+		} else if((fd = open(pe->path, O_RDONLY)) == -1) {
+			err = errno;
+		} else {
+			MAKE_BINARY_FD(fd);
+			while(nbytes < size && (n = read(fd, buf + nbytes, size - nbytes)) > 0) {
+				nbytes += n;
+			}
+			if(n == -1) err = errno;
+			close(fd);
+		}
+
+		pthread_mutex_lock(&prefetch.mutex);
+		pe->buf = buf;
+		pe->nbytes = nbytes;
+		pe->err = err;
+		pe->state = (err == 0) ? 1 : -1;
+		pthread_cond_broadcast(&prefetch.cond);
+	}
+	pthread_mutex_unlock(&prefetch.mutex);
+	return(NULL);
+}
+
+static void
+prefetch_start(struct file_entry *list) {
+	struct file_entry	*fip;
+	unsigned			num;
+	int					jobs;
+
+	jobs = num_jobs;
+#ifdef _SC_NPROCESSORS_ONLN
+	if(jobs <= 0) jobs = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+	if(jobs > PREFETCH_MAX_JOBS) jobs = PREFETCH_MAX_JOBS;
+	if(jobs <= 1) return;
+
+	num = 0;
+	for(fip = list; fip != NULL; fip = fip->next) {
+		if(prefetch_candidate(fip)) ++num;
+	}
+	if(num == 0) return;
+
+	prefetch.entries = calloc(num, sizeof(*prefetch.entries));
+	if(prefetch.entries == NULL) return;
+	for(fip = list; fip != NULL; fip = fip->next) {
+		if(prefetch_candidate(fip)) {
+			prefetch.entries[prefetch.num].fip = fip;
+			prefetch.entries[prefetch.num].path = prefetch_path(fip);
+			++prefetch.num;
+		}
+	}
+	if(jobs > num) jobs = num;
+	while(prefetch.nthreads < jobs) {
+		if(pthread_create(&prefetch.threads[prefetch.nthreads], NULL, prefetch_thread, NULL) != 0) break;
+		++prefetch.nthreads;
+	}
+	if(prefetch.nthreads == 0) {
+		// Couldn't get any help, read the files the old way.
+		prefetch.num = 0;
+	}
+}
+
+//
+// Write out the data for fip if a worker has loaded it. Returns zero
+// if the caller has to read the file itself.
+//
+static int
+prefetch_write(FILE *dst_fp, struct file_entry *fip) {
+	struct prefetch_entry	*pe;
+
+	if(prefetch.done >= prefetch.num) return(0);
+	pe = &prefetch.entries[prefetch.done];
+	if(pe->fip != fip) return(0);
+
+	pthread_mutex_lock(&prefetch.mutex);
+	while(pe->state == 0) {
+		pthread_cond_wait(&prefetch.cond, &prefetch.mutex);
+	}
+	pthread_mutex_unlock(&prefetch.mutex);
+	if(pe->state < 0) {
+		error_exit("Unable to read %s : %s\n", fip->hostpath, strerror(pe->err));
+	}
+
+	iwrite(pe->buf, pe->nbytes, dst_fp, fip->hostpath);
+	free(pe->buf);
+	pe->buf = NULL;
+
+	pthread_mutex_lock(&prefetch.mutex);
+	++prefetch.done;
+	prefetch.bytes -= fip->size;
+	pthread_cond_broadcast(&prefetch.cond);
+	pthread_mutex_unlock(&prefetch.mutex);
+	return(1);
+}
+
+static void
+prefetch_stop(void) {
+	unsigned	i;
+
+	for(i = 0; i < prefetch.nthreads; ++i) {
+		pthread_join(prefetch.threads[i], NULL);
+	}
+	for(i = 0; i < prefetch.num; ++i) {
+		free(prefetch.entries[i].path);
+		free(prefetch.entries[i].buf);
+	}
+	free(prefetch.entries);
+	prefetch.entries = NULL;
+	prefetch.num = prefetch.next = prefetch.done = prefetch.bytes = 0;
+	prefetch.nthreads = 0;
+}
+#endif
+
 unsigned
 ifs_make_fsys(FILE *dst_fp, struct file_entry *list, char *mountpoint, char *destname) {
 	int						fd;
@@ -1940,6 +2265,7 @@ ifs_make_fsys(FILE *dst_fp, struct file_entry *list, char *mountpoint, char *des
 			}
 		}
 	}
+	dedup_files(list);
 	if(!booter.virtual) booter.vboot_addr = 0;
 
 	if(mountpoint == NULL) {
@@ -2336,10 +2662,18 @@ ifs_make_fsys(FILE *dst_fp, struct file_entry *list, char *mountpoint, char *des
 		fprintf(debug_fp, "%8x %6x     ----      --- Image-directory\n", image.addr + bsize + ssize + hsize, dsize);
 	}
 
+#ifdef IFS_THREADS
+	prefetch_start(list);
+#endif
 	for(fip = list; fip ; fip = fip->next) {
 		switch(fip->attr->mode) {
 		case S_IFREG:
+			// Duplicates share the data of their twin
+			if(fip->same != NULL) break;
 			padfile(dst_fp, fip->file_offset, fip->hostpath);
+#ifdef IFS_THREADS
+			if(prefetch_write(dst_fp, fip)) break;
+#endif
 			fd = ropen(fip);
 
 			if(fip->flags & (FILE_FLAGS_EXEC|FILE_FLAGS_SO)) {
@@ -2384,6 +2718,13 @@ ifs_make_fsys(FILE *dst_fp, struct file_entry *list, char *mountpoint, char *des
 			fprintf(debug_fp, "\n");
 		}
 	}
+#ifdef IFS_THREADS
+	prefetch_stop();
+#endif
+	if(verbose && dedup_files_saved != 0) {
+		fprintf(debug_fp, "%u duplicate files stored once, saving 0x%x bytes\n",
+					dedup_files_saved, dedup_bytes_saved);
+	}
 
 	// Pad file out
 	padfile(dst_fp, totalsize-sizeof(itlr), "Image-trailer");
@@ -24,11 +24,13 @@
 
 %C - make a image/flash file system
 
-%C	-t type [-r root] [-l input] [-s section] [-nv] [in-file [out-file]]
+%C	-t type [-r root] [-l input] [-s section] [-j jobs] [-nv] [in-file [out-file]]
 
 Options:
  -t ffs2|ffs3|ifs|etfs Set the type of the output file system.
  -l input              Prefix a line to the input-file.
+ -j jobs               Number of threads reading files while an IFS image is
+                       written (default: one per CPU, 1 disables).
  -n                    No timestamps. Allows for binary identical images. One
                        'n' will strip timestamps from files which vary from run
                        to run. More than one will strip ALL time information
@@ -72,9 +74,11 @@ Options:
 
 %C - make an image file system
 
-%C	[-r root] [-l input] [-s section] [-nv] [in-file [out-file]]
+%C	[-r root] [-l input] [-s section] [-j jobs] [-nv] [in-file [out-file]]
 
 Options:
+ -j jobs        Number of threads reading files while the image is written
+                (default: one per CPU, 1 disables).
  -l input       Prefix a line to the input-file.
  -n             No timestamps. Allows for binary identical images.  One 'n'
                 will strip timestamps from files which vary from run to run.
@@ -173,6 +177,7 @@ FILE				*script_fp;
 unsigned			 line_num;
 char				*cache_dir;
 int					new_style_bootstrap;
+int					num_jobs;
 int					ext_sched = SCRIPT_SCHED_EXT_NONE;
 
 int no_time;
@@ -1983,7 +1988,7 @@ main(int argc, char *argv[]) {
 	// Get the right permissions on temp files
 	old_mask = umask(0);
 
-	while((n = getopt(argc, argv, "a:c:r:l:nNps:t:v")) != -1) {
+	while((n = getopt(argc, argv, "a:c:j:r:l:nNps:t:v")) != -1) {
 		switch(n) {
 		case 'a':
 			symfile_suffix = strdup( optarg );
@@ -1991,6 +1996,9 @@ main(int argc, char *argv[]) {
 		case 'c':
 			cache_dir = optarg;
 			break;
+		case 'j':
+			num_jobs = strtol(optarg, NULL, 0);
+			break;
 		case 'l':
 			add_data(optarg);
 			add_data("\n");
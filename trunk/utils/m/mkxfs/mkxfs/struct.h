@@ -119,6 +119,7 @@ struct file_entry {
 	char					*linker;
 	struct keep_section		*sect;
 	uint32_t				host_file_crc;
+	struct file_entry		*same;		// Identical file sharing our data
 };
 
 struct tmpfile_entry {
@@ -340,6 +341,7 @@ extern char *mountpoint;
 extern int ext_sched;
 extern int no_time; /* no timestamps - declared in mkxfs.c */
 extern int new_style_bootstrap;
+extern int num_jobs;
 extern char *symfile_suffix;
 
 #define RUP(n, pagesize)	(((n) + ((pagesize)-1)) & ~((pagesize)-1))
@@ -735,12 +735,26 @@ svn_txdelta_compose_windows(const svn_txdelta_window_t *window_A,
 {
   svn_txdelta__ops_baton_t build_baton = { 0 };
   svn_txdelta_window_t *composite;
-  apr_pool_t *subpool = svn_pool_create(pool);
-  offset_index_t *offset_index = create_offset_index(window_A, subpool);
-  range_index_t *range_index = create_range_index(subpool);
+  apr_pool_t *subpool;
+  offset_index_t *offset_index;
+  range_index_t *range_index;
   apr_size_t target_offset = 0;
   int i;
 
+  /* If window_B doesn't read its source at all, it is its own
+     composite; don't bother indexing window_A. */
+  if (window_B->src_ops == 0)
+    {
+      composite = svn_txdelta_window_dup(window_B, pool);
+      composite->sview_offset = window_A->sview_offset;
+      composite->sview_len = window_A->sview_len;
+      return composite;
+    }
+
+  subpool = svn_pool_create(pool);
+  offset_index = create_offset_index(window_A, subpool);
+  range_index = create_range_index(subpool);
+
   /* Read the description of the delta composition algorithm in
      notes/fs-improvements.txt before going any further.
      You have been warned. */
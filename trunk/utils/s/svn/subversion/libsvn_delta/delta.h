@@ -64,6 +64,13 @@ void svn_txdelta__insert_op(svn_txdelta__ops_baton_t *build_baton,
                             apr_pool_t *pool);
 
 
+/* Return the length of the common prefix of A and B, looking at no
+   more than MAX_LEN bytes of either. */
+apr_size_t svn_txdelta__match_length(const char *a,
+                                     const char *b,
+                                     apr_size_t max_len);
+
+
 /* Allocate a delta window from POOL. */
 svn_txdelta_window_t *
 svn_txdelta__make_window(const svn_txdelta__ops_baton_t *build_baton,
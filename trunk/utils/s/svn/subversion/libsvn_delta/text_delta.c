@@ -271,6 +271,33 @@ svn_txdelta__insert_op(svn_txdelta__ops_baton_t *build_baton,
 }
 
 
+apr_size_t
+svn_txdelta__match_length(const char *a, const char *b, apr_size_t max_len)
+{
+  apr_size_t pos = 0;
+
+  /* Compare a word at a time while we can.  Going through memcpy()
+     keeps this safe on machines that trap unaligned loads; elsewhere
+     the compiler turns it into a plain load. */
+  while (max_len - pos >= sizeof(apr_size_t))
+    {
+      apr_size_t word_a, word_b;
+
+      memcpy(&word_a, a + pos, sizeof(word_a));
+      memcpy(&word_b, b + pos, sizeof(word_b));
+      if (word_a != word_b)
+        break;
+      pos += sizeof(apr_size_t);
+    }
+
+  /* Then find the mismatch, if any, a byte at a time. */
+  while (pos < max_len && a[pos] == b[pos])
+    ++pos;
+
+  return pos;
+}
+
+
 
 /* Generic delta stream functions. */
 
@@ -537,13 +564,21 @@ svn_txdelta_apply_instructions(svn_txdelta_window_t *window,
           break;
 
         case svn_txdelta_target:
-          /* Copy from target area.  Don't use memcpy() since its
-             semantics aren't guaranteed for overlapping memory areas,
-             and target copies are allowed to overlap to generate
-             repeated data.  */
+          /* Copy from target area.  Target copies are allowed to
+             overlap to generate repeated data, and memcpy()'s
+             semantics aren't guaranteed for overlapping memory areas.
+             But the result repeats the data between the op's offset
+             and TPOS, so we can memcpy() everything from the offset
+             up to where we've got to, doubling the length of each
+             copy until we're done.  */
           assert(op->offset < tpos);
-          for (i = op->offset, j = tpos; i < op->offset + buf_len; i++)
-            tbuf[j++] = tbuf[i];
+          for (j = tpos; j < tpos + buf_len; j += i)
+            {
+              i = j - op->offset;
+              if (i > tpos + buf_len - j)
+                i = tpos + buf_len - j;
+              memcpy(tbuf + j, tbuf + op->offset, i);
+            }
           break;
 
         case svn_txdelta_new:
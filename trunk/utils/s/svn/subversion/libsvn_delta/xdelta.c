@@ -24,6 +24,11 @@
 
 #include "svn_delta.h"
 #include "delta.h"
+
+/* Define a MIN macro if this platform doesn't already have one. */
+#ifndef MIN
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+#endif
 
 /* This is pseudo-adler32. It is adler32 without the prime modulus.
    The idea is borrowed from monotone, and is a translation of the C++
@@ -80,11 +85,22 @@ adler32_sum(const struct adler32 *ad)
 static APR_INLINE struct adler32 *
 init_adler32(struct adler32 *ad, const char *data, apr_uint32_t datalen)
 {
-  ad->s1 = 1;
-  ad->s2 = 0;
-  ad->len = 0;
-  while (datalen--)
-    adler32_in(ad, *(data++));
+  apr_uint32_t s1 = 1;
+  apr_uint32_t s2 = 0;
+  apr_uint32_t i;
+
+  /* This gives the same result as feeding the bytes to adler32_in()
+     one by one: masking only once at the end doesn't change the low
+     bits, which are all we keep.  */
+  for (i = 0; i < datalen; i++)
+    {
+      s1 += ((apr_uint32_t) data[i]) & ADLER32_CHAR_MASK;
+      s2 += s1;
+    }
+
+  ad->s1 = s1 & ADLER32_MASK;
+  ad->s2 = s2 & ADLER32_MASK;
+  ad->len = datalen;
   return ad;
 }
 
@@ -234,21 +250,19 @@ find_match(const struct blocks *blocks,
   tlen = ((tpos + MATCH_BLOCKSIZE) >= asize)
     ? (asize - tpos) : MATCH_BLOCKSIZE;
 
-  /* Make sure it's not a false match.  */
-  if (memcmp(a + tpos, b + bpos, tlen) != 0)
+  /* Make sure it's not a false match.  The block may also be longer
+     than what is left of the target, in which case it can't match.  */
+  if (tlen > bsize - bpos || memcmp(a + tpos, b + bpos, tlen) != 0)
     return FALSE;
 
   apos = tpos;
   alen = tlen;
   badvance = tlen;
   /* Extend the match forward as far as possible */
-  while ((apos + alen < asize)
-         && (bpos + badvance < bsize)
-         && (a[apos + alen] == b[bpos + badvance]))
-    {
-      ++alen;
-      ++badvance;
-    }
+  alen += svn_txdelta__match_length(a + apos + alen, b + bpos + badvance,
+                                    MIN(asize - apos - alen,
+                                        bsize - bpos - badvance));
+  badvance = alen;
 
   /* See if we can extend backwards into a previous insert hunk.  */
   while (apos > 0
@@ -349,13 +363,22 @@ compute_delta(svn_txdelta__ops_baton_t *build_baton,
           svn_txdelta__insert_op(build_baton, svn_txdelta_source,
                                  apos, alen, NULL, pool);
         }
-      next = lo;
-      for (; next < lo + badvance; ++next)
+      next = lo + badvance;
+      if (badvance >= MATCH_BLOCKSIZE)
         {
-          adler32_out(&rolling, b[next]);
-          if (next + MATCH_BLOCKSIZE < bsize)
-            adler32_in(&rolling, b[next + MATCH_BLOCKSIZE]);
+          /* None of the bytes in the checksum are left; start over
+             rather than rolling through the whole match.  */
+          if (next < bsize)
+            init_adler32(&rolling, b + next,
+                         MIN(MATCH_BLOCKSIZE, bsize - next));
         }
+      else
+        for (next = lo; next < lo + badvance; ++next)
+          {
+            adler32_out(&rolling, b[next]);
+            if (next + MATCH_BLOCKSIZE < bsize)
+              adler32_in(&rolling, b[next + MATCH_BLOCKSIZE]);
+          }
       lo = next;
       hi = lo + MATCH_BLOCKSIZE;
     }
@@ -0,0 +1,360 @@
+/* cache.c : in-memory cache of immutable data read from revision files
+ *
+ * ====================================================================
+ * Copyright (c) 2008 CollabNet.  All rights reserved.
+ *
+ * This software is licensed as described in the file COPYING, which
+ * you should have received as part of this distribution.  The terms
+ * are also available at http://subversion.tigris.org/license-1.html.
+ * If newer versions of this license are posted there, you may use a
+ * newer version instead, at your option.
+ *
+ * This software consists of voluntary contributions made by many
+ * individuals.  For exact contribution history, see the revision
+ * history and logs, available at http://subversion.tigris.org/.
+ * ====================================================================
+ */
+
+#include <string.h>
+
+#include <apr_pools.h>
+#include <apr_hash.h>
+#include <apr_thread_mutex.h>
+
+#include "svn_pools.h"
+#include "svn_error.h"
+
+#include "cache.h"
+
+#include "svn_private_config.h"
+
+/* Memory charged for each item on top of what the caller says it
+   takes: the entry below, and the hash table's own bookkeeping. */
+#define ENTRY_OVERHEAD (sizeof(cache_entry_t) + 4 * sizeof(void *))
+
+/* Pages smaller than this aren't worth having; a cache that would
+   have them isn't created at all. */
+#define MIN_PAGE_SIZE 4096
+
+/* What an item is looked up by.  Keys are hashed as raw bytes, so
+   they must be zeroed before being filled in to clear any padding. */
+typedef struct
+{
+  svn_revnum_t rev;
+  apr_off_t offset;
+  int kind;
+} cache_key_t;
+
+typedef struct cache_page_t cache_page_t;
+
+/* One cached item. */
+typedef struct cache_entry_t
+{
+  cache_key_t key;
+  void *item;
+
+  /* The page this entry is allocated in, and the next entry there. */
+  cache_page_t *page;
+  struct cache_entry_t *next_in_page;
+} cache_entry_t;
+
+/* A group of entries allocated in one pool, and freed together.  Pages
+   in use are kept in a circular list ordered by when an entry in them
+   was last used; pages not in use are kept on a free list. */
+struct cache_page_t
+{
+  cache_page_t *prev;
+  cache_page_t *next;
+
+  apr_pool_t *pool;
+  cache_entry_t *first_entry;
+  apr_size_t size;
+};
+
+struct svn_fs_fs__cache_t
+{
+  /* Maps cache_key_t to cache_entry_t *. */
+  apr_hash_t *hash;
+
+  /* The head of the list of pages in use.  SENTINEL.next is the page
+     used most recently, SENTINEL.prev the one used least recently. */
+  cache_page_t sentinel;
+
+  /* The page new entries are put in, or NULL if a fresh one is needed. */
+  cache_page_t *partial_page;
+
+  /* Pages not in use, linked through their NEXT fields. */
+  cache_page_t *free_pages;
+
+  /* The most memory to charge to a single page. */
+  apr_size_t page_size;
+
+  svn_fs_fs__cache_stats_t stats;
+
+  /* The pool everything above, and every page's pool, is allocated
+     from.  It has its own allocator, so that it can be used under
+     LOCK alone without racing anyone else's allocations. */
+  apr_pool_t *pool;
+
+#if APR_HAS_THREADS
+  apr_thread_mutex_t *lock;
+#endif
+};
+
+
+static svn_error_t *
+lock_cache(svn_fs_fs__cache_t *cache)
+{
+#if APR_HAS_THREADS
+  apr_status_t status = apr_thread_mutex_lock(cache->lock);
+  if (status)
+    return svn_error_wrap_apr(status, _("Can't grab FSFS cache mutex"));
+#endif
+  return SVN_NO_ERROR;
+}
+
+static svn_error_t *
+unlock_cache(svn_fs_fs__cache_t *cache)
+{
+#if APR_HAS_THREADS
+  apr_status_t status = apr_thread_mutex_unlock(cache->lock);
+  if (status)
+    return svn_error_wrap_apr(status, _("Can't ungrab FSFS cache mutex"));
+#endif
+  return SVN_NO_ERROR;
+}
+
+/* Remove PAGE from whichever list it is on. */
+static void
+unlink_page(cache_page_t *page)
+{
+  page->prev->next = page->next;
+  page->next->prev = page->prev;
+}
+
+/* Put PAGE at the most recently used end of CACHE's list. */
+static void
+link_page_first(svn_fs_fs__cache_t *cache, cache_page_t *page)
+{
+  page->prev = &cache->sentinel;
+  page->next = cache->sentinel.next;
+  page->prev->next = page;
+  page->next->prev = page;
+}
+
+/* Forget every entry on PAGE, of CACHE, and free their memory. */
+static void
+empty_page(svn_fs_fs__cache_t *cache, cache_page_t *page)
+{
+  cache_entry_t *entry;
+
+  for (entry = page->first_entry; entry; entry = entry->next_in_page)
+    {
+      apr_hash_set(cache->hash, &entry->key, sizeof(entry->key), NULL);
+      cache->stats.items--;
+    }
+
+  cache->stats.size -= page->size;
+  page->first_entry = NULL;
+  page->size = 0;
+  svn_pool_clear(page->pool);
+}
+
+/* Return a page of CACHE with room for an item of SIZE bytes, and make
+   it the partial page.  If there is no such page, start a new one,
+   emptying the least recently used page if there is no free one. */
+static cache_page_t *
+get_partial_page(svn_fs_fs__cache_t *cache, apr_size_t size)
+{
+  cache_page_t *page = cache->partial_page;
+
+  if (page && page->size + size <= cache->page_size)
+    return page;
+
+  if (cache->free_pages)
+    {
+      page = cache->free_pages;
+      cache->free_pages = page->next;
+      page->pool = svn_pool_create(cache->pool);
+      page->first_entry = NULL;
+      page->size = 0;
+    }
+  else
+    {
+      page = cache->sentinel.prev;
+      unlink_page(page);
+      empty_page(cache, page);
+      cache->stats.evictions++;
+    }
+
+  link_page_first(cache, page);
+  cache->partial_page = page;
+  return page;
+}
+
+
+svn_error_t *
+svn_fs_fs__cache_create(svn_fs_fs__cache_t **cache_p,
+                        apr_size_t max_size,
+                        apr_pool_t *pool)
+{
+  svn_fs_fs__cache_t *cache;
+  apr_allocator_t *allocator;
+  apr_pool_t *cache_pool;
+  cache_page_t *pages;
+  apr_status_t status;
+  int i;
+
+  if (max_size / SVN_FS_FS__CACHE_PAGES < MIN_PAGE_SIZE)
+    {
+      *cache_p = NULL;
+      return SVN_NO_ERROR;
+    }
+
+  status = apr_allocator_create(&allocator);
+  if (status)
+    return svn_error_wrap_apr(status, _("Can't create FSFS cache"));
+  cache_pool = svn_pool_create_ex(pool, allocator);
+  apr_allocator_owner_set(allocator, cache_pool);
+
+  cache = apr_pcalloc(cache_pool, sizeof(*cache));
+  cache->pool = cache_pool;
+  cache->hash = apr_hash_make(cache_pool);
+  cache->sentinel.prev = &cache->sentinel;
+  cache->sentinel.next = &cache->sentinel;
+  cache->page_size = max_size / SVN_FS_FS__CACHE_PAGES;
+  cache->stats.max_size = cache->page_size * SVN_FS_FS__CACHE_PAGES;
+
+  pages = apr_pcalloc(cache_pool, SVN_FS_FS__CACHE_PAGES * sizeof(*pages));
+  for (i = 0; i < SVN_FS_FS__CACHE_PAGES; i++)
+    {
+      pages[i].next = cache->free_pages;
+      cache->free_pages = &pages[i];
+    }
+
+#if APR_HAS_THREADS
+  status = apr_thread_mutex_create(&cache->lock, APR_THREAD_MUTEX_DEFAULT,
+                                   cache_pool);
+  if (status)
+    return svn_error_wrap_apr(status, _("Can't create FSFS cache mutex"));
+#endif
+
+  *cache_p = cache;
+  return SVN_NO_ERROR;
+}
+
+svn_error_t *
+svn_fs_fs__cache_get(void **item_p,
+                     svn_fs_fs__cache_t *cache,
+                     svn_fs_fs__cache_kind_t kind,
+                     svn_revnum_t rev,
+                     apr_off_t offset,
+                     svn_fs_fs__cache_dup_func_t dup_func,
+                     apr_pool_t *pool)
+{
+  cache_key_t key;
+  cache_entry_t *entry;
+
+  *item_p = NULL;
+  if (! cache)
+    return SVN_NO_ERROR;
+
+  memset(&key, 0, sizeof(key));
+  key.rev = rev;
+  key.offset = offset;
+  key.kind = kind;
+
+  SVN_ERR(lock_cache(cache));
+
+  cache->stats.gets[kind]++;
+  entry = apr_hash_get(cache->hash, &key, sizeof(key));
+  if (entry)
+    {
+      cache->stats.hits[kind]++;
+      *item_p = dup_func(entry->item, pool);
+
+      /* Keep the page this was found on from being emptied soon. */
+      if (entry->page != cache->sentinel.next)
+        {
+          unlink_page(entry->page);
+          link_page_first(cache, entry->page);
+        }
+    }
+
+  return unlock_cache(cache);
+}
+
+svn_error_t *
+svn_fs_fs__cache_set(svn_fs_fs__cache_t *cache,
+                     svn_fs_fs__cache_kind_t kind,
+                     svn_revnum_t rev,
+                     apr_off_t offset,
+                     const void *item,
+                     apr_size_t size,
+                     svn_fs_fs__cache_dup_func_t dup_func)
+{
+  cache_key_t key;
+  cache_entry_t *entry;
+  cache_page_t *page;
+
+  if (! cache)
+    return SVN_NO_ERROR;
+
+  size += ENTRY_OVERHEAD;
+  if (size > cache->page_size)
+    return SVN_NO_ERROR;
+
+  memset(&key, 0, sizeof(key));
+  key.rev = rev;
+  key.offset = offset;
+  key.kind = kind;
+
+  SVN_ERR(lock_cache(cache));
+
+  /* Someone else may have read and stored the same item while we
+     were reading it. */
+  if (! apr_hash_get(cache->hash, &key, sizeof(key)))
+    {
+      page = get_partial_page(cache, size);
+
+      entry = apr_palloc(page->pool, sizeof(*entry));
+      entry->key = key;
+      entry->item = dup_func(item, page->pool);
+      entry->page = page;
+      entry->next_in_page = page->first_entry;
+      page->first_entry = entry;
+      page->size += size;
+
+      apr_hash_set(cache->hash, &entry->key, sizeof(entry->key), entry);
+
+      cache->stats.sets++;
+      cache->stats.items++;
+      cache->stats.size += size;
+    }
+
+  return unlock_cache(cache);
+}
+
+apr_size_t
+svn_fs_fs__cache_max_item_size(svn_fs_fs__cache_t *cache)
+{
+  if (! cache)
+    return 0;
+
+  return cache->page_size - ENTRY_OVERHEAD;
+}
+
+svn_error_t *
+svn_fs_fs__cache_get_stats(svn_fs_fs__cache_stats_t *stats,
+                           svn_fs_fs__cache_t *cache)
+{
+  if (! cache)
+    {
+      memset(stats, 0, sizeof(*stats));
+      return SVN_NO_ERROR;
+    }
+
+  SVN_ERR(lock_cache(cache));
+  *stats = cache->stats;
+  return unlock_cache(cache);
+}
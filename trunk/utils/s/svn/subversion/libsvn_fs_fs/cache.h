@@ -0,0 +1,146 @@
+/* cache.h : in-memory cache of immutable data read from revision files
+ *
+ * ====================================================================
+ * Copyright (c) 2008 CollabNet.  All rights reserved.
+ *
+ * This software is licensed as described in the file COPYING, which
+ * you should have received as part of this distribution.  The terms
+ * are also available at http://subversion.tigris.org/license-1.html.
+ * If newer versions of this license are posted there, you may use a
+ * newer version instead, at your option.
+ *
+ * This software consists of voluntary contributions made by many
+ * individuals.  For exact contribution history, see the revision
+ * history and logs, available at http://subversion.tigris.org/.
+ * ====================================================================
+ */
+
+#ifndef SVN_LIBSVN_FS_FS_CACHE_H
+#define SVN_LIBSVN_FS_FS_CACHE_H
+
+#include <apr_pools.h>
+
+#include "svn_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+
+/* A cache of objects parsed or reconstructed from the revision files
+   of one repository.  Everything in a revision file is immutable once
+   the revision has been committed, so an item is identified by the
+   revision and offset it was read from, plus what kind of item it is;
+   nothing ever needs to be invalidated.
+
+   The cache is bounded: items are grouped into a fixed number of
+   pages, each holding roughly 1/SVN_FS_FS__CACHE_PAGES of the memory
+   the cache may use, and when a new item doesn't fit, the page used
+   least recently is emptied as a whole.  Items bigger than a page
+   are never cached.
+
+   All functions serialize on a mutex inside the cache, so one cache
+   may be used by every svn_fs_t object, in every thread, that has the
+   repository open.  Items are copied in and out, so callers never
+   share memory with the cache or with each other.
+
+   Wherever a cache is passed to one of these functions, it may be
+   NULL, in which case nothing is ever found and nothing is stored. */
+typedef struct svn_fs_fs__cache_t svn_fs_fs__cache_t;
+
+/* The number of pages a cache's memory is split over. */
+#define SVN_FS_FS__CACHE_PAGES 16
+
+/* The kinds of item that can be cached. */
+typedef enum
+{
+  /* A node_revision_t, keyed by the location of the node-rev. */
+  svn_fs_fs__cache_noderev = 0,
+
+  /* A directory's entries as a hash of svn_fs_dirent_t, keyed by the
+     location of the directory's data representation. */
+  svn_fs_fs__cache_dir,
+
+  /* The fulltext of a representation as an svn_stringbuf_t, keyed by
+     the location of the representation. */
+  svn_fs_fs__cache_fulltext,
+
+  /* Not a kind; the number of kinds there are. */
+  svn_fs_fs__cache_kinds
+} svn_fs_fs__cache_kind_t;
+
+/* A function returning a copy of ITEM, allocated in POOL, that shares
+   no memory with ITEM. */
+typedef void *(*svn_fs_fs__cache_dup_func_t)(const void *item,
+                                             apr_pool_t *pool);
+
+/* Counters describing how well a cache is doing. */
+typedef struct
+{
+  /* Lookups made, and how many of them found their item, by kind. */
+  apr_uint64_t gets[svn_fs_fs__cache_kinds];
+  apr_uint64_t hits[svn_fs_fs__cache_kinds];
+
+  /* Items stored, and pages emptied to make room for them. */
+  apr_uint64_t sets;
+  apr_uint64_t evictions;
+
+  /* The number of items in the cache now, the memory they are
+     charged for, and the most that may be charged. */
+  apr_size_t items;
+  apr_size_t size;
+  apr_size_t max_size;
+} svn_fs_fs__cache_stats_t;
+
+
+/* Create a cache that uses about MAX_SIZE bytes of memory at most, and
+   set *CACHE_P to it.  If MAX_SIZE is too small to be worth caching
+   anything, set *CACHE_P to NULL instead.  The cache is allocated in
+   its own subpool of POOL, with its own allocator, and lives as long
+   as POOL does. */
+svn_error_t *
+svn_fs_fs__cache_create(svn_fs_fs__cache_t **cache_p,
+                        apr_size_t max_size,
+                        apr_pool_t *pool);
+
+/* Look for the item of kind KIND read from offset OFFSET in revision
+   REV of CACHE.  If it is there, set *ITEM_P to a copy of it made by
+   DUP_FUNC in POOL; otherwise set *ITEM_P to NULL. */
+svn_error_t *
+svn_fs_fs__cache_get(void **item_p,
+                     svn_fs_fs__cache_t *cache,
+                     svn_fs_fs__cache_kind_t kind,
+                     svn_revnum_t rev,
+                     apr_off_t offset,
+                     svn_fs_fs__cache_dup_func_t dup_func,
+                     apr_pool_t *pool);
+
+/* Store a copy of ITEM, made by DUP_FUNC, in CACHE as the item of kind
+   KIND read from offset OFFSET in revision REV, charging SIZE bytes
+   for it.  Do nothing if the cache already has that item, or if SIZE
+   is more than svn_fs_fs__cache_max_item_size() allows. */
+svn_error_t *
+svn_fs_fs__cache_set(svn_fs_fs__cache_t *cache,
+                     svn_fs_fs__cache_kind_t kind,
+                     svn_revnum_t rev,
+                     apr_off_t offset,
+                     const void *item,
+                     apr_size_t size,
+                     svn_fs_fs__cache_dup_func_t dup_func);
+
+/* Return the largest SIZE that svn_fs_fs__cache_set() will store in
+   CACHE, or 0 if CACHE is NULL. */
+apr_size_t
+svn_fs_fs__cache_max_item_size(svn_fs_fs__cache_t *cache);
+
+/* Fill in *STATS from CACHE.  If CACHE is NULL, every counter is 0. */
+svn_error_t *
+svn_fs_fs__cache_get_stats(svn_fs_fs__cache_stats_t *stats,
+                           svn_fs_fs__cache_t *cache);
+
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* SVN_LIBSVN_FS_FS_CACHE_H */
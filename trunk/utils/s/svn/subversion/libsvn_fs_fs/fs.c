@@ -28,6 +28,7 @@
 #include "svn_delta.h"
 #include "svn_version.h"
 #include "svn_pools.h"
+#include "svn_path.h"
 #include "fs.h"
 #include "err.h"
 #include "fs_fs.h"
@@ -42,6 +43,11 @@
    per-filesystem shared data.  See fs_serialized_init. */
 #define SVN_FSFS_SHARED_USERDATA_PREFIX "svn-fsfs-shared-"
 
+/* A prefix for the pool userdata variables used to hold the node-rev,
+   directory and fulltext cache of each repository.  See
+   fs_cache_init. */
+#define SVN_FSFS_CACHE_USERDATA_PREFIX "svn-fsfs-cache-"
+
 
 
 static svn_error_t *
@@ -117,6 +123,53 @@ fs_serialized_init(svn_fs_t *fs, apr_pool_t *common_pool, apr_pool_t *pool)
   return SVN_NO_ERROR;
 }
 
+/* Point FS at the cache of revision file contents used by every FS
+   object that has the same repository open, creating the cache in
+   COMMON_POOL if there isn't one yet.  Unlike the shared data above,
+   the cache is found by path as well as by uuid: two repositories
+   that have been given the same uuid (by "svnadmin load" into an empty
+   repository, say) have different revision files, and must not see
+   each other's.  Like the shared data, it is never freed before
+   COMMON_POOL is. */
+static svn_error_t *
+fs_cache_init(svn_fs_t *fs, apr_pool_t *common_pool, apr_pool_t *pool)
+{
+  fs_fs_data_t *ffd = fs->fsap_data;
+  const char *abs_path, *key;
+  void *val;
+  apr_status_t status;
+
+  SVN_ERR(svn_path_get_absolute(&abs_path, fs->path, pool));
+  key = apr_pstrcat(pool, SVN_FSFS_CACHE_USERDATA_PREFIX, ffd->uuid, ":",
+                    abs_path, (char *) NULL);
+  status = apr_pool_userdata_get(&val, key, common_pool);
+  if (status)
+    return svn_error_wrap_apr(status, _("Can't fetch FSFS cache"));
+
+  if (!val)
+    {
+      svn_fs_fs__cache_t *cache;
+
+      /* The first FS object to open the repository gets to size the
+         cache; if fsfs.conf turns caching off, there's nothing to
+         remember. */
+      SVN_ERR(svn_fs_fs__cache_create(&cache, ffd->memory_cache_size,
+                                      common_pool));
+      if (cache)
+        {
+          key = apr_pstrdup(common_pool, key);
+          status = apr_pool_userdata_set(cache, key, NULL, common_pool);
+          if (status)
+            return svn_error_wrap_apr(status, _("Can't store FSFS cache"));
+        }
+      val = cache;
+    }
+
+  ffd->cache = val;
+
+  return SVN_NO_ERROR;
+}
+
 
 
 /* This function is provided for Subversion 1.0.x compatibility.  It
@@ -186,7 +239,8 @@ fs_create(svn_fs_t *fs, const char *path, apr_pool_t *pool,
   initialize_fs_struct(fs);
 
   SVN_ERR(svn_fs_fs__create(fs, path, pool));
-  return fs_serialized_init(fs, common_pool, pool);
+  SVN_ERR(fs_serialized_init(fs, common_pool, pool));
+  return fs_cache_init(fs, common_pool, pool);
 }
 
 
@@ -204,7 +258,8 @@ fs_open(svn_fs_t *fs, const char *path, apr_pool_t *pool,
   initialize_fs_struct(fs);
 
   SVN_ERR(svn_fs_fs__open(fs, path, pool));
-  return fs_serialized_init(fs, common_pool, pool);
+  SVN_ERR(fs_serialized_init(fs, common_pool, pool));
+  return fs_cache_init(fs, common_pool, pool);
 }
 
 
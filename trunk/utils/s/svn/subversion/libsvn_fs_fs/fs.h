@@ -27,6 +27,8 @@
 #include "svn_fs.h"
 #include "private/svn_fs_private.h"
 
+#include "cache.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
@@ -50,6 +52,7 @@ extern "C" {
 #define PATH_TXN_CURRENT      "txn-current"      /* File with next txn key */
 #define PATH_TXN_CURRENT_LOCK "txn-current-lock" /* Lock for txn-current */
 #define PATH_LOCKS_DIR        "locks"            /* Directory of locks */
+#define PATH_CONFIG           "fsfs.conf"        /* Configuration */
 
 /* Names of special files and file extensions for transactions */
 #define PATH_CHANGES       "changes"       /* Records changes made so far */
@@ -100,6 +103,10 @@ extern "C" {
 /* Maximum number of revroot ids to cache dirents for at a time. */
 #define NUM_RRI_CACHE_ENTRIES 4096
 
+/* Default number of megabytes for the node-rev, directory and fulltext
+   cache, if fsfs.conf doesn't say. */
+#define SVN_FS_FS__DEFAULT_MEMORY_CACHE_SIZE 16
+
 /* Private FSFS-specific data shared between all svn_txn_t objects that
    relate to a particular transaction in a filesystem (as identified
    by transaction id and filesystem UUID).  Objects of this type are
@@ -220,6 +227,16 @@ typedef struct
   dag_node_cache_t rev_node_list;
   apr_hash_t *rev_node_cache;
 
+  /* The number of bytes fsfs.conf allows for CACHE. */
+  apr_size_t memory_cache_size;
+
+  /* A cache of node-revs, directory contents and fulltexts read from
+     revision files, or NULL if caching is turned off.  Unlike the
+     caches above, this one is shared, under its own mutex, with every
+     svn_fs_t object in the process that has opened the same
+     repository at the same path. */
+  svn_fs_fs__cache_t *cache;
+
   /* Data shared between all svn_fs_t objects for a given filesystem. */
   fs_fs_shared_data_t *shared;
 } fs_fs_data_t;
@@ -39,6 +39,7 @@
 #include "svn_sorts.h"
 #include "svn_time.h"
 #include "svn_mergeinfo.h"
+#include "svn_config.h"
 
 #include "fs.h"
 #include "err.h"
@@ -102,6 +103,14 @@
 #define REP_PLAIN          "PLAIN"
 #define REP_DELTA          "DELTA"
 
+/* Sections and options in fsfs.conf. */
+#define CONFIG_SECTION_CACHES            "caches"
+#define CONFIG_OPTION_MEMORY_CACHE_SIZE  "memory-cache-size"
+
+/* What we charge the cache for each node-rev id we put in it.  Ids are
+   parsed into several small allocations; this is a rough average. */
+#define CACHED_ID_SIZE     64
+
 /* Notes:
 
 To avoid opening and closing the rev-files all the time, it would
@@ -139,6 +148,12 @@ path_uuid(svn_fs_t *fs, apr_pool_t *pool)
   return svn_path_join(fs->path, PATH_UUID, pool);
 }
 
+static APR_INLINE const char *
+path_config(svn_fs_t *fs, apr_pool_t *pool)
+{
+  return svn_path_join(fs->path, PATH_CONFIG, pool);
+}
+
 const char *
 svn_fs_fs__path_current(svn_fs_t *fs, apr_pool_t *pool)
 {
@@ -982,6 +997,67 @@ svn_fs_fs__fs_supports_mergeinfo(svn_fs_t *fs)
   return ffd->format >= SVN_FS_FS__MIN_MERGEINFO_FORMAT;
 }
 
+/* Read FS's fsfs.conf, if it has one, into FS's private data.  Use
+   POOL for temporary allocation. */
+static svn_error_t *
+read_config(svn_fs_t *fs, apr_pool_t *pool)
+{
+  fs_fs_data_t *ffd = fs->fsap_data;
+  svn_config_t *config;
+  const char *value;
+  char *end;
+  apr_int64_t megabytes;
+
+  SVN_ERR(svn_config_read(&config, path_config(fs, pool), FALSE, pool));
+
+  svn_config_get(config, &value, CONFIG_SECTION_CACHES,
+                 CONFIG_OPTION_MEMORY_CACHE_SIZE, NULL);
+  if (value == NULL)
+    megabytes = SVN_FS_FS__DEFAULT_MEMORY_CACHE_SIZE;
+  else
+    {
+      errno = 0;
+      megabytes = apr_strtoi64(value, &end, 10);
+      if (end == value || *end != '\0' || errno || megabytes < 0)
+        return svn_error_createf
+          (SVN_ERR_FS_GENERAL, NULL,
+           _("'%s' has invalid value '%s' for option '%s'"),
+           svn_path_local_style(path_config(fs, pool), pool), value,
+           CONFIG_OPTION_MEMORY_CACHE_SIZE);
+    }
+
+  if (megabytes > (apr_int64_t) (APR_SIZE_MAX / (1024 * 1024)))
+    megabytes = APR_SIZE_MAX / (1024 * 1024);
+  ffd->memory_cache_size = (apr_size_t) megabytes * 1024 * 1024;
+
+  return SVN_NO_ERROR;
+}
+
+/* Write a new fsfs.conf, with every option at its default, for FS.
+   Use POOL for temporary allocation. */
+static svn_error_t *
+write_config(svn_fs_t *fs, apr_pool_t *pool)
+{
+#define NL APR_EOL_STR
+  static const char * const fsfs_conf_contents =
+"### This file controls the configuration of the FSFS filesystem."        NL
+""                                                                         NL
+"[" CONFIG_SECTION_CACHES "]"                                              NL
+"### The number of megabytes of memory that each process with this"       NL
+"### repository open may use to keep node-revisions, directory"            NL
+"### listings and file contents it has read from the revision files,"     NL
+"### so that it needn't read and reassemble them again.  A process"       NL
+"### such as svnserve or httpd uses one cache for all the connections"    NL
+"### it serves.  Set this to 0 to turn the cache off.  A change only"     NL
+"### takes effect in processes that open the repository afterwards."      NL
+"# " CONFIG_OPTION_MEMORY_CACHE_SIZE " = "
+  APR_STRINGIFY(SVN_FS_FS__DEFAULT_MEMORY_CACHE_SIZE)                      NL
+;
+#undef NL
+  return svn_io_file_create(path_config(fs, pool), fsfs_conf_contents,
+                            pool);
+}
+
 static svn_error_t *
 get_youngest(svn_revnum_t *youngest_p, const char *fs_path, apr_pool_t *pool);
 
@@ -1015,6 +1091,9 @@ svn_fs_fs__open(svn_fs_t *fs, const char *path, apr_pool_t *pool)
 
   SVN_ERR(svn_io_file_close(uuid_file, pool));
 
+  /* Read the configuration file, which older filesystems may lack. */
+  SVN_ERR(read_config(fs, pool));
+
   SVN_ERR(get_youngest(&(ffd->youngest_rev_cache), path, pool));
 
   return SVN_NO_ERROR;
@@ -1042,9 +1121,17 @@ upgrade_body(void *baton, apr_pool_t *pool)
   int format, max_files_per_dir;
   const char *format_path = path_format(fs, pool);
 
+  svn_node_kind_t kind;
+
   /* Read the FS format number and max-files-per-dir setting. */
   SVN_ERR(read_format(&format, &max_files_per_dir, format_path, pool));
 
+  /* Filesystems of any format may predate fsfs.conf; give them one
+     with the defaults written out, to show what can be set. */
+  SVN_ERR(svn_io_check_path(path_config(fs, pool), &kind, pool));
+  if (kind == svn_node_none)
+    SVN_ERR(write_config(fs, pool));
+
   /* If we're already up-to-date, there's nothing to be done here. */
   if (format == SVN_FS_FS__FORMAT_NUMBER)
     return SVN_NO_ERROR;
@@ -1224,6 +1311,12 @@ svn_fs_fs__hotcopy(const char *src_path,
   /* Copy the uuid. */
   SVN_ERR(svn_io_dir_file_copy(src_path, dst_path, PATH_UUID, pool));
 
+  /* Copy the config, if there is one. */
+  SVN_ERR(svn_io_check_path(svn_path_join(src_path, PATH_CONFIG, pool),
+                            &kind, pool));
+  if (kind == svn_node_file)
+    SVN_ERR(svn_io_dir_file_copy(src_path, dst_path, PATH_CONFIG, pool));
+
   /* Find the youngest revision from this current file. */
   SVN_ERR(get_youngest(&youngest, dst_path, pool));
 
@@ -1587,6 +1680,47 @@ read_rep_offsets(representation_t **rep_p,
   return SVN_NO_ERROR;
 }
 
+/* Return a copy of the node-revision NODEREV in POOL.  This
+   implements svn_fs_fs__cache_dup_func_t. */
+static void *
+dup_noderev(const void *item, apr_pool_t *pool)
+{
+  const node_revision_t *noderev = item;
+  node_revision_t *new_noderev = apr_palloc(pool, sizeof(*new_noderev));
+
+  *new_noderev = *noderev;
+  new_noderev->id = svn_fs_fs__id_copy(noderev->id, pool);
+  if (noderev->predecessor_id)
+    new_noderev->predecessor_id = svn_fs_fs__id_copy(noderev->predecessor_id,
+                                                     pool);
+  if (noderev->copyfrom_path)
+    new_noderev->copyfrom_path = apr_pstrdup(pool, noderev->copyfrom_path);
+  new_noderev->copyroot_path = apr_pstrdup(pool, noderev->copyroot_path);
+  new_noderev->prop_rep = svn_fs_fs__rep_copy(noderev->prop_rep, pool);
+  new_noderev->data_rep = svn_fs_fs__rep_copy(noderev->data_rep, pool);
+  new_noderev->created_path = apr_pstrdup(pool, noderev->created_path);
+
+  return new_noderev;
+}
+
+/* Return roughly how much memory a copy of NODEREV takes. */
+static apr_size_t
+noderev_size(const node_revision_t *noderev)
+{
+  apr_size_t size = sizeof(*noderev) + 2 * CACHED_ID_SIZE;
+
+  if (noderev->copyfrom_path)
+    size += strlen(noderev->copyfrom_path) + 1;
+  size += strlen(noderev->copyroot_path) + 1;
+  if (noderev->prop_rep)
+    size += sizeof(*noderev->prop_rep);
+  if (noderev->data_rep)
+    size += sizeof(*noderev->data_rep);
+  size += strlen(noderev->created_path) + 1;
+
+  return size;
+}
+
 /* See svn_fs_fs__get_node_revision, which wraps this and adds another
    error. */
 static svn_error_t *
@@ -1595,12 +1729,26 @@ get_node_revision_body(node_revision_t **noderev_p,
                        const svn_fs_id_t *id,
                        apr_pool_t *pool)
 {
+  fs_fs_data_t *ffd = fs->fsap_data;
   apr_file_t *revision_file;
   apr_hash_t *headers;
   node_revision_t *noderev;
   char *value;
   svn_error_t *err;
 
+  /* Node-revs in revision files never change, so we may have read
+     this one before. */
+  if (! svn_fs_fs__id_txn_id(id))
+    {
+      SVN_ERR(svn_fs_fs__cache_get((void **) noderev_p, ffd->cache,
+                                   svn_fs_fs__cache_noderev,
+                                   svn_fs_fs__id_rev(id),
+                                   svn_fs_fs__id_offset(id),
+                                   dup_noderev, pool));
+      if (*noderev_p)
+        return SVN_NO_ERROR;
+    }
+
   if (svn_fs_fs__id_txn_id(id))
     {
       /* This is a transaction node-rev. */
@@ -1751,6 +1899,13 @@ get_node_revision_body(node_revision_t **noderev_p,
   value = apr_hash_get(headers, HEADER_MINFO_HERE, APR_HASH_KEY_STRING);
   noderev->has_mergeinfo = (value != NULL);
 
+  if (! svn_fs_fs__id_txn_id(id))
+    SVN_ERR(svn_fs_fs__cache_set(ffd->cache, svn_fs_fs__cache_noderev,
+                                 svn_fs_fs__id_rev(id),
+                                 svn_fs_fs__id_offset(id),
+                                 noderev, noderev_size(noderev),
+                                 dup_noderev));
+
   *noderev_p = noderev;
 
   return SVN_NO_ERROR;
@@ -2315,28 +2470,58 @@ create_rep_state(struct rep_state **rep_state,
   return err;
 }
 
+/* Return a copy of the stringbuf ITEM in POOL.  This implements
+   svn_fs_fs__cache_dup_func_t. */
+static void *
+dup_stringbuf(const void *item, apr_pool_t *pool)
+{
+  return svn_stringbuf_dup(item, pool);
+}
+
 /* Build an array of rep_state structures in *LIST giving the delta
    reps from first_rep to a plain-text or self-compressed rep.  Set
    *SRC_STATE to the plain-text rep we find at the end of the chain,
    or to NULL if the final delta representation is self-compressed.
+   If the fulltext of one of the base reps is in FS's cache, stop the
+   chain there instead, setting *SRC_STATE to NULL and *BASE_FULLTEXT
+   to that fulltext; otherwise set *BASE_FULLTEXT to NULL.
    The representation to start from is designated by filesystem FS, id
    ID, and representation REP. */
 static svn_error_t *
 build_rep_list(apr_array_header_t **list,
                struct rep_state **src_state,
+               svn_stringbuf_t **base_fulltext,
                svn_fs_t *fs,
                representation_t *first_rep,
                apr_pool_t *pool)
 {
+  fs_fs_data_t *ffd = fs->fsap_data;
   representation_t rep;
   struct rep_state *rs;
   struct rep_args *rep_args;
 
   *list = apr_array_make(pool, 1, sizeof(struct rep_state *));
+  *base_fulltext = NULL;
   rep = *first_rep;
 
   while (1)
     {
+      /* Skip-deltas make many chains end in the same few reps; if we
+         already have the text of this one, there's no need to read
+         it, or anything it is a delta against. */
+      if ((*list)->nelts > 0)
+        {
+          SVN_ERR(svn_fs_fs__cache_get((void **) base_fulltext, ffd->cache,
+                                       svn_fs_fs__cache_fulltext,
+                                       rep.revision, rep.offset,
+                                       dup_stringbuf, pool));
+          if (*base_fulltext)
+            {
+              *src_state = NULL;
+              return SVN_NO_ERROR;
+            }
+        }
+
       SVN_ERR(create_rep_state(&rs, &rep_args, &rep, fs, pool));
       if (rep_args->is_delta == FALSE)
         {
@@ -2372,6 +2557,10 @@ struct rep_read_baton
   /* The plaintext state, if there is a plaintext. */
   struct rep_state *src_state;
 
+  /* The fulltext the last delta rep applies to, if we got it from the
+     cache rather than from a plaintext rep. */
+  svn_stringbuf_t *base_fulltext;
+
   /* The index of the current delta chunk, if we are reading a delta. */
   int chunk_index;
 
@@ -2423,8 +2612,8 @@ rep_read_get_baton(struct rep_read_baton **rb_p,
   b->pool = svn_pool_create(pool);
   b->filehandle_pool = svn_pool_create(pool);
 
-  SVN_ERR(build_rep_list(&b->rs_list, &b->src_state, fs, rep,
-                         b->filehandle_pool));
+  SVN_ERR(build_rep_list(&b->rs_list, &b->src_state, &b->base_fulltext,
+                         fs, rep, b->filehandle_pool));
 
   /* Save our output baton. */
   *rb_p = b;
@@ -2595,7 +2784,16 @@ get_contents(struct rep_read_baton *rb,
                  the delta combiner. */
               SVN_ERR(read_window(&lwindow, rb->chunk_index, rs, rb->pool));
 
-              if (lwindow->src_ops > 0)
+              if (lwindow->src_ops > 0 && rb->base_fulltext)
+                {
+                  if (lwindow->sview_offset + lwindow->sview_len
+                      > rb->base_fulltext->len)
+                    return svn_error_create(SVN_ERR_FS_CORRUPT, NULL,
+                                            _("svndiff requested position "
+                                              "beyond end of stream"));
+                  sbuf = rb->base_fulltext->data + lwindow->sview_offset;
+                }
+              else if (lwindow->src_ops > 0)
                 {
                   if (! rb->src_state)
                     return svn_error_create(SVN_ERR_FS_CORRUPT, NULL,
@@ -2735,13 +2933,60 @@ read_representation(svn_stream_t **contents_p,
   return SVN_NO_ERROR;
 }
 
+/* Like read_representation, but if the fulltext of REP is small enough
+   to go in FS's cache, take it from there, or reconstruct the whole of
+   it at once and put it there. */
+static svn_error_t *
+read_cached_representation(svn_stream_t **contents_p,
+                           svn_fs_t *fs,
+                           representation_t *rep,
+                           apr_pool_t *pool)
+{
+  fs_fs_data_t *ffd = fs->fsap_data;
+  struct rep_read_baton *rb;
+  svn_stringbuf_t *fulltext;
+  apr_size_t len;
+
+  if (! rep || rep->txn_id || rep->expanded_size <= 0
+      || rep->expanded_size > svn_fs_fs__cache_max_item_size(ffd->cache))
+    return read_representation(contents_p, fs, rep, pool);
+
+  SVN_ERR(svn_fs_fs__cache_get((void **) &fulltext, ffd->cache,
+                               svn_fs_fs__cache_fulltext,
+                               rep->revision, rep->offset,
+                               dup_stringbuf, pool));
+  if (! fulltext)
+    {
+      len = (apr_size_t) rep->expanded_size;
+      fulltext = svn_stringbuf_create("", pool);
+      svn_stringbuf_ensure(fulltext, len + 1);
+
+      /* Reading the whole text in one go also verifies its checksum. */
+      SVN_ERR(rep_read_get_baton(&rb, fs, rep, pool));
+      SVN_ERR(rep_read_contents(rb, fulltext->data, &len));
+      SVN_ERR(rep_read_contents_close(rb));
+      fulltext->len = len;
+      fulltext->data[len] = '\0';
+
+      /* A rep that is shorter than it claims to be doesn't get its
+         checksum verified, so don't let it into the cache. */
+      if (len == rep->expanded_size)
+        SVN_ERR(svn_fs_fs__cache_set(ffd->cache, svn_fs_fs__cache_fulltext,
+                                     rep->revision, rep->offset,
+                                     fulltext, len, dup_stringbuf));
+    }
+
+  *contents_p = svn_stream_from_stringbuf(fulltext, pool);
+  return SVN_NO_ERROR;
+}
+
 svn_error_t *
 svn_fs_fs__get_contents(svn_stream_t **contents_p,
                         svn_fs_t *fs,
                         node_revision_t *noderev,
                         apr_pool_t *pool)
 {
-  return read_representation(contents_p, fs, noderev->data_rep, pool);
+  return read_cached_representation(contents_p, fs, noderev->data_rep, pool);
 }
 
 /* Baton used when reading delta windows. */
@@ -2890,38 +3135,28 @@ copy_dir_entries(apr_hash_t *entries,
   return new_entries;
 }
 
+/* Return a copy of the directory hash ITEM in POOL.  This implements
+   svn_fs_fs__cache_dup_func_t. */
+static void *
+dup_dir_entries(const void *item, apr_pool_t *pool)
+{
+  return copy_dir_entries((apr_hash_t *) item, pool);
+}
 
-svn_error_t *
-svn_fs_fs__rep_contents_dir(apr_hash_t **entries_p,
-                            svn_fs_t *fs,
-                            node_revision_t *noderev,
-                            apr_pool_t *pool)
+/* Translate the string dir entries UNPARSED_ENTRIES, as read by
+   get_dir_contents, into a hash of svn_fs_dirent_t in *ENTRIES_P, and
+   set *SIZE_P to roughly how much memory that takes.  Allocate the
+   entries in POOL. */
+static svn_error_t *
+parse_dir_entries(apr_hash_t **entries_p,
+                  apr_size_t *size_p,
+                  apr_hash_t *unparsed_entries,
+                  apr_pool_t *pool)
 {
-  fs_fs_data_t *ffd = fs->fsap_data;
-  apr_hash_t *unparsed_entries, *parsed_entries;
+  apr_hash_t *parsed_entries = apr_hash_make(pool);
   apr_hash_index_t *hi;
-  unsigned int hid;
-
-  /* Calculate an index into the dir entries cache.  This should be
-     completely ignored if this is a mutable noderev. */
-  hid = DIR_CACHE_ENTRIES_MASK(svn_fs_fs__id_rev(noderev->id));
-
-  /* If we have this directory cached, return it. */
-  if (! svn_fs_fs__id_txn_id(noderev->id) &&
-      ffd->dir_cache_id[hid] && svn_fs_fs__id_eq(ffd->dir_cache_id[hid],
-                                                 noderev->id))
-    {
-      *entries_p = copy_dir_entries(ffd->dir_cache[hid], pool);
-      return SVN_NO_ERROR;
-    }
+  apr_size_t size = 0;
 
-  /* Read in the directory hash. */
-  unparsed_entries = apr_hash_make(pool);
-  SVN_ERR(get_dir_contents(unparsed_entries, fs, noderev, pool));
-
-  parsed_entries = apr_hash_make(pool);
-
-  /* Translate the string dir entries into real entries. */
   for (hi = apr_hash_first(pool, unparsed_entries); hi; hi = apr_hash_next(hi))
     {
       const void *key;
@@ -2961,6 +3196,62 @@ svn_fs_fs__rep_contents_dir(apr_hash_t **entries_p,
       dirent->id = svn_fs_fs__id_parse(str, strlen(str), pool);
 
       apr_hash_set(parsed_entries, dirent->name, APR_HASH_KEY_STRING, dirent);
+      size += sizeof(*dirent) + strlen(dirent->name) + 1 + CACHED_ID_SIZE
+              + 4 * sizeof(void *);
+    }
+
+  *entries_p = parsed_entries;
+  *size_p = size;
+  return SVN_NO_ERROR;
+}
+
+
+svn_error_t *
+svn_fs_fs__rep_contents_dir(apr_hash_t **entries_p,
+                            svn_fs_t *fs,
+                            node_revision_t *noderev,
+                            apr_pool_t *pool)
+{
+  fs_fs_data_t *ffd = fs->fsap_data;
+  apr_hash_t *unparsed_entries, *parsed_entries = NULL;
+  representation_t *rep = noderev->data_rep;
+  unsigned int hid;
+
+  /* Calculate an index into the dir entries cache.  This should be
+     completely ignored if this is a mutable noderev. */
+  hid = DIR_CACHE_ENTRIES_MASK(svn_fs_fs__id_rev(noderev->id));
+
+  /* If we have this directory cached, return it. */
+  if (! svn_fs_fs__id_txn_id(noderev->id) &&
+      ffd->dir_cache_id[hid] && svn_fs_fs__id_eq(ffd->dir_cache_id[hid],
+                                                 noderev->id))
+    {
+      *entries_p = copy_dir_entries(ffd->dir_cache[hid], pool);
+      return SVN_NO_ERROR;
+    }
+
+  /* Failing that, another FS object may have read the same contents. */
+  if (! svn_fs_fs__id_txn_id(noderev->id) && rep)
+    SVN_ERR(svn_fs_fs__cache_get((void **) &parsed_entries, ffd->cache,
+                                 svn_fs_fs__cache_dir,
+                                 rep->revision, rep->offset,
+                                 dup_dir_entries, pool));
+
+  if (! parsed_entries)
+    {
+      apr_size_t size = 0;
+
+      /* Read in the directory hash. */
+      unparsed_entries = apr_hash_make(pool);
+      SVN_ERR(get_dir_contents(unparsed_entries, fs, noderev, pool));
+      SVN_ERR(parse_dir_entries(&parsed_entries, &size, unparsed_entries,
+                                pool));
+
+      if (! svn_fs_fs__id_txn_id(noderev->id) && rep)
+        SVN_ERR(svn_fs_fs__cache_set(ffd->cache, svn_fs_fs__cache_dir,
+                                     rep->revision, rep->offset,
+                                     parsed_entries, size,
+                                     dup_dir_entries));
     }
 
   /* If this is an immutable directory, let's cache the contents. */
@@ -3010,7 +3301,8 @@ svn_fs_fs__get_proplist(apr_hash_t **proplist_p,
     }
   else if (noderev->prop_rep)
     {
-      SVN_ERR(read_representation(&stream, fs, noderev->prop_rep, pool));
+      SVN_ERR(read_cached_representation(&stream, fs, noderev->prop_rep,
+                                         pool));
       SVN_ERR(svn_hash_read2(proplist, stream, SVN_HASH_TERMINATOR, pool));
       SVN_ERR(svn_stream_close(stream));
     }
@@ -5425,6 +5717,9 @@ svn_fs_fs__create(svn_fs_t *fs,
   SVN_ERR(svn_io_file_create(path_lock(fs, pool), "", pool));
   SVN_ERR(svn_fs_fs__set_uuid(fs, svn_uuid_generate(pool), pool));
 
+  SVN_ERR(write_config(fs, pool));
+  SVN_ERR(read_config(fs, pool));
+
   SVN_ERR(write_revision_zero(fs));
 
   /* Create the txn-current file if the repository supports
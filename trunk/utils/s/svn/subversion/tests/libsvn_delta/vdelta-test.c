@@ -19,6 +19,7 @@
 #include <apr_want.h>
 
 #include <apr_general.h>
+#include <apr_time.h>
 #include <assert.h>
 
 #include "svn_delta.h"
@@ -39,17 +40,51 @@ print_delta_window(const svn_txdelta_window_t *window,
 }
 
 
+static void
+print_time(const char *what, apr_time_t elapsed,
+           const char *tag, FILE *stream)
+{
+  fprintf(stream, "%s: (TIME %s %" APR_TIME_T_FMT " usec)\n",
+          tag, what, elapsed);
+}
+
+
 static void
 do_one_diff(apr_file_t *source_file, apr_file_t *target_file,
             int *count, apr_off_t *len,
-            int quiet, apr_pool_t *pool,
+            int quiet, int timing, apr_pool_t *pool,
             const char *tag, FILE* stream)
 {
   svn_txdelta_stream_t *delta_stream = NULL;
   svn_txdelta_window_t *delta_window = NULL;
+  svn_txdelta_window_handler_t handler = NULL;
+  void *handler_baton = NULL;
+  apr_time_t delta_time = 0;
+  apr_time_t apply_time = 0;
+  apr_time_t start;
+  svn_error_t *err;
   apr_pool_t *fpool = svn_pool_create(pool);
   apr_pool_t *wpool = svn_pool_create(pool);
 
+  if (timing)
+    {
+      /* Apply the delta as it is made, from a copy of the source in
+         memory, so that only the delta code itself is timed. */
+      svn_stringbuf_t *source = svn_stringbuf_create("", fpool);
+      if (source_file)
+        {
+          apr_off_t offset = 0;
+
+          err = svn_stringbuf_from_aprfile(&source, source_file, fpool);
+          if (err)
+            svn_handle_error2(err, stderr, TRUE, "vdelta-test: ");
+          apr_file_seek(source_file, APR_SET, &offset);
+        }
+      svn_txdelta_apply(svn_stream_from_stringbuf(source, fpool),
+                        svn_stream_empty(fpool), NULL, NULL, fpool,
+                        &handler, &handler_baton);
+    }
+
   *count = 0;
   *len = 0;
   svn_txdelta(&delta_stream,
@@ -57,10 +92,21 @@ do_one_diff(apr_file_t *source_file, apr_file_t *target_file,
               svn_stream_from_aprfile(target_file, fpool),
               fpool);
   do {
-    svn_error_t *err;
+    start = apr_time_now();
     err = svn_txdelta_next_window(&delta_window, delta_stream, wpool);
+    delta_time += apr_time_now() - start;
     if (err)
       svn_handle_error2(err, stderr, TRUE, "vdelta-test: ");
+
+    if (handler)
+      {
+        start = apr_time_now();
+        err = handler(delta_window, handler_baton);
+        apply_time += apr_time_now() - start;
+        if (err)
+          svn_handle_error2(err, stderr, TRUE, "vdelta-test: ");
+      }
+
     if (delta_window != NULL)
       {
         *len += print_delta_window(delta_window, tag, quiet, stream);
@@ -69,6 +115,11 @@ do_one_diff(apr_file_t *source_file, apr_file_t *target_file,
       }
   } while (delta_window != NULL);
   fprintf(stream, "%s: (LENGTH %" APR_OFF_T_FMT " +%d)\n", tag, *len, *count);
+  if (timing)
+    {
+      print_time("delta", delta_time, tag, stream);
+      print_time("apply", apply_time, tag, stream);
+    }
 
   svn_pool_destroy(fpool);
   svn_pool_destroy(wpool);
@@ -109,10 +160,15 @@ main(int argc, char **argv)
 
   apr_pool_t *pool;
   int quiet = 0;
+  int timing = 0;
 
-  if (argc > 1 && argv[1][0] == '-' && argv[1][1] == 'q')
+  while (argc > 1 && argv[1][0] == '-'
+         && (argv[1][1] == 'q' || argv[1][1] == 't'))
     {
-      quiet = 1;
+      if (argv[1][1] == 'q')
+        quiet = 1;
+      else
+        timing = 1;
       --argc; ++argv;
     }
 
@@ -138,14 +194,17 @@ main(int argc, char **argv)
   else
     {
       fprintf(stderr,
-              "Usage: vdelta-test [-q] <target>\n"
-              "   or: vdelta-test [-q] <source> <target>\n"
-              "   or: vdelta-test [-q] <source> <intermediate> <target>\n");
+              "Usage: vdelta-test [-q] [-t] <target>\n"
+              "   or: vdelta-test [-q] [-t] <source> <target>\n"
+              "   or: vdelta-test [-q] [-t] <source> <intermediate> <target>\n"
+              "\n"
+              "  -q  print only the total length of each delta\n"
+              "  -t  also time making, applying and combining the deltas\n");
       exit(1);
     }
 
   do_one_diff(source_file_A, target_file_A,
-              &count_A, &len_A, quiet, pool, "A ", stdout);
+              &count_A, &len_A, quiet, timing, pool, "A ", stdout);
 
   if (source_file_B)
     {
@@ -158,10 +217,11 @@ main(int argc, char **argv)
       svn_txdelta_window_t *window_AB = NULL;
       int count_AB = 0;
       apr_off_t len_AB = 0;
+      apr_time_t compose_time = 0;
 
       putc('\n', stdout);
       do_one_diff(source_file_B, target_file_B,
-                  &count_B, &len_B, quiet, pool, "B ", stdout);
+                  &count_B, &len_B, quiet, timing, pool, "B ", stdout);
 
       putc('\n', stdout);
 
@@ -203,14 +263,20 @@ main(int argc, char **argv)
               window_AB->sview_len = 0;
             }
           else
-            window_AB = svn_txdelta_compose_windows(window_A, window_B,
-                                                    wpool);
+            {
+              apr_time_t start = apr_time_now();
+              window_AB = svn_txdelta_compose_windows(window_A, window_B,
+                                                      wpool);
+              compose_time += apr_time_now() - start;
+            }
           len_AB += print_delta_window(window_AB, "AB", quiet, stdout);
           svn_pool_clear(wpool);
         }
 
       fprintf(stdout, "AB: (LENGTH %" APR_OFF_T_FMT " +%d)\n",
               len_AB, count_AB);
+      if (timing)
+        print_time("compose", compose_time, "AB", stdout);
     }
 
   if (source_file_A) apr_file_close(source_file_A);
@@ -0,0 +1,392 @@
+/* fs-cache-test.c --- tests for the FSFS revision file cache
+ *
+ * ====================================================================
+ * Copyright (c) 2008 CollabNet.  All rights reserved.
+ *
+ * This software is licensed as described in the file COPYING, which
+ * you should have received as part of this distribution.  The terms
+ * are also available at http://subversion.tigris.org/license-1.html.
+ * If newer versions of this license are posted there, you may use a
+ * newer version instead, at your option.
+ *
+ * This software consists of voluntary contributions made by many
+ * individuals.  For exact contribution history, see the revision
+ * history and logs, available at http://subversion.tigris.org/.
+ * ====================================================================
+ */
+
+#include <string.h>
+#include <apr_pools.h>
+
+#include "svn_pools.h"
+#include "svn_string.h"
+#include "svn_path.h"
+#include "svn_fs.h"
+
+#include "../svn_test.h"
+#include "../svn_test_fs.h"
+
+#include "../../libsvn_fs_fs/fs.h"
+#include "../../libsvn_fs_fs/cache.h"
+#include "../../libsvn_fs/fs-loader.h"
+
+
+
+/* Return a copy of the stringbuf ITEM in POOL. */
+static void *
+dup_stringbuf(const void *item, apr_pool_t *pool)
+{
+  return svn_stringbuf_dup(item, pool);
+}
+
+/* Return the cache behind the FSFS filesystem FS. */
+static svn_fs_fs__cache_t *
+fs_cache(svn_fs_t *fs)
+{
+  fs_fs_data_t *ffd = fs->fsap_data;
+  return ffd->cache;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/** The actual fs-cache-tests called by `make check` **/
+
+static svn_error_t *
+cache_basics(const char **msg,
+             svn_boolean_t msg_only,
+             svn_test_opts_t *opts,
+             apr_pool_t *pool)
+{
+  svn_fs_fs__cache_t *cache;
+  svn_fs_fs__cache_stats_t stats;
+  svn_stringbuf_t *item, *found;
+  apr_size_t max_item;
+
+  *msg = "store, find and miss items in the cache";
+
+  if (msg_only)
+    return SVN_NO_ERROR;
+
+  SVN_ERR(svn_fs_fs__cache_create(&cache, 1024 * 1024, pool));
+  if (! cache)
+    return svn_error_create(SVN_ERR_TEST_FAILED, NULL,
+                            "No cache created for 1MB");
+
+  item = svn_stringbuf_create("some text", pool);
+  SVN_ERR(svn_fs_fs__cache_set(cache, svn_fs_fs__cache_fulltext, 3, 100,
+                               item, item->len, dup_stringbuf));
+
+  SVN_ERR(svn_fs_fs__cache_get((void **) &found, cache,
+                               svn_fs_fs__cache_fulltext, 3, 100,
+                               dup_stringbuf, pool));
+  if (! found || ! svn_stringbuf_compare(found, item) || found == item)
+    return svn_error_create(SVN_ERR_TEST_FAILED, NULL,
+                            "Didn't get a copy of a cached item back");
+
+  /* Each part of the key counts. */
+  SVN_ERR(svn_fs_fs__cache_get((void **) &found, cache,
+                               svn_fs_fs__cache_fulltext, 4, 100,
+                               dup_stringbuf, pool));
+  if (found)
+    return svn_error_create(SVN_ERR_TEST_FAILED, NULL,
+                            "Found an item under the wrong revision");
+  SVN_ERR(svn_fs_fs__cache_get((void **) &found, cache,
+                               svn_fs_fs__cache_fulltext, 3, 101,
+                               dup_stringbuf, pool));
+  if (found)
+    return svn_error_create(SVN_ERR_TEST_FAILED, NULL,
+                            "Found an item under the wrong offset");
+  SVN_ERR(svn_fs_fs__cache_get((void **) &found, cache,
+                               svn_fs_fs__cache_dir, 3, 100,
+                               dup_stringbuf, pool));
+  if (found)
+    return svn_error_create(SVN_ERR_TEST_FAILED, NULL,
+                            "Found an item under the wrong kind");
+
+  /* Items too big for a page are turned away. */
+  max_item = svn_fs_fs__cache_max_item_size(cache);
+  SVN_ERR(svn_fs_fs__cache_set(cache, svn_fs_fs__cache_fulltext, 3, 200,
+                               item, max_item + 1, dup_stringbuf));
+  SVN_ERR(svn_fs_fs__cache_get((void **) &found, cache,
+                               svn_fs_fs__cache_fulltext, 3, 200,
+                               dup_stringbuf, pool));
+  if (found)
+    return svn_error_create(SVN_ERR_TEST_FAILED, NULL,
+                            "Cached an item bigger than a page");
+
+  SVN_ERR(svn_fs_fs__cache_get_stats(&stats, cache));
+  if (stats.gets[svn_fs_fs__cache_fulltext] != 4
+      || stats.hits[svn_fs_fs__cache_fulltext] != 1
+      || stats.gets[svn_fs_fs__cache_dir] != 1
+      || stats.hits[svn_fs_fs__cache_dir] != 0
+      || stats.sets != 1 || stats.items != 1)
+    return svn_error_create(SVN_ERR_TEST_FAILED, NULL,
+                            "Cache statistics don't add up");
+
+  /* Too little memory for a cache is no cache. */
+  SVN_ERR(svn_fs_fs__cache_create(&cache, 0, pool));
+  if (cache)
+    return svn_error_create(SVN_ERR_TEST_FAILED, NULL,
+                            "Created a cache with no memory");
+  SVN_ERR(svn_fs_fs__cache_set(cache, svn_fs_fs__cache_fulltext, 3, 100,
+                               item, item->len, dup_stringbuf));
+  SVN_ERR(svn_fs_fs__cache_get((void **) &found, cache,
+                               svn_fs_fs__cache_fulltext, 3, 100,
+                               dup_stringbuf, pool));
+  if (found)
+    return svn_error_create(SVN_ERR_TEST_FAILED, NULL,
+                            "Found an item without a cache");
+
+  return SVN_NO_ERROR;
+}
+
+
+static svn_error_t *
+cache_eviction(const char **msg,
+               svn_boolean_t msg_only,
+               svn_test_opts_t *opts,
+               apr_pool_t *pool)
+{
+  svn_fs_fs__cache_t *cache;
+  svn_fs_fs__cache_stats_t stats;
+  svn_stringbuf_t *item, *found;
+  apr_pool_t *subpool = svn_pool_create(pool);
+  int i;
+
+  *msg = "stay within the limit, keeping recent items";
+
+  if (msg_only)
+    return SVN_NO_ERROR;
+
+  SVN_ERR(svn_fs_fs__cache_create(&cache, 256 * 1024, pool));
+
+  item = svn_stringbuf_create("", pool);
+  for (i = 0; i < 1000; i++)
+    svn_stringbuf_appendbytes(item, "x", 1);
+
+  /* Write ten times what fits, looking up item 0 all along. */
+  for (i = 0; i < 2560; i++)
+    {
+      svn_pool_clear(subpool);
+      SVN_ERR(svn_fs_fs__cache_set(cache, svn_fs_fs__cache_fulltext, 1, i,
+                                   item, item->len, dup_stringbuf));
+      SVN_ERR(svn_fs_fs__cache_get((void **) &found, cache,
+                                   svn_fs_fs__cache_fulltext, 1, 0,
+                                   dup_stringbuf, subpool));
+      if (! found)
+        return svn_error_createf(SVN_ERR_TEST_FAILED, NULL,
+                                 "Item in constant use was evicted after "
+                                 "%d more were added", i);
+    }
+
+  SVN_ERR(svn_fs_fs__cache_get_stats(&stats, cache));
+  if (stats.size > stats.max_size || stats.max_size > 256 * 1024)
+    return svn_error_createf(SVN_ERR_TEST_FAILED, NULL,
+                             "Cache holds %" APR_SIZE_T_FMT " bytes, "
+                             "over its limit of %" APR_SIZE_T_FMT,
+                             stats.size, stats.max_size);
+  if (stats.evictions == 0 || stats.items >= 2560)
+    return svn_error_create(SVN_ERR_TEST_FAILED, NULL,
+                            "Cache never evicted anything");
+
+  /* Older items have gone. */
+  SVN_ERR(svn_fs_fs__cache_get((void **) &found, cache,
+                               svn_fs_fs__cache_fulltext, 1, 100,
+                               dup_stringbuf, subpool));
+  if (found)
+    return svn_error_create(SVN_ERR_TEST_FAILED, NULL,
+                            "Least recently used item is still cached");
+
+  svn_pool_destroy(subpool);
+  return SVN_NO_ERROR;
+}
+
+
+static svn_error_t *
+shared_between_fs_objects(const char **msg,
+                          svn_boolean_t msg_only,
+                          svn_test_opts_t *opts,
+                          apr_pool_t *pool)
+{
+  svn_fs_t *fs, *fs2;
+  svn_fs_txn_t *txn;
+  svn_fs_root_t *txn_root, *rev_root;
+  svn_revnum_t youngest_rev;
+  svn_stringbuf_t *contents;
+  apr_hash_t *entries;
+  svn_fs_fs__cache_stats_t before, after;
+  const char *path = "test-repo-fs-cache-shared";
+
+  *msg = "share the cache between FS objects";
+
+  if (msg_only)
+    return SVN_NO_ERROR;
+
+  SVN_ERR(svn_test__create_fs(&fs, path, "fsfs", pool));
+  SVN_ERR(svn_fs_begin_txn(&txn, fs, 0, pool));
+  SVN_ERR(svn_fs_txn_root(&txn_root, txn, pool));
+  SVN_ERR(svn_test__create_greek_tree(txn_root, pool));
+  SVN_ERR(svn_fs_commit_txn(NULL, &youngest_rev, txn, pool));
+
+  /* Read through one FS object... */
+  SVN_ERR(svn_fs_revision_root(&rev_root, fs, youngest_rev, pool));
+  SVN_ERR(svn_test__get_file_contents(rev_root, "iota", &contents, pool));
+  SVN_ERR(svn_fs_dir_entries(&entries, rev_root, "A/D", pool));
+
+  /* ...and then the same things through another. */
+  SVN_ERR(svn_fs_open(&fs2, path, NULL, pool));
+  if (! fs_cache(fs) || fs_cache(fs2) != fs_cache(fs))
+    return svn_error_create(SVN_ERR_TEST_FAILED, NULL,
+                            "FS objects for one repository don't share "
+                            "a cache");
+
+  SVN_ERR(svn_fs_fs__cache_get_stats(&before, fs_cache(fs2)));
+  SVN_ERR(svn_fs_revision_root(&rev_root, fs2, youngest_rev, pool));
+  SVN_ERR(svn_test__get_file_contents(rev_root, "iota", &contents, pool));
+  SVN_ERR(svn_fs_dir_entries(&entries, rev_root, "A/D", pool));
+  SVN_ERR(svn_fs_fs__cache_get_stats(&after, fs_cache(fs2)));
+
+  if (strcmp(contents->data, "This is the file 'iota'.\n") != 0)
+    return svn_error_create(SVN_ERR_TEST_FAILED, NULL,
+                            "Wrong contents for cached file");
+  if (apr_hash_count(entries) != 3
+      || ! apr_hash_get(entries, "gamma", APR_HASH_KEY_STRING))
+    return svn_error_create(SVN_ERR_TEST_FAILED, NULL,
+                            "Wrong entries for cached directory");
+
+  if (after.hits[svn_fs_fs__cache_noderev]
+      <= before.hits[svn_fs_fs__cache_noderev])
+    return svn_error_create(SVN_ERR_TEST_FAILED, NULL,
+                            "Node-revs weren't found in the cache");
+  if (after.hits[svn_fs_fs__cache_dir] <= before.hits[svn_fs_fs__cache_dir])
+    return svn_error_create(SVN_ERR_TEST_FAILED, NULL,
+                            "Directory wasn't found in the cache");
+  if (after.hits[svn_fs_fs__cache_fulltext]
+      != before.hits[svn_fs_fs__cache_fulltext] + 1)
+    return svn_error_create(SVN_ERR_TEST_FAILED, NULL,
+                            "File contents weren't found in the cache");
+
+  return SVN_NO_ERROR;
+}
+
+
+static svn_error_t *
+cached_delta_base(const char **msg,
+                  svn_boolean_t msg_only,
+                  svn_test_opts_t *opts,
+                  apr_pool_t *pool)
+{
+  svn_fs_t *fs;
+  svn_fs_txn_t *txn;
+  svn_fs_root_t *txn_root, *rev_root;
+  svn_revnum_t youngest_rev = 0;
+  svn_stringbuf_t *contents;
+  svn_fs_fs__cache_stats_t before, after;
+  const char *expected = NULL;
+  int i;
+
+  *msg = "read deltas against cached fulltexts";
+
+  if (msg_only)
+    return SVN_NO_ERROR;
+
+  SVN_ERR(svn_test__create_fs(&fs, "test-repo-fs-cache-delta-base",
+                              "fsfs", pool));
+
+  /* Make a file with a few revisions, each stored as a delta. */
+  for (i = 1; i <= 5; i++)
+    {
+      expected = apr_psprintf(pool, "This is the file 'iota'.\n"
+                              "It has been changed %d times.\n", i);
+      SVN_ERR(svn_fs_begin_txn(&txn, fs, youngest_rev, pool));
+      SVN_ERR(svn_fs_txn_root(&txn_root, txn, pool));
+      if (i == 1)
+        SVN_ERR(svn_fs_make_file(txn_root, "iota", pool));
+      SVN_ERR(svn_test__set_file_contents(txn_root, "iota", expected, pool));
+      SVN_ERR(svn_fs_commit_txn(NULL, &youngest_rev, txn, pool));
+    }
+
+  /* Read all but the last, so that their fulltexts are cached... */
+  for (i = 1; i < youngest_rev; i++)
+    {
+      SVN_ERR(svn_fs_revision_root(&rev_root, fs, i, pool));
+      SVN_ERR(svn_test__get_file_contents(rev_root, "iota", &contents,
+                                          pool));
+    }
+
+  /* ...and then the last should need only one delta applied to one
+     of them. */
+  SVN_ERR(svn_fs_fs__cache_get_stats(&before, fs_cache(fs)));
+  SVN_ERR(svn_fs_revision_root(&rev_root, fs, youngest_rev, pool));
+  SVN_ERR(svn_test__get_file_contents(rev_root, "iota", &contents, pool));
+  SVN_ERR(svn_fs_fs__cache_get_stats(&after, fs_cache(fs)));
+
+  if (strcmp(contents->data, expected) != 0)
+    return svn_error_create(SVN_ERR_TEST_FAILED, NULL,
+                            "Wrong contents for file read from a delta "
+                            "against a cached fulltext");
+  if (after.gets[svn_fs_fs__cache_fulltext]
+      != before.gets[svn_fs_fs__cache_fulltext] + 2
+      || after.hits[svn_fs_fs__cache_fulltext]
+      != before.hits[svn_fs_fs__cache_fulltext] + 1)
+    return svn_error_create(SVN_ERR_TEST_FAILED, NULL,
+                            "Delta base wasn't taken from the cache");
+
+  return SVN_NO_ERROR;
+}
+
+
+static svn_error_t *
+memory_cache_size_config(const char **msg,
+                         svn_boolean_t msg_only,
+                         svn_test_opts_t *opts,
+                         apr_pool_t *pool)
+{
+  svn_fs_t *fs;
+  svn_error_t *err;
+  const char *path = "test-repo-fs-cache-config";
+  const char *conf_path;
+
+  *msg = "read memory-cache-size from fsfs.conf";
+
+  if (msg_only)
+    return SVN_NO_ERROR;
+
+  SVN_ERR(svn_test__create_fs(&fs, path, "fsfs", pool));
+
+  conf_path = svn_path_join(path, PATH_CONFIG, pool);
+  SVN_ERR(svn_io_remove_file(conf_path, pool));
+  SVN_ERR(svn_io_file_create(conf_path,
+                             "[caches]\nmemory-cache-size = lots\n", pool));
+
+  err = svn_fs_open(&fs, path, NULL, pool);
+  if (! err)
+    return svn_error_create(SVN_ERR_TEST_FAILED, NULL,
+                            "Opened a repository with a bad fsfs.conf");
+  svn_error_clear(err);
+
+  /* Without fsfs.conf, the defaults apply. */
+  SVN_ERR(svn_io_remove_file(conf_path, pool));
+  SVN_ERR(svn_fs_open(&fs, path, NULL, pool));
+  if (! fs_cache(fs))
+    return svn_error_create(SVN_ERR_TEST_FAILED, NULL,
+                            "No cache without fsfs.conf");
+
+  return SVN_NO_ERROR;
+}
+
+
+
+/* The test table.  */
+
+struct svn_test_descriptor_t test_funcs[] =
+  {
+    SVN_TEST_NULL,
+    SVN_TEST_PASS(cache_basics),
+    SVN_TEST_PASS(cache_eviction),
+    SVN_TEST_PASS(shared_between_fs_objects),
+    SVN_TEST_PASS(cached_delta_base),
+    SVN_TEST_PASS(memory_cache_size_config),
+    SVN_TEST_NULL
+  };
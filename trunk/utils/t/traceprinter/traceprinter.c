@@ -2510,6 +2510,15 @@ static int s_aps_bankruptcy(tp_state_t s, void* d, unsigned h, unsigned t, unsig
 	_TO3("SYSTEM  ", "APS_BANKRUPTCY ", "fDpid", "fDtid", "fDpartition_id");
 }
 
+/*
+ *  APS scheduling decision latency over the last window, one per cpu
+ *  (class - _NTO_TRACE_SYSTEM)
+ */
+static int s_aps_sched_lat(tp_state_t s, void* d, unsigned h, unsigned t, unsigned* p, unsigned l)
+{
+	_TO4("SYSTEM  ", "APS_SCHED_LAT  ", "fDcpu", "fDdecisions", "fDavg_cycles", "Dmax_cycles");
+}
+
 static int s_function_enter(tp_state_t s, void* d, unsigned h, unsigned t, unsigned* p, unsigned l)
 {
 	_TO2("SYSTEM  ", "FUNC_ENTER", "fHthisfn", "fHcall_site");
@@ -3108,6 +3117,7 @@ int main(int argc, char **argv)
 	TP_CS(traceparser_cs(tp_state, NULL, s_function_enter, _NTO_TRACE_SYSTEM, _NTO_TRACE_SYS_FUNC_ENTER));
 	TP_CS(traceparser_cs(tp_state, NULL, s_function_exit, _NTO_TRACE_SYSTEM, _NTO_TRACE_SYS_FUNC_EXIT));
 	TP_CS(traceparser_cs(tp_state, NULL, s_slog, _NTO_TRACE_SYSTEM, _NTO_TRACE_SYS_SLOG));
+	TP_CS(traceparser_cs(tp_state, NULL, s_aps_sched_lat, _NTO_TRACE_SYSTEM, _NTO_TRACE_SYS_APS_SCHED_LAT));
 
 	/* Setting communication event class callbacs */
 	TP_CS(traceparser_cs(tp_state, NULL, comm_smsg, _NTO_TRACE_COMM, _NTO_TRACE_COMM_SMSG));